@@ -12,6 +12,7 @@
 #include <iomanip>
 
 #include "common/types.h"
+#include "common/rolling_indicators.h"
 #include "strategy/signal_output.h"
 
 // Forward declarations to avoid circular dependencies
@@ -102,9 +103,14 @@ struct MarketState {
  */
 class MarketRegimeDetector {
 private:
-    std::vector<double> price_history_;
-    std::vector<double> volume_history_;
-    const size_t LOOKBACK_PERIOD = 20;
+    static constexpr size_t LOOKBACK_PERIOD = 20;
+    
+    // Rolling state over the last LOOKBACK_PERIOD bars (O(1) updates)
+    rolling::RingWindow<double, LOOKBACK_PERIOD> price_history_;
+    rolling::RollingMoments<double, LOOKBACK_PERIOD - 1> log_returns_;
+    rolling::RollingSlope<double, LOOKBACK_PERIOD> price_trend_;
+    rolling::RollingMean<double, LOOKBACK_PERIOD> volume_mean_;
+    double last_volume_ = 0.0;
     
 public:
     /**
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "cli/command_interface.h"
+#include "strategy/signal_sink.h"
+#include <memory>
 
 namespace sentio {
 namespace cli {
@@ -16,7 +18,10 @@ namespace cli {
  * - Multiple AI strategies (Sigor, GRU, Transformer, Momentum Scalper)
  * - Configurable parameters and output formats
  * - Automatic file organization in data/signals/
- * - JSONL format for efficient signal storage
+ * - JSONL (default), CSV or binary signal files written as a stream
+ * - Live mode: follows a growing bar file or socket, one signal per new bar
+ * - Incremental mode (--extend): appends only the bars after an existing file
+ * - Ensemble (--strategy ens): children evaluated concurrently, log-odds fusion
  */
 class StrattestCommand : public Command {
 public:
@@ -37,7 +42,31 @@ private:
                               const std::vector<std::string>& args);
     
     /**
-     * @brief Execute GRU strategy
+     * @brief Execute a parallel ensemble of child strategies (--strategy ens)
+     */
+    int execute_ensemble_strategy(const std::string& dataset,
+                                  const std::string& output,
+                                  const std::string& config_path,
+                                  const std::vector<std::string>& args);
+    
+    /**
+     * @brief Append signals for bars after the last one in an existing file (--extend)
+     */
+    int execute_incremental(const std::string& dataset,
+                            const std::string& output,
+                            const std::string& config_path,
+                            const std::vector<std::string>& args);
+    
+    /**
+     * @brief Run Sigor incrementally against a growing bar feed (--mode live)
+     */
+    int execute_live_mode(const std::string& feed_spec,
+                          const std::string& output,
+                          const std::string& config_path,
+                          const std::vector<std::string>& args);
+    
+    /**
+     * @brief Execute the LibTorch-free GRU strategy (NativeGruStrategy)
      */
     int execute_gru_strategy(const std::string& dataset,
                             const std::string& output,
@@ -82,6 +111,12 @@ private:
     bool validate_parameters(const std::string& dataset,
                            const std::string& strategy) const;
     
+    /**
+     * @brief Create the output sink from --format / --async-io
+     */
+    std::unique_ptr<sentio::SignalSink> make_sink(const std::string& output,
+                                                  const std::vector<std::string>& args) const;
+    
     /**
      * @brief Extract blocks parameter from arguments
      */
@@ -0,0 +1,135 @@
+#pragma once
+
+// =============================================================================
+// Module: common/bar_feed.h
+// Purpose: Incremental bar sources for live (tailing) signal generation.
+//
+// Core idea:
+// - A live feed is a byte stream in the binary_data file format:
+//   [BinaryHeader][BinaryBar][BinaryBar]... Both sources below parse the same
+//   framing, so a recorded .bin file can be replayed through a socket as-is.
+// - BinaryFileTailFeed follows an append-only .bin file (the header bar_count
+//   is ignored; the file size is authoritative). Bars already on disk at
+//   open() are reported as history so callers can warm up without emitting.
+// - UnixSocketBarFeed connects to a local stream socket and reads frames as
+//   they arrive (poll(2), no busy loop).
+// - next() hands out one bar at a time; bars received in one read share an
+//   arrival timestamp, which is the start point for latency measurement.
+// =============================================================================
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/types.h"
+
+namespace sentio {
+
+class BarFeed {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Status {
+        Ready,    // a bar was returned
+        Idle,     // no complete bar within the timeout
+        Closed,   // producer closed the stream
+        Error     // malformed stream or I/O error
+    };
+
+    virtual ~BarFeed();
+
+    virtual bool open() = 0;
+    virtual void close();
+
+    // Return the next bar, waiting at most `timeout_us` for data to arrive
+    // (0 = do not wait).
+    Status next(Bar& bar, int64_t timeout_us);
+
+    // True if a complete bar is buffered and next() will not touch the source.
+    bool has_buffered() const;
+
+    // Number of bars at the start of the stream that predate open().
+    virtual uint64_t history_bars() const { return 0; }
+    // Index in the source of the first bar returned by next().
+    virtual uint64_t start_index() const { return 0; }
+
+    const std::string& symbol() const { return symbol_; }
+    uint64_t bars_read() const { return bars_read_; }
+    // Time at which the data of the last returned bar was received.
+    Clock::time_point arrival() const { return arrival_; }
+
+protected:
+    // Read available bytes into `dst` (at most `cap`), waiting up to
+    // `timeout_us`. Returns bytes read (> 0), 0 on timeout, -1 when the
+    // producer has closed, -2 on error.
+    virtual long read_some(char* dst, size_t cap, int64_t timeout_us) = 0;
+
+    // Clear buffered bytes. With `expect_header` the stream must start with a
+    // BinaryHeader (which sets symbol_); otherwise it starts at a bar frame.
+    void reset_stream(bool expect_header);
+
+    std::string symbol_;
+
+private:
+    bool parse_header();
+
+    std::vector<char> buffer_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+    bool header_done_ = false;
+    uint64_t bars_read_ = 0;
+    Clock::time_point arrival_{};
+};
+
+// Follows an append-only binary_data file.
+class BinaryFileTailFeed : public BarFeed {
+public:
+    struct Options {
+        int64_t poll_interval_us = 100;   // sleep between size checks when idle
+        int64_t max_history = -1;         // bars of existing history to replay (-1 = all)
+        int64_t resume_index = -1;        // >= 0: start at this bar, no history (restored state)
+    };
+
+    BinaryFileTailFeed(std::string path, Options options);
+    explicit BinaryFileTailFeed(std::string path) : BinaryFileTailFeed(std::move(path), Options{}) {}
+    ~BinaryFileTailFeed() override;
+
+    bool open() override;
+    void close() override;
+    uint64_t history_bars() const override { return history_bars_; }
+    uint64_t start_index() const override { return start_index_; }
+
+protected:
+    long read_some(char* dst, size_t cap, int64_t timeout_us) override;
+
+private:
+    std::string path_;
+    Options options_;
+    int fd_ = -1;
+    uint64_t history_bars_ = 0;
+    uint64_t start_index_ = 0;
+};
+
+// Reads frames from a unix-domain stream socket.
+class UnixSocketBarFeed : public BarFeed {
+public:
+    explicit UnixSocketBarFeed(std::string socket_path);
+    ~UnixSocketBarFeed() override;
+
+    bool open() override;
+    void close() override;
+
+protected:
+    long read_some(char* dst, size_t cap, int64_t timeout_us) override;
+
+private:
+    std::string socket_path_;
+    int fd_ = -1;
+};
+
+// "unix:/path/to.sock" -> UnixSocketBarFeed, anything else -> BinaryFileTailFeed.
+std::unique_ptr<BarFeed> make_bar_feed(const std::string& spec,
+                                       const BinaryFileTailFeed::Options& file_options = {});
+
+} // namespace sentio
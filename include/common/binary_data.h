@@ -15,6 +15,10 @@
 // - Data: [Bar1][Bar2]...[BarN] (fixed-size structs)
 // - Each Bar: timestamp_ms(8) + open(8) + high(8) + low(8) + close(8) + volume(8) = 48 bytes
 //
+// Microstructure companion (<name>.micro.bin, written by tick_aggregator):
+// - Header: BinaryHeader with BINARY_MICRO_MAGIC
+// - Data: one BinaryMicroBar per bar, in the same order as <name>.bin
+//
 // Performance Benefits:
 // - Loading: ~100x faster than CSV parsing
 // - Memory: Compact binary representation
@@ -27,6 +31,7 @@
 #include <string>
 #include <fstream>
 #include <cstdint>
+#include <cstring>
 
 namespace sentio {
 namespace binary_data {
@@ -34,6 +39,7 @@ namespace binary_data {
 // Magic number for file format validation
 static constexpr uint32_t BINARY_DATA_MAGIC = 0x53454E54; // "SENT"
 static constexpr uint32_t BINARY_DATA_VERSION = 1;
+static constexpr uint32_t BINARY_MICRO_MAGIC = 0x53454E4D; // "SENM"
 
 // Binary file header structure
 struct BinaryHeader {
@@ -65,6 +71,23 @@ struct BinaryBar {
     static BinaryBar from_bar(const Bar& bar);
 };
 
+// Per-bar microstructure columns (56 bytes), built from trade and quote prints
+struct BinaryMicroBar {
+    uint64_t timestamp_ms;    // Same as the matching BinaryBar
+    double vwap;              // Volume-weighted average trade price
+    double ofi;               // Order-flow imbalance from best bid/ask updates (shares)
+    double buy_volume;        // Trade volume classified as buyer-initiated
+    double sell_volume;       // Trade volume classified as seller-initiated
+    uint64_t trade_count;     // Trade prints in the bar
+    uint64_t quote_count;     // Quote updates attributed to the bar
+};
+
+// "data/QQQ.bin" -> "data/QQQ.micro.bin"
+std::string micro_path_for(const std::string& binary_path);
+
+// Read a whole microstructure companion file
+bool read_micro_file(const std::string& micro_path, std::vector<BinaryMicroBar>& out);
+
 // High-performance binary data reader
 class BinaryDataReader {
 public:
@@ -0,0 +1,92 @@
+#pragma once
+
+// =============================================================================
+// Module: common/buffered_writer.h
+// Purpose: Large-buffer sequential file writer with optional background I/O.
+//
+// Core idea:
+// - Producers append bytes into an in-memory buffer (1 MiB by default) and the
+//   buffer is handed to the OS in one large write when full. This replaces
+//   per-line ofstream writes and "collect everything, then write" patterns.
+// - In async mode two buffers are used: while the I/O thread writes one, the
+//   producer keeps filling the other, so compute overlaps with disk writes.
+//   The producer only blocks if it fills a buffer before the previous write
+//   has finished.
+// - Memory use is bounded by 2 x buffer size regardless of output length.
+// =============================================================================
+
+#include <string>
+#include <cstdio>
+#include <cstddef>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace sentio {
+
+class BufferedFileWriter {
+public:
+    static constexpr size_t DEFAULT_BUFFER_BYTES = 1 << 20;
+
+    BufferedFileWriter() = default;
+    ~BufferedFileWriter();
+
+    BufferedFileWriter(const BufferedFileWriter&) = delete;
+    BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+    // Open (truncate) `path`. With `async` a background thread performs the
+    // actual writes. Returns false if the file cannot be created.
+    bool open(const std::string& path,
+              size_t buffer_bytes = DEFAULT_BUFFER_BYTES,
+              bool async = false);
+
+    // Open `path` for appending instead of truncating.
+    bool open_append(const std::string& path,
+                     size_t buffer_bytes = DEFAULT_BUFFER_BYTES,
+                     bool async = false);
+
+    void write(const char* data, size_t size);
+    void write(const std::string& s) { write(s.data(), s.size()); }
+    void put(char c) {
+        if (fill_ == capacity_) swap_buffers();
+        active_[fill_++] = c;
+    }
+
+    // Push buffered bytes to the OS (waits for the I/O thread in async mode).
+    bool flush();
+
+    // Flush, stop the I/O thread and close the file. Safe to call twice.
+    bool close();
+
+    bool is_open() const { return file_ != nullptr; }
+    bool good() const { return !failed_; }
+    size_t bytes_written() const { return total_bytes_; }
+    const std::string& path() const { return path_; }
+
+private:
+    bool open_mode(const std::string& path, const char* mode,
+                   size_t buffer_bytes, bool async);
+    void swap_buffers();
+    void write_out(const char* data, size_t size);
+    void io_loop();
+
+    std::string path_;
+    std::FILE* file_ = nullptr;
+    bool failed_ = false;
+    size_t total_bytes_ = 0;
+
+    // Double buffer: producer fills active_, I/O thread drains pending_.
+    char* active_ = nullptr;
+    char* pending_ = nullptr;
+    size_t capacity_ = 0;
+    size_t fill_ = 0;
+    size_t pending_size_ = 0;
+
+    bool async_ = false;
+    bool stop_ = false;
+    std::thread io_thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+} // namespace sentio
@@ -0,0 +1,102 @@
+#pragma once
+
+// =============================================================================
+// Module: common/feature_sequence_manager.h
+// Purpose: Sliding window of the last N feature rows for sequence models
+//          (TransformerStrategy, CppPpoStrategy).
+//
+// Core idea:
+// - Rows live in a preallocated float ring of 2 * N rows. Every row is
+//   written twice (slot h and slot h + N), so the latest N rows, oldest
+//   first, are always the contiguous slice starting at the oldest slot:
+//   window() is a pointer, never a copy or a gather.
+// - Optional per-feature normalization (x - mean) / std is applied once, when
+//   the row is inserted, instead of on the whole window every bar.
+// - add_features() does not allocate; with LibTorch, sequence_tensor_view()
+//   wraps window() as a [1, N, feature_dim] tensor without copying.
+// - The window can only start at N slots, so callers that hand the window to
+//   a model can build one tensor view per window_slot() up front, and a
+//   producer can write the next row in place (next_row() + commit_row()).
+// - save_state()/load_state() snapshot the window rows and their slot; load
+//   refills the existing ring, so views built over window_at() stay valid.
+// =============================================================================
+
+#include <cstddef>
+#include <vector>
+
+namespace sentio {
+
+class StateWriter;
+class StateReader;
+
+class FeatureSequenceManager {
+public:
+    FeatureSequenceManager(int sequence_length, int feature_dim);
+
+    // Normalize inserted rows by (x - means[i]) / stds[i]; both vectors must
+    // have feature_dim entries. Affects rows added afterwards.
+    bool set_normalization(const std::vector<float>& means, const std::vector<float>& stds);
+
+    // Append one row of feature_dim values (the oldest row drops out).
+    void add_features(const float* features);
+    void add_features(const std::vector<double>& features);
+
+    bool is_ready() const { return size_ >= static_cast<size_t>(sequence_length_); }
+    size_t get_history_size() const { return size_; }
+    int sequence_length() const { return sequence_length_; }
+    int feature_dim() const { return feature_dim_; }
+
+    // The last sequence_length rows, oldest first, row-major and contiguous.
+    // Only meaningful once is_ready(); invalidated by the next add_features().
+    const float* window() const { return ring_.data() + head_ * feature_dim_; }
+    // Writable view of the same rows (e.g. to fill per-window columns in place).
+    float* window() { return ring_.data() + head_ * feature_dim_; }
+
+    // In-place append: write feature_dim values to next_row(), then
+    // commit_row(). Same result as add_features() on those values.
+    float* next_row() { return ring_.data() + head_ * feature_dim_; }
+    void commit_row();
+
+    // Slot of window()'s first row, in [0, sequence_length); window_at(slot)
+    // is the window that starts there.
+    size_t window_slot() const { return head_; }
+    float* window_at(size_t slot) { return ring_.data() + slot * feature_dim_; }
+
+    void reset();
+
+    // Rows in the window (already normalized) and window_slot(). Normalization
+    // is configuration and is not stored; load_state() leaves the manager
+    // untouched and returns false when the shape differs or data is short.
+    void save_state(StateWriter& w) const;
+    bool load_state(StateReader& r);
+
+private:
+    void store(const float* row);
+
+    int sequence_length_;
+    int feature_dim_;
+    std::vector<float> ring_;       // 2 * sequence_length rows
+    size_t head_ = 0;               // slot of the oldest row in the window
+    size_t size_ = 0;               // rows seen, capped at sequence_length
+    std::vector<float> means_;
+    std::vector<float> stds_;
+    std::vector<float> scratch_;    // one row (normalization / double input)
+};
+
+} // namespace sentio
+
+#ifdef TORCH_AVAILABLE
+#include <torch/torch.h>
+
+namespace sentio {
+
+// [1, sequence_length, feature_dim] tensor over window(); no copy, valid until
+// the next add_features().
+inline torch::Tensor sequence_tensor_view(FeatureSequenceManager& sequence) {
+    return torch::from_blob(sequence.window(),
+                            {1, sequence.sequence_length(), sequence.feature_dim()},
+                            torch::kFloat);
+}
+
+} // namespace sentio
+#endif
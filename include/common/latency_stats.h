@@ -0,0 +1,53 @@
+#pragma once
+
+// =============================================================================
+// Module: common/latency_stats.h
+// Purpose: Collect latency samples and report percentiles.
+//
+// Samples are stored as nanoseconds in a pre-reserved vector; percentiles are
+// computed on demand (nearest-rank on a sorted copy), so recording on the hot
+// path is a single push_back.
+// =============================================================================
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sentio {
+
+class LatencyStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit LatencyStats(size_t reserve = 1 << 16) { samples_.reserve(reserve); }
+
+    void add_ns(int64_t ns) { samples_.push_back(ns < 0 ? 0 : ns); }
+    void add(Clock::time_point start, Clock::time_point end) {
+        add_ns(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+    size_t count() const { return samples_.size(); }
+    bool empty() const { return samples_.empty(); }
+    void clear() { samples_.clear(); }
+
+    struct Summary {
+        size_t count = 0;
+        double mean_us = 0.0;
+        double p50_us = 0.0;
+        double p90_us = 0.0;
+        double p99_us = 0.0;
+        double p999_us = 0.0;
+        double max_us = 0.0;
+    };
+
+    Summary summary() const;
+
+    // One-line "n=.. mean=..us p50=..us ..." rendering of summary().
+    std::string format() const;
+
+private:
+    std::vector<int64_t> samples_;
+};
+
+} // namespace sentio
@@ -0,0 +1,47 @@
+#pragma once
+
+// =============================================================================
+// Module: common/metadata_sidecar.h
+// Purpose: Binary copy of the normalization part of a model's JSON metadata,
+//          so strategy startup does not parse JSON.
+//
+// Core idea:
+// - The first load parses the JSON as before and writes
+//   "<metadata>.norm" next to it: a 32-byte header (shape, content hash of
+//   the JSON) followed by the means and stds as float64, the precision the
+//   JSON parser produced.
+// - Later loads hash the JSON bytes (no parsing) and read the sidecar if the
+//   hash matches; an edited or replaced metadata file is parsed again and
+//   the sidecar rewritten. Sidecars are written to a temporary name and
+//   renamed, so concurrent strategy processes never read a partial file.
+// =============================================================================
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sentio {
+
+struct NormalizationMetadata {
+    uint32_t sequence_length = 0;       // 0 when the metadata does not say
+    uint32_t feature_dim = 0;
+    std::vector<double> means;
+    std::vector<double> stds;
+};
+
+class MetadataSidecar {
+public:
+    static constexpr uint32_t MAGIC = 0x534E4D53;   // "SMNS"
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    static std::string path_for(const std::string& metadata_path) { return metadata_path + ".norm"; }
+
+    // True if a sidecar written from the current content of metadata_path
+    // exists; fills `out` from it.
+    static bool load(const std::string& metadata_path, NormalizationMetadata& out);
+
+    // Write the sidecar for metadata_path (whose content hash is recorded).
+    static bool store(const std::string& metadata_path, const NormalizationMetadata& metadata);
+};
+
+} // namespace sentio
@@ -0,0 +1,71 @@
+#pragma once
+
+// =============================================================================
+// Module: common/result_cache.h
+// Purpose: Content-addressed cache of generated result files (signal files).
+//
+// Core idea:
+// - A CacheKey is built from everything that determines the bytes of a
+//   result: input content hashes, strategy identity, configuration, range and
+//   output format. The key is the 128-bit hash of that canonical description.
+// - Entries are files named <key><ext> in the cache directory. store() links
+//   a finished output into the cache; fetch() hard-links the entry to the
+//   requested path (copying when the cache is on another filesystem), so a
+//   hit costs a directory operation instead of a run.
+// - Recency is the entry's mtime (refreshed on every hit). After each store
+//   the least recently used entries are removed until the directory fits in
+//   max_bytes.
+// - Outputs served from the cache share their inode with the entry; anything
+//   that modifies a result in place must call detach_hard_link() first.
+// =============================================================================
+
+#include <cstdint>
+#include <string>
+
+namespace sentio {
+
+class CacheKey {
+public:
+    CacheKey& add(const std::string& field, const std::string& value);
+    // Adds the content hash of a file; false if it cannot be read.
+    bool add_file(const std::string& field, const std::string& path);
+
+    std::string hex() const;
+    const std::string& description() const { return canonical_; }
+
+private:
+    std::string canonical_;
+};
+
+class ResultCache {
+public:
+    struct Options {
+        std::string directory = "data/cache/signals";
+        uint64_t max_bytes = 1024ULL << 20;   // 1 GiB
+    };
+
+    explicit ResultCache(Options options);
+
+    // Place the entry for `key` at `dest`. Returns false on a miss.
+    bool fetch(const CacheKey& key, const std::string& dest);
+    // Add a finished result file under `key`, then evict down to max_bytes.
+    bool store(const CacheKey& key, const std::string& src);
+
+    // Remove least recently used entries until the cache fits; returns the
+    // number of entries removed.
+    size_t evict();
+
+    std::string entry_path(const CacheKey& key, const std::string& extension) const;
+
+private:
+    Options options_;
+};
+
+// Hash of a file's bytes (FNV-1a over the whole content); false if unreadable.
+bool hash_file_contents(const std::string& path, uint64_t& hash);
+
+// Give `path` its own copy of the data if it shares an inode with other links
+// (e.g. a cache entry), so in-place writes cannot leak into the cache.
+bool detach_hard_link(const std::string& path);
+
+} // namespace sentio
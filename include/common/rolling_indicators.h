@@ -0,0 +1,657 @@
+#pragma once
+
+// =============================================================================
+// Module: common/rolling_indicators.h
+// Purpose: Header-only library of rolling-window indicator kernels shared by
+//          strategies, feature engines, trainers and the backend.
+//
+// Core idea:
+// - One definition per indicator (SMA, EMA, mean/stddev, RSI, regression
+//   slope, min/max) instead of per-component copies with different costs.
+// - Windows are template parameters when known at compile time
+//   (RollingMean<double, 20>) and constructor arguments otherwise
+//   (RollingMean<double>(period), i.e. N = 0).
+// - Two flavours with the same semantics:
+//   * Streaming kernels (RollingMean, RollingMoments, Ema, RollingRsi,
+//     RollingSlope, RollingMax/RollingMin): push() one value per bar, O(1)
+//     (amortized for max/min) per update, no allocation after construction.
+//   * Batch kernels (rolling::sma, rolling::stddev, ...): evaluate the window
+//     [end - w, end) of any indexable sequence (vector, deque, RingWindow).
+//     They fold the window oldest -> newest, so the result depends only on the
+//     window contents.
+//
+// Semantics shared by both flavours:
+// - Mean/variance/stddev are population statistics (divide by n).
+// - RSI uses simple averages of gains/losses over `period` price changes and
+//   returns 100 when the average loss is <= loss_epsilon.
+// - EMA uses alpha = 2 / (period + 1), seeded with the first value.
+// - Regression slope is ordinary least squares of y against x = 0..n-1.
+//
+// Snapshots: every kernel has save(w)/load(r) templated on the archive
+// (StateWriter/StateReader from common/state_stream.h). Running sums are
+// stored bit-exactly, so a restored kernel continues exactly like the
+// original. load() returns false on truncated or mismatching input.
+//
+// Note: running-sum kernels carry rounding from values that already left the
+// window (last-bit differences, periodically resynced). Where results must be
+// a pure function of the window (bitwise sharded-vs-sequential checks), keep
+// values in a RingWindow and use the batch kernels.
+// =============================================================================
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace sentio {
+namespace rolling {
+
+// -----------------------------------------------------------------------------
+// RingWindow: fixed-capacity FIFO. Index 0 is the oldest element; back(k) is
+// the k-th most recent. Compile-time capacity uses inline storage.
+// -----------------------------------------------------------------------------
+template <typename T, size_t N = 0>
+class RingWindow {
+    using Storage = std::conditional_t<N == 0, std::vector<T>, std::array<T, (N == 0 ? 1 : N)>>;
+
+public:
+    template <size_t M = N, typename = std::enable_if_t<M != 0>>
+    RingWindow() : data_{} {}
+
+    template <size_t M = N, typename = std::enable_if_t<M == 0>>
+    explicit RingWindow(size_t capacity) : data_(capacity > 0 ? capacity : 1) {}
+
+    // Append a value, evicting the oldest one when full.
+    void push(T value) {
+        data_[head_] = value;
+        head_ = (head_ + 1 == data_.size()) ? 0 : head_ + 1;
+        if (size_ < data_.size()) ++size_;
+    }
+
+    // Value push() would evict next (only meaningful when full()).
+    T oldest() const { return (*this)[0]; }
+
+    T operator[](size_t i) const {
+        size_t idx = head_ + data_.size() - size_ + i;
+        if (idx >= data_.size()) idx -= data_.size();
+        return data_[idx];
+    }
+
+    T back(size_t k = 0) const { return (*this)[size_ - 1 - k]; }
+    T front() const { return (*this)[0]; }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return data_.size(); }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == data_.size(); }
+    void clear() { head_ = 0; size_ = 0; }
+
+    // Stored oldest -> newest; capacity is not stored and must match on load.
+    template <typename W>
+    void save(W& w) const {
+        w.put(static_cast<uint64_t>(size_));
+        for (size_t i = 0; i < size_; ++i) w.put((*this)[i]);
+    }
+
+    template <typename R>
+    bool load(R& r) {
+        uint64_t n = 0;
+        if (!r.get(n) || n > data_.size()) return false;
+        clear();
+        for (uint64_t i = 0; i < n; ++i) {
+            T v;
+            if (!r.get(v)) return false;
+            push(v);
+        }
+        return true;
+    }
+
+private:
+    Storage data_;
+    size_t head_ = 0;   // next write position
+    size_t size_ = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Batch kernels over the window [end - w, end) of an indexable sequence.
+// Callers guarantee w > 0 and end >= w (end >= w + 1 for price-change kernels).
+// -----------------------------------------------------------------------------
+template <typename Seq>
+inline double sum(const Seq& s, size_t end, size_t w) {
+    double acc = 0.0;
+    for (size_t i = end - w; i < end; ++i) acc += s[i];
+    return acc;
+}
+
+template <typename Seq>
+inline double sma(const Seq& s, size_t end, size_t w) {
+    return sum(s, end, w) / static_cast<double>(w);
+}
+
+template <typename Seq>
+inline double variance(const Seq& s, size_t end, size_t w, double mean) {
+    double acc = 0.0;
+    for (size_t i = end - w; i < end; ++i) {
+        double d = s[i] - mean;
+        acc += d * d;
+    }
+    return acc / static_cast<double>(w);
+}
+
+template <typename Seq>
+inline double stddev(const Seq& s, size_t end, size_t w, double mean) {
+    return std::sqrt(variance(s, end, w, mean));
+}
+
+template <typename Seq>
+inline double stddev(const Seq& s, size_t end, size_t w) {
+    return stddev(s, end, w, sma(s, end, w));
+}
+
+template <typename Seq>
+inline double max_of(const Seq& s, size_t end, size_t w) {
+    double m = -std::numeric_limits<double>::infinity();
+    for (size_t i = end - w; i < end; ++i) m = s[i] > m ? s[i] : m;
+    return m;
+}
+
+template <typename Seq>
+inline double min_of(const Seq& s, size_t end, size_t w) {
+    double m = std::numeric_limits<double>::infinity();
+    for (size_t i = end - w; i < end; ++i) m = s[i] < m ? s[i] : m;
+    return m;
+}
+
+// RSI value from average gain/loss (0..100).
+inline double rsi_value(double avg_gain, double avg_loss, double loss_epsilon = 0.0) {
+    if (avg_loss <= loss_epsilon) return 100.0;
+    double rs = avg_gain / avg_loss;
+    return 100.0 - (100.0 / (1.0 + rs));
+}
+
+// RSI over the last `period` price changes ending at prices[end - 1].
+template <typename Seq>
+inline double rsi(const Seq& prices, size_t end, size_t period, double loss_epsilon = 0.0) {
+    double gain = 0.0, loss = 0.0;
+    for (size_t i = end - period; i < end; ++i) {
+        double change = prices[i] - prices[i - 1];
+        gain += change > 0.0 ? change : 0.0;
+        loss += change < 0.0 ? -change : 0.0;
+    }
+    return rsi_value(gain / static_cast<double>(period), loss / static_cast<double>(period), loss_epsilon);
+}
+
+// OLS slope of y against x = 0..w-1.
+template <typename Seq>
+inline double slope(const Seq& s, size_t end, size_t w) {
+    const double n = static_cast<double>(w);
+    const double sum_x = n * (n - 1) / 2;
+    const double sum_x2 = n * (n - 1) * (2 * n - 1) / 6;
+    double sum_y = 0.0, sum_xy = 0.0;
+    for (size_t i = 0; i < w; ++i) {
+        double y = s[end - w + i];
+        sum_y += y;
+        sum_xy += static_cast<double>(i) * y;
+    }
+    double den = n * sum_x2 - sum_x * sum_x;
+    return den != 0.0 ? (n * sum_xy - sum_x * sum_y) / den : 0.0;
+}
+
+// -----------------------------------------------------------------------------
+// Streaming kernels
+// Running sums are recomputed from the window every RESYNC_FACTOR * period
+// pushes, which keeps drift bounded on multi-million-bar runs at O(1)
+// amortized cost.
+// -----------------------------------------------------------------------------
+static constexpr size_t RESYNC_FACTOR = 64;
+
+// Simple moving average with an O(1) running sum.
+template <typename T = double, size_t N = 0>
+class RollingMean {
+public:
+    template <size_t M = N, typename = std::enable_if_t<M != 0>>
+    RollingMean() {}
+
+    template <size_t M = N, typename = std::enable_if_t<M == 0>>
+    explicit RollingMean(size_t period) : window_(period) {}
+
+    void push(T value) {
+        if (window_.full()) sum_ -= window_.oldest();
+        window_.push(value);
+        sum_ += value;
+        if (++since_resync_ >= RESYNC_FACTOR * window_.capacity()) resync();
+    }
+
+    // Recompute the running sum from the window (bounds rounding drift).
+    void resync() {
+        sum_ = T(0);
+        for (size_t i = 0; i < window_.size(); ++i) sum_ += window_[i];
+        since_resync_ = 0;
+    }
+
+    bool ready() const { return window_.full(); }
+    size_t size() const { return window_.size(); }
+    size_t period() const { return window_.capacity(); }
+    T sum() const { return sum_; }
+    // Mean of the values currently in the window (all `period` once ready()).
+    T value() const { return window_.empty() ? T(0) : sum_ / static_cast<T>(window_.size()); }
+    const RingWindow<T, N>& window() const { return window_; }
+    void reset() { window_.clear(); sum_ = T(0); since_resync_ = 0; }
+
+    template <typename W>
+    void save(W& w) const {
+        window_.save(w);
+        w.put(sum_);
+        w.put(static_cast<uint64_t>(since_resync_));
+    }
+
+    template <typename R>
+    bool load(R& r) {
+        uint64_t since = 0;
+        if (!window_.load(r) || !r.get(sum_) || !r.get(since)) return false;
+        since_resync_ = static_cast<size_t>(since);
+        return true;
+    }
+
+private:
+    RingWindow<T, N> window_;
+    T sum_ = T(0);
+    size_t since_resync_ = 0;
+};
+
+// Rolling mean/variance using a sliding Welford update (numerically stable
+// for price-level data where sum-of-squares would cancel).
+template <typename T = double, size_t N = 0>
+class RollingMoments {
+public:
+    template <size_t M = N, typename = std::enable_if_t<M != 0>>
+    RollingMoments() {}
+
+    template <size_t M = N, typename = std::enable_if_t<M == 0>>
+    explicit RollingMoments(size_t period) : window_(period) {}
+
+    void push(T value) {
+        if (window_.full()) {
+            T old = window_.oldest();
+            T n = static_cast<T>(window_.size() - 1);
+            if (n > 0) {
+                T d = old - mean_;
+                mean_ -= d / n;
+                m2_ -= d * (old - mean_);
+            } else {
+                mean_ = T(0);
+                m2_ = T(0);
+            }
+        }
+        window_.push(value);
+        T n = static_cast<T>(window_.size());
+        T d = value - mean_;
+        mean_ += d / n;
+        m2_ += d * (value - mean_);
+        if (m2_ < T(0)) m2_ = T(0);
+        if (++since_resync_ >= RESYNC_FACTOR * window_.capacity()) resync();
+    }
+
+    // Recompute mean and M2 from the window with two passes.
+    void resync() {
+        const size_t n = window_.size();
+        mean_ = T(0);
+        m2_ = T(0);
+        since_resync_ = 0;
+        if (n == 0) return;
+        for (size_t i = 0; i < n; ++i) mean_ += window_[i];
+        mean_ /= static_cast<T>(n);
+        for (size_t i = 0; i < n; ++i) {
+            T d = window_[i] - mean_;
+            m2_ += d * d;
+        }
+    }
+
+    bool ready() const { return window_.full(); }
+    size_t size() const { return window_.size(); }
+    size_t period() const { return window_.capacity(); }
+    T mean() const { return mean_; }
+    T variance() const { return window_.empty() ? T(0) : m2_ / static_cast<T>(window_.size()); }
+    T stddev() const { return std::sqrt(variance()); }
+    const RingWindow<T, N>& window() const { return window_; }
+    void reset() { window_.clear(); mean_ = T(0); m2_ = T(0); since_resync_ = 0; }
+
+    template <typename W>
+    void save(W& w) const {
+        window_.save(w);
+        w.put(mean_);
+        w.put(m2_);
+        w.put(static_cast<uint64_t>(since_resync_));
+    }
+
+    template <typename R>
+    bool load(R& r) {
+        uint64_t since = 0;
+        if (!window_.load(r) || !r.get(mean_) || !r.get(m2_) || !r.get(since)) return false;
+        since_resync_ = static_cast<size_t>(since);
+        return true;
+    }
+
+private:
+    RingWindow<T, N> window_;
+    T mean_ = T(0);
+    T m2_ = T(0);
+    size_t since_resync_ = 0;
+};
+
+// Exponential moving average, alpha = 2 / (period + 1), seeded with the first value.
+template <typename T = double, size_t P = 0>
+class Ema {
+public:
+    template <size_t M = P, typename = std::enable_if_t<M != 0>>
+    Ema() : alpha_(T(2) / (static_cast<T>(P) + T(1))) {}
+
+    template <size_t M = P, typename = std::enable_if_t<M == 0>>
+    explicit Ema(size_t period) : alpha_(T(2) / (static_cast<T>(period) + T(1))) {}
+
+    void push(T value) {
+        value_ = initialized_ ? alpha_ * value + (T(1) - alpha_) * value_ : value;
+        initialized_ = true;
+    }
+
+    bool ready() const { return initialized_; }
+    T value() const { return value_; }
+    T alpha() const { return alpha_; }
+    void reset() { initialized_ = false; value_ = T(0); }
+
+    template <typename W>
+    void save(W& w) const {
+        w.put(value_);
+        w.put(static_cast<uint8_t>(initialized_));
+    }
+
+    template <typename R>
+    bool load(R& r) {
+        uint8_t init = 0;
+        if (!r.get(value_) || !r.get(init)) return false;
+        initialized_ = init != 0;
+        return true;
+    }
+
+private:
+    T alpha_;
+    T value_ = T(0);
+    bool initialized_ = false;
+};
+
+// RSI over the last N price changes (simple averages).
+template <typename T = double, size_t N = 0>
+class RollingRsi {
+public:
+    template <size_t M = N, typename = std::enable_if_t<M != 0>>
+    RollingRsi() {}
+
+    template <size_t M = N, typename = std::enable_if_t<M == 0>>
+    explicit RollingRsi(size_t period) : gains_(period), losses_(period) {}
+
+    void push(T price) {
+        if (has_last_) {
+            T change = price - last_;
+            gains_.push(change > T(0) ? change : T(0));
+            losses_.push(change < T(0) ? -change : T(0));
+        }
+        last_ = price;
+        has_last_ = true;
+    }
+
+    bool ready() const { return gains_.ready(); }
+    // 50 (neutral) until `period` changes have been seen.
+    T value(T loss_epsilon = T(0)) const {
+        if (!ready()) return T(50);
+        return static_cast<T>(rsi_value(gains_.value(), losses_.value(), loss_epsilon));
+    }
+    void reset() { gains_.reset(); losses_.reset(); has_last_ = false; }
+
+    template <typename W>
+    void save(W& w) const {
+        gains_.save(w);
+        losses_.save(w);
+        w.put(last_);
+        w.put(static_cast<uint8_t>(has_last_));
+    }
+
+    template <typename R>
+    bool load(R& r) {
+        uint8_t has = 0;
+        if (!gains_.load(r) || !losses_.load(r) || !r.get(last_) || !r.get(has)) return false;
+        has_last_ = has != 0;
+        return true;
+    }
+
+private:
+    RollingMean<T, N> gains_;
+    RollingMean<T, N> losses_;
+    T last_ = T(0);
+    bool has_last_ = false;
+};
+
+// OLS slope of the window against x = 0..n-1, updated in O(1).
+template <typename T = double, size_t N = 0>
+class RollingSlope {
+public:
+    template <size_t M = N, typename = std::enable_if_t<M != 0>>
+    RollingSlope() {}
+
+    template <size_t M = N, typename = std::enable_if_t<M == 0>>
+    explicit RollingSlope(size_t period) : window_(period) {}
+
+    void push(T y) {
+        if (window_.full()) {
+            // Drop x = 0 and shift the remaining x down by one.
+            T old = window_.oldest();
+            sum_y_ -= old;
+            sum_xy_ -= sum_y_;
+            window_.push(y);
+            sum_xy_ += static_cast<T>(window_.size() - 1) * y;
+            sum_y_ += y;
+        } else {
+            sum_xy_ += static_cast<T>(window_.size()) * y;
+            sum_y_ += y;
+            window_.push(y);
+        }
+        if (++since_resync_ >= RESYNC_FACTOR * window_.capacity()) resync();
+    }
+
+    // Recompute the running sums from the window (bounds rounding drift).
+    void resync() {
+        sum_y_ = T(0);
+        sum_xy_ = T(0);
+        for (size_t i = 0; i < window_.size(); ++i) {
+            sum_y_ += window_[i];
+            sum_xy_ += static_cast<T>(i) * window_[i];
+        }
+        since_resync_ = 0;
+    }
+
+    bool ready() const { return window_.full(); }
+    size_t size() const { return window_.size(); }
+    T value() const {
+        const T n = static_cast<T>(window_.size());
+        if (n < T(2)) return T(0);
+        const T sum_x = n * (n - 1) / 2;
+        const T sum_x2 = n * (n - 1) * (2 * n - 1) / 6;
+        const T den = n * sum_x2 - sum_x * sum_x;
+        return den != T(0) ? (n * sum_xy_ - sum_x * sum_y_) / den : T(0);
+    }
+    const RingWindow<T, N>& window() const { return window_; }
+    void reset() { window_.clear(); sum_y_ = T(0); sum_xy_ = T(0); since_resync_ = 0; }
+
+    template <typename W>
+    void save(W& w) const {
+        window_.save(w);
+        w.put(sum_y_);
+        w.put(sum_xy_);
+        w.put(static_cast<uint64_t>(since_resync_));
+    }
+
+    template <typename R>
+    bool load(R& r) {
+        uint64_t since = 0;
+        if (!window_.load(r) || !r.get(sum_y_) || !r.get(sum_xy_) || !r.get(since)) return false;
+        since_resync_ = static_cast<size_t>(since);
+        return true;
+    }
+
+private:
+    RingWindow<T, N> window_;
+    T sum_y_ = T(0);
+    T sum_xy_ = T(0);
+    size_t since_resync_ = 0;
+};
+
+// Rolling maximum (Better = std::greater) or minimum (std::less) via a
+// monotonic queue: each value is pushed and popped at most once.
+template <typename T, size_t N, typename Better>
+class RollingExtreme {
+public:
+    template <size_t M = N, typename = std::enable_if_t<M != 0>>
+    RollingExtreme() : entries_{} {}
+
+    template <size_t M = N, typename = std::enable_if_t<M == 0>>
+    explicit RollingExtreme(size_t period) : entries_(period > 0 ? period : 1) {}
+
+    void push(T value) {
+        const size_t cap = entries_.size();
+        // Drop the value leaving the window, then values the new one dominates
+        if (count_ > 0 && at(0).seq + cap <= seq_) {
+            first_ = wrap(first_ + 1);
+            --count_;
+        }
+        while (count_ > 0 && !Better()(at(count_ - 1).value, value)) --count_;
+        entries_[wrap(first_ + count_)] = Entry{seq_, value};
+        ++count_;
+        ++seq_;
+    }
+
+    bool ready() const { return seq_ >= entries_.size(); }
+    // Extreme of the last min(pushed, period) values; 0 before the first push.
+    T value() const { return count_ > 0 ? at(0).value : T(0); }
+    size_t period() const { return entries_.size(); }
+    void reset() { first_ = 0; count_ = 0; seq_ = 0; }
+
+    template <typename W>
+    void save(W& w) const {
+        w.put(static_cast<uint64_t>(seq_));
+        w.put(static_cast<uint64_t>(count_));
+        for (size_t i = 0; i < count_; ++i) {
+            w.put(static_cast<uint64_t>(at(i).seq));
+            w.put(at(i).value);
+        }
+    }
+
+    template <typename R>
+    bool load(R& r) {
+        uint64_t seq = 0, count = 0;
+        if (!r.get(seq) || !r.get(count) || count > entries_.size()) return false;
+        reset();
+        for (uint64_t i = 0; i < count; ++i) {
+            uint64_t s = 0;
+            T v;
+            if (!r.get(s) || !r.get(v)) return false;
+            entries_[i] = Entry{static_cast<size_t>(s), v};
+        }
+        count_ = static_cast<size_t>(count);
+        seq_ = static_cast<size_t>(seq);
+        return true;
+    }
+
+private:
+    struct Entry {
+        size_t seq;
+        T value;
+    };
+    using Storage = std::conditional_t<N == 0, std::vector<Entry>, std::array<Entry, (N == 0 ? 1 : N)>>;
+
+    size_t wrap(size_t i) const { return i >= entries_.size() ? i - entries_.size() : i; }
+    const Entry& at(size_t i) const { return entries_[wrap(first_ + i)]; }
+
+    Storage entries_;
+    size_t first_ = 0;
+    size_t count_ = 0;
+    size_t seq_ = 0;       // index of the next push
+};
+
+template <typename T = double, size_t N = 0>
+using RollingMax = RollingExtreme<T, N, std::greater<T>>;
+
+template <typename T = double, size_t N = 0>
+using RollingMin = RollingExtreme<T, N, std::less<T>>;
+
+// -----------------------------------------------------------------------------
+// Banks of compile-time windows updated together. value(period) looks a
+// window up at runtime and returns 0 if the period is unknown or not ready.
+// -----------------------------------------------------------------------------
+template <typename T, size_t... Ps>
+class MeanBank {
+public:
+    void push(T value) {
+        std::apply([value](auto&... m) { (m.push(value), ...); }, means_);
+    }
+
+    template <size_t P>
+    const RollingMean<T, P>& get() const { return std::get<RollingMean<T, P>>(means_); }
+
+    T value(size_t period) const {
+        T out = T(0);
+        std::apply([&](const auto&... m) {
+            ((m.period() == period ? (out = m.ready() ? m.value() : T(0), true) : false) || ...);
+        }, means_);
+        return out;
+    }
+
+    void reset() { std::apply([](auto&... m) { (m.reset(), ...); }, means_); }
+
+    template <typename W>
+    void save(W& w) const { std::apply([&w](const auto&... m) { (m.save(w), ...); }, means_); }
+
+    template <typename R>
+    bool load(R& r) { return std::apply([&r](auto&... m) { return (m.load(r) && ...); }, means_); }
+
+private:
+    std::tuple<RollingMean<T, Ps>...> means_;
+};
+
+template <typename T, size_t... Ps>
+class EmaBank {
+public:
+    void push(T value) {
+        std::apply([value](auto&... e) { (e.push(value), ...); }, emas_);
+    }
+
+    template <size_t P>
+    const Ema<T, P>& get() const { return std::get<Ema<T, P>>(emas_); }
+
+    T value(size_t period) const {
+        static constexpr size_t periods[] = {Ps...};
+        T out = T(0);
+        size_t i = 0;
+        std::apply([&](const auto&... e) {
+            ((periods[i++] == period ? (out = e.ready() ? e.value() : T(0), true) : false) || ...);
+        }, emas_);
+        return out;
+    }
+
+    void reset() { std::apply([](auto&... e) { (e.reset(), ...); }, emas_); }
+
+    template <typename W>
+    void save(W& w) const { std::apply([&w](const auto&... e) { (e.save(w), ...); }, emas_); }
+
+    template <typename R>
+    bool load(R& r) { return std::apply([&r](auto&... e) { return (e.load(r) && ...); }, emas_); }
+
+private:
+    std::tuple<Ema<T, Ps>...> emas_;
+};
+
+} // namespace rolling
+} // namespace sentio
@@ -0,0 +1,101 @@
+#pragma once
+
+// =============================================================================
+// Module: common/state_stream.h
+// Purpose: Minimal binary writer/reader for component state snapshots.
+//
+// Core idea:
+// - Values are appended as raw host-endian bytes (trivially copyable types
+//   only), strings as [u32 length][bytes]. Snapshots are meant to be restored
+//   by the same build on the same machine type, not exchanged across
+//   platforms.
+// - StateReader never reads past the end: every get() returns false on
+//   truncation and the reader stays failed, so a chain of reads can be
+//   checked once with ok().
+// =============================================================================
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace sentio {
+
+class StateWriter {
+public:
+    template <typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "put() requires a trivially copyable type");
+        const char* p = reinterpret_cast<const char*>(&value);
+        buffer_.insert(buffer_.end(), p, p + sizeof(T));
+    }
+
+    void put_string(const std::string& s) {
+        put(static_cast<uint32_t>(s.size()));
+        buffer_.insert(buffer_.end(), s.begin(), s.end());
+    }
+
+    void put_bytes(const char* data, size_t size) {
+        buffer_.insert(buffer_.end(), data, data + size);
+    }
+
+    const std::vector<char>& data() const { return buffer_; }
+    std::vector<char>& data() { return buffer_; }
+    size_t size() const { return buffer_.size(); }
+
+private:
+    std::vector<char> buffer_;
+};
+
+class StateReader {
+public:
+    StateReader(const char* data, size_t size) : cur_(data), end_(data + size) {}
+
+    template <typename T>
+    bool get(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "get() requires a trivially copyable type");
+        if (!ok_ || remaining() < sizeof(T)) return ok_ = false;
+        std::memcpy(&value, cur_, sizeof(T));
+        cur_ += sizeof(T);
+        return true;
+    }
+
+    bool get_string(std::string& s, size_t max_length = 1 << 20) {
+        uint32_t n = 0;
+        if (!get(n) || n > max_length || remaining() < n) return ok_ = false;
+        s.assign(cur_, n);
+        cur_ += n;
+        return true;
+    }
+
+    // Advance past `size` bytes and return a pointer to them (nullptr on truncation).
+    const char* take(size_t size) {
+        if (!ok_ || remaining() < size) { ok_ = false; return nullptr; }
+        const char* p = cur_;
+        cur_ += size;
+        return p;
+    }
+
+    bool ok() const { return ok_; }
+    size_t remaining() const { return static_cast<size_t>(end_ - cur_); }
+    bool at_end() const { return ok_ && cur_ == end_; }
+
+private:
+    const char* cur_;
+    const char* end_;
+    bool ok_ = true;
+};
+
+// FNV-1a, used for config fingerprints and snapshot checksums.
+inline uint64_t fnv1a64(const char* data, size_t size, uint64_t hash = 1469598103934665603ULL) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+inline uint64_t fnv1a64(const std::string& s) { return fnv1a64(s.data(), s.size()); }
+
+} // namespace sentio
@@ -0,0 +1,63 @@
+#pragma once
+
+// =============================================================================
+// Module: common/thread_pool.h
+// Purpose: Minimal fixed-size worker pool for CPU-bound batch work.
+//
+// Core idea:
+// - A fixed set of worker threads drains a FIFO task queue.
+// - submit() returns a std::future so callers can collect results in the
+//   order they need (e.g. stitching shard outputs back together), regardless
+//   of completion order. Exceptions propagate through the future.
+// - The destructor finishes queued tasks and joins all workers.
+// =============================================================================
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace sentio {
+
+class ThreadPool {
+public:
+    // threads <= 0 selects std::thread::hardware_concurrency().
+    explicit ThreadPool(int threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto submit(F&& fn) -> std::future<std::invoke_result_t<F>> {
+        using R = std::invoke_result_t<F>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+        std::future<R> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace([task] { (*task)(); });
+        }
+        cv_.notify_one();
+        return result;
+    }
+
+    size_t size() const { return workers_.size(); }
+
+    static int default_thread_count();
+
+private:
+    void worker_loop();
+
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+};
+
+} // namespace sentio
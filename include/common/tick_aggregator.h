@@ -0,0 +1,178 @@
+#pragma once
+
+// =============================================================================
+// Module: common/tick_aggregator.h
+// Purpose: Stream trade and quote prints into bars with real microstructure
+//          columns (VWAP, order-flow imbalance, signed volume, trade count).
+//
+// Core idea:
+// - TickAggregator is a push-style state machine: on_trade()/on_quote() in
+//   timestamp order, finish() at the end. Each event is O(1) with no
+//   allocation, so the aggregator itself runs at tens of millions of events
+//   per second; file parsing is the usual bottleneck.
+// - Time bars are stamped with the bucket start (floor(ts / interval)), like
+//   the existing 1-minute data. A bar closes when an event arrives in a later
+//   bucket. Buckets without trades produce no bar; quote activity in them is
+//   carried into the next emitted bar's OFI.
+// - Volume bars close on the trade that brings the bar's volume to at least
+//   volume_per_bar (prints are not split) and are stamped with their first
+//   trade.
+// - OFI follows Cont, Kukanov & Stoikov: each best bid/ask update contributes
+//   e = 1{b>=b'}q_b - 1{b<=b'}q_b' - 1{a<=a'}q_a + 1{a>=a'}q_a' against the
+//   previous quote (b', a', q').
+// - Trades are signed with the prevailing quote (at/above ask: buy, at/below
+//   bid: sell, otherwise against the mid) and fall back to the tick rule at
+//   the mid or when no quote has been seen. At equal timestamps quotes are
+//   applied before trades.
+// - TickCsvReader parses "ts,price,size" and "ts,bid,bid_size,ask,ask_size"
+//   files in large blocks with std::from_chars. Timestamps are epoch integers
+//   in s, ms, us or ns (detected by magnitude); header lines are skipped.
+// - TickBarFileWriter writes the OHLCV bars as a regular binary_data .bin
+//   file and the microstructure columns to its .micro.bin companion.
+// =============================================================================
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+#include "common/binary_data.h"
+#include "common/buffered_writer.h"
+
+namespace sentio {
+namespace ticks {
+
+struct TradeTick {
+    int64_t timestamp_ms = 0;
+    double price = 0.0;
+    double size = 0.0;
+};
+
+struct QuoteTick {
+    int64_t timestamp_ms = 0;
+    double bid = 0.0;
+    double bid_size = 0.0;
+    double ask = 0.0;
+    double ask_size = 0.0;
+};
+
+struct AggregationStats {
+    uint64_t trades = 0;
+    uint64_t quotes = 0;
+    uint64_t bars = 0;
+    uint64_t out_of_order = 0;     // events older than their predecessor (clamped)
+    uint64_t malformed = 0;        // input lines that failed to parse
+};
+
+class TickAggregator {
+public:
+    enum class BarType { Time, Volume };
+
+    struct Config {
+        BarType type = BarType::Time;
+        int64_t interval_ms = 60000;     // time bars
+        double volume_per_bar = 0.0;     // volume bars
+    };
+
+    using BarCallback = std::function<void(const binary_data::BinaryBar&,
+                                           const binary_data::BinaryMicroBar&)>;
+
+    TickAggregator(const Config& config, BarCallback on_bar);
+
+    void on_trade(const TradeTick& trade);
+    void on_quote(const QuoteTick& quote);
+
+    // Emit the open bar, if any.
+    void finish();
+
+    const AggregationStats& stats() const { return stats_; }
+    AggregationStats& stats() { return stats_; }
+
+private:
+    int64_t clamp_time(int64_t ts);
+    void roll_time_bar(int64_t ts);
+    double classify(const TradeTick& trade);
+    void emit();
+
+    Config config_;
+    BarCallback on_bar_;
+    AggregationStats stats_;
+    int64_t last_ts_ = INT64_MIN;
+
+    // Prevailing quote and last trade (for OFI and trade signing)
+    bool have_quote_ = false;
+    QuoteTick quote_;
+    double last_trade_price_ = 0.0;
+    double last_sign_ = 0.0;
+
+    // Open bar
+    bool open_ = false;
+    binary_data::BinaryBar bar_{};
+    double notional_ = 0.0;
+    double ofi_ = 0.0;              // includes OFI carried from trade-less buckets
+    double buy_volume_ = 0.0;
+    double sell_volume_ = 0.0;
+    uint64_t trade_count_ = 0;
+    uint64_t quote_count_ = 0;
+};
+
+// Block-buffered reader for trade or quote CSV files.
+class TickCsvReader {
+public:
+    TickCsvReader() = default;
+    ~TickCsvReader();
+
+    TickCsvReader(const TickCsvReader&) = delete;
+    TickCsvReader& operator=(const TickCsvReader&) = delete;
+
+    bool open(const std::string& path, size_t buffer_bytes = 4 << 20);
+    void close();
+
+    // Next record; false at end of file. Lines that do not parse (headers,
+    // blanks, garbage) are skipped and counted.
+    bool next(TradeTick& trade);
+    bool next(QuoteTick& quote);
+
+    uint64_t malformed() const { return malformed_; }
+    uint64_t bytes_read() const { return bytes_read_; }
+
+private:
+    // Next non-empty line as [begin, end); false at end of file.
+    bool next_line(const char*& begin, const char*& end);
+
+    std::FILE* file_ = nullptr;
+    std::vector<char> buffer_;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+    bool eof_ = false;
+    uint64_t malformed_ = 0;
+    uint64_t bytes_read_ = 0;
+};
+
+// Writes <path> (OHLCV, binary_data format) and its .micro.bin companion.
+class TickBarFileWriter {
+public:
+    bool open(const std::string& binary_path, const std::string& symbol);
+    void write(const binary_data::BinaryBar& bar, const binary_data::BinaryMicroBar& micro);
+    // Flush and patch the bar counts into both headers.
+    bool close();
+
+    uint64_t written() const { return written_; }
+
+private:
+    std::string bar_path_;
+    std::string micro_path_;
+    std::string symbol_;
+    BufferedFileWriter bars_;
+    BufferedFileWriter micro_;
+    uint64_t written_ = 0;
+};
+
+// Merge a trade file and an optional quote file (empty path: trades only)
+// through `aggregator` in timestamp order.
+bool aggregate_files(const std::string& trades_path,
+                     const std::string& quotes_path,
+                     TickAggregator& aggregator);
+
+} // namespace ticks
+} // namespace sentio
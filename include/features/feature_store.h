@@ -0,0 +1,106 @@
+#pragma once
+
+// =============================================================================
+// Module: features/feature_store.h
+// Purpose: Persistent, memory-mapped UnifiedFeatureEngine output for a whole
+//          dataset, computed once and shared by trainers and strategies.
+//
+// Core idea:
+// - A store holds one float32 row per bar of the dataset (row i = the engine
+//   output after bar i, the same values update(bar, out) produces in a
+//   sequential run from bar 0), row-major after a 64-byte header.
+// - Stores are keyed by (dataset content hash, Config::fingerprint(),
+//   UnifiedFeatureEngine::VERSION): path_for() names the file after that
+//   key, so a changed dataset, configuration or engine gets a new file and
+//   an unchanged one is reused across runs and processes.
+// - open() maps the file read-only; row(bar_index) is a pointer into the
+//   mapping, so consumers read features without computing or copying them
+//   and concurrent processes share the page cache.
+// - Files are written to a temporary name and renamed, so a reader never
+//   sees a partial store.
+// =============================================================================
+
+#include "features/unified_feature_engine.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace sentio {
+namespace features {
+
+class FeatureStore {
+public:
+    static constexpr uint32_t MAGIC = 0x53465453;   // "STFS"
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr const char* DEFAULT_DIRECTORY = "data/cache/features";
+
+    struct Header {
+        uint32_t magic = MAGIC;
+        uint32_t format_version = FORMAT_VERSION;
+        uint32_t engine_version = UnifiedFeatureEngine::VERSION;
+        uint32_t cols = 0;
+        uint64_t rows = 0;
+        uint64_t warmup_bars = 0;
+        uint64_t config_hash = 0;       // fnv1a64 of Config::fingerprint()
+        uint64_t dataset_hash = 0;      // hash_file_contents() of the dataset
+        int64_t first_timestamp_ms = 0;
+        int64_t last_timestamp_ms = 0;
+    };
+    static_assert(sizeof(Header) == 64, "feature store header must stay 64 bytes");
+
+    FeatureStore() = default;
+    ~FeatureStore();
+
+    FeatureStore(const FeatureStore&) = delete;
+    FeatureStore& operator=(const FeatureStore&) = delete;
+
+    // Store file for `dataset` under `config` in `directory`; empty if the
+    // dataset cannot be read.
+    static std::string path_for(const std::string& dataset,
+                                const UnifiedFeatureEngine::Config& config,
+                                const std::string& directory = DEFAULT_DIRECTORY);
+
+    // Run the engine over the whole dataset and write the store to `path`.
+    static bool build(const std::string& dataset,
+                      const UnifiedFeatureEngine::Config& config,
+                      const std::string& path);
+
+    // Map an existing store. Fails on a bad header, another format or engine
+    // version, or a truncated file.
+    bool open(const std::string& path);
+    // Map the store for (dataset, config) in `directory`, building it first if
+    // it does not exist yet.
+    bool open_or_build(const std::string& dataset,
+                       const UnifiedFeatureEngine::Config& config,
+                       const std::string& directory = DEFAULT_DIRECTORY);
+    void close();
+
+    bool is_open() const { return data_ != nullptr; }
+    // True if the store was computed with this configuration.
+    bool matches(const UnifiedFeatureEngine::Config& config) const;
+    // True if it was also computed from `dataset` as it is now (content hash),
+    // so row(i) holds the features of the dataset's bar i.
+    bool matches(const UnifiedFeatureEngine::Config& config, const std::string& dataset) const;
+
+    const Header& header() const { return header_; }
+    const std::string& path() const { return path_; }
+    size_t rows() const { return static_cast<size_t>(header_.rows); }
+    int cols() const { return static_cast<int>(header_.cols); }
+
+    // Features of bar `bar_index` (cols() floats); the caller checks bounds.
+    const float* row(size_t bar_index) const { return data_ + bar_index * header_.cols; }
+    // True once the engine had seen warmup_bars bars (engine is_ready()).
+    bool is_ready(size_t bar_index) const {
+        return bar_index < header_.rows && bar_index + 1 >= header_.warmup_bars;
+    }
+
+private:
+    Header header_;
+    std::string path_;
+    void* mapping_ = nullptr;
+    size_t mapping_bytes_ = 0;
+    const float* data_ = nullptr;
+};
+
+} // namespace features
+} // namespace sentio
@@ -0,0 +1,264 @@
+#pragma once
+
+// =============================================================================
+// Module: features/unified_feature_engine.h
+// Purpose: Per-bar feature vector shared by the ML strategies and trainers
+//          (TransformerStrategy, CppPpoStrategy, TradingEnvironment, TFM).
+//
+// Core idea:
+// - Fully incremental: every indicator is a streaming kernel from
+//   common/rolling_indicators.h (running sums, EMAs, monotonic min/max), so
+//   update() costs O(1) amortized per bar regardless of window lengths.
+// - Features are written as float in a fixed order (categories in Category
+//   order, then the order listed in feature_names()) into a caller-provided
+//   contiguous buffer: update(bar, out) fills `out` directly, e.g. a row of a
+//   pre-allocated [n_bars, feature_count()] matrix or tensor. update(bar)
+//   writes into an internal buffer exposed by features().
+// - Disabled categories cost nothing and are omitted from the vector.
+// - Categories and sizes (126 in total; the standard ML set in
+//   feature_config_standard.h enables the first seven = 91):
+//     Time(5) PriceAction(20) MovingAverages(15) Momentum(15) Volatility(10)
+//     Volume(20) Patterns(6) Statistical(10) PriceLags(15) ReturnLags(10)
+// - All features are scale-free (ratios, returns, z-scores, 0..1 oscillators,
+//   0/1 patterns). With normalize_features non-finite values become 0 and
+//   values are clipped to [-clip_value, clip_value].
+// - is_ready() after warmup_bars bars (64), which covers the longest window.
+// - Optional per-category timing (set_timing_enabled) for profiling.
+// - save_state()/load_state() snapshot every kernel bit-exactly.
+// =============================================================================
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "common/rolling_indicators.h"
+#include "common/types.h"
+
+namespace sentio {
+
+class StateWriter;
+class StateReader;
+
+namespace features {
+
+class UnifiedFeatureEngine {
+public:
+    enum class Category {
+        Time = 0,
+        PriceAction,
+        MovingAverages,
+        Momentum,
+        Volatility,
+        Volume,
+        Patterns,
+        Statistical,
+        PriceLags,
+        ReturnLags,
+        Count
+    };
+    static constexpr size_t CATEGORY_COUNT = static_cast<size_t>(Category::Count);
+
+    // Bump whenever a feature definition or the output order changes; stored
+    // feature matrices (features/feature_store.h) built by another version
+    // are rebuilt.
+    static constexpr uint32_t VERSION = 1;
+
+    struct Config {
+        bool enable_time_features = true;
+        bool enable_price_action = true;
+        bool enable_moving_averages = true;
+        bool enable_momentum = true;
+        bool enable_volatility = true;
+        bool enable_volume = true;
+        bool enable_pattern_detection = true;
+        bool enable_statistical = true;
+        bool enable_price_lags = true;
+        bool enable_return_lags = true;
+
+        bool normalize_features = true;    // zero non-finite values and clip
+        double clip_value = 10.0;
+        size_t warmup_bars = 64;
+
+        bool enabled(Category category) const;
+        int total_features() const;
+        // Canonical text of every field (feature store and cache keys)
+        std::string fingerprint() const;
+    };
+
+    struct CategoryTiming {
+        uint64_t calls = 0;
+        int64_t total_ns = 0;
+    };
+
+    static int category_size(Category category);
+    static const char* category_name(Category category);
+
+    UnifiedFeatureEngine();
+    explicit UnifiedFeatureEngine(const Config& config);
+
+    // Consume one bar and write feature_count() floats to `out`.
+    void update(const Bar& bar, float* out);
+    // Consume one bar; the features are available through features().
+    void update(const Bar& bar);
+
+    bool is_ready() const { return bar_count_ >= config_.warmup_bars; }
+    size_t get_bar_count() const { return bar_count_; }
+    int feature_count() const { return feature_count_; }
+    const Config& config() const { return config_; }
+
+    // Features of the last update(bar) (feature_count() floats).
+    const float* features() const { return current_.data(); }
+    // Copy of features() as double (for callers that need a vector).
+    std::vector<double> get_features() const;
+
+    // Names of the enabled features, in output order.
+    std::vector<std::string> feature_names() const;
+
+    void reset();
+
+    // Per-category timing (off by default; adds two clock reads per category).
+    void set_timing_enabled(bool enabled) { timing_enabled_ = enabled; }
+    const CategoryTiming& timing(Category category) const { return timing_[static_cast<size_t>(category)]; }
+    void reset_timing() { timing_ = {}; }
+    // One line per enabled category: calls, ns/bar and share of the total.
+    std::string timing_report() const;
+
+    // Snapshot of all indicator state (configuration is not stored and must
+    // match on load). load_state() leaves the engine unchanged on failure.
+    void save_state(StateWriter& w) const;
+    bool load_state(StateReader& r);
+
+private:
+    // Values derived from the bar and the previous bar, shared by categories
+    struct BarContext {
+        double open, high, low, close, volume;
+        int64_t timestamp_ms;
+        double prev_close;
+        double ret;            // simple return vs previous close
+        double log_ret;
+        double true_range;
+        double typical;        // (h + l + c) / 3
+        double log_volume;     // log(1 + volume)
+    };
+
+    // Values kept from the previous bar
+    struct PrevBar {
+        double open = 0.0, high = 0.0, low = 0.0, close = 0.0, volume = 0.0;
+        double typical = 0.0, log_volume = 0.0;
+    };
+
+    using Writer = float* (UnifiedFeatureEngine::*)(const BarContext&, float*);
+    static const Writer WRITERS[CATEGORY_COUNT];
+
+    // Each writer updates its category's kernels and writes its features
+    float* write_time(const BarContext& c, float* out);
+    float* write_price_action(const BarContext& c, float* out);
+    float* write_moving_averages(const BarContext& c, float* out);
+    float* write_momentum(const BarContext& c, float* out);
+    float* write_volatility(const BarContext& c, float* out);
+    float* write_volume(const BarContext& c, float* out);
+    float* write_patterns(const BarContext& c, float* out);
+    float* write_statistical(const BarContext& c, float* out);
+    float* write_price_lags(const BarContext& c, float* out);
+    float* write_return_lags(const BarContext& c, float* out);
+
+    // Close k bars ago (oldest available if the history is shorter)
+    double close_ago(size_t k) const;
+
+    // Apply `f` to every kernel in a fixed order (shared by save and load)
+    template <typename Engine, typename F>
+    static bool for_each_kernel(Engine& engine, F&& f);
+
+    Config config_;
+    int feature_count_ = 0;
+    std::vector<float> current_;
+    size_t bar_count_ = 0;
+
+    bool timing_enabled_ = false;
+    std::array<CategoryTiming, CATEGORY_COUNT> timing_{};
+
+    // Shared history (always updated)
+    PrevBar prev_;
+    bool has_prev_ = false;
+    rolling::RingWindow<double, 64> closes_;     // back(k) = close k bars ago
+    rolling::RingWindow<double, 16> returns_;    // back(k) = return k bars ago
+
+    // Time (day-of-week terms change once per day)
+    int64_t time_day_ = -1;
+    float day_of_week_[2] = {0.0f, 0.0f};
+
+    // Price action
+    rolling::RollingMax<double, 10> high_10_;
+    rolling::RollingMin<double, 10> low_10_;
+    rolling::RollingMax<double, 20> high_20_;
+    rolling::RollingMin<double, 20> low_20_;
+    rolling::RollingMax<double, 50> high_50_;
+    rolling::RollingMin<double, 50> low_50_;
+
+    // Moving averages
+    rolling::MeanBank<double, 5, 10, 20, 50> close_sma_;
+    rolling::EmaBank<double, 5, 10, 12, 20, 26, 50> close_ema_;
+    rolling::RollingSlope<double, 10> slope_10_;
+    rolling::RollingSlope<double, 20> slope_20_;
+
+    // Momentum
+    rolling::RollingRsi<double, 7> rsi_7_;
+    rolling::RollingRsi<double, 14> rsi_14_;
+    rolling::RollingRsi<double, 21> rsi_21_;
+    rolling::EmaBank<double, 12, 26> macd_ema_;
+    rolling::Ema<double, 9> macd_signal_;
+    rolling::RollingMax<double, 14> high_14_;
+    rolling::RollingMin<double, 14> low_14_;
+    rolling::RollingMean<double, 3> stoch_d_;
+    rolling::RollingMax<double, 28> high_28_;
+    rolling::RollingMin<double, 28> low_28_;
+    rolling::RollingMoments<double, 20> typical_20_;
+    rolling::RollingMean<double, 10> up_bars_10_;
+    rolling::Ema<double, 10> ret_ema_10_;
+    rolling::Ema<double, 10> abs_ret_ema_10_;
+
+    // Volatility
+    rolling::RollingMoments<double, 5> vol_ret_5_;
+    rolling::RollingMoments<double, 10> vol_ret_10_;
+    rolling::RollingMoments<double, 20> vol_ret_20_;
+    rolling::RollingMoments<double, 50> vol_ret_50_;
+    rolling::RollingMean<double, 14> true_range_14_;
+    rolling::RollingMean<double, 20> parkinson_20_;
+    rolling::RollingMean<double, 20> garman_klass_20_;
+    rolling::RollingMoments<double, 20> bollinger_20_;
+
+    // Volume
+    rolling::MeanBank<double, 5, 10, 20, 50> volume_sma_;
+    rolling::RollingMoments<double, 20> log_volume_20_;
+    rolling::RollingMoments<double, 20> volume_20_;
+    double obv_ = 0.0;
+    rolling::RollingSlope<double, 10> obv_slope_10_;
+    rolling::RollingSlope<double, 20> obv_slope_20_;
+    rolling::RollingMean<double, 10> pv_10_;            // typical * volume
+    rolling::RollingMean<double, 20> pv_20_;
+    rolling::RollingMean<double, 50> pv_50_;
+    rolling::RollingMean<double, 10> up_volume_10_;     // volume on up bars
+    rolling::RollingMean<double, 20> up_volume_20_;
+    rolling::Ema<double, 5> volume_ema_5_;
+    rolling::Ema<double, 20> volume_ema_20_;
+    rolling::RollingMean<double, 14> positive_flow_14_;
+    rolling::RollingMean<double, 14> negative_flow_14_;
+    rolling::RollingMoments<double, 20> flow_ret_20_;
+    rolling::RollingMean<double, 20> ret_volume_20_;    // ret * volume
+    rolling::RollingMean<double, 10> ad_10_;
+
+    // Statistical
+    rolling::RollingMoments<double, 20> stat_ret_20_;
+    rolling::RollingMoments<double, 50> stat_ret_50_;
+    rolling::RollingMean<double, 20> ret3_20_;
+    rolling::RollingMean<double, 20> ret4_20_;
+    rolling::RollingMean<double, 50> ret3_50_;
+    rolling::RollingMean<double, 50> ret4_50_;
+    rolling::RollingMean<double, 20> ret_lag_prod_20_;  // r_t * r_{t-1}
+    rolling::RollingMoments<double, 20> stat_close_20_;
+    rolling::RollingMoments<double, 50> stat_close_50_;
+    rolling::RollingMean<double, 20> hl_range_20_;
+};
+
+} // namespace features
+} // namespace sentio
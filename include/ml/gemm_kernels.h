@@ -0,0 +1,77 @@
+#pragma once
+
+// =============================================================================
+// Module: ml/gemm_kernels.h
+// Purpose: Dense float32 kernels for LibTorch-free model inference
+//          (ml/native_gru.h).
+//
+// Core idea:
+// - Weights use the torch Linear layout: W[out, in], row-major. Both kernels
+//   reduce to dot products of weight rows with input rows, computed four
+//   weight rows at a time so every input load feeds four FMAs.
+// - gemm_nt() walks W in blocks that fit in L1/L2 and streams every input row
+//   past the block, so each weight is read from memory once per call instead
+//   of once per input row.
+// - AVX2+FMA or NEON when the compiler targets them (Release builds use
+//   -march=native), portable scalar loops otherwise. Results match the
+//   scalar path up to float summation order.
+// - WeightMatrix stores W at reduced precision for the opt-in quantized mode:
+//   Int8 keeps one symmetric scale per row (max|w| / 127), Bf16 keeps the
+//   upper 16 bits of each float (rounded to nearest even). The kernels widen
+//   weights to float in registers and accumulate in float32; activations are
+//   never quantized.
+// =============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sentio {
+namespace ml {
+namespace kernels {
+
+// Name of the SIMD path compiled in ("avx2", "neon" or "scalar").
+const char* simd_path();
+
+// dot(a, b) over n floats.
+float dot(const float* a, const float* b, int n);
+
+// y[rows] = W[rows, cols] * x[cols] (+ bias[rows] when not null).
+void gemv(const float* W, const float* x, const float* bias, float* y, int rows, int cols);
+
+// Y[m, n] = X[m, k] * W[n, k]^T (+ bias[n] when not null); Y rows are n wide.
+void gemm_nt(const float* X, const float* W, const float* bias, float* Y, int m, int n, int k);
+
+enum class WeightPrecision { Fp32, Bf16, Int8 };
+
+const char* to_string(WeightPrecision precision);
+// Accepts "fp32", "bf16" or "int8".
+bool parse_weight_precision(const std::string& name, WeightPrecision& precision);
+
+// A [rows, cols] row-major weight matrix at the chosen precision.
+struct WeightMatrix {
+    WeightPrecision precision = WeightPrecision::Fp32;
+    int rows = 0;
+    int cols = 0;
+    const float* fp32 = nullptr;    // Fp32: borrowed, must outlive the matrix
+    std::vector<uint16_t> bf16;     // Bf16
+    std::vector<int8_t> int8;       // Int8: round(w / scales[row])
+    std::vector<float> scales;      // Int8
+
+    static WeightMatrix quantize(const float* W, int rows, int cols, WeightPrecision precision);
+    bool empty() const { return rows == 0; }
+    // Bytes the kernels stream per full pass over the matrix.
+    size_t bytes() const;
+};
+
+// gemv() / gemm_nt() over a WeightMatrix (rows = n, cols = k).
+void gemv(const WeightMatrix& W, const float* x, const float* bias, float* y);
+void gemm_nt(const float* X, const WeightMatrix& W, const float* bias, float* Y, int m);
+
+// In-place LayerNorm over n values: (x - mean) / sqrt(var + eps) * gamma + beta.
+void layer_norm(float* x, const float* gamma, const float* beta, int n, float eps = 1e-5f);
+
+} // namespace kernels
+} // namespace ml
+} // namespace sentio
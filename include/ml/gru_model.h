@@ -55,6 +55,20 @@ struct GRUOutput {
     torch::Tensor regime;       ///< Market regime probabilities [4 classes]
 };
 
+/**
+ * @brief Recurrent state for streaming (one bar at a time) inference
+ *
+ * Holds the final hidden state of every GRU layer after the last processed
+ * step. Filled by forward_window() and advanced by forward_step().
+ */
+struct GRUStreamState {
+    std::vector<torch::Tensor> hidden;  ///< Per layer [1, batch_size, hidden_dim]
+    int steps_since_sync = 0;           ///< forward_step() calls since the last forward_window()
+    
+    bool valid() const { return !hidden.empty(); }
+    void reset() { hidden.clear(); steps_since_sync = 0; }
+};
+
 /**
  * @brief Advanced GRU Model Implementation
  * 
@@ -80,6 +94,27 @@ public:
      */
     GRUOutput forward(const torch::Tensor& input);
     
+    /**
+     * @brief Full-window pass that also (re)initializes a streaming state
+     * @param input Input tensor [batch_size, sequence_length, feature_dim]
+     * @param state Receives each layer's hidden state after the last timestep
+     * @return GRUOutput Same predictions as forward(input)
+     */
+    GRUOutput forward_window(const torch::Tensor& input, GRUStreamState& state);
+    
+    /**
+     * @brief Advance a streaming state by one timestep
+     * 
+     * Runs only the newest feature vector through the GRU stack, starting from
+     * the hidden states in `state`. Unlike forward(), the state carries history
+     * from before the window, so callers re-sync with forward_window()
+     * periodically to stay close to windowed inference.
+     * 
+     * @param features Newest features [batch_size, feature_dim] or [batch_size, 1, feature_dim]
+     * @param state Valid state from forward_window()/forward_step(); updated in place
+     */
+    GRUOutput forward_step(const torch::Tensor& features, GRUStreamState& state);
+    
     /**
      * @brief Get model configuration
      */
@@ -99,6 +134,11 @@ public:
      * @brief Load model state
      */
     void load_model(const std::string& path);
+    
+    /**
+     * @brief Write the weights in the LibTorch-free format read by ml::NativeGruModel
+     */
+    bool export_native(const std::string& path);
 
 private:
     GRUConfig config_;
@@ -132,6 +172,20 @@ private:
      * @brief Create prediction head
      */
     torch::nn::Sequential create_prediction_head(int output_dim, bool use_sigmoid = false, bool use_softmax = false, bool use_relu = false);
+    
+    /**
+     * @brief Encoder, GRU stack and attention; returns the last timestep [batch_size, hidden_dim]
+     * @param h0 Initial hidden state per layer (nullptr = zeros)
+     * @param h_n Receives the final hidden state per layer (optional)
+     */
+    torch::Tensor encode(const torch::Tensor& input,
+                         const std::vector<torch::Tensor>* h0,
+                         std::vector<torch::Tensor>* h_n);
+    
+    /**
+     * @brief Apply the prediction heads to the last timestep
+     */
+    GRUOutput predict(const torch::Tensor& last_timestep);
 };
 
 // Convenience typedef
@@ -0,0 +1,176 @@
+#pragma once
+
+// =============================================================================
+// Module: ml/model_server.h
+// Purpose: One local process that holds each model once and serves inference
+//          to many strategy instances over a Unix-domain socket.
+//
+// Core idea:
+// - Clients (ml::RemoteModel) open a model by kind and path, the same path
+//   the strategy would otherwise load itself. The first open loads it; later
+//   opens from any client share the instance. Kinds: "native" (or
+//   "native-bf16"/"native-int8"; ml::NativeGruModel weights), and in LibTorch
+//   builds "torchscript" (the GRU model.pt) and "transformer"
+//   (TransformerStrategy's checkpoint).
+// - Every request carries a client-chosen id and one or more windows of
+//   [seq_len, feature_dim] floats; the reply echoes the id with output_dim
+//   floats per window.
+// - Each model has one batcher thread. It waits up to batch_window_us after
+//   the oldest queued request (or until max_batch_rows are queued), runs one
+//   forward over all of them and scatters the rows back to their clients.
+// - The socket's file permissions are the access control: any client that
+//   can connect may load models the server user can read.
+// =============================================================================
+
+#include "strategy/execution_context.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sentio {
+namespace ml {
+
+// -----------------------------------------------------------------------------
+// Wire format (host byte order; both ends run on the same machine)
+// -----------------------------------------------------------------------------
+namespace serving {
+
+constexpr uint32_t MAGIC = 0x53524D53;            // "SMRS"
+constexpr uint32_t MAX_PAYLOAD_BYTES = 256u << 20;
+
+enum class FrameType : uint32_t {
+    Open = 1,        // OpenRequest + "kind\0path"      -> OpenReply
+    OpenReply = 2,   // ModelInfo
+    Infer = 3,       // InferRequest + rows * window floats -> InferReply
+    InferReply = 4,  // rows * output_dim floats
+    Error = 5        // message text, request_id of the failed request
+};
+
+struct FrameHeader {
+    uint32_t magic = MAGIC;
+    uint32_t type = 0;
+    uint64_t request_id = 0;
+    uint32_t payload_bytes = 0;
+    uint32_t reserved = 0;
+};
+static_assert(sizeof(FrameHeader) == 24, "model server frame header must stay 24 bytes");
+
+struct OpenRequest {
+    uint32_t sequence_length = 0;
+    uint32_t feature_dim = 0;
+};
+
+struct ModelInfo {
+    uint32_t model_id = 0;
+    uint32_t sequence_length = 0;
+    uint32_t feature_dim = 0;
+    uint32_t output_dim = 0;
+};
+
+struct InferRequest {
+    uint32_t model_id = 0;
+    uint32_t rows = 0;
+};
+
+// Blocking frame I/O on a stream socket. send_frame() writes the header and
+// up to two payload parts without copying them together.
+bool send_frame(int fd, FrameType type, uint64_t request_id,
+                const void* part1, size_t bytes1,
+                const void* part2 = nullptr, size_t bytes2 = 0);
+bool recv_exact(int fd, void* dst, size_t bytes);
+bool recv_header(int fd, FrameHeader& header);
+
+} // namespace serving
+
+// A loaded model as the server sees it: rows of [sequence_length, feature_dim]
+// in, rows of output_dim out. Only the model's batcher thread calls forward().
+class ModelBackend {
+public:
+    virtual ~ModelBackend() = default;
+
+    virtual uint32_t sequence_length() const = 0;
+    virtual uint32_t feature_dim() const = 0;
+    virtual uint32_t output_dim() const = 0;
+    virtual bool forward(const float* windows, int rows, float* out) = 0;
+
+    // kind: "native[-bf16|-int8]", "torchscript", "transformer". The shape is the one the
+    // opening client uses; backends that know their own shape check it.
+    static std::unique_ptr<ModelBackend> load(const std::string& kind, const std::string& path,
+                                              uint32_t sequence_length, uint32_t feature_dim,
+                                              std::string& error);
+};
+
+class ModelServer {
+public:
+    struct Options {
+        std::string socket_path = "/tmp/sentio_models.sock";
+        int64_t batch_window_us = 200;   // wait after the oldest queued request
+        int max_batch_rows = 256;        // flush early once this many rows are queued
+        ExecutionContext execution;      // applied on every batcher thread
+    };
+
+    struct Stats {
+        uint64_t connections = 0;
+        uint64_t requests = 0;
+        uint64_t rows = 0;
+        uint64_t batches = 0;
+        size_t models = 0;
+    };
+
+    explicit ModelServer(Options options);
+    ~ModelServer();
+
+    ModelServer(const ModelServer&) = delete;
+    ModelServer& operator=(const ModelServer&) = delete;
+
+    // Bind the socket (replacing a stale socket file) and start accepting.
+    bool start();
+    // Close the socket, disconnect clients, answer queued requests, join.
+    void stop();
+
+    Stats stats() const;
+
+private:
+    struct Connection;
+    struct ServedModel;
+    struct PendingRequest {
+        std::shared_ptr<Connection> connection;
+        uint64_t request_id = 0;
+        uint32_t rows = 0;
+        std::vector<float> windows;
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+    void accept_loop();
+    void serve_connection(std::shared_ptr<Connection> connection);
+    void batch_loop(ServedModel& model);
+    bool handle_open(Connection& connection, const serving::FrameHeader& header);
+    bool handle_infer(const std::shared_ptr<Connection>& connection, const serving::FrameHeader& header);
+
+    Options options_;
+    int listen_fd_ = -1;
+    std::atomic<bool> stopping_{false};
+    std::thread accept_thread_;
+
+    std::mutex connections_mutex_;
+    std::vector<std::shared_ptr<Connection>> connections_;
+
+    // Models by "kind:path"; ids index models_by_id_
+    mutable std::mutex models_mutex_;
+    std::map<std::string, std::unique_ptr<ServedModel>> models_;
+    std::vector<ServedModel*> models_by_id_;
+
+    std::atomic<uint64_t> connection_count_{0};
+    std::atomic<uint64_t> request_count_{0};
+    std::atomic<uint64_t> row_count_{0};
+    std::atomic<uint64_t> batch_count_{0};
+};
+
+} // namespace ml
+} // namespace sentio
@@ -0,0 +1,177 @@
+#pragma once
+
+// =============================================================================
+// Module: ml/native_gru.h
+// Purpose: LibTorch-free inference for the AdvancedGRUModelImpl architecture
+//          (ml/gru_model.h): linear encoder, stacked GRU with layer norms and
+//          residuals, attention, multi-task heads.
+//
+// Core idea:
+// - Weights come from a flat binary file written by
+//   AdvancedGRUModelImpl::export_native(): a 64-byte header with the
+//   architecture, a table of named float32 tensors (torch parameter names and
+//   shapes), then the tensor data, each 64-byte aligned.
+// - A window pass runs the encoder and every layer's input projection as one
+//   cache-blocked GEMM over all timesteps; only the recurrent h -> gates GEMV
+//   is sequential. Attention and heads run on the last timestep only.
+// - Attention: the torch model feeds batch-first tensors into a
+//   sequence-first MultiheadAttention, so each timestep attends to itself
+//   alone at batch size 1 (softmax over one key = 1). The output is
+//   out_proj(v_proj(x)), which is what this engine computes. Batch size is
+//   always 1.
+// - forward_window()/forward_step() mirror the LibTorch streaming API: carry
+//   per-layer hidden states and advance one feature row per bar.
+// - Scratch buffers are sized at load(); forward calls do not allocate. One
+//   model instance per thread.
+// - load() maps the file read-only: fp32 weights are used in place (the
+//   64-byte aligned offsets stay aligned in a page-aligned mapping), so
+//   startup copies nothing and processes loading the same model share its
+//   pages. The first forward faults the weights in; strategies run it as a
+//   background warm-up (strategy/startup_profile.h).
+// - load() can convert every Linear and GRU weight matrix to bf16 or per-row
+//   int8 (kernels::WeightMatrix). Biases, norms and activations stay float32;
+//   tools/gru_quantization_calibration measures the signal drift.
+// =============================================================================
+
+#include "ml/gemm_kernels.h"
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sentio {
+namespace ml {
+
+struct NativeGruConfig {
+    uint32_t feature_dim = 0;
+    uint32_t hidden_dim = 0;
+    uint32_t num_layers = 0;
+    uint32_t num_heads = 0;
+    uint32_t sequence_length = 0;
+    uint32_t multi_task = 1;        // 0: direction head only
+};
+
+// Head outputs for one window (after the heads' activations).
+struct NativeGruOutput {
+    float direction = 0.0f;         // raw logit
+    float magnitude = 0.0f;
+    float confidence = 0.5f;
+    float volatility = 0.1f;
+    float regime[4] = {0.25f, 0.25f, 0.25f, 0.25f};
+};
+
+// Per-layer hidden states for streaming inference.
+struct NativeGruState {
+    std::vector<float> hidden;      // num_layers * hidden_dim
+    int steps_since_sync = 0;       // forward_step() calls since the last forward_window()
+
+    bool valid() const { return !hidden.empty(); }
+    void reset() { hidden.clear(); steps_since_sync = 0; }
+};
+
+class NativeGruModel {
+public:
+    static constexpr uint32_t MAGIC = 0x57474E53;   // "SNGW"
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    // One named tensor for write_weights() (torch parameter name and shape).
+    struct TensorView {
+        std::string name;
+        std::vector<uint32_t> shape;
+        const float* data = nullptr;
+    };
+
+    // Write a weight file; tensors are stored in the given order.
+    static bool write_weights(const std::string& path,
+                              const NativeGruConfig& config,
+                              const std::vector<TensorView>& tensors);
+    // Random weights with the AdvancedGRUModelImpl names and shapes, for
+    // benchmarks that need no trained model (latency does not depend on values).
+    static bool write_synthetic_weights(const std::string& path, const NativeGruConfig& config,
+                                        uint32_t seed = 7);
+
+    // Load and validate a weight file (architecture, names and shapes),
+    // storing the weight matrices at `precision`.
+    bool load(const std::string& path,
+              kernels::WeightPrecision precision = kernels::WeightPrecision::Fp32);
+    bool is_loaded() const { return loaded_; }
+    const NativeGruConfig& config() const { return config_; }
+    kernels::WeightPrecision precision() const { return precision_; }
+    // Bytes of weight matrices read by one timestep (excludes biases and norms).
+    size_t weight_bytes() const;
+
+    // window: `steps` rows of feature_dim floats, oldest first.
+    bool forward(const float* window, int steps, NativeGruOutput& out);
+    // Same as forward(), and stores each layer's final hidden state in `state`.
+    bool forward_window(const float* window, int steps, NativeGruState& state, NativeGruOutput& out);
+    // Advance `state` (from forward_window()) by one feature row.
+    bool forward_step(const float* features, NativeGruState& state, NativeGruOutput& out);
+
+private:
+    struct Linear {
+        kernels::WeightMatrix weight;   // [out, in]
+        const float* bias = nullptr;    // [out]
+        int out = 0;
+        int in = 0;
+    };
+    struct Norm {
+        const float* gamma = nullptr;
+        const float* beta = nullptr;
+    };
+    struct GruLayer {
+        Linear input;                   // weight_ih / bias_ih, [3H, H]
+        Linear hidden;                  // weight_hh / bias_hh, [3H, H]
+        Norm norm;
+    };
+    enum class Activation { None, Relu, Sigmoid, Softmax };
+    struct Head {
+        Linear hidden;                  // [H/2, H]
+        Linear output;                  // [out, H/2]
+        Activation activation = Activation::None;
+        bool present = false;
+    };
+
+    const float* find(const std::string& name, std::initializer_list<uint32_t> shape) const;
+    bool bind_linear(Linear& linear, const std::string& prefix, uint32_t out, uint32_t in) const;
+    bool set_linear(Linear& linear, const float* weight, const float* bias, uint32_t out, uint32_t in) const;
+    bool bind_norm(Norm& norm, const std::string& prefix, uint32_t n) const;
+    bool bind_head(Head& head, const std::string& prefix, uint32_t out, Activation activation) const;
+
+    // h0: initial hidden per layer (null = zeros); h_n: receives final hidden.
+    void run(const float* input, int steps, const float* h0, float* h_n, NativeGruOutput& out);
+    void run_head(const Head& head, const float* x, float* out);
+
+    bool loaded_ = false;
+    NativeGruConfig config_;
+    kernels::WeightPrecision precision_ = kernels::WeightPrecision::Fp32;
+    // The whole file, mapped read-only; tensors (and fp32 weight matrices)
+    // point into it. Shared so copies of a model keep the mapping alive.
+    std::shared_ptr<const char> mapping_;
+    struct Entry {
+        std::string name;
+        std::vector<uint32_t> shape;
+        const float* data = nullptr;
+    };
+    std::vector<Entry> entries_;
+
+    Linear encoder_;
+    Norm encoder_norm_;
+    std::vector<GruLayer> layers_;
+    Linear value_;                      // rows [2H, 3H) of attention in_proj
+    Linear attention_out_;
+    Norm attention_norm_;
+    Head direction_, magnitude_, confidence_, volatility_, regime_;
+
+    // Scratch, sized for sequence_length timesteps at load()
+    std::vector<float> x_;              // [steps, H] layer input / output
+    std::vector<float> gates_in_;       // [steps, 3H] input projections
+    std::vector<float> gates_h_;        // [3H] recurrent projection
+    std::vector<float> h_;              // [H]
+    std::vector<float> head_hidden_;    // [H/2]
+    std::vector<float> last_;           // [H] attention / heads input
+    std::vector<float> tmp_;            // [H]
+};
+
+} // namespace ml
+} // namespace sentio
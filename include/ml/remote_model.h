@@ -0,0 +1,55 @@
+#pragma once
+
+// =============================================================================
+// Module: ml/remote_model.h
+// Purpose: Client side of ml::ModelServer; evaluates model windows in the
+//          shared server process instead of a model loaded in this process.
+//
+// Core idea:
+// - connect() opens the model by the same kind and path the strategy would
+//   load locally and learns its output width; after that infer() sends
+//   `rows` windows and blocks for the reply carrying the request's id.
+// - One request is outstanding per client, so a reply with another id is a
+//   protocol error. Use one RemoteModel per strategy instance (per thread);
+//   the server batches requests from all clients together.
+// - Failures (server gone, model error) are logged and reported as false;
+//   callers keep their neutral signal, as for a failed local forward.
+// =============================================================================
+
+#include <cstdint>
+#include <string>
+
+namespace sentio {
+namespace ml {
+
+class RemoteModel {
+public:
+    RemoteModel() = default;
+    ~RemoteModel();
+
+    RemoteModel(const RemoteModel&) = delete;
+    RemoteModel& operator=(const RemoteModel&) = delete;
+
+    bool connect(const std::string& socket_path, const std::string& kind, const std::string& model_path,
+                 uint32_t sequence_length, uint32_t feature_dim);
+    void close();
+    bool connected() const { return fd_ >= 0; }
+
+    uint32_t output_dim() const { return output_dim_; }
+
+    // windows: rows * sequence_length * feature_dim floats;
+    // out: rows * output_dim() floats
+    bool infer(const float* windows, int rows, float* out);
+
+private:
+    int fd_ = -1;
+    uint32_t model_id_ = 0;
+    uint32_t sequence_length_ = 0;
+    uint32_t feature_dim_ = 0;
+    uint32_t output_dim_ = 0;
+    uint64_t next_request_id_ = 1;
+    std::string socket_path_;
+};
+
+} // namespace ml
+} // namespace sentio
@@ -0,0 +1,67 @@
+#pragma once
+
+// =============================================================================
+// Module: strategy/batched_inference.h
+// Purpose: Hold backtest signal records until the model inputs they depend on
+//          have been evaluated together in one large batch.
+//
+// Core idea:
+// - In a batched backtest run (stream_dataset_range() of an ML strategy),
+//   generate_signal() copies its model input into row next_row() of a batch
+//   tensor and returns a neutral placeholder instead of calling the model.
+//   The driver adds every emitted record here in bar order, marking the ones
+//   whose input was queued as deferred.
+// - When the batch is full (and at the end of the range) the strategy runs a
+//   single forward pass; flush() passes each deferred record together with its
+//   batch row to `fill`, in bar order, then writes all held records to the
+//   sink. The output is the same record stream the per-bar path produces.
+// =============================================================================
+
+#include "strategy/signal_output.h"
+#include "strategy/signal_sink.h"
+#include <cstddef>
+#include <vector>
+
+namespace sentio {
+
+class DeferredRecordBatch {
+public:
+    explicit DeferredRecordBatch(size_t capacity) : capacity_(capacity ? capacity : 1) {
+        rows_.reserve(capacity_);
+        records_.reserve(capacity_);
+    }
+
+    size_t capacity() const { return capacity_; }
+    // Batch row the next deferred record's input goes to (= rows used so far)
+    size_t next_row() const { return rows_.size(); }
+    bool full() const { return rows_.size() >= capacity_; }
+
+    // A finished record (e.g. warm-up) that only has to keep its place.
+    void add(const SignalRecord& record) { records_.push_back(record); }
+    // A record completed by the model output of batch row next_row().
+    void add_deferred(const SignalRecord& record) {
+        rows_.push_back(records_.size());
+        records_.push_back(record);
+    }
+
+    // fill(row, record) for every deferred record in bar order, then write all
+    // held records to `sink` and start an empty batch.
+    template <typename Fill>
+    void flush(SignalSink& sink, Fill&& fill) {
+        for (size_t row = 0; row < rows_.size(); ++row) {
+            fill(row, records_[rows_[row]]);
+        }
+        for (const auto& record : records_) {
+            sink.write(record);
+        }
+        rows_.clear();
+        records_.clear();
+    }
+
+private:
+    size_t capacity_;
+    std::vector<size_t> rows_;            // index into records_ per batch row
+    std::vector<SignalRecord> records_;   // in bar order
+};
+
+} // namespace sentio
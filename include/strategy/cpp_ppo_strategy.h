@@ -0,0 +1,167 @@
+#pragma once
+
+#include "strategy/strategy_component.h"
+#include "features/unified_feature_engine.h"
+#include "features/feature_store.h"
+#include "common/feature_sequence_manager.h"
+#include "common/types.h"
+#include <torch/torch.h>
+#include <torch/script.h>
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sentio {
+
+/**
+ * @brief Configuration for the C++ PPO inference strategy
+ */
+struct CppPpoConfig {
+    std::string model_path = "artifacts/PPO/cpp_trained/model.pt";
+    int window_size = 30;                 // Observation window (bars)
+    int feature_dim = 91;                 // Market features per bar
+    double confidence_threshold = 0.5;
+    bool enable_action_masking = true;    // Mask invalid actions for the position state
+    bool enable_state_features = false;   // Append [long, short, hold, pnl] per bar
+    double transaction_fee_pct = 0.0;     // Applied to unrealized P&L
+    bool enable_debug = false;
+    std::string feature_store_path;       // Precomputed features; skips the feature engine
+    std::string feature_store_dataset;    // Dataset the store must be built from
+};
+
+/**
+ * @brief Discrete PPO actions (model output order)
+ */
+enum class PpoAction {
+    SELL = 0,
+    HOLD = 1,
+    BUY = 2
+};
+
+inline PpoAction index_to_ppo_action(int index) {
+    switch (index) {
+        case 0: return PpoAction::SELL;
+        case 2: return PpoAction::BUY;
+        default: return PpoAction::HOLD;
+    }
+}
+
+inline std::string ppo_action_to_string(PpoAction action) {
+    switch (action) {
+        case PpoAction::SELL: return "SELL";
+        case PpoAction::BUY: return "BUY";
+        default: return "HOLD";
+    }
+}
+
+/**
+ * @brief C++ PPO Trading Strategy
+ *
+ * Runs a TorchScript PPO actor (trained by cpp_ppo_trainer) on a window of
+ * per-bar features, tracks the simulated position implied by its actions,
+ * and reports p(BUY) as the signal probability.
+ *
+ * All state (bar window, position, caches) is per instance; the thread budget
+ * for inference comes from the instance's ExecutionContext.
+ *
+ * The per-bar path does not allocate outside the TorchScript forward call:
+ * features are written straight into the observation ring, the model inputs
+ * (one observation view per ring slot plus the mask tensor) are built at
+ * load, and softmax/masking/argmax run on the three logits in place.
+ * generate_record() is the hot path; generate_signal() adds the metadata.
+ */
+class CppPpoStrategy : public StrategyComponent {
+public:
+    explicit CppPpoStrategy(const CppPpoConfig& config);
+    // base_config names the strategy in run output; its warmup_bars adds to
+    // the strategy's own window warm-up (records before it are neutral)
+    CppPpoStrategy(const StrategyConfig& base_config, const CppPpoConfig& config);
+    ~CppPpoStrategy() override = default;
+
+    bool initialize();
+    std::string get_name() const { return "CppPPO"; }
+
+    // Feed the bar to the feature window and run the actor (called per bar).
+    SignalOutput generate_signal(const Bar& bar, int bar_index) override;
+    SignalRecord generate_record(const Bar& bar, int bar_index) override;
+
+    // Last inference results: [p_sell, p_hold, p_buy] and [sell, hold, buy] validity
+    std::vector<double> get_action_probabilities() const;
+    std::vector<bool> get_action_mask() const;
+
+    // Actions taken so far, indexed like PpoAction, and simulated trades
+    const std::array<int, 3>& action_counts() const { return action_counts_; }
+    int total_trades() const { return total_trades_; }
+
+    // Snapshot: feature engine, observation window and the simulated position
+    bool supports_snapshots() const override { return true; }
+
+protected:
+    // Features are pushed by generate_signal()/generate_record(); no
+    // base-class indicator history
+    void update_indicators(const Bar& /*bar*/) override {}
+    std::string config_fingerprint() const override;
+    void save_derived_state(StateWriter& w) const override;
+    bool load_derived_state(StateReader& r) override;
+
+private:
+    enum class PositionState {
+        HOLD = 0,
+        LONG = 1,
+        SHORT = 2
+    };
+
+    bool load_model();
+    // One input list per observation ring slot: [observation view, mask]
+    void build_model_inputs();
+
+    static constexpr int STATE_FEATURE_DIM = 4;   // [long, short, hold, unrealized pnl]
+    static constexpr int ACTION_COUNT = 3;
+
+    // Append this bar's feature row to the observation window and run the
+    // actor when the window is full; false when no action was taken
+    bool step(const Bar& bar, int bar_index);
+    // Write the bar's features in place into the next observation row
+    bool push_observation_row(const Bar& bar, int bar_index);
+    // Refresh the per-window state columns; returns the model inputs that
+    // view the current window
+    std::vector<torch::jit::IValue>& prepare_observation();
+    void fill_state_features(float* out) const;
+    // Softmax, mask and argmax of the actor logits into probabilities_/action_
+    void select_action(const torch::Tensor& logits);
+
+    void compute_action_mask(std::array<bool, ACTION_COUNT>& mask) const;
+    void update_position_state(int action);
+    double compute_reward() const;
+    SignalOutput convert_to_signal(int action, const std::array<double, ACTION_COUNT>& probabilities, int bar_index);
+
+    void log_inference_details(int action, const std::array<double, ACTION_COUNT>& probs, int bar_index) const;
+
+    CppPpoConfig config_;
+    std::unique_ptr<features::UnifiedFeatureEngine> feature_engine_;
+    std::unique_ptr<features::FeatureStore> feature_store_;   // replaces feature_engine_ when set
+    // Last window_size rows of [features, state features] (no per-bar allocation)
+    FeatureSequenceManager observation_window_;
+
+    torch::jit::script::Module model_;
+    bool model_loaded_ = false;
+    std::vector<std::vector<torch::jit::IValue>> model_inputs_;   // indexed by window_slot()
+    torch::Tensor mask_tensor_;                                    // [3] bool, rewritten per bar
+
+    double last_close_ = 0.0;
+    int64_t last_timestamp_ms_ = 0;
+    int current_tick_ = 0;
+
+    // Simulated position driven by the actor's actions
+    PositionState position_state_ = PositionState::HOLD;
+    double entry_price_ = 0.0;
+    int total_trades_ = 0;
+
+    int last_action_ = 1;
+    std::array<int, ACTION_COUNT> action_counts_{};
+    std::array<double, ACTION_COUNT> last_probabilities_{};
+    std::array<bool, ACTION_COUNT> last_action_mask_{};
+};
+
+} // namespace sentio
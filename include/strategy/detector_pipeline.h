@@ -0,0 +1,105 @@
+#pragma once
+
+// =============================================================================
+// Module: strategy/detector_pipeline.h
+// Purpose: Compile-time detector pipelines for Signal-OR style ensembles.
+//
+// Core idea:
+// - The detector set is a type list: DetectorPipeline<Context, Config, D1, D2, ...>.
+//   Each detector is a stateless struct exposing
+//       static constexpr const char* name;
+//       static double weight(const Config&);                       // runtime
+//       static double probability(const Context&, const Config&);  // runtime windows
+// - evaluate() expands the type list with a fold expression, so the fusion
+//   loop is unrolled and each detector call can be inlined.
+// - A detector whose weight is 0 is skipped entirely: its probability is not
+//   computed and it does not vote in the confidence estimate.
+// - Fusion is log-odds averaging (LogOddsFusion), shared with other
+//   ensemble-style components.
+//
+// Adding a detector = writing one struct and appending it to the type list;
+// no signature changes in the aggregation code.
+// =============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace sentio {
+
+// -----------------------------------------------------------------------------
+// Weighted log-odds fusion with agreement-based confidence.
+//   L = sum(w_i * logit(p_i)) / sum(w_i),  P = sigmoid(k * L)
+//   confidence = clamp01(0.4 + 0.6 * max(agreement, max |p_i - 0.5|))
+// where agreement is the majority share of inputs on one side of 0.5.
+// -----------------------------------------------------------------------------
+struct LogOddsFusion {
+    double num = 0.0;
+    double den = 0.0;
+    int long_votes = 0;
+    int short_votes = 0;
+    int count = 0;
+    double max_strength = 0.0;
+
+    void add(double p, double w) {
+        double pc = std::clamp(p, 1e-6, 1.0 - 1e-6);
+        num += w * std::log(pc / (1.0 - pc));
+        den += w;
+        if (p > 0.5) ++long_votes; else if (p < 0.5) ++short_votes;
+        max_strength = std::max(max_strength, std::fabs(p - 0.5));
+        ++count;
+    }
+
+    double probability(double k) const {
+        double L = (den > 1e-12) ? (num / den) : 0.0;
+        return 1.0 / (1.0 + std::exp(-k * L));
+    }
+
+    double confidence() const {
+        if (count == 0) return 0.4;
+        double agreement = std::max(long_votes, short_votes) / static_cast<double>(count);
+        double c = 0.4 + 0.6 * std::max(agreement, max_strength);
+        return c < 0.0 ? 0.0 : (c > 1.0 ? 1.0 : c);
+    }
+};
+
+template <typename Context, typename Config, typename... Detectors>
+class DetectorPipeline {
+public:
+    static constexpr size_t size = sizeof...(Detectors);
+
+    struct Result {
+        double probability = 0.5;
+        double confidence = 0.0;
+        int active = 0;          // detectors with non-zero weight
+    };
+
+    static Result evaluate(const Context& ctx, const Config& cfg, double k) {
+        LogOddsFusion fusion;
+        (step<Detectors>(ctx, cfg, fusion), ...);
+        Result r;
+        r.probability = fusion.probability(k);
+        r.confidence = fusion.confidence();
+        r.active = fusion.count;
+        return r;
+    }
+
+    // Comma-separated names of the detectors enabled under `cfg`.
+    static std::string active_names(const Config& cfg) {
+        std::string out;
+        ((Detectors::weight(cfg) != 0.0
+              ? (out += (out.empty() ? "" : ","), out += Detectors::name, 0)
+              : 0), ...);
+        return out;
+    }
+
+private:
+    template <typename D>
+    static void step(const Context& ctx, const Config& cfg, LogOddsFusion& fusion) {
+        const double w = D::weight(cfg);
+        if (w == 0.0) return;
+        fusion.add(D::probability(ctx, cfg), w);
+    }
+};
+
+} // namespace sentio
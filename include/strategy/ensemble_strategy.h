@@ -0,0 +1,133 @@
+#pragma once
+
+// =============================================================================
+// Module: strategy/ensemble_strategy.h
+// Purpose: EnsembleStrategy — a meta-strategy that owns several child
+//          strategies (rule-based and ML) and fuses their probabilities.
+//
+// Core idea:
+// - Every bar is fed to every child; children evaluate concurrently, each on
+//   its own single-thread lane (a ThreadPool of size 1), so a child always
+//   sees its bars in order and needs no locking.
+// - Fusion is the weighted log-odds average used by Sigor's detectors
+//   (LogOddsFusion): P = sigmoid(k * sum(w_i * logit(p_i)) / sum(w_i)).
+//   Only children that emitted a record for the bar take part.
+// - Per bar (live): on_bar() waits for all children, or at most
+//   child_budget_us when a budget is set. A child that misses the budget is
+//   left out of that bar's fusion and its late result is dropped, so one
+//   slow model cannot stall the ensemble; it keeps processing its queue.
+//   Bars submitted while it still has a backlog are skipped without waiting
+//   (and counted as misses) until it catches up, instead of each costing
+//   the full budget.
+// - Per batch (backtest): stream_dataset_range() hands each child a block of
+//   batch_bars bars at a time and fuses afterwards. Output is identical to
+//   the per-bar path without a budget. With a budget set it streams bar by
+//   bar instead, since the budget is a per-bar deadline.
+// - Per-child latency (per bar, recorded on the child's lane, so late bars
+//   count), budget misses and the deepest backlog are kept for reporting.
+// - The ensemble emits once every child has warmed up; required_lookback()
+//   and snapshots are available when all children support them.
+// =============================================================================
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "common/latency_stats.h"
+#include "common/thread_pool.h"
+#include "strategy_component.h"
+
+namespace sentio {
+
+class EnsembleStrategy : public StrategyComponent {
+public:
+    struct Config {
+        double k = 1.0;                 // log-odds sharpening
+        int64_t child_budget_us = 0;    // per-bar wait for children (0 = wait for all)
+        size_t batch_bars = 4096;       // bars per child task in stream_dataset_range()
+    };
+
+    EnsembleStrategy(const StrategyConfig& config, const Config& ensemble_config);
+    ~EnsembleStrategy() override;
+
+    // Add a child before the first bar. `label` names it in reports and
+    // fingerprints; weight 0 keeps it running but out of the fusion.
+    void add_child(const std::string& label, std::unique_ptr<StrategyComponent> child, double weight);
+
+    // Split `total_threads` (<= 0: all cores, or cpus.size()) across the
+    // children's contexts; with `cpus` each child is pinned to its own slice.
+    void partition_threads(int total_threads, const std::vector<int>& cpus = {});
+
+    size_t child_count() const { return children_.size(); }
+    const std::string& child_label(size_t i) const { return children_[i]->label; }
+    // Copy of the child's samples (its lane may still be recording).
+    LatencyStats child_latency(size_t i) const;
+    uint64_t child_budget_misses(size_t i) const { return children_[i]->misses; }
+    // Most bars queued on the child's lane at once (1 = never fell behind).
+    uint32_t child_max_backlog(size_t i) const { return children_[i]->max_backlog; }
+    // One line per child: label, weight, latency percentiles, budget misses
+    // and backlog.
+    std::string latency_report() const;
+
+    int required_lookback() const override;
+    bool supports_snapshots() const override;
+
+    bool stream_dataset_range(const std::string& dataset_path,
+                              const std::string& strategy_name,
+                              SignalSink& sink,
+                              uint64_t start_index = 0,
+                              uint64_t count = 0) override;
+
+protected:
+    SignalRecord generate_record(const Bar& bar, int bar_index) override;
+    void update_indicators(const Bar& bar) override;
+    bool is_warmed_up() const override;
+
+    std::string config_fingerprint() const override;
+    void save_derived_state(StateWriter& w) const override;
+    bool load_derived_state(StateReader& r) override;
+
+private:
+    // Result of one child on one bar
+    struct Eval {
+        SignalRecord record;
+        bool emitted = false;
+    };
+
+    struct Child {
+        std::string label;
+        double weight = 1.0;
+        std::unique_ptr<StrategyComponent> strategy;
+        std::unique_ptr<ThreadPool> lane;       // declared after strategy: joined first
+
+        // Written on the lane
+        mutable std::mutex latency_mutex;
+        LatencyStats latency;                   // guarded by latency_mutex
+        std::atomic<uint32_t> backlog{0};       // bars submitted and not finished
+
+        uint64_t misses = 0;
+        uint32_t max_backlog = 0;
+        bool warmed = false;
+
+        // Current bar's contribution
+        bool present = false;
+        double probability = 0.5;
+    };
+
+    // Runs on c's lane; records the bar's latency
+    static Eval evaluate(Child& c, const Bar& bar, int bar_index);
+    void evaluate_children(const Bar& bar, int bar_index);
+    void take_batch_results(size_t offset);
+
+    Config ens_cfg_;
+    std::vector<std::unique_ptr<Child>> children_;
+
+    // Batch mode: per-child results for the current block, consumed in order
+    bool batch_mode_ = false;
+    std::vector<std::vector<Eval>> batch_;
+    size_t batch_cursor_ = 0;
+};
+
+} // namespace sentio
@@ -0,0 +1,73 @@
+#pragma once
+
+// =============================================================================
+// Module: strategy/execution_context.h
+// Purpose: Explicit compute budget for one strategy instance.
+//
+// Core idea:
+// - Strategies no longer change process-wide library settings. Each instance
+//   carries an ExecutionContext that says how many threads a single inference
+//   call may use, and applies it to the thread that runs the inference right
+//   before the call (apply_to_current_thread()).
+// - With LibTorch's default OpenMP backend the intra-op thread count is a
+//   per-calling-thread setting, so N instances driven from N threads can each
+//   keep their own budget. The setting is cached per thread, so applying it
+//   on every bar costs a thread_local compare.
+// - Settings a library accepts only once per process (LibTorch's inter-op
+//   pool) go through configure_process(), which applies the first request
+//   and ignores later ones instead of throwing.
+// - partition() splits a machine-wide thread budget across N instances,
+//   e.g. for parallel sweeps and sharded runs.
+// - Optionally the context pins the thread that applies it to a CPU set
+//   (Linux; ignored with a warning elsewhere). Threads started afterwards by
+//   that thread (LibTorch's OpenMP team, a ThreadPool) inherit the set, so a
+//   pinned instance keeps its intra-op workers on its own cores. partition()
+//   hands each instance a disjoint slice of the given CPU list.
+// =============================================================================
+
+#include <string>
+#include <vector>
+
+namespace sentio {
+
+class ExecutionContext {
+public:
+    struct Options {
+        int intra_op_threads = 1;   // threads one inference call may use
+        int interop_threads = 1;    // process-wide inter-op pool (first model load wins)
+        std::vector<int> cpus;      // CPU ids to pin to; empty = no pinning
+    };
+
+    // Default budget: single-threaded inference (the previous global setting)
+    ExecutionContext() = default;
+    explicit ExecutionContext(Options options);
+
+    int intra_op_threads() const { return options_.intra_op_threads; }
+    int interop_threads() const { return options_.interop_threads; }
+    const std::vector<int>& cpus() const { return options_.cpus; }
+
+    // Apply the budget (and CPU pinning) to the calling thread; cheap when
+    // already applied.
+    void apply_to_current_thread() const;
+
+    // Split `total_threads` (<= 0: all hardware threads, or cpus.size() when
+    // given) across `instances` contexts; every context gets at least one
+    // thread. With `cpus`, instance i is pinned to the next intra_op_threads
+    // ids of the list (wrapping when the list is shorter than the budget).
+    static std::vector<ExecutionContext> partition(int total_threads, int instances,
+                                                   const std::vector<int>& cpus = {});
+
+    // Process-wide, apply-once settings. Returns false if a different value
+    // was already configured (the first one stays in effect).
+    static bool configure_process(int interop_threads);
+
+    // Parse "0-7,16,18-19" into CPU ids; false on malformed input.
+    static bool parse_cpu_list(const std::string& text, std::vector<int>& cpus);
+    // "intra=4 interop=1 cpus=0-3" (logging and cache keys)
+    std::string describe() const;
+
+private:
+    Options options_;
+};
+
+} // namespace sentio
@@ -0,0 +1,81 @@
+#pragma once
+
+// =============================================================================
+// Module: strategy/gru_feature_window.h
+// Purpose: The 53 per-timestep features the advanced GRU model consumes,
+//          built into a plain float buffer without LibTorch.
+//
+// Core idea:
+// - update_statistics() advances the O(1) SMA/EMA banks and appends ONE
+//   feature row for the new bar, computed from that bar and its predecessors
+//   (so every row carries the SMAs as of its own bar, like the training
+//   data). Per-bar cost is O(53), not O(seq_len x 53).
+// - Rows live in a FeatureSequenceManager(seq_len, 53): the row is computed
+//   straight into next_row() and committed, and the newest seq_len rows are
+//   one contiguous [seq_len, 53] block, oldest row first, the layout both the
+//   TorchScript model and ml::NativeGruModel read. window() returns it
+//   without copying; build() copies it out.
+// - OptimizedGruStrategy wraps window() in a tensor; torch-free tools
+//   (quantization calibration) use build() so both see identical inputs.
+// =============================================================================
+
+#include "common/types.h"
+#include "common/rolling_indicators.h"
+#include "common/feature_sequence_manager.h"
+#include <cstdint>
+
+namespace sentio {
+
+class StateWriter;
+class StateReader;
+
+struct GruFeatureWindow {
+    static constexpr int FEATURE_COUNT = 53;
+
+    explicit GruFeatureWindow(int seq_len = 64);
+
+    // Compile-time SMA/EMA windows for the 53-feature advanced model
+    rolling::MeanBank<double, 3, 5, 10, 15, 20, 25, 30, 40, 50, 60> smas_;
+    rolling::EmaBank<double, 5, 10, 12, 15, 20, 26, 30, 50> emas_;
+
+    // Update ALL moving averages incrementally in O(1) time
+    void update_mas(double new_price);
+
+    // Advance the moving averages and append the bar's feature row
+    void update_statistics(const Bar& bar);
+
+    int sequence_length() const { return seq_len_; }
+    // At least sequence_length() bars seen
+    bool ready() const { return bars_seen_ >= static_cast<uint64_t>(seq_len_); }
+
+    // Newest sequence_length() rows of FEATURE_COUNT floats, oldest first;
+    // nullptr until ready(). Valid until the next update_statistics().
+    const float* window() const;
+
+    // Copy window() to `out`; false (and `out` untouched) until ready().
+    bool build(float* out) const;
+
+    // Get any SMA in O(1) time (0 until the window is full)
+    double get_sma(int period) const;
+
+    // Get any EMA in O(1) time
+    double get_ema(int period) const;
+
+    // Snapshot of the averages, the raw-value lags and the current window
+    // (FeatureSequenceManager::save_state); the sequence length must match.
+    void save(StateWriter& w) const;
+    bool load(StateReader& r);
+
+private:
+    void compute_row(const Bar& bar, double ret, float* row) const;
+
+    int seq_len_;
+    FeatureSequenceManager rows_;
+    uint64_t bars_seen_ = 0;
+    // Lags the row formulas reach back to (the current bar is back(0))
+    rolling::RingWindow<double, 20> closes_;
+    rolling::RingWindow<double, 5> volumes_;
+    rolling::RingWindow<double, 6> returns_;
+};
+
+} // namespace sentio
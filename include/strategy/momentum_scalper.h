@@ -1,9 +1,9 @@
 #pragma once
 
 #include <vector>
-#include <deque>
 #include <memory>
 #include "common/types.h"
+#include "common/rolling_indicators.h"
 #include "strategy/signal_output.h"
 #include "backend/position_state_machine.h"
 #include "backend/adaptive_trading_mechanism.h"
@@ -137,8 +137,10 @@ private:
     ScalperConfig config_;
     MarketRegime current_regime_ = MarketRegime::NEUTRAL;
     
-    // Price history for SMA calculation
-    std::deque<double> price_history_;
+    // Streaming SMAs for trend detection (O(1) per bar)
+    rolling::RollingMean<double> fast_ma_;
+    rolling::RollingMean<double> slow_ma_;
+    size_t bars_seen_ = 0;
     
     // SMA values
     double fast_sma_ = 0.0;
@@ -165,10 +167,7 @@ private:
     bool is_long_transition(const PositionStateMachine::StateTransition& transition) const;
     bool is_short_transition(const PositionStateMachine::StateTransition& transition) const;
     std::string select_optimal_instrument(const SignalOutput& signal, MarketRegime regime) const;
-    
-    // SMA calculation utilities
-    double calculate_sma(const std::deque<double>& data, int period) const;
-    void maintain_history_size();
+
 };
 
 } // namespace sentio
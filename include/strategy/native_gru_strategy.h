@@ -0,0 +1,71 @@
+#pragma once
+
+// =============================================================================
+// Module: strategy/native_gru_strategy.h
+// Purpose: The advanced GRU model as a strategy that needs no LibTorch at all.
+//
+// Core idea:
+// - GruFeatureWindow builds the 53 features one row per bar into a contiguous
+//   [seq_len, 53] window; ml::NativeGruModel evaluates that window in place.
+//   Signals equal OptimizedGruStrategy's native_model_path path without its
+//   bias correction: probability = sigmoid(direction logit), confidence =
+//   distance from 0.5.
+// - Weights are the model.native file written by gru_trainer, or converted
+//   from a model.pt checkpoint with tools/gru_native_export.
+// - streaming = true steps the carried GRU state one row per bar and runs a
+//   full window every resync_interval bars (and after a snapshot restore).
+// - generate_record() does not allocate; snapshots carry the feature window.
+// =============================================================================
+
+#include "strategy/strategy_component.h"
+#include "strategy/gru_feature_window.h"
+#include "strategy/startup_profile.h"
+#include "ml/native_gru.h"
+#include <memory>
+#include <string>
+
+namespace sentio {
+
+class NativeGruStrategy : public StrategyComponent {
+public:
+    struct Config {
+        std::string model_path = "artifacts/GRU/cpp_trained/model.native";
+        int sequence_length = 64;
+        std::string precision = "fp32";   // weight storage: fp32, bf16 or int8
+        bool streaming = false;
+        int resync_interval = 64;
+    };
+
+    NativeGruStrategy(const StrategyConfig& base_config, const Config& config);
+
+    // Load the weights and start the background warm-up forward
+    bool initialize();
+    std::string get_name() const { return "NativeGRU"; }
+
+    // Snapshot: SMA/EMA banks and feature rows; the GRU state re-syncs
+    bool supports_snapshots() const override { return true; }
+
+protected:
+    uint32_t state_version() const override { return 2; }   // 2: feature rows as FeatureSequenceManager
+    SignalOutput generate_signal(const Bar& bar, int bar_index) override;
+    SignalRecord generate_record(const Bar& bar, int bar_index) override;
+    void update_indicators(const Bar& bar) override;
+
+    std::string config_fingerprint() const override;
+    void save_derived_state(StateWriter& w) const override;
+    bool load_derived_state(StateReader& r) override;
+
+private:
+    // Evaluate the current window; false (neutral signal) before it is full
+    bool infer(int bar_index, double& probability, double& confidence);
+
+    Config config_;
+    GruFeatureWindow features_;
+    std::unique_ptr<ml::NativeGruModel> model_;
+    ml::NativeGruState state_;        // streaming only; not snapshotted
+
+    // Last member: its warm-up thread uses the model and is joined first
+    StartupProfile startup_;
+};
+
+} // namespace sentio
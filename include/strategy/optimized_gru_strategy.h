@@ -1,7 +1,13 @@
 #pragma once
 
 #include "strategy/strategy_component.h"
+#include "strategy/batched_inference.h"
+#include "strategy/gru_feature_window.h"
 #include "common/types.h"
+#include "ml/gru_model.h"
+#include "ml/native_gru.h"
+#include "ml/remote_model.h"
+#include "strategy/startup_profile.h"
 #include <torch/torch.h>
 #include <torch/script.h>
 #include <deque>
@@ -21,6 +27,28 @@ struct OptimizedGruConfig {
     int feature_dim = 53;
     double confidence_threshold = 0.6;
     bool enable_debug = false;
+    int inference_batch = 512;  // windows per forward in stream_dataset_range(); 1 = per bar
+    
+    // Stateful streaming: an ml::AdvancedGRUModel checkpoint (gru_trainer
+    // model.pt; architecture from metadata_path) run one bar at a time from
+    // carried hidden states, with a full-window pass every resync_interval bars.
+    std::string streaming_model_path;
+    int resync_interval = 64;
+    
+    // LibTorch-free inference: weights exported by AdvancedGRUModelImpl::
+    // export_native() (gru_trainer model.native); native_streaming steps the
+    // carried state with the same resync_interval. native_precision ("fp32",
+    // "bf16" or "int8") is the weight storage precision; check the drift with
+    // gru_quantization_calibration before enabling a reduced one.
+    std::string native_model_path;
+    bool native_streaming = false;
+    std::string native_precision = "fp32";
+    
+    // Shared model server (tools/model_server) socket: the model named above
+    // (native_model_path, else model_path as TorchScript) is evaluated there
+    // instead of being loaded in this process. Full-window inference only;
+    // carried-state streaming needs a local model.
+    std::string model_server;
 };
 
 /**
@@ -65,57 +93,52 @@ public:
     }
     
     PerformanceStats get_performance_stats() const { return perf_stats_; }
+    
+    // Snapshot: SMA/EMA banks and the bar window feeding the model
+    bool supports_snapshots() const override { return true; }
+
+    // Historical run with batched inference (see OptimizedGruConfig::inference_batch)
+    bool stream_dataset_range(const std::string& dataset_path,
+                              const std::string& strategy_name,
+                              SignalSink& sink,
+                              uint64_t start_index = 0,
+                              uint64_t count = 0) override;
 
 protected:
     // Override base class hooks
     SignalOutput generate_signal(const Bar& bar, int bar_index) override;
     void update_indicators(const Bar& bar) override;
+    
+    uint32_t state_version() const override { return 3; }   // 3: feature rows as FeatureSequenceManager
+    std::string config_fingerprint() const override;
+    void save_derived_state(StateWriter& w) const override;
+    bool load_derived_state(StateReader& r) override;
 
 private:
     OptimizedGruConfig config_;
     torch::jit::script::Module model_;
     bool model_loaded_ = false;
+    ml::AdvancedGRUModel streaming_model_{nullptr};
+    ml::GRUStreamState stream_state_;   // not snapshotted; re-synced after a restore
+    std::unique_ptr<ml::NativeGruModel> native_model_;
+    ml::NativeGruState native_state_;
+    std::unique_ptr<ml::RemoteModel> remote_model_;
     PerformanceStats perf_stats_;
     
-    // High-performance feature calculation with O(1) updates
-    struct FastFeatureEngine {
-        // Pre-allocated tensor pool (300x speedup)
-        torch::Tensor cached_tensor_;
-        bool tensor_initialized_ = false;
-        
-        // CRITICAL: O(1) Incremental Feature Calculator (250x speedup)
-        // Sliding window sums for O(1) moving averages
-        std::map<int, double> ma_sums_;  // period -> sum
-        std::map<int, std::deque<double>> ma_windows_;  // period -> window
-        
-        // EMA state for O(1) updates
-        std::map<int, double> ema_values_;  // period -> current EMA
-        bool ema_initialized_ = false;
+    // High-performance feature calculation: one new feature row per bar
+    struct FastFeatureEngine : GruFeatureWindow {
+        explicit FastFeatureEngine(int seq_len) : GruFeatureWindow(seq_len) {}
         
         // Feature normalization parameters
         std::vector<double> feature_means_;
         std::vector<double> feature_stds_;
         
-        // Initialize with metadata
+        // Initialize with metadata (binary sidecar when current, else JSON)
         bool initialize(const std::string& metadata_path);
         
-        // Get reusable tensor (avoids allocation overhead)
-        torch::Tensor& get_tensor(int seq_len, int feat_count);
-        
-        // CRITICAL: Update ALL moving averages incrementally in O(1) time
-        void update_mas(double new_price);
-        
-        // Update incremental statistics O(1)
-        void update_statistics(const Bar& bar);
-        
-        // Create optimized feature tensor
-        torch::Tensor create_features(const std::deque<Bar>& history, int seq_len, int feat_dim);
-        
-        // Get any SMA in O(1) time
-        double get_sma(int period) const;
-        
-        // Get any EMA in O(1) time
-        double get_ema(int period) const;
+        // [1, seq_len, 53] tensor over the rolling window (no copy); valid
+        // until the next bar. Zeros until the window is full.
+        torch::Tensor create_features();
         
         // Legacy methods (deprecated - use get_sma instead)
         double get_ma5() const { return get_sma(5); }
@@ -127,11 +150,32 @@ private:
     
     // Core inference methods
     torch::Tensor run_inference(const torch::Tensor& features);
-    SignalOutput convert_to_signal(const torch::Tensor& output, int bar_index);
+    double run_streaming_inference(const torch::Tensor& features);
+    double run_native_inference(const torch::Tensor& features);
+    // [rows, seq_len, 53] windows -> [rows] direction logits from the server
+    torch::Tensor run_remote_inference(const torch::Tensor& windows);
+    SignalOutput convert_to_signal(double direction_logit, int bar_index);
+    // Evaluate the queued windows and write the held records
+    void flush_inference_batch(DeferredRecordBatch& batch, SignalSink& sink);
+    
+    // Batched backtest state: feature windows are queued in batch_inputs_
+    // [inference_batch, seq_len, 53] while inference_batch_ is set
+    DeferredRecordBatch* inference_batch_ = nullptr;
+    torch::Tensor batch_inputs_;
+    bool deferred_ = false;           // the current bar's record was queued
     
     // Utility methods
     bool load_model();
+    bool load_streaming_model();
+    bool load_native_model();
+    bool load_remote_model();
+    // First forward on a zero window in the background while warm-up bars
+    // are consumed; joined before the first real inference
+    void start_model_warmup();
     void log_performance_stats() const;
+    
+    // Last member: its warm-up thread uses the model and is joined first
+    StartupProfile startup_;
 };
 
 } // namespace sentio
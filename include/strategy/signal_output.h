@@ -8,11 +8,19 @@
 // - A signal is the strategy's probabilistic opinion about the next action,
 //   decoupled from execution. It can be serialized to JSON/CSV and consumed by
 //   the backend for trade decisions or by audit tools for analysis.
+// - Two representations exist:
+//   * SignalOutput: the rich, string-carrying record used at the edges
+//     (JSONL readers, backend, audit).
+//   * SignalRecord: a compact 32-byte POD emitted on the hot path. Strings
+//     (symbol, strategy name/version, per-run metadata) live once in a
+//     SignalRunInfo side channel and are referenced by small integer ids.
 // =============================================================================
 
 #include <string>
 #include <map>
+#include <vector>
 #include <cstdint>
+#include <type_traits>
 
 namespace sentio {
 
@@ -31,6 +39,56 @@ struct SignalOutput {
     static SignalOutput from_json(const std::string& json_str);
 };
 
-} // namespace sentio
+// -----------------------------------------------------------------------------
+// Struct: SignalRecord
+// Allocation-free signal emitted once per bar. Trivially copyable so it can be
+// stored in flat arrays, written as raw bytes, and passed between threads.
+// -----------------------------------------------------------------------------
+struct SignalRecord {
+    int64_t timestamp_ms = 0;
+    int32_t bar_index = 0;
+    uint16_t symbol_id = 0;         // index into SignalRunInfo::symbols
+    uint16_t strategy_id = 0;       // index into SignalRunInfo::strategies
+    double probability = 0.5;       // 0.0 to 1.0
+    double confidence = 0.0;        // 0.0 to 1.0
+};
+
+static_assert(std::is_trivially_copyable<SignalRecord>::value,
+              "SignalRecord must stay trivially copyable");
+static_assert(sizeof(SignalRecord) == 32, "SignalRecord layout changed");
+
+// -----------------------------------------------------------------------------
+// Struct: SignalRunInfo
+// Per-run side channel for everything that does not change bar to bar.
+// Interning happens at run setup (or on a new symbol), never per bar.
+// -----------------------------------------------------------------------------
+struct SignalRunInfo {
+    struct StrategyEntry {
+        std::string name;
+        std::string version;
+    };
 
+    std::vector<std::string> symbols;
+    std::vector<StrategyEntry> strategies;
+    std::map<std::string, std::string> metadata;   // e.g. market_data_path, detectors
 
+    // Return the id of symbol/strategy, registering it on first use.
+    uint16_t intern_symbol(const std::string& symbol);
+    uint16_t intern_strategy(const std::string& name, const std::string& version);
+
+    // Conversions between the compact and the rich representation.
+    SignalOutput expand(const SignalRecord& record) const;
+    SignalRecord compact(const SignalOutput& signal);
+
+    // Append the serialized record to `out` (no trailing newline). JSON is
+    // byte-identical to expand(record).to_json() and CSV matches the rows of
+    // StrategyComponent::export_signals, but the caller's buffer is reused so
+    // steady-state serialization does not allocate.
+    void append_json(const SignalRecord& record, std::string& out) const;
+    void append_csv(const SignalRecord& record, std::string& out) const;
+
+private:
+    uint16_t last_symbol_id_ = 0;   // fast path: consecutive bars share a symbol
+};
+
+} // namespace sentio
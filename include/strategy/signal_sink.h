@@ -0,0 +1,176 @@
+#pragma once
+
+// =============================================================================
+// Module: strategy/signal_sink.h
+// Purpose: Streaming destinations for SignalRecords produced by strategies.
+//
+// Core idea:
+// - Strategies push each record into a sink as soon as it is generated instead
+//   of accumulating a vector and serializing it at the end. Peak memory is the
+//   writer buffer, not the size of the run.
+// - File sinks serialize into a reused line buffer and hand bytes to a
+//   BufferedFileWriter (optionally on a background I/O thread).
+// - Sinks resolve ids against the run's SignalRunInfo at write time, so
+//   symbols interned mid-run are handled transparently.
+// - flush() pushes buffered bytes to the OS without closing, for consumers
+//   that read the file while it is being written (strattest --mode live).
+//
+// Formats:
+// - jsonl : identical to SignalOutput::to_json() lines (backend/audit input)
+// - csv   : header + rows identical to StrategyComponent::export_signals
+// - bin   : [SignalFileHeader][SignalRecord x N][run info][SignalFileFooter]
+//           Appending truncates the run info/footer, adds records and writes
+//           them again; the new run info must extend the file's (same ids).
+// - memory: records kept in a vector (tests, in-process consumers)
+// =============================================================================
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "strategy/signal_output.h"
+#include "common/buffered_writer.h"
+
+namespace sentio {
+
+class SignalSink {
+public:
+    virtual ~SignalSink() = default;
+
+    // Bind the run side channel. Must outlive the sink until finish().
+    virtual bool begin(const SignalRunInfo& run_info) { run_info_ = &run_info; return true; }
+    virtual void write(const SignalRecord& record) = 0;
+    // Make everything written so far visible to readers (live mode). Cheap
+    // when nothing is pending; callers batch writes between flushes.
+    virtual bool flush() { return true; }
+    // Flush and finalize the destination. Returns false on any I/O error.
+    virtual bool finish() { return true; }
+
+    uint64_t count() const { return count_; }
+
+protected:
+    const SignalRunInfo* run_info_ = nullptr;
+    uint64_t count_ = 0;
+};
+
+// Options shared by the file-backed sinks.
+struct SignalSinkOptions {
+    size_t buffer_bytes = BufferedFileWriter::DEFAULT_BUFFER_BYTES;
+    bool async_io = false;      // write on a background I/O thread
+    bool append = false;        // append to an existing file
+};
+
+class JsonlSignalSink : public SignalSink {
+public:
+    JsonlSignalSink(std::string path, SignalSinkOptions options = {});
+    bool begin(const SignalRunInfo& run_info) override;
+    void write(const SignalRecord& record) override;
+    bool flush() override { return writer_.flush(); }
+    bool finish() override;
+
+private:
+    std::string path_;
+    SignalSinkOptions options_;
+    BufferedFileWriter writer_;
+    std::string line_;
+};
+
+class CsvSignalSink : public SignalSink {
+public:
+    CsvSignalSink(std::string path, SignalSinkOptions options = {});
+    bool begin(const SignalRunInfo& run_info) override;
+    void write(const SignalRecord& record) override;
+    bool flush() override { return writer_.flush(); }
+    bool finish() override;
+
+private:
+    std::string path_;
+    SignalSinkOptions options_;
+    BufferedFileWriter writer_;
+    std::string line_;
+};
+
+// -----------------------------------------------------------------------------
+// Binary signal file. Records are raw SignalRecords; the run info (symbols,
+// strategies, metadata) is written after them because symbols may be interned
+// while the run progresses. The footer points back to it.
+// -----------------------------------------------------------------------------
+static constexpr uint32_t SIGNAL_FILE_MAGIC = 0x53494753; // "SGIS"
+static constexpr uint32_t SIGNAL_FILE_VERSION = 1;
+
+struct SignalFileHeader {
+    uint32_t magic = SIGNAL_FILE_MAGIC;
+    uint32_t version = SIGNAL_FILE_VERSION;
+    uint32_t record_size = sizeof(SignalRecord);
+    uint32_t reserved = 0;
+};
+
+struct SignalFileFooter {
+    uint64_t record_count = 0;
+    uint64_t run_info_offset = 0;   // byte offset of the serialized run info
+    uint32_t magic = SIGNAL_FILE_MAGIC;
+    uint32_t reserved = 0;
+};
+
+class BinarySignalSink : public SignalSink {
+public:
+    BinarySignalSink(std::string path, SignalSinkOptions options = {});
+    bool begin(const SignalRunInfo& run_info) override;
+    void write(const SignalRecord& record) override;
+    bool flush() override { return writer_.flush(); }
+    bool finish() override;
+
+private:
+    std::string path_;
+    SignalSinkOptions options_;
+    BufferedFileWriter writer_;
+    uint64_t existing_records_ = 0;   // records already in the file (append)
+};
+
+// Read a file produced by BinarySignalSink. Returns false if it is malformed.
+bool read_signal_file(const std::string& path,
+                      std::vector<SignalRecord>& records,
+                      SignalRunInfo& run_info);
+
+// Read only the run info (and optionally the footer) of a binary signal file.
+bool read_signal_run_info(const std::string& path,
+                          SignalRunInfo& run_info,
+                          SignalFileFooter* footer = nullptr);
+
+// Last signal of an existing signal file, found without reading the whole
+// file (last line for jsonl/csv, last record for bin).
+struct SignalFileTail {
+    bool empty = true;          // file missing or without signals
+    int64_t bar_index = -1;
+    int64_t timestamp_ms = 0;
+};
+
+bool read_signal_file_tail(const std::string& path,
+                           const std::string& format,
+                           SignalFileTail& tail);
+
+// Format name for a signal file path by extension ("" if unknown).
+std::string signal_format_from_path(const std::string& path);
+
+class MemorySignalSink : public SignalSink {
+public:
+    void reserve(size_t n) { records_.reserve(n); }
+    void write(const SignalRecord& record) override { records_.push_back(record); ++count_; }
+
+    const std::vector<SignalRecord>& records() const { return records_; }
+    std::vector<SignalRecord> take() { return std::move(records_); }
+
+private:
+    std::vector<SignalRecord> records_;
+};
+
+// Create a file sink by format name ("jsonl", "csv", "bin"). Returns nullptr
+// for unknown formats.
+std::unique_ptr<SignalSink> make_signal_sink(const std::string& format,
+                                             const std::string& path,
+                                             const SignalSinkOptions& options = {});
+
+// File extension used for a format ("jsonl" -> ".jsonl", "bin" -> ".sigbin").
+std::string signal_file_extension(const std::string& format);
+
+} // namespace sentio
@@ -10,13 +10,15 @@
 //   "w_boll": 1.0, "w_rsi": 1.0, "w_mom": 1.0,
 //   "w_vwap": 1.0, "w_orb": 0.5, "w_ofi": 0.5, "w_vol": 0.5,
 //   "win_boll": 20, "win_rsi": 14, "win_mom": 10, "win_vwap": 20,
-//   "orb_opening_bars": 30
+//   "win_vol": 20, "orb_opening_bars": 30
 // }
 //
 // Notes:
 // - "k" controls sharpness in log-odds fusion: P = sigma(k * L).
-// - w_* are detector reliabilities; set to 0 to disable a detector.
-// - win_* are window lengths for respective detectors.
+// - w_* are detector reliabilities; set to 0 to disable a detector (it is
+//   then neither evaluated nor counted in the confidence vote).
+// - win_* are window lengths for respective detectors; windows longer than
+//   SigorStrategy::HISTORY_CAP keep the detector neutral.
 // =============================================================================
 
 #include <string>
@@ -41,6 +43,7 @@ struct SigorConfig {
     int win_rsi  = 14;
     int win_mom  = 10;
     int win_vwap = 20;
+    int win_vol  = 20;
     int orb_opening_bars = 30;
 
     static SigorConfig defaults();
@@ -7,78 +7,152 @@
 //
 // Detailed algorithm (Signal-OR aggregator):
 // - Compute several detector probabilities independently per bar:
-//   1) Bollinger Z-Score: z = (Close - SMA20) / StdDev20; prob = 0.5 + 0.5*tanh(z/2).
-//   2) RSI(14): map RSI [0..100] to prob around 0.5 (50 neutral).
-//   3) Momentum (10 bars): prob = 0.5 + 0.5*tanh(return*scale), scale≈50.
-//   4) VWAP reversion (rolling window): typical price vs rolling VWAP.
-//   5) Opening Range Breakout (daily): breakout above/below day’s opening range (first N bars).
+//   1) Bollinger Z-Score: z = (Close - SMA(win_boll)) / StdDev; prob = 0.5 + 0.5*tanh(z/2).
+//   2) RSI(win_rsi): map RSI [0..100] to prob around 0.5 (50 neutral).
+//   3) Momentum (win_mom bars): prob = 0.5 + 0.5*tanh(return*scale), scale≈50.
+//   4) VWAP reversion (win_vwap): typical price vs rolling VWAP.
+//   5) Opening Range Breakout (daily): breakout above/below day’s opening range (first orb_opening_bars bars).
 //   6) OFI Proxy: order-flow imbalance proxy using bar geometry and volume.
-//   7) Volume Surge: volume vs rolling average scales the momentum signal.
-// - OR aggregation: choose the detector with maximum strength |p - 0.5| as the
-//   final probability for the bar. This captures the strongest signal.
+//   7) Volume Surge (win_vol): volume vs rolling average scales the momentum signal.
+// - Fusion: weighted log-odds average sharpened by k (LogOddsFusion).
 // - Confidence: blend detector agreement (majority on the same side of 0.5)
 //   with maximum strength, then clamp to [0,1].
+// - The detector set is the compile-time SigorPipeline type list; detectors
+//   with weight 0 are not evaluated and do not vote.
 //
 // Design notes:
-// - Stateless outside of rolling windows; no I/O. All state is internal buffers.
+// - Stateless outside of rolling windows; no I/O. All state is internal ring
+//   buffers; detectors use the window-pure batch kernels from
+//   common/rolling_indicators.h so results depend only on the last
+//   HISTORY_CAP bars.
 // - Uses only OHLCV bars, no external feature libs; computations are simplified
 //   proxies of the detectors referenced in sentio_cpp.
 // - Warmup is inherited from StrategyComponent; emits signals after warmup.
+// - generate_record() is the native hot path; the detector list is published
+//   once per run in run_info().metadata instead of on every signal.
+// - Snapshots hold the rolling series (<= HISTORY_CAP bars per field) and are
+//   tied to the SigorConfig they were taken with.
 // =============================================================================
 
 #include <vector>
 #include <string>
 #include <cstdint>
 #include "common/types.h"
+#include "common/rolling_indicators.h"
 #include "strategy_component.h"
+#include "detector_pipeline.h"
 #include "sigor_config.h"
 
 namespace sentio {
 
+// -----------------------------------------------------------------------------
+// Rolling OHLCV series shared by the Sigor detectors (bounded, oldest first).
+// -----------------------------------------------------------------------------
+struct SigorSeries {
+    // Series are capped at HISTORY_CAP bars, so that many bars of prefix
+    // reproduce the detector state exactly.
+    static constexpr size_t HISTORY_CAP = 2048;
+
+    rolling::RingWindow<double, HISTORY_CAP> closes;
+    rolling::RingWindow<double, HISTORY_CAP> highs;
+    rolling::RingWindow<double, HISTORY_CAP> lows;
+    rolling::RingWindow<double, HISTORY_CAP> volumes;
+    rolling::RingWindow<int64_t, HISTORY_CAP> timestamps;
+
+    void push(const Bar& bar) {
+        closes.push(bar.close);
+        highs.push(bar.high);
+        lows.push(bar.low);
+        volumes.push(bar.volume);
+        timestamps.push(bar.timestamp_ms);
+    }
+
+    void save(StateWriter& w) const {
+        closes.save(w);
+        highs.save(w);
+        lows.save(w);
+        volumes.save(w);
+        timestamps.save(w);
+    }
+
+    bool load(StateReader& r) {
+        return closes.load(r) && highs.load(r) && lows.load(r) &&
+               volumes.load(r) && timestamps.load(r);
+    }
+};
+
+// Per-bar view handed to each detector.
+struct SigorContext {
+    const SigorSeries& series;
+    const Bar& bar;
+};
+
+// ---- Detectors (see algorithm notes above) ----
+namespace sigor {
+    struct Bollinger {
+        static constexpr const char* name = "boll";
+        static double weight(const SigorConfig& c) { return c.w_boll; }
+        static double probability(const SigorContext& ctx, const SigorConfig& c);
+    };
+    struct Rsi {
+        static constexpr const char* name = "rsi";
+        static double weight(const SigorConfig& c) { return c.w_rsi; }
+        static double probability(const SigorContext& ctx, const SigorConfig& c);
+    };
+    struct Momentum {
+        static constexpr const char* name = "mom";
+        static double weight(const SigorConfig& c) { return c.w_mom; }
+        static double probability(const SigorContext& ctx, const SigorConfig& c);
+    };
+    struct VwapReversion {
+        static constexpr const char* name = "vwap";
+        static double weight(const SigorConfig& c) { return c.w_vwap; }
+        static double probability(const SigorContext& ctx, const SigorConfig& c);
+    };
+    struct OpeningRangeBreakout {
+        static constexpr const char* name = "orb";
+        static double weight(const SigorConfig& c) { return c.w_orb; }
+        static double probability(const SigorContext& ctx, const SigorConfig& c);
+    };
+    struct OfiProxy {
+        static constexpr const char* name = "ofi";
+        static double weight(const SigorConfig& c) { return c.w_ofi; }
+        static double probability(const SigorContext& ctx, const SigorConfig& c);
+    };
+    struct VolumeSurge {
+        static constexpr const char* name = "vol";
+        static double weight(const SigorConfig& c) { return c.w_vol; }
+        static double probability(const SigorContext& ctx, const SigorConfig& c);
+    };
+} // namespace sigor
+
+using SigorPipeline = DetectorPipeline<SigorContext, SigorConfig,
+    sigor::Bollinger, sigor::Rsi, sigor::Momentum, sigor::VwapReversion,
+    sigor::OpeningRangeBreakout, sigor::OfiProxy, sigor::VolumeSurge>;
+
 class SigorStrategy : public StrategyComponent {
 public:
     explicit SigorStrategy(const StrategyConfig& config);
     // Optional: set configuration (weights, windows, k)
-    void set_config(const SigorConfig& cfg) { cfg_ = cfg; }
+    void set_config(const SigorConfig& cfg);
+
+    static constexpr size_t HISTORY_CAP = SigorSeries::HISTORY_CAP;
+    int required_lookback() const override { return static_cast<int>(HISTORY_CAP); }
+    bool supports_snapshots() const override { return true; }
 
 protected:
     SignalOutput generate_signal(const Bar& bar, int bar_index) override;
+    SignalRecord generate_record(const Bar& bar, int bar_index) override;
     void update_indicators(const Bar& bar) override;
     bool is_warmed_up() const override;
 
+    std::string config_fingerprint() const override;
+    void save_derived_state(StateWriter& w) const override;
+    bool load_derived_state(StateReader& r) override;
+
 private:
     SigorConfig cfg_;
-    // ---- Rolling series ----
-    std::vector<double> closes_;
-    std::vector<double> highs_;
-    std::vector<double> lows_;
-    std::vector<double> volumes_;
-    std::vector<int64_t> timestamps_;
-    std::vector<double> gains_;
-    std::vector<double> losses_;
-
-    // ---- Detector probabilities ----
-    double prob_bollinger_(const Bar& bar) const;
-    double prob_rsi_14_() const;
-    double prob_momentum_(int window, double scale) const;
-    double prob_vwap_reversion_(int window) const;
-    double prob_orb_daily_(int opening_window_bars) const;
-    double prob_ofi_proxy_(const Bar& bar) const;
-    double prob_volume_surge_scaled_(int window) const;
-
-    // ---- Aggregation & helpers ----
-    double aggregate_probability(double p1, double p2, double p3,
-                                 double p4, double p5, double p6, double p7) const;
-    double calculate_confidence(double p1, double p2, double p3,
-                                double p4, double p5, double p6, double p7) const;
-
-    // Stats helpers
-    double compute_sma(const std::vector<double>& v, int window) const;
-    double compute_stddev(const std::vector<double>& v, int window, double mean) const;
-    double compute_rsi(int window) const;
-    double clamp01(double v) const { return v < 0.0 ? 0.0 : (v > 1.0 ? 1.0 : v); }
+    SigorSeries series_;
 };
 
 } // namespace sentio
-
-
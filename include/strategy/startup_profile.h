@@ -0,0 +1,65 @@
+#pragma once
+
+// =============================================================================
+// Module: strategy/startup_profile.h
+// Purpose: Time-to-first-signal of an ML strategy, and a background warm-up
+//          inference that overlaps with feature warm-up.
+//
+// Core idea:
+// - begin() at the start of initialize(), mark(phase) after each startup
+//   phase (metadata, model load); first_signal() when the first model output
+//   is produced logs one line with every phase and the total.
+// - The first forward pass of a freshly loaded model is slow (lazy
+//   allocation, JIT profiling, page faults on mapped weights). start_warmup()
+//   runs a synthetic forward on a background thread while the strategy is
+//   still consuming warm-up bars; finish_warmup() joins it and must be called
+//   before the strategy's own first forward, which then runs warm.
+// =============================================================================
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sentio {
+
+class StartupProfile {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    StartupProfile() = default;
+    ~StartupProfile() { finish_warmup(); }
+
+    StartupProfile(const StartupProfile&) = delete;
+    StartupProfile& operator=(const StartupProfile&) = delete;
+
+    void begin();
+    void mark(const std::string& phase);
+
+    // Run `warmup` on a background thread (exceptions are logged, not thrown).
+    void start_warmup(std::function<void()> warmup);
+    // Join the warm-up thread; no-op when none is running.
+    void finish_warmup();
+
+    // First model output at `bar_index`: logs the report once.
+    void first_signal(int bar_index);
+
+    bool reported() const { return reported_; }
+    // Microseconds from begin() to the first signal (0 before it).
+    int64_t time_to_first_signal_us() const { return first_signal_us_; }
+    std::string report() const;
+
+private:
+    Clock::time_point start_{};
+    Clock::time_point last_{};
+    std::vector<std::pair<std::string, int64_t>> phases_;   // name, duration us
+    std::thread warmup_;
+    int64_t warmup_us_ = -1;        // written by the warm-up thread, read after join
+    int64_t first_signal_us_ = 0;
+    int first_signal_bar_ = -1;
+    bool reported_ = false;
+};
+
+} // namespace sentio
@@ -9,6 +9,14 @@
 //   emits SignalOutput records once warm-up is complete.
 // - The base class provides the ingest/export orchestration; derived classes
 //   implement indicator updates and signal generation.
+// - The hot path (on_bar / process_records_range) emits compact SignalRecords;
+//   per-run strings live in run_info() and are attached only at export time.
+// - Strategies with bounded rolling state can snapshot it (save_state /
+//   restore_state) so a restarted process resumes at the next bar without a
+//   warm-up replay.
+// - All mutable state is per instance (no function statics, no process-wide
+//   library settings), so independent instances can run on separate threads;
+//   thread budgets come from the instance's ExecutionContext.
 // =============================================================================
 
 #include <vector>
@@ -16,7 +24,10 @@
 #include <string>
 #include <map>
 #include "common/types.h"
+#include "common/state_stream.h"
 #include "signal_output.h"
+#include "signal_sink.h"
+#include "execution_context.h"
 
 namespace sentio {
 
@@ -50,6 +61,40 @@ public:
         uint64_t count = 0  // 0 = process from start_index to end
     );
 
+    // Compact variant of process_dataset_range: one SignalRecord per emitted
+    // bar, strings registered once in run_info().
+    virtual std::vector<SignalRecord> process_records_range(
+        const std::string& dataset_path,
+        const std::string& strategy_name,
+        uint64_t start_index = 0,
+        uint64_t count = 0  // 0 = process from start_index to end
+    );
+
+    // Streaming variant: each record is written to `sink` as it is produced,
+    // so memory does not grow with the number of signals. Calls
+    // sink.begin()/finish(); returns false on load or write failure.
+    virtual bool stream_dataset_range(
+        const std::string& dataset_path,
+        const std::string& strategy_name,
+        SignalSink& sink,
+        uint64_t start_index = 0,
+        uint64_t count = 0  // 0 = process from start_index to end
+    );
+
+    // Feed [start_index, start_index + count) through on_bar() without
+    // emitting, to rebuild rolling state before continuing at the next bar.
+    bool warm_up_range(const std::string& dataset_path,
+                       uint64_t start_index,
+                       uint64_t count);
+
+    // Feed a single bar. Returns true and fills `out` when a signal is emitted
+    // (i.e. after warm-up). Does not allocate for strategies that override
+    // generate_record().
+    bool on_bar(const Bar& bar, int bar_index, SignalRecord& out);
+
+    // Register the strategy name used to tag records emitted by on_bar().
+    void set_run_strategy(const std::string& strategy_name);
+
     // Export signals to file in jsonl or csv format.
     virtual bool export_signals(
         const std::vector<SignalOutput>& signals,
@@ -57,17 +102,91 @@ public:
         const std::string& format = "jsonl"
     );
 
+    // Export compact records (resolved against run_info()) in jsonl, csv or bin format.
+    virtual bool export_records(
+        const std::vector<SignalRecord>& records,
+        const std::string& output_path,
+        const std::string& format = "jsonl"
+    ) const;
+
+    // Number of preceding bars needed to reproduce the strategy's internal
+    // state exactly (bounded history). -1 means unbounded: the strategy cannot
+    // be split into independently warmed-up shards.
+    virtual int required_lookback() const { return -1; }
+    int warmup_bars() const { return config_.warmup_bars; }
+
+    // Compute budget for this instance (threads per inference call). Set
+    // before the first bar; strategies without native parallelism ignore it.
+    void set_execution_context(const ExecutionContext& context) { execution_context_ = context; }
+    const ExecutionContext& execution_context() const { return execution_context_; }
+
+    // Per-run metadata side channel (symbols, strategy ids, run-level metadata).
+    const SignalRunInfo& run_info() const { return run_info_; }
+    SignalRunInfo& run_info() { return run_info_; }
+
+    // State snapshots. Layout:
+    //   [magic][format][name][version][state_version][config hash]
+    //   [bars_processed][last bar index][last bar timestamp]
+    //   [payload size][payload][payload checksum]
+    // restore_state() rejects snapshots taken by a different strategy, state
+    // layout (state_version) or configuration (config_fingerprint) and leaves
+    // the strategy untouched in that case.
+    static constexpr uint32_t SNAPSHOT_MAGIC = 0x534E4150; // "SNAP"
+    static constexpr uint32_t SNAPSHOT_FORMAT_VERSION = 1;
+
+    virtual bool supports_snapshots() const { return false; }
+    bool save_state(std::vector<char>& out) const;
+    bool restore_state(const char* data, size_t size);
+    // File variants; saving writes a temporary file and renames it into place.
+    bool save_state_file(const std::string& path) const;
+    bool load_state_file(const std::string& path);
+
+    // Last bar fed through on_bar() (-1 before the first bar); restored with
+    // the snapshot so callers know where to resume.
+    int last_bar_index() const { return last_bar_index_; }
+    int64_t last_bar_timestamp_ms() const { return last_bar_timestamp_ms_; }
+    int bars_processed() const { return bars_processed_; }
+
+    // Identity of the signals produced for a given bar range (strategy,
+    // version and configuration); part of the strattest result-cache key.
+    std::string result_fingerprint() const { return config_fingerprint(); }
+
+protected:
+    // Snapshot hooks. Bump state_version() whenever the payload layout
+    // changes; config_fingerprint() must cover every setting that shapes the
+    // rolling state or the signal computed from it. load_derived_state()
+    // reads the whole payload and checks r.at_end() before changing
+    // anything, so a rejected payload (trailing bytes included) leaves the
+    // strategy untouched.
+    virtual uint32_t state_version() const { return 1; }
+    virtual std::string config_fingerprint() const;
+    virtual void save_derived_state(StateWriter& /*w*/) const {}
+    virtual bool load_derived_state(StateReader& /*r*/) { return true; }
+
 protected:
     // Hooks for strategy authors to implement
     virtual SignalOutput generate_signal(const Bar& bar, int bar_index);
     virtual void update_indicators(const Bar& bar);
     virtual bool is_warmed_up() const;
 
+    // Compact signal hook used on the hot path. The default adapts
+    // generate_signal(); strategies that care about per-bar cost override it
+    // and build the record directly.
+    virtual SignalRecord generate_record(const Bar& bar, int bar_index);
+
 protected:
     StrategyConfig config_;
     std::vector<Bar> historical_bars_;
     int bars_processed_ = 0;
     bool warmup_complete_ = false;
+    int last_bar_index_ = -1;
+    int64_t last_bar_timestamp_ms_ = 0;
+
+    // Run-level side channel and id of the strategy tag in it
+    SignalRunInfo run_info_;
+    uint16_t strategy_id_ = 0;
+
+    ExecutionContext execution_context_;
 
     // Example internal indicators
     std::vector<double> moving_average_;
@@ -78,5 +197,3 @@ protected:
 // Note: SigorStrategy is defined in `strategy/sigor_strategy.h`.
 
 } // namespace sentio
-
-
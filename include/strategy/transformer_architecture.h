@@ -0,0 +1,30 @@
+#pragma once
+
+// =============================================================================
+// Module: strategy/transformer_architecture.h
+// Purpose: The TransformerModel architecture of the checkpoints
+//          TransformerStrategy runs, in one place.
+//
+// torch::load() restores weights into an already built module, so whoever
+// loads a checkpoint (TransformerStrategy::initialize(), the model server's
+// Transformer backend) must build exactly the architecture it was trained
+// with. Only the input shape comes from the model's metadata.
+// =============================================================================
+
+#include "strategy/transformer_model.h"
+
+namespace sentio {
+
+inline TransformerModelConfig transformer_model_config(int sequence_length, int feature_dim) {
+    return TransformerModelConfig{
+        .feature_dim = feature_dim,
+        .sequence_length = sequence_length,
+        .d_model = 256,
+        .nhead = 8,
+        .num_encoder_layers = 4,
+        .dim_feedforward = 1024,
+        .dropout = 0.1
+    };
+}
+
+} // namespace sentio
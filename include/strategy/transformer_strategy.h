@@ -2,8 +2,13 @@
 
 #include "strategy/ml_strategy_base.h"
 #include "strategy/transformer_model.h"
+#include "strategy/transformer_architecture.h"
 #include "features/unified_feature_engine.h"
+#include "features/feature_store.h"
 #include "common/feature_sequence_manager.h" // NEW: For proper sequence management
+#include "strategy/batched_inference.h"
+#include "ml/remote_model.h"
+#include "strategy/startup_profile.h"
 #include "common/types.h"
 #include <torch/torch.h>
 #include <memory>
@@ -27,6 +32,16 @@ public:
         std::string model_path;
         std::string metadata_path;
         double confidence_threshold = 0.5; // Act on signals with >50% confidence
+        // Precomputed features (features/feature_store.h) for the dataset being
+        // run; rows are read by bar index instead of running the feature engine.
+        std::string feature_store_path;
+        std::string feature_store_dataset;   // dataset the store must be built from
+        // Backtests (stream_dataset_range) evaluate this many windows per
+        // forward pass; 1 runs the model bar by bar.
+        int inference_batch = 512;
+        // Shared model server (tools/model_server) socket: model_path is
+        // evaluated there instead of being loaded in this process.
+        std::string model_server;
     };
 
     explicit TransformerStrategy(const StrategyConfig& base_config, const Config& tfm_config);
@@ -35,6 +50,17 @@ public:
     bool initialize();
     std::string get_name() const { return "Transformer_v2"; }
 
+    // Snapshot: feature engine, normalized sequence window and log throttling
+    bool supports_snapshots() const override { return true; }
+
+    // Historical run with batched inference (see Config::inference_batch);
+    // emits the same records as the per-bar path.
+    bool stream_dataset_range(const std::string& dataset_path,
+                              const std::string& strategy_name,
+                              SignalSink& sink,
+                              uint64_t start_index = 0,
+                              uint64_t count = 0) override;
+
 protected:
     SignalOutput generate_signal(const Bar& bar, int bar_index) override;
     void update_indicators(const Bar& bar) override;
@@ -46,24 +72,58 @@ protected:
     size_t get_sequence_length() const override;
     int get_feature_count() const override;
 
+    std::string config_fingerprint() const override;
+    void save_derived_state(StateWriter& w) const override;
+    bool load_derived_state(StateReader& r) override;
+
 private:
+    // Normalization and shape from the binary sidecar when it is current,
+    // otherwise from the JSON (which refreshes the sidecar)
     bool load_metadata();
+    // Model outputs -> probability/confidence (shared by both inference paths)
+    void apply_prediction(double predicted_return, double log_variance,
+                          double& probability, double& confidence) const;
+    // Evaluate the queued windows and write the held records
+    void flush_inference_batch(DeferredRecordBatch& batch, SignalSink& sink);
     
     Config config_;
     TransformerModelConfig model_config_;
 
     // ✅ UPDATED: Load PyTorch model directly (not TorchScript due to API limitations)
     std::unique_ptr<TransformerModel> pytorch_model_{nullptr};
+    // Set instead of pytorch_model_ when config_.model_server is given
+    std::unique_ptr<ml::RemoteModel> remote_model_{nullptr};
 
     // Use the unified feature engine for consistency
     std::unique_ptr<features::UnifiedFeatureEngine> feature_engine_{nullptr};
+    // Set instead of feature_engine_ when config_.feature_store_path is given
+    std::unique_ptr<features::FeatureStore> feature_store_{nullptr};
     
-    // NEW: Proper sequence management to fix the critical temporal bug
+    // Normalized window of the last sequence_length feature rows
     std::unique_ptr<FeatureSequenceManager> sequence_manager_{nullptr};
     
-    // Feature normalization parameters loaded from metadata
-    torch::Tensor feature_means_;
-    torch::Tensor feature_stds_;
+    // Feature normalization parameters loaded from metadata (applied by the
+    // sequence manager as rows are added)
+    std::vector<float> feature_means_;
+    std::vector<float> feature_stds_;
+
+    // Batched backtest state: windows are queued in batch_inputs_
+    // [inference_batch, seq_len, feature_dim] while inference_batch_ is set
+    DeferredRecordBatch* inference_batch_ = nullptr;
+    torch::Tensor batch_inputs_;
+    bool deferred_ = false;           // the current bar's record was queued
+
+    // Diagnostic log throttling, per instance
+    struct Diagnostics {
+        int calls = 0;
+        int warmup_logged = 0;
+        bool sequence_ready_logged = false;
+        int inference_attempts = 0;
+        int inference_logged = 0;
+    } diag_;
+
+    // Last member: its warm-up thread uses the model and is joined first
+    StartupProfile startup_;
 };
 
 } // namespace sentio
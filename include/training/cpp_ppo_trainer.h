@@ -26,6 +26,7 @@
 #include <torch/script.h>
 #include "common/types.h"
 #include "features/unified_feature_engine.h"  // 🔧 CONSOLIDATED: Use unified 91-feature engine
+#include "features/feature_store.h"
 #include <vector>
 #include <memory>
 #include <string>
@@ -41,6 +42,7 @@ struct CppPpoTrainerConfig {
     // Data parameters
     std::string dataset_path = "data/equities/QQQ_RTH_NH.csv";
     std::string output_dir = "artifacts/PPO/cpp_trained";
+    std::string feature_store_path;     // Precomputed features ("auto" = build/reuse in data/cache/features)
     
     // Model architecture
     int window_size = 30;           // Observation window (matching Kochi)
@@ -142,6 +144,9 @@ public:
         int window_size = 30;
         int max_episode_length = 1000;
         bool enable_action_masking = true;
+        // Precomputed features; market_data[i] is store row feature_store_offset + i
+        const features::FeatureStore* feature_store = nullptr;
+        size_t feature_store_offset = 0;
     };
     
     enum class Action {
@@ -216,6 +221,8 @@ private:
     torch::Tensor create_observation();
     torch::Tensor create_action_mask() const;
     void reset_state();
+    // Append the features of market_data_[index] to the observation buffer once ready
+    void push_features(int index);
 };
 
 /**
@@ -344,6 +351,7 @@ private:
     std::vector<Bar> validation_data_;
     
     // Training components
+    std::unique_ptr<features::FeatureStore> feature_store_;   // outlives the environments
     std::unique_ptr<TradingEnvironment> train_env_;
     std::unique_ptr<TradingEnvironment> val_env_;
     std::unique_ptr<PPOBuffer> buffer_;
@@ -354,6 +362,7 @@ private:
     // Private methods
     bool load_data();
     void split_data();
+    bool open_feature_store();
     bool setup_model();
     bool setup_optimizer();
     
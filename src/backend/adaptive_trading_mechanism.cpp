@@ -14,17 +14,14 @@ MarketState MarketRegimeDetector::analyze_market_state(const Bar& current_bar,
                                                       const SignalOutput& signal) {
     MarketState state;
     
-    // Update price history
-    price_history_.push_back(current_bar.close);
-    if (price_history_.size() > LOOKBACK_PERIOD) {
-        price_history_.erase(price_history_.begin());
-    }
-    
-    // Update volume history
-    volume_history_.push_back(current_bar.volume);
-    if (volume_history_.size() > LOOKBACK_PERIOD) {
-        volume_history_.erase(volume_history_.begin());
+    // Update rolling price/volume state
+    if (!price_history_.empty()) {
+        log_returns_.push(std::log(current_bar.close / price_history_.back()));
     }
+    price_history_.push(current_bar.close);
+    price_trend_.push(current_bar.close);
+    volume_mean_.push(current_bar.volume);
+    last_volume_ = current_bar.volume;
     
     // Calculate market metrics
     state.current_price = current_bar.close;
@@ -47,41 +44,19 @@ MarketState MarketRegimeDetector::analyze_market_state(const Bar& current_bar,
 double MarketRegimeDetector::calculate_volatility() {
     if (price_history_.size() < 2) return 0.1; // Default volatility
     
-    std::vector<double> returns;
-    for (size_t i = 1; i < price_history_.size(); ++i) {
-        double ret = std::log(price_history_[i] / price_history_[i-1]);
-        returns.push_back(ret);
-    }
-    
-    // Calculate standard deviation of returns
-    double mean = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
-    double sq_sum = 0.0;
-    for (double ret : returns) {
-        sq_sum += (ret - mean) * (ret - mean);
-    }
-    
-    return std::sqrt(sq_sum / returns.size()) * std::sqrt(252); // Annualized
+    // Standard deviation of log returns over the window
+    return log_returns_.stddev() * std::sqrt(252); // Annualized
 }
 
 double MarketRegimeDetector::calculate_trend_strength() {
     if (price_history_.size() < 10) return 0.0;
     
     // Linear regression slope over recent prices
-    double n = static_cast<double>(price_history_.size());
-    double sum_x = n * (n - 1) / 2;
-    double sum_y = std::accumulate(price_history_.begin(), price_history_.end(), 0.0);
-    double sum_xy = 0.0;
-    double sum_x2 = n * (n - 1) * (2 * n - 1) / 6;
-    
-    for (size_t i = 0; i < price_history_.size(); ++i) {
-        sum_xy += static_cast<double>(i) * price_history_[i];
-    }
-    
-    double slope = (n * sum_xy - sum_x * sum_y) / (n * sum_x2 - sum_x * sum_x);
+    double slope = price_trend_.value();
     
     // Normalize slope to [-1, 1] range
-    double price_range = *std::max_element(price_history_.begin(), price_history_.end()) -
-                        *std::min_element(price_history_.begin(), price_history_.end());
+    const size_t n = price_history_.size();
+    double price_range = rolling::max_of(price_history_, n, n) - rolling::min_of(price_history_, n, n);
     
     if (price_range > 0) {
         return std::clamp(slope / price_range * 100, -1.0, 1.0);
@@ -91,12 +66,11 @@ double MarketRegimeDetector::calculate_trend_strength() {
 }
 
 double MarketRegimeDetector::calculate_volume_ratio() {
-    if (volume_history_.empty()) return 1.0;
+    if (volume_mean_.size() == 0) return 1.0;
     
-    double current_volume = volume_history_.back();
-    double avg_volume = std::accumulate(volume_history_.begin(), volume_history_.end(), 0.0) / volume_history_.size();
+    double avg_volume = volume_mean_.value();
     
-    return (avg_volume > 0) ? current_volume / avg_volume : 1.0;
+    return (avg_volume > 0) ? last_volume_ / avg_volume : 1.0;
 }
 
 MarketRegime MarketRegimeDetector::classify_market_regime(double volatility, double trend_strength) {
@@ -1,7 +1,16 @@
 #include "cli/strattest_command.h"
 #include "strategy/sigor_strategy.h"
 #include "strategy/sigor_config.h"
+#include "strategy/signal_sink.h"
+#include "strategy/sharded_runner.h"
+#include "strategy/ensemble_strategy.h"
+#include "strategy/native_gru_strategy.h"
+#include "common/bar_feed.h"
+#include "common/latency_stats.h"
+#include "common/result_cache.h"
 #include "common/utils.h"
+#include <atomic>
+#include <csignal>
 #include <iostream>
 #include <filesystem>
 #include <chrono>
@@ -17,6 +26,7 @@
 #ifdef TORCH_AVAILABLE
 #include "strategy/cpp_ppo_strategy.h"
 #include "strategy/transformer_strategy.h"
+#include "features/feature_config_standard.h"
 #endif
 
 // Check if momentum scalper exists
@@ -57,11 +67,11 @@ std::string generate_kst_timestamp() {
 }
 
 /**
- * @brief Generate auto signal filename: <strategy>-<MM-DD-HH-MM-KST>.jsonl
+ * @brief Generate auto signal filename: <strategy>-<MM-DD-HH-MM-KST>.<ext>
  */
-std::string generate_signal_filename(const std::string& strategy) {
+std::string generate_signal_filename(const std::string& strategy, const std::string& format = "jsonl") {
     std::string timestamp = generate_kst_timestamp();
-    return "data/signals/" + strategy + "-" + timestamp + ".jsonl";
+    return "data/signals/" + strategy + "-" + timestamp + sentio::signal_file_extension(format);
 }
 
 int StrattestCommand::execute(const std::vector<std::string>& args) {
@@ -69,16 +79,29 @@ int StrattestCommand::execute(const std::vector<std::string>& args) {
     std::string dataset = get_arg(args, "--dataset");
     const std::string strategy = get_arg(args, "--strategy", "sgo");  // Default changed to sgo
     
-    // Auto-generate output filename based on strategy and timestamp
-    std::string output = generate_signal_filename(strategy);
-    
-    // Ensure signals directory exists
-    std::filesystem::create_directories("data/signals");
-    
     const std::string format = get_arg(args, "--format", "jsonl");
     const std::string config_path = get_arg(args, "--config", "");
     
-    std::cout << "📁 Auto-generated signal file: " << output << std::endl;
+    if (format != "jsonl" && format != "csv" && format != "bin") {
+        std::cerr << "Error: Unknown output format '" << format << "' (expected jsonl, csv or bin)\n";
+        return 1;
+    }
+    
+    // Incremental mode extends a named signal file instead of creating a new one
+    const std::string extend_path = get_arg(args, "--extend", "");
+    std::string output;
+    if (!extend_path.empty()) {
+        output = extend_path;
+        std::cout << "📁 Extending signal file: " << output << std::endl;
+    } else {
+        // Auto-generate output filename based on strategy and timestamp
+        output = generate_signal_filename(strategy, format);
+        
+        // Ensure signals directory exists
+        std::filesystem::create_directories("data/signals");
+        
+        std::cout << "📁 Auto-generated signal file: " << output << std::endl;
+    }
     
     // Show help if requested
     if (has_flag(args, "--help") || has_flag(args, "-h")) {
@@ -100,14 +123,46 @@ int StrattestCommand::execute(const std::vector<std::string>& args) {
         dataset = "data/equities/QQQ_RTH_NH.csv";
     }
     
+    const std::string mode = get_arg(args, "--mode", "historical");
+    if (mode == "live") {
+        if (strategy != "sgo") {
+            std::cerr << "Error: live mode currently supports the sgo strategy only\n";
+            return 1;
+        }
+        // Default feed: the binary twin of the dataset (data/x.csv -> data/x.bin)
+        std::string feed = get_arg(args, "--feed", "");
+        if (feed.empty()) {
+            feed = dataset;
+            if (feed.size() >= 4 && feed.substr(feed.size() - 4) == ".csv") {
+                feed = feed.substr(0, feed.size() - 4) + ".bin";
+            }
+        }
+        return execute_live_mode(feed, output, config_path, args);
+    } else if (mode != "historical") {
+        std::cerr << "Error: Unknown mode '" << mode << "' (expected historical or live)\n";
+        return 1;
+    }
+    
     // Validate parameters
     if (!validate_parameters(dataset, strategy)) {
         return 1;
     }
     
+    if (!extend_path.empty()) {
+        if (strategy != "sgo") {
+            std::cerr << "Error: --extend currently supports the sgo strategy only\n";
+            return 1;
+        }
+        return execute_incremental(dataset, output, config_path, args);
+    }
+    
     // Execute strategy based on type
     if (strategy == "sgo") {
         return execute_sigor_strategy(dataset, output, config_path, args);
+    } else if (strategy == "ens") {
+        return execute_ensemble_strategy(dataset, output, config_path, args);
+    } else if (strategy == "gru") {
+        return execute_gru_strategy(dataset, output, args);
     } else if (strategy == "ppo") {
 #ifdef TORCH_AVAILABLE
         return execute_cpp_ppo_strategy(dataset, output, args);
@@ -131,7 +186,7 @@ int StrattestCommand::execute(const std::vector<std::string>& args) {
 #endif
     } else {
         std::cerr << "Error: Unknown strategy '" << strategy << "'\n";
-        std::cerr << "Available strategies: sgo";
+        std::cerr << "Available strategies: sgo, ens, gru";
 #ifdef TORCH_AVAILABLE
         std::cerr << ", ppo, tfm";
 #endif
@@ -149,18 +204,204 @@ void StrattestCommand::show_help() const {
     std::cout << "Note: Signal files are auto-generated with timestamps for uniqueness.\n\n";
     std::cout << "Options:\n";
     std::cout << "  --dataset PATH     Market data file (default: data/equities/QQQ_RTH_NH.csv)\n";
-    std::cout << "  --strategy NAME    Strategy to use: sgo, ppo, tfm, momentum (default: sgo)\n";
-    std::cout << "  --format FORMAT    Output format: jsonl (default: jsonl)\n";
+    std::cout << "  --strategy NAME    Strategy to use: sgo, ens, gru, ppo, tfm, momentum (default: sgo)\n";
+    std::cout << "  --format FORMAT    Output format: jsonl, csv, bin (default: jsonl)\n";
+    std::cout << "  --async-io         Write signals on a background I/O thread\n";
+    std::cout << "  --shards N         Split the range into N shards processed in parallel (sgo)\n";
+    std::cout << "  --threads N        Threads for sharded mode / ensemble children (default: all cores)\n";
+    std::cout << "  --verify-shards    Check sharded output against a sequential run\n";
     std::cout << "  --config PATH      Strategy configuration file (optional)\n";
     std::cout << "  --blocks N         Number of blocks to process (default: all)\n";
     std::cout << "  --mode MODE        Processing mode: historical, live (default: historical)\n";
+    std::cout << "  --feed SPEC        Live bar feed: growing .bin file or unix:/path.sock\n";
+    std::cout << "                     (default: dataset with .csv replaced by .bin)\n";
+    std::cout << "  --idle-exit-ms N   Live: stop after N ms without new bars (default: run until Ctrl-C)\n";
+    std::cout << "  --poll-us N        Live: file poll interval in microseconds (default: 100)\n";
+    std::cout << "  --save-state PATH  Save a strategy state snapshot at the end of the run (sgo, gru, tfm, ppo)\n";
+    std::cout << "  --resume-state PATH Restore a snapshot and continue after its last bar (sgo, gru, tfm, ppo)\n";
+    std::cout << "  --checkpoint-bars N Live: also save the snapshot every N bars\n";
+    std::cout << "  --ensemble SPEC    Ensemble members as name[=config]:weight,... (default: sgo:1)\n";
+    std::cout << "                     names: sgo (config = SigorConfig file), tfm, ppo\n";
+    std::cout << "  --child-budget-us N Ensemble: per-bar wait for children; late ones are skipped\n";
+    std::cout << "  --batch-bars N     Ensemble: bars per child task in backtests (default: 4096)\n";
+    std::cout << "  --no-cache         Always recompute instead of reusing a cached identical run\n";
+    std::cout << "  --cache-dir PATH   Result cache directory (default: data/cache/signals)\n";
+    std::cout << "  --cache-max-mb N   Result cache size limit, LRU eviction (default: 1024)\n";
+    std::cout << "  --extend PATH      Append signals for bars after the last one in PATH\n";
+    std::cout << "                     (.jsonl, .csv or .sigbin; created if missing) (sgo)\n";
+    std::cout << "  --feature-store P  tfm/ppo: read precomputed features from store P, or \"auto\"\n";
+    std::cout << "                     to build/reuse one in data/cache/features\n";
+    std::cout << "  --inference-batch N  tfm: model windows per forward pass in backtests\n";
+    std::cout << "                     (default: 512, 1 = one forward per bar)\n";
+    std::cout << "  --intra-op-threads N tfm/ppo: threads one inference call may use (default: 1)\n";
+    std::cout << "  --interop-threads N  tfm/ppo/ens: LibTorch inter-op pool size (default: 1)\n";
+    std::cout << "  --cpus LIST        tfm/ppo: pin the strategy thread to CPUs, e.g. 0-7,16;\n";
+    std::cout << "                     ens: split LIST across the children\n";
+    std::cout << "  --model-server P   tfm: evaluate the model in a shared model_server on socket P\n";
+    std::cout << "  --native-model P   gru: LibTorch-free weights (model.native from gru_trainer or\n";
+    std::cout << "                     gru_native_export; default: artifacts/GRU/cpp_trained/model.native)\n";
+    std::cout << "  --native-precision P gru: weight storage fp32, bf16 or int8 (default: fp32)\n";
+    std::cout << "  --resync-interval N gru: step the GRU state per bar, full window every N bars\n";
+    std::cout << "                     (default: 0 = full window every bar)\n";
     std::cout << "  --help, -h         Show this help message\n\n";
     std::cout << "Examples:\n";
     std::cout << "  sentio_cli strattest\n";
     std::cout << "  sentio_cli strattest --strategy momentum --blocks 20\n";
     std::cout << "  sentio_cli strattest --strategy ppo --blocks 20\n";
     std::cout << "  sentio_cli strattest --strategy tfm --blocks 20\n";
+    std::cout << "  sentio_cli strattest --strategy gru --native-model artifacts/GRU/cpp_trained/model.native\n";
     std::cout << "  sentio_cli strattest --dataset data/custom.csv --blocks 10\n";
+    std::cout << "  sentio_cli strattest --blocks 200 --shards 8 --verify-shards\n";
+    std::cout << "  sentio_cli strattest --strategy ens --ensemble sgo:1,tfm:1,ppo:0.5\n";
+    std::cout << "  sentio_cli strattest --extend data/signals/sgo-daily.jsonl\n";
+    std::cout << "  sentio_cli strattest --mode live --feed data/equities/QQQ_live.bin --idle-exit-ms 60000\n";
+}
+
+namespace {
+    sentio::StrategyComponent::StrategyConfig sigor_strategy_config() {
+        sentio::StrategyComponent::StrategyConfig cfg;
+        cfg.name = "sigor";
+        cfg.version = "0.1";
+        cfg.warmup_bars = 20;
+        return cfg;
+    }
+    
+    sentio::StrategyComponent::StrategyConfig native_gru_base_config() {
+        sentio::StrategyComponent::StrategyConfig cfg;
+        cfg.name = "gru";
+        cfg.version = "1.0";
+        cfg.warmup_bars = 0;   // the strategy is neutral until its feature window fills
+        return cfg;
+    }
+    
+#ifdef TORCH_AVAILABLE
+    void transformer_strategy_configs(sentio::StrategyComponent::StrategyConfig& base_cfg,
+                                      sentio::TransformerStrategy::Config& transformer_cfg) {
+        base_cfg.name = "transformer_v2";
+        base_cfg.version = "2.0";
+        base_cfg.warmup_bars = 64; // Transformer requires sequence warmup
+        
+        // 🔧 FIX: Use 2-epoch retrained model with correct 91-feature normalization metadata
+        transformer_cfg.model_path = "artifacts/Transformer/filtered_2epoch/tfm_model.pt";  // ✅ UPDATED: Use 2-epoch retrained model  
+        transformer_cfg.metadata_path = "artifacts/Transformer/filtered_2epoch/tfm_metadata.json";  // ✅ UPDATED: Use correct 91-feature metadata
+        transformer_cfg.confidence_threshold = 0.05;  // 🔧 TEMP: Lowered for comparison testing (was 0.5)
+    }
+    
+    sentio::StrategyComponent::StrategyConfig cpp_ppo_base_config() {
+        sentio::StrategyComponent::StrategyConfig cfg;
+        cfg.name = "cpp_ppo";
+        cfg.version = "1.0";
+        cfg.warmup_bars = 0;   // the strategy is neutral until its observation window fills
+        return cfg;
+    }
+    
+    sentio::CppPpoConfig cpp_ppo_strategy_config() {
+        // C++ PPO strategy with Kochi model
+        sentio::CppPpoConfig config;
+        config.model_path = "kochi/data/PPO_116/real_kochi_model.pt";
+        config.window_size = 30;
+        config.feature_dim = 91;   // 🔧 TFM LESSON: Filtered UnifiedFeatureEngine set (30 x 91 = 2730)
+        config.confidence_threshold = 0.5;
+        config.enable_action_masking = true;
+        return config;
+    }
+    
+    // --feature-store PATH|auto for the ML strategies; "auto" builds or reuses
+    // the standard-feature store of the dataset. Empty on failure.
+    std::string resolve_feature_store(const std::string& spec, const std::string& dataset) {
+        if (spec != "auto") return spec;
+        sentio::features::FeatureStore store;
+        return store.open_or_build(dataset, sentio::features::get_standard_91_feature_config())
+            ? store.path() : "";
+    }
+    
+    // --intra-op-threads / --interop-threads / --cpus for a strategy instance.
+    // The inter-op pool is process-wide and only the first setting counts, so
+    // it is configured here, before any model is loaded. False on a bad --cpus.
+    bool execution_context_from_args(const std::string& intra_op, const std::string& interop,
+                                     const std::string& cpus, sentio::ExecutionContext& context) {
+        sentio::ExecutionContext::Options options;
+        if (!intra_op.empty()) options.intra_op_threads = std::stoi(intra_op);
+        if (!interop.empty()) options.interop_threads = std::stoi(interop);
+        if (!cpus.empty() && !sentio::ExecutionContext::parse_cpu_list(cpus, options.cpus)) {
+            std::cerr << "ERROR: Invalid --cpus list '" << cpus << "' (expected e.g. 0-7,16)" << std::endl;
+            return false;
+        }
+        context = sentio::ExecutionContext(options);
+        sentio::ExecutionContext::configure_process(context.interop_threads());
+        return true;
+    }
+#endif
+    
+    // Build one ensemble member from its spec name ("sgo", "tfm", "ppo").
+    std::unique_ptr<sentio::StrategyComponent> make_ensemble_child(const std::string& name,
+                                                                   const std::string& config_path,
+                                                                   std::string& error) {
+        if (name == "sgo") {
+            sentio::SigorConfig scfg;
+            if (!config_path.empty()) {
+                scfg = sentio::SigorConfig::from_file(config_path);
+            }
+            auto sigor = std::make_unique<sentio::SigorStrategy>(sigor_strategy_config());
+            sigor->set_config(scfg);
+            return sigor;
+        }
+#ifdef TORCH_AVAILABLE
+        if (name == "tfm") {
+            sentio::StrategyComponent::StrategyConfig base_cfg;
+            sentio::TransformerStrategy::Config transformer_cfg;
+            transformer_strategy_configs(base_cfg, transformer_cfg);
+            auto transformer = std::make_unique<sentio::TransformerStrategy>(base_cfg, transformer_cfg);
+            if (!transformer->initialize()) {
+                error = "failed to initialize Transformer strategy";
+                return nullptr;
+            }
+            return transformer;
+        }
+        if (name == "ppo") {
+            auto cpp_ppo = std::make_unique<sentio::CppPpoStrategy>(cpp_ppo_strategy_config());
+            if (!cpp_ppo->initialize()) {
+                error = "failed to initialize C++ PPO strategy";
+                return nullptr;
+            }
+            return cpp_ppo;
+        }
+#endif
+        error = "unknown or unavailable ensemble member '" + name + "'";
+        return nullptr;
+    }
+    
+    std::atomic<bool> g_live_stop{false};
+    void request_live_stop(int) { g_live_stop = true; }
+    
+    // --cache-dir / --cache-max-mb values (empty = default)
+    sentio::ResultCache::Options result_cache_options(const std::string& directory, const std::string& max_mb) {
+        sentio::ResultCache::Options options;
+        if (!directory.empty()) {
+            options.directory = directory;
+        }
+        if (!max_mb.empty()) {
+            options.max_bytes = std::stoull(max_mb) << 20;
+        }
+        return options;
+    }
+    
+    // Everything that determines the bytes of a signal file. Returns false
+    // (no caching) if an input cannot be hashed.
+    bool signal_cache_key(const std::string& dataset,
+                          const sentio::StrategyComponent& strategy,
+                          const std::string& format,
+                          uint64_t start_index,
+                          uint64_t bars_to_process,
+                          sentio::CacheKey& key) {
+        key.add("kind", "strattest-signals");
+        if (!key.add_file("dataset", dataset)) return false;
+        key.add("market_data_path", dataset)
+           .add("strategy", strategy.result_fingerprint())
+           .add("format", format)
+           .add("range", std::to_string(start_index) + "+" + std::to_string(bars_to_process));
+        return true;
+    }
 }
 
 int StrattestCommand::execute_sigor_strategy(const std::string& dataset,
@@ -169,53 +410,139 @@ int StrattestCommand::execute_sigor_strategy(const std::string& dataset,
                                            const std::vector<std::string>& args) {
     try {
         // Initialize Sigor strategy with configuration
-        sentio::StrategyComponent::StrategyConfig cfg;
-        cfg.name = "sigor";
-        cfg.version = "0.1";
-        cfg.warmup_bars = 20;
-        
-        auto sigor = std::make_unique<sentio::SigorStrategy>(cfg);
+        const auto cfg = sigor_strategy_config();
         
         // Load custom configuration if provided
+        sentio::SigorConfig scfg;
         if (!config_path.empty()) {
-            auto scfg = sentio::SigorConfig::from_file(config_path);
-            sigor->set_config(scfg);
+            scfg = sentio::SigorConfig::from_file(config_path);
         }
+        auto make_sigor = [cfg, scfg]() {
+            auto sigor = std::make_unique<sentio::SigorStrategy>(cfg);
+            sigor->set_config(scfg);
+            return sigor;
+        };
+        
+        auto sigor = make_sigor();
+        
+        // Run-level metadata for traceability (attached once, not per signal)
+        sigor->run_info().metadata["market_data_path"] = dataset;
+        
+        uint64_t start_index = 0;
+        uint64_t bars_to_process = 0;  // 0 = full dataset
         
         // Get blocks parameter for performance optimization
         int blocks_to_process = get_blocks_parameter(args);
-        std::vector<sentio::SignalOutput> signals;
-        
         if (blocks_to_process > 0) {
             std::cout << "🔧 Performance mode: Processing only " << blocks_to_process << " blocks (~" << (blocks_to_process * STANDARD_BLOCK_SIZE) << " bars)" << std::endl;
             std::cout << "⚡ Sigor ensemble strategy - fast binary data loading with index-based processing" << std::endl;
             
             // Use index-based processing (no temporary files needed)
             uint64_t total_bars = utils::get_market_data_count(dataset);
-            uint64_t bars_to_process = blocks_to_process * STANDARD_BLOCK_SIZE;
-            uint64_t start_index = (total_bars > bars_to_process) ? (total_bars - bars_to_process) : 0;
-            
-            signals = sigor->process_dataset_range(dataset, cfg.name, {}, start_index, bars_to_process);
-            
-            std::cout << "⚡ Processed " << signals.size() << " signals from range [" << start_index << "-" << (start_index + bars_to_process - 1) << "]" << std::endl;
+            bars_to_process = blocks_to_process * STANDARD_BLOCK_SIZE;
+            start_index = (total_bars > bars_to_process) ? (total_bars - bars_to_process) : 0;
         } else {
             std::cout << "Processing full dataset: " << dataset << std::endl;
-            signals = sigor->process_dataset(dataset, cfg.name, {});
         }
         
-        // Add metadata for traceability
-        for (auto& signal : signals) {
-            signal.metadata["market_data_path"] = dataset;
+        const int shards = std::stoi(get_arg(args, "--shards", "1"));
+        const std::string resume_path = get_arg(args, "--resume-state", "");
+        const std::string save_path = get_arg(args, "--save-state", "");
+        if (shards > 1 && (!resume_path.empty() || !save_path.empty())) {
+            std::cerr << "Error: --resume-state/--save-state require a sequential run (--shards 1)" << std::endl;
+            return 1;
+        }
+        if (!resume_path.empty()) {
+            // Continue right after the snapshot's last bar, no warm-up replay
+            if (!sigor->load_state_file(resume_path)) {
+                std::cerr << "ERROR: Cannot resume from " << resume_path << std::endl;
+                return 1;
+            }
+            start_index = static_cast<uint64_t>(sigor->last_bar_index() + 1);
+            bars_to_process = 0;
+            std::cout << "♻️  Resumed from " << resume_path << " at bar " << start_index << std::endl;
+        }
+        
+        // Identical (dataset, config, range, format) runs are served from the
+        // result cache. Runs with state side effects or verification always compute.
+        sentio::ResultCache cache(result_cache_options(get_arg(args, "--cache-dir"), get_arg(args, "--cache-max-mb")));
+        sentio::CacheKey cache_key;
+        const bool use_cache = !has_flag(args, "--no-cache") && resume_path.empty() && save_path.empty() &&
+                               !has_flag(args, "--verify-shards") &&
+                               signal_cache_key(dataset, *sigor, get_arg(args, "--format", "jsonl"),
+                                                start_index, bars_to_process, cache_key);
+        if (use_cache && cache.fetch(cache_key, output)) {
+            std::cout << "⚡ Result cache hit (" << cache_key.hex() << ")" << std::endl;
+            std::cout << "✅ Exported cached signals to " << output << std::endl;
+            return 0;
+        }
+        
+        auto sink = make_sink(output, args);
+        bool success = false;
+        
+        if (shards > 1) {
+            // Parallel block-sharded execution with lookback warm-up per shard
+            const int threads = std::stoi(get_arg(args, "--threads", "0"));
+            sentio::ShardedRunner runner(make_sigor, threads);
+            runner.run_info().metadata["market_data_path"] = dataset;
+            
+            const bool verify = has_flag(args, "--verify-shards");
+            sentio::MemorySignalSink sharded;   // only used with --verify-shards
+            
+            auto t0 = std::chrono::steady_clock::now();
+            success = runner.run(dataset, cfg.name, verify ? static_cast<sentio::SignalSink&>(sharded) : *sink,
+                                 shards, start_index, bars_to_process);
+            auto sharded_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            std::cout << "⚡ Sharded run: " << shards << " shards in " << std::fixed << std::setprecision(1)
+                      << sharded_ms << " ms" << std::endl;
+            
+            if (success && verify) {
+                // Re-run sequentially (in memory) and compare bit for bit
+                sentio::MemorySignalSink sequential;
+                t0 = std::chrono::steady_clock::now();
+                sigor->stream_dataset_range(dataset, cfg.name, sequential, start_index, bars_to_process);
+                auto sequential_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+                
+                std::string diff;
+                if (!sentio::compare_signal_streams(sharded.records(), runner.run_info(),
+                                                    sequential.records(), sigor->run_info(), &diff)) {
+                    std::cerr << "❌ Shard verification FAILED: " << diff << std::endl;
+                    return 3;
+                }
+                std::cout << "✅ Shard verification passed: " << sequential.count()
+                          << " signals identical to sequential run (sequential " << std::fixed
+                          << std::setprecision(1) << sequential_ms << " ms)" << std::endl;
+                
+                success = sink->begin(runner.run_info());
+                for (const auto& r : sharded.records()) sink->write(r);
+                success = sink->finish() && success;
+            }
+        } else {
+            // Stream signals straight to the output file
+            success = sigor->stream_dataset_range(dataset, cfg.name, *sink, start_index, bars_to_process);
         }
         
-        // Export signals to output file
-        bool success = sigor->export_signals(signals, output, "jsonl");
         if (!success) {
             std::cerr << "ERROR: Failed exporting signals to " << output << std::endl;
             return 2;
         }
         
-        std::cout << "✅ Exported " << signals.size() << " signals to " << output << std::endl;
+        if (!save_path.empty()) {
+            if (!sigor->save_state_file(save_path)) {
+                std::cerr << "ERROR: Failed to save strategy state to " << save_path << std::endl;
+                return 2;
+            }
+            std::cout << "💾 Saved strategy state after bar " << sigor->last_bar_index() << " to " << save_path << std::endl;
+        }
+        
+        if (use_cache) {
+            cache.store(cache_key, output);
+        }
+        
+        if (blocks_to_process > 0) {
+            std::cout << "⚡ Processed " << sink->count() << " signals from range [" << start_index << "-" << (start_index + bars_to_process - 1) << "]" << std::endl;
+        }
+        std::cout << "✅ Exported " << sink->count() << " signals to " << output << std::endl;
         return 0;
         
     } catch (const std::exception& e) {
@@ -224,6 +551,437 @@ int StrattestCommand::execute_sigor_strategy(const std::string& dataset,
     }
 }
 
+int StrattestCommand::execute_ensemble_strategy(const std::string& dataset,
+                                               const std::string& output,
+                                               const std::string& config_path,
+                                               const std::vector<std::string>& args) {
+    try {
+        sentio::StrategyComponent::StrategyConfig cfg;
+        cfg.name = "ensemble";
+        cfg.version = "0.1";
+        cfg.warmup_bars = 0;    // emits once every child has warmed up
+        
+        sentio::EnsembleStrategy::Config ens_cfg;
+        ens_cfg.child_budget_us = std::stoll(get_arg(args, "--child-budget-us", "0"));
+        ens_cfg.batch_bars = static_cast<size_t>(std::stoull(get_arg(args, "--batch-bars", "4096")));
+        auto ensemble = std::make_unique<sentio::EnsembleStrategy>(cfg, ens_cfg);
+        // Process-wide, so before the members load their models
+        sentio::ExecutionContext::configure_process(std::stoi(get_arg(args, "--interop-threads", "1")));
+        
+        // --ensemble name[=config]:weight,...  (--config applies to sgo members without their own)
+        const std::string spec = get_arg(args, "--ensemble", "sgo:1");
+        std::stringstream members(spec);
+        std::string member;
+        while (std::getline(members, member, ',')) {
+            if (member.empty()) continue;
+            double weight = 1.0;
+            const size_t colon = member.rfind(':');
+            std::string name = member.substr(0, colon);
+            if (colon != std::string::npos) {
+                weight = std::stod(member.substr(colon + 1));
+            }
+            std::string member_config = config_path;
+            const size_t eq = name.find('=');
+            if (eq != std::string::npos) {
+                member_config = name.substr(eq + 1);
+                name = name.substr(0, eq);
+            }
+            std::string error;
+            auto child = make_ensemble_child(name, member_config, error);
+            if (!child) {
+                std::cerr << "ERROR: Ensemble member '" << member << "': " << error << std::endl;
+                return 1;
+            }
+            ensemble->add_child(name + "#" + std::to_string(ensemble->child_count()), std::move(child), weight);
+        }
+        if (ensemble->child_count() == 0) {
+            std::cerr << "ERROR: --ensemble lists no members" << std::endl;
+            return 1;
+        }
+        std::vector<int> cpus;
+        if (!get_arg(args, "--cpus").empty() &&
+            !sentio::ExecutionContext::parse_cpu_list(get_arg(args, "--cpus"), cpus)) {
+            std::cerr << "ERROR: Invalid --cpus list '" << get_arg(args, "--cpus") << "'" << std::endl;
+            return 1;
+        }
+        ensemble->partition_threads(std::stoi(get_arg(args, "--threads", "0")), cpus);
+        
+        ensemble->run_info().metadata["market_data_path"] = dataset;
+        ensemble->run_info().metadata["ensemble_members"] = spec;
+        
+        uint64_t start_index = 0;
+        uint64_t bars_to_process = 0;  // 0 = full dataset
+        int blocks_to_process = get_blocks_parameter(args);
+        if (blocks_to_process > 0) {
+            uint64_t total_bars = utils::get_market_data_count(dataset);
+            bars_to_process = blocks_to_process * STANDARD_BLOCK_SIZE;
+            start_index = (total_bars > bars_to_process) ? (total_bars - bars_to_process) : 0;
+        }
+        std::cout << "🧩 Ensemble of " << ensemble->child_count() << " strategies (" << spec << ")"
+                  << (ens_cfg.child_budget_us > 0 ? ", per-bar with child budget" : ", batched") << std::endl;
+        
+        auto sink = make_sink(output, args);
+        auto t0 = std::chrono::steady_clock::now();
+        if (!ensemble->stream_dataset_range(dataset, cfg.name, *sink, start_index, bars_to_process)) {
+            std::cerr << "ERROR: Failed exporting ensemble signals to " << output << std::endl;
+            return 2;
+        }
+        auto elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        
+        std::cout << "⏱️  Per-child latency (" << std::fixed << std::setprecision(1) << elapsed_ms << " ms total):\n"
+                  << ensemble->latency_report();
+        std::cout << "✅ Exported " << sink->count() << " ensemble signals to " << output << std::endl;
+        return 0;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: Ensemble strategy execution failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+int StrattestCommand::execute_incremental(const std::string& dataset,
+                                          const std::string& output,
+                                          const std::string& config_path,
+                                          const std::vector<std::string>& args) {
+    try {
+        const std::string format = sentio::signal_format_from_path(output);
+        if (format.empty()) {
+            std::cerr << "Error: --extend file must end in .jsonl, .csv or .sigbin: " << output << std::endl;
+            return 1;
+        }
+        if (!get_arg(args, "--format").empty() && get_arg(args, "--format") != format) {
+            std::cerr << "Error: --format " << get_arg(args, "--format") << " does not match " << output << std::endl;
+            return 1;
+        }
+        
+        const auto cfg = sigor_strategy_config();
+        sentio::SigorConfig scfg;
+        if (!config_path.empty()) {
+            scfg = sentio::SigorConfig::from_file(config_path);
+        }
+        auto make_sigor = [&cfg, &scfg]() {
+            auto sigor = std::make_unique<sentio::SigorStrategy>(cfg);
+            sigor->set_config(scfg);
+            return sigor;
+        };
+        auto sigor = make_sigor();
+        
+        sentio::SignalFileTail tail;
+        if (!sentio::read_signal_file_tail(output, format, tail)) {
+            std::cerr << "ERROR: Cannot read the last signal of " << output << std::endl;
+            return 1;
+        }
+        
+        const uint64_t total_bars = utils::get_market_data_count(dataset);
+        const uint64_t start_index = tail.empty ? 0 : static_cast<uint64_t>(tail.bar_index + 1);
+        
+        if (!tail.empty) {
+            // The file must describe this dataset: its last bar has to line up
+            auto anchor = utils::read_market_data_range(dataset, static_cast<uint64_t>(tail.bar_index), 1);
+            if (anchor.empty() || anchor[0].timestamp_ms != tail.timestamp_ms) {
+                std::cerr << "ERROR: Last signal of " << output << " (bar " << tail.bar_index
+                          << ") does not match " << dataset << "; refusing to append" << std::endl;
+                return 1;
+            }
+        }
+        if (start_index >= total_bars) {
+            std::cout << "✅ " << output << " is up to date (last bar " << tail.bar_index << ")" << std::endl;
+            return 0;
+        }
+        
+        // Rebuild state for the bars before start_index: snapshot sidecar if it
+        // matches the file, otherwise replay only the strategy's lookback.
+        const std::string state_path = output + ".state";
+        if (!tail.empty) {
+            bool restored = std::filesystem::exists(state_path) &&
+                            sigor->load_state_file(state_path) &&
+                            sigor->last_bar_index() == tail.bar_index;
+            if (restored) {
+                std::cout << "♻️  Restored strategy state from " << state_path << std::endl;
+            } else {
+                sigor = make_sigor();
+                const int lookback = sigor->required_lookback();
+                const uint64_t needed = lookback < 0 ? start_index
+                    : std::min<uint64_t>(start_index, static_cast<uint64_t>(std::max(lookback, sigor->warmup_bars())));
+                if (!sigor->warm_up_range(dataset, start_index - needed, needed)) {
+                    std::cerr << "ERROR: Failed to warm up on bars before " << start_index << std::endl;
+                    return 2;
+                }
+                std::cout << "🔥 Re-warmed on " << needed << " bars before bar " << start_index << std::endl;
+            }
+        }
+        
+        // Binary records carry ids: keep the file's id assignments
+        if (format == "bin" && !tail.empty) {
+            sentio::SignalRunInfo prior;
+            if (!sentio::read_signal_run_info(output, prior)) {
+                std::cerr << "ERROR: Cannot read run info of " << output << std::endl;
+                return 1;
+            }
+            sigor->run_info().symbols = prior.symbols;
+            sigor->run_info().strategies = prior.strategies;
+        }
+        sigor->run_info().metadata["market_data_path"] = dataset;
+        
+        // The file may be a cached result shared with the cache entry
+        if (!sentio::detach_hard_link(output)) {
+            std::cerr << "ERROR: Cannot detach " << output << " from its cached copy" << std::endl;
+            return 1;
+        }
+        
+        sentio::SignalSinkOptions options;
+        options.async_io = has_flag(args, "--async-io");
+        options.append = true;
+        auto sink = sentio::make_signal_sink(format, output, options);
+        
+        auto t0 = std::chrono::steady_clock::now();
+        if (!sigor->stream_dataset_range(dataset, cfg.name, *sink, start_index, 0)) {
+            std::cerr << "ERROR: Failed appending signals to " << output << std::endl;
+            return 2;
+        }
+        auto elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        
+        if (!sigor->save_state_file(state_path)) {
+            std::cerr << "WARNING: Could not save " << state_path << "; next run will re-warm" << std::endl;
+        }
+        
+        std::cout << "✅ Appended " << sink->count() << " signals for bars [" << start_index << "-"
+                  << (total_bars - 1) << "] to " << output << " in " << std::fixed << std::setprecision(1)
+                  << elapsed_ms << " ms" << std::endl;
+        return 0;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: Incremental run failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+int StrattestCommand::execute_live_mode(const std::string& feed_spec,
+                                        const std::string& output,
+                                        const std::string& config_path,
+                                        const std::vector<std::string>& args) {
+    try {
+        const auto cfg = sigor_strategy_config();
+        sentio::SigorConfig scfg;
+        if (!config_path.empty()) {
+            scfg = sentio::SigorConfig::from_file(config_path);
+        }
+        auto sigor = std::make_unique<sentio::SigorStrategy>(cfg);
+        sigor->set_config(scfg);
+        sigor->run_info().metadata["market_data_path"] = feed_spec;
+        
+        const std::string resume_path = get_arg(args, "--resume-state", "");
+        const std::string save_path = get_arg(args, "--save-state", "");
+        const int64_t checkpoint_bars = std::stoll(get_arg(args, "--checkpoint-bars", "0"));
+        if (!resume_path.empty() && !sigor->load_state_file(resume_path)) {
+            std::cerr << "ERROR: Cannot resume from " << resume_path << std::endl;
+            return 1;
+        }
+        const bool resumed = !resume_path.empty();
+        
+        // Only the bars needed to rebuild indicator state are replayed from
+        // history; a restored snapshot needs none.
+        sentio::BinaryFileTailFeed::Options feed_options;
+        feed_options.poll_interval_us = std::stoll(get_arg(args, "--poll-us", "100"));
+        feed_options.max_history = std::max(sigor->required_lookback(), sigor->warmup_bars());
+        if (resumed) {
+            feed_options.resume_index = sigor->last_bar_index() + 1;
+        }
+        auto feed = sentio::make_bar_feed(feed_spec, feed_options);
+        if (!feed->open()) {
+            std::cerr << "ERROR: Cannot open live feed " << feed_spec << std::endl;
+            return 1;
+        }
+        
+        auto sink = make_sink(output, args);
+        sigor->set_run_strategy(cfg.name);
+        if (!sink->begin(sigor->run_info())) {
+            std::cerr << "ERROR: Cannot open " << output << std::endl;
+            return 2;
+        }
+        
+        // Warm up on existing history without emitting
+        sentio::Bar bar;
+        sentio::SignalRecord record;
+        uint64_t index = resumed ? static_cast<uint64_t>(sigor->last_bar_index() + 1) : feed->start_index();
+        const uint64_t history = feed->history_bars();
+        for (uint64_t i = 0; i < history; ++i) {
+            if (feed->next(bar, 0) != sentio::BarFeed::Status::Ready) break;
+            sigor->on_bar(bar, static_cast<int>(index++), record);
+        }
+        if (resumed) {
+            std::cout << "📡 Live mode on " << feed_spec << " (resumed from " << resume_path
+                      << ", emitting from bar " << index << ")" << std::endl;
+        } else {
+            std::cout << "📡 Live mode on " << feed_spec << " (warmed up on " << (index - feed->start_index())
+                      << " bars, emitting from bar " << index << ")" << std::endl;
+        }
+        
+        // Each signal is visible once its burst of bars has been processed: the
+        // sink is flushed when no further bar is buffered (or every
+        // MAX_UNPUBLISHED signals), so a backlog costs a few writes instead of
+        // one per bar. Latency runs from the read that delivered the bar to the
+        // flush that published its signal.
+        g_live_stop = false;
+        auto prev_int = std::signal(SIGINT, request_live_stop);
+        auto prev_term = std::signal(SIGTERM, request_live_stop);
+        
+        const int64_t idle_exit_ms = std::stoll(get_arg(args, "--idle-exit-ms", "0"));
+        constexpr int64_t WAIT_SLICE_US = 50000;   // re-check the stop flag this often
+        constexpr size_t MAX_UNPUBLISHED = 256;
+        sentio::LatencyStats latency;
+        std::vector<sentio::BarFeed::Clock::time_point> unpublished;
+        unpublished.reserve(MAX_UNPUBLISHED);
+        auto last_bar = sentio::BarFeed::Clock::now();
+        int64_t since_checkpoint = 0;
+        bool ok = true;
+        
+        while (!g_live_stop) {
+            auto status = feed->next(bar, WAIT_SLICE_US);
+            if (status == sentio::BarFeed::Status::Ready) {
+                if (sigor->on_bar(bar, static_cast<int>(index), record)) {
+                    sink->write(record);
+                    unpublished.push_back(feed->arrival());
+                }
+                ++index;
+                ++since_checkpoint;
+                if (!unpublished.empty() &&
+                    (!feed->has_buffered() || unpublished.size() >= MAX_UNPUBLISHED)) {
+                    ok = sink->flush() && ok;
+                    const auto published = sentio::BarFeed::Clock::now();
+                    for (const auto& arrival : unpublished) latency.add(arrival, published);
+                    unpublished.clear();
+                    
+                    // Checkpoint only after a flush so the snapshot never
+                    // covers a bar whose signal is not yet on disk
+                    if (checkpoint_bars > 0 && !save_path.empty() && since_checkpoint >= checkpoint_bars) {
+                        ok = sigor->save_state_file(save_path) && ok;
+                        since_checkpoint = 0;
+                    }
+                }
+                last_bar = sentio::BarFeed::Clock::now();
+            } else if (status == sentio::BarFeed::Status::Idle) {
+                if (idle_exit_ms > 0 &&
+                    sentio::BarFeed::Clock::now() - last_bar > std::chrono::milliseconds(idle_exit_ms)) {
+                    std::cout << "⏹  No new bars for " << idle_exit_ms << " ms, stopping" << std::endl;
+                    break;
+                }
+            } else if (status == sentio::BarFeed::Status::Closed) {
+                std::cout << "⏹  Feed closed by producer" << std::endl;
+                break;
+            } else {
+                std::cerr << "ERROR: Live feed error on " << feed_spec << std::endl;
+                ok = false;
+                break;
+            }
+        }
+        
+        std::signal(SIGINT, prev_int);
+        std::signal(SIGTERM, prev_term);
+        ok = sink->finish() && ok;
+        if (!save_path.empty() && sigor->last_bar_index() >= 0) {
+            ok = sigor->save_state_file(save_path) && ok;
+            std::cout << "💾 Saved strategy state after bar " << sigor->last_bar_index() << " to " << save_path << std::endl;
+        }
+        
+        std::cout << "✅ Live run: " << sink->count() << " signals written to " << output << std::endl;
+        if (!latency.empty()) {
+            std::cout << "⏱  Bar-to-signal latency: " << latency.format() << std::endl;
+        }
+        return ok ? 0 : 2;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: Live mode failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+int StrattestCommand::execute_gru_strategy(const std::string& dataset,
+                                          const std::string& output,
+                                          const std::vector<std::string>& args) {
+    try {
+        const auto base_cfg = native_gru_base_config();
+        sentio::NativeGruStrategy::Config gru_cfg;
+        gru_cfg.model_path = get_arg(args, "--native-model", gru_cfg.model_path);
+        gru_cfg.precision = get_arg(args, "--native-precision", gru_cfg.precision);
+        const int resync_interval = std::stoi(get_arg(args, "--resync-interval", "0"));
+        gru_cfg.streaming = resync_interval > 0;
+        if (gru_cfg.streaming) {
+            gru_cfg.resync_interval = resync_interval;
+        }
+        
+        auto gru = std::make_unique<sentio::NativeGruStrategy>(base_cfg, gru_cfg);
+        if (!gru->initialize()) {
+            std::cerr << "ERROR: Failed to initialize the native GRU strategy from " << gru_cfg.model_path << std::endl;
+            std::cerr << "Train with gru_trainer, or convert a model.pt with gru_native_export" << std::endl;
+            return 1;
+        }
+        gru->run_info().metadata["market_data_path"] = dataset;
+        
+        uint64_t start_index = 0;
+        uint64_t bars_to_process = 0;  // 0 = full dataset
+        
+        int blocks_to_process = get_blocks_parameter(args);
+        if (blocks_to_process > 0) {
+            std::cout << "🔧 Performance mode: Processing only " << blocks_to_process << " blocks (~" << (blocks_to_process * STANDARD_BLOCK_SIZE) << " bars)" << std::endl;
+            uint64_t total_bars = utils::get_market_data_count(dataset);
+            bars_to_process = blocks_to_process * STANDARD_BLOCK_SIZE;
+            start_index = (total_bars > bars_to_process) ? (total_bars - bars_to_process) : 0;
+        } else {
+            std::cout << "Processing full dataset: " << dataset << std::endl;
+        }
+        
+        const std::string resume_path = get_arg(args, "--resume-state", "");
+        const std::string save_path = get_arg(args, "--save-state", "");
+        if (!resume_path.empty()) {
+            // Continue right after the snapshot's last bar, no warm-up replay
+            if (!gru->load_state_file(resume_path)) {
+                std::cerr << "ERROR: Cannot resume from " << resume_path << std::endl;
+                return 1;
+            }
+            start_index = static_cast<uint64_t>(gru->last_bar_index() + 1);
+            bars_to_process = 0;
+            std::cout << "♻️  Resumed from " << resume_path << " at bar " << start_index << std::endl;
+        }
+        
+        // Model outputs depend on the weights too
+        sentio::ResultCache cache(result_cache_options(get_arg(args, "--cache-dir"), get_arg(args, "--cache-max-mb")));
+        sentio::CacheKey cache_key;
+        const bool use_cache = !has_flag(args, "--no-cache") && resume_path.empty() && save_path.empty() &&
+                               cache_key.add_file("model", gru_cfg.model_path) &&
+                               signal_cache_key(dataset, *gru, get_arg(args, "--format", "jsonl"),
+                                                start_index, bars_to_process, cache_key);
+        if (use_cache && cache.fetch(cache_key, output)) {
+            std::cout << "⚡ Result cache hit (" << cache_key.hex() << ")" << std::endl;
+            std::cout << "✅ Exported cached native GRU signals to " << output << std::endl;
+            return 0;
+        }
+        
+        auto sink = make_sink(output, args);
+        if (!gru->stream_dataset_range(dataset, base_cfg.name, *sink, start_index, bars_to_process)) {
+            std::cerr << "ERROR: Failed exporting native GRU signals to " << output << std::endl;
+            return 2;
+        }
+        if (!save_path.empty()) {
+            if (!gru->save_state_file(save_path)) {
+                std::cerr << "ERROR: Failed to save strategy state to " << save_path << std::endl;
+                return 2;
+            }
+            std::cout << "💾 Saved strategy state after bar " << gru->last_bar_index() << " to " << save_path << std::endl;
+        }
+        if (use_cache) {
+            cache.store(cache_key, output);
+        }
+        
+        std::cout << "✅ Exported " << sink->count() << " native GRU signals to " << output << std::endl;
+        return 0;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: Native GRU strategy execution failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
 int StrattestCommand::execute_transformer_strategy(const std::string& dataset,
                                                   const std::string& output,
                                                   const std::vector<std::string>& args) {
@@ -231,17 +989,29 @@ int StrattestCommand::execute_transformer_strategy(const std::string& dataset,
     try {
         // Initialize Transformer strategy
         sentio::StrategyComponent::StrategyConfig base_cfg;
-        base_cfg.name = "transformer_v2";
-        base_cfg.version = "2.0";
-        base_cfg.warmup_bars = 64; // Transformer requires sequence warmup
-        
         sentio::TransformerStrategy::Config transformer_cfg;
-        // 🔧 FIX: Use 2-epoch retrained model with correct 91-feature normalization metadata
-        transformer_cfg.model_path = "artifacts/Transformer/filtered_2epoch/tfm_model.pt";  // ✅ UPDATED: Use 2-epoch retrained model  
-        transformer_cfg.metadata_path = "artifacts/Transformer/filtered_2epoch/tfm_metadata.json";  // ✅ UPDATED: Use correct 91-feature metadata
-        transformer_cfg.confidence_threshold = 0.05;  // 🔧 TEMP: Lowered for comparison testing (was 0.5)
+        transformer_strategy_configs(base_cfg, transformer_cfg);
+        const std::string feature_store = get_arg(args, "--feature-store", "");
+        if (!feature_store.empty()) {
+            transformer_cfg.feature_store_path = resolve_feature_store(feature_store, dataset);
+            transformer_cfg.feature_store_dataset = dataset;
+            if (transformer_cfg.feature_store_path.empty()) {
+                std::cerr << "ERROR: Cannot build feature store for " << dataset << std::endl;
+                return 1;
+            }
+        }
+        transformer_cfg.inference_batch = std::max(1, std::stoi(get_arg(args, "--inference-batch", "512")));
+        transformer_cfg.model_server = get_arg(args, "--model-server", "");
+        
+        sentio::ExecutionContext execution;
+        if (!execution_context_from_args(get_arg(args, "--intra-op-threads"), get_arg(args, "--interop-threads"),
+                                         get_arg(args, "--cpus"), execution)) {
+            return 1;
+        }
         
         auto transformer = std::make_unique<sentio::TransformerStrategy>(base_cfg, transformer_cfg);
+        transformer->set_execution_context(execution);
+        std::cout << "Execution resources: " << execution.describe() << std::endl;
         
         // Initialize the strategy (load model)
         std::cout << "Initializing Transformer strategy v2..." << std::endl;
@@ -254,43 +1024,84 @@ int StrattestCommand::execute_transformer_strategy(const std::string& dataset,
         // Process dataset with limited blocks for performance
         std::cout << "Processing dataset with Transformer strategy v2: " << dataset << std::endl;
         
+        // Run-level metadata
+        transformer->run_info().metadata["market_data_path"] = dataset;
+        transformer->run_info().metadata["model_type"] = "Transformer_v2";
+        transformer->run_info().metadata["dual_head"] = "true";
+        transformer->run_info().metadata["uncertainty_estimation"] = "true";
+        
+        uint64_t start_index = 0;
+        uint64_t bars_to_process = 0;  // 0 = full dataset
+        
         // Get blocks parameter for performance optimization
         int blocks_to_process = get_blocks_parameter(args);
-        std::vector<sentio::SignalOutput> signals;
-        
         if (blocks_to_process > 0) {
             std::cout << "🔧 Performance mode: Processing only " << blocks_to_process << " blocks (~" << (blocks_to_process * STANDARD_BLOCK_SIZE) << " bars)" << std::endl;
             std::cout << "⚡ Transformer v2 with dual-head architecture - fast inference with uncertainty estimation" << std::endl;
             
             // Use index-based processing (no temporary files needed)
             uint64_t total_bars = utils::get_market_data_count(dataset);
-            uint64_t bars_to_process = blocks_to_process * STANDARD_BLOCK_SIZE;
-            uint64_t start_index = (total_bars > bars_to_process) ? (total_bars - bars_to_process) : 0;
-            
-            signals = transformer->process_dataset_range(dataset, base_cfg.name, {}, start_index, bars_to_process);
-            
-            std::cout << "⚡ Processed " << signals.size() << " signals from range [" << start_index << "-" << (start_index + bars_to_process - 1) << "]" << std::endl;
+            bars_to_process = blocks_to_process * STANDARD_BLOCK_SIZE;
+            start_index = (total_bars > bars_to_process) ? (total_bars - bars_to_process) : 0;
         } else {
             std::cout << "⚠️  Processing full dataset - this will take a long time with transformer!" << std::endl;
-            signals = transformer->process_dataset(dataset, base_cfg.name, {});
         }
         
-        // Add metadata
-        for (auto& signal : signals) {
-            signal.metadata["market_data_path"] = dataset;
-            signal.metadata["model_type"] = "Transformer_v2";
-            signal.metadata["dual_head"] = "true";
-            signal.metadata["uncertainty_estimation"] = "true";
+        const std::string resume_path = get_arg(args, "--resume-state", "");
+        const std::string save_path = get_arg(args, "--save-state", "");
+        if (!resume_path.empty()) {
+            // Continue right after the snapshot's last bar, no warm-up replay
+            if (!transformer->load_state_file(resume_path)) {
+                std::cerr << "ERROR: Cannot resume from " << resume_path << std::endl;
+                return 1;
+            }
+            start_index = static_cast<uint64_t>(transformer->last_bar_index() + 1);
+            bars_to_process = 0;
+            std::cout << "♻️  Resumed from " << resume_path << " at bar " << start_index << std::endl;
+        }
+        
+        // Model outputs depend on the weights and normalization metadata too
+        sentio::ResultCache cache(result_cache_options(get_arg(args, "--cache-dir"), get_arg(args, "--cache-max-mb")));
+        sentio::CacheKey cache_key;
+        // Batched forwards may round differently from one-window forwards
+        cache_key.add("inference_batch", std::to_string(transformer_cfg.inference_batch));
+        // ... and so may intra-op parallel reductions
+        cache_key.add("intra_op_threads", std::to_string(execution.intra_op_threads()));
+        // ... and so may the server's micro-batches, which mix in other clients' windows
+        if (!transformer_cfg.model_server.empty()) {
+            cache_key.add("model_server", "1");
+        }
+        const bool use_cache = !has_flag(args, "--no-cache") && resume_path.empty() && save_path.empty() &&
+                               cache_key.add_file("model", transformer_cfg.model_path) &&
+                               cache_key.add_file("model_metadata", transformer_cfg.metadata_path) &&
+                               (transformer_cfg.feature_store_path.empty() ||
+                                cache_key.add_file("feature_store", transformer_cfg.feature_store_path)) &&
+                               signal_cache_key(dataset, *transformer, get_arg(args, "--format", "jsonl"),
+                                                start_index, bars_to_process, cache_key);
+        if (use_cache && cache.fetch(cache_key, output)) {
+            std::cout << "⚡ Result cache hit (" << cache_key.hex() << ")" << std::endl;
+            std::cout << "✅ Exported cached Transformer v2 signals to " << output << std::endl;
+            return 0;
         }
         
-        // Export signals
-        bool success = transformer->export_signals(signals, output, "jsonl");
+        auto sink = make_sink(output, args);
+        bool success = transformer->stream_dataset_range(dataset, base_cfg.name, *sink, start_index, bars_to_process);
         if (!success) {
             std::cerr << "ERROR: Failed exporting transformer signals to " << output << std::endl;
             return 2;
         }
+        if (!save_path.empty()) {
+            if (!transformer->save_state_file(save_path)) {
+                std::cerr << "ERROR: Failed to save strategy state to " << save_path << std::endl;
+                return 2;
+            }
+            std::cout << "💾 Saved strategy state after bar " << transformer->last_bar_index() << " to " << save_path << std::endl;
+        }
+        if (use_cache) {
+            cache.store(cache_key, output);
+        }
         
-        std::cout << "✅ Exported " << signals.size() << " Transformer v2 signals to " << output << std::endl;
+        std::cout << "✅ Exported " << sink->count() << " Transformer v2 signals to " << output << std::endl;
         return 0;
         
     } catch (const std::exception& e) {
@@ -316,24 +1127,20 @@ int StrattestCommand::execute_momentum_strategy(const std::string& dataset,
         
         auto momentum = std::make_unique<sentio::MomentumScalper>(cfg);
         
-        // Process dataset
-        std::cout << "Processing dataset with Momentum Scalper: " << dataset << std::endl;
-        auto signals = momentum->process_dataset(dataset, cfg.name, {});
-        
-        // Add metadata
-        for (auto& signal : signals) {
-            signal.metadata["market_data_path"] = dataset;
-            signal.metadata["strategy_type"] = "momentum_scalper";
-        }
+        // Run-level metadata
+        momentum->run_info().metadata["market_data_path"] = dataset;
+        momentum->run_info().metadata["strategy_type"] = "momentum_scalper";
         
-        // Export signals
-        bool success = momentum->export_signals(signals, output, "jsonl");
+        // Process dataset, streaming signals to the output file
+        std::cout << "Processing dataset with Momentum Scalper: " << dataset << std::endl;
+        auto sink = make_sink(output, args);
+        bool success = momentum->stream_dataset_range(dataset, cfg.name, *sink);
         if (!success) {
             std::cerr << "ERROR: Failed exporting momentum signals to " << output << std::endl;
             return 2;
         }
         
-        std::cout << "✅ Exported " << signals.size() << " momentum signals to " << output << std::endl;
+        std::cout << "✅ Exported " << sink->count() << " momentum signals to " << output << std::endl;
         return 0;
         
     } catch (const std::exception& e) {
@@ -363,16 +1170,34 @@ bool StrattestCommand::validate_parameters(const std::string& dataset,
     }
     
     // Validate strategy name
-        if (strategy != "sgo" && strategy != "ppo" && strategy != "tfm" &&
+        if (strategy != "sgo" && strategy != "ens" && strategy != "gru" && strategy != "ppo" && strategy != "tfm" &&
             strategy != "momentum" && strategy != "scalper") {
             std::cerr << "Error: Invalid strategy '" << strategy << "'" << std::endl;
-            std::cerr << "Available strategies: sgo, ppo, tfm, momentum" << std::endl;
+            std::cerr << "Available strategies: sgo, ens, gru, ppo, tfm, momentum" << std::endl;
             return false;
         }
     
     return true;
 }
 
+std::unique_ptr<sentio::SignalSink> StrattestCommand::make_sink(const std::string& output,
+                                                               const std::vector<std::string>& args) const {
+    // Auto-generated names can repeat within a minute; never truncate a file
+    // that shares its inode with a result-cache entry.
+    std::error_code ec;
+    if (std::filesystem::exists(output, ec) && std::filesystem::hard_link_count(output, ec) > 1) {
+        std::filesystem::remove(output, ec);
+    }
+    
+    sentio::SignalSinkOptions options;
+    options.async_io = has_flag(args, "--async-io");
+    auto sink = sentio::make_signal_sink(get_arg(args, "--format", "jsonl"), output, options);
+    if (!sink) {
+        throw std::runtime_error("unsupported output format for " + output);
+    }
+    return sink;
+}
+
 int StrattestCommand::get_blocks_parameter(const std::vector<std::string>& args) const {
     for (size_t i = 0; i < args.size(); ++i) {
         if (args[i] == "--blocks" && i + 1 < args.size()) {
@@ -390,23 +1215,29 @@ int StrattestCommand::execute_cpp_ppo_strategy(const std::string& dataset,
     std::cout << "🤖 Executing C++ PPO Strategy" << std::endl;
     std::cout << "==============================" << std::endl;
     
-    // Parse blocks parameter
-    int blocks_to_process = get_blocks_parameter(args);
-    
-    // TODO: Update PPO strategy to use index-based processing like other strategies
-    std::cout << "⚠️  PPO strategy still uses full dataset processing (not optimized)" << std::endl;
-    
     try {
         // Initialize C++ PPO strategy with Kochi model
-        sentio::CppPpoConfig config;
-        config.model_path = "kochi/data/PPO_116/real_kochi_model.pt";
-        config.window_size = 30;
-        config.feature_dim = 91;   // 🔧 TFM LESSON: Filtered UnifiedFeatureEngine set (30 x 91 = 2730)
-        config.confidence_threshold = 0.5;
-        config.enable_action_masking = true;
-        config.enable_debug = true;   // Enable for testing
+        const auto base_cfg = cpp_ppo_base_config();
+        sentio::CppPpoConfig config = cpp_ppo_strategy_config();
+        const std::string feature_store = get_arg(args, "--feature-store", "");
+        if (!feature_store.empty()) {
+            config.feature_store_path = resolve_feature_store(feature_store, dataset);
+            config.feature_store_dataset = dataset;
+            if (config.feature_store_path.empty()) {
+                std::cerr << "❌ Cannot build feature store for " << dataset << std::endl;
+                return 1;
+            }
+        }
+        
+        sentio::ExecutionContext execution;
+        if (!execution_context_from_args(get_arg(args, "--intra-op-threads"), get_arg(args, "--interop-threads"),
+                                         get_arg(args, "--cpus"), execution)) {
+            return 1;
+        }
         
-        auto cpp_ppo = std::make_unique<sentio::CppPpoStrategy>(config);
+        auto cpp_ppo = std::make_unique<sentio::CppPpoStrategy>(base_cfg, config);
+        cpp_ppo->set_execution_context(execution);
+        std::cout << "   Execution resources: " << execution.describe() << std::endl;
         
         // Initialize strategy
         if (!cpp_ppo->initialize()) {
@@ -420,145 +1251,92 @@ int StrattestCommand::execute_cpp_ppo_strategy(const std::string& dataset,
         std::cout << "   Feature dimensions: " << config.feature_dim << std::endl;
         std::cout << "   Action masking: " << (config.enable_action_masking ? "enabled" : "disabled") << std::endl;
         
-        // Load market data
-        std::cout << "\n📊 Loading market data..." << std::endl;
-        std::ifstream file(dataset);
-        if (!file.is_open()) {
-            std::cerr << "❌ Failed to open dataset: " << dataset << std::endl;
-            return 1;
-        }
+        // Run-level metadata (per-bar action/probability strings are not exported)
+        cpp_ppo->run_info().metadata["market_data_path"] = dataset;
+        cpp_ppo->run_info().metadata["model_type"] = "CppPPO";
         
-        std::vector<sentio::Bar> bars;
-        std::string line;
-        std::getline(file, line); // Skip header
+        uint64_t start_index = 0;
+        uint64_t bars_to_process = 0;  // 0 = full dataset
         
-        while (std::getline(file, line)) {
-            if (line.empty()) continue;
-            
-            std::istringstream ss(line);
-            std::string token;
-            
-            sentio::Bar bar;
-            
-            // Parse CSV: ts_utc,open,high,low,close,volume
-            std::getline(ss, token, ',');
-            bar.timestamp_ms = std::stoull(token) * 1000; // Convert to milliseconds
-            
-            std::getline(ss, token, ',');
-            bar.open = std::stod(token);
-            
-            std::getline(ss, token, ',');
-            bar.high = std::stod(token);
-            
-            std::getline(ss, token, ',');
-            bar.low = std::stod(token);
-            
-            std::getline(ss, token, ',');
-            bar.close = std::stod(token);
-            
-            std::getline(ss, token, ',');
-            bar.volume = std::stod(token);
-            
-            bars.push_back(bar);
+        int blocks_to_process = get_blocks_parameter(args);
+        if (blocks_to_process > 0) {
+            std::cout << "🔧 Performance mode: Processing only " << blocks_to_process << " blocks (~" << (blocks_to_process * STANDARD_BLOCK_SIZE) << " bars)" << std::endl;
+            uint64_t total_bars = utils::get_market_data_count(dataset);
+            bars_to_process = blocks_to_process * STANDARD_BLOCK_SIZE;
+            start_index = (total_bars > bars_to_process) ? (total_bars - bars_to_process) : 0;
+        } else {
+            std::cout << "Processing full dataset: " << dataset << std::endl;
+        }
+        
+        const std::string resume_path = get_arg(args, "--resume-state", "");
+        const std::string save_path = get_arg(args, "--save-state", "");
+        if (!resume_path.empty()) {
+            // Continue right after the snapshot's last bar, no warm-up replay
+            if (!cpp_ppo->load_state_file(resume_path)) {
+                std::cerr << "ERROR: Cannot resume from " << resume_path << std::endl;
+                return 1;
+            }
+            start_index = static_cast<uint64_t>(cpp_ppo->last_bar_index() + 1);
+            bars_to_process = 0;
+            std::cout << "♻️  Resumed from " << resume_path << " at bar " << start_index << std::endl;
         }
-        file.close();
         
-        std::cout << "✅ Loaded " << bars.size() << " bars from dataset" << std::endl;
+        // Model outputs depend on the weights too
+        sentio::ResultCache cache(result_cache_options(get_arg(args, "--cache-dir"), get_arg(args, "--cache-max-mb")));
+        sentio::CacheKey cache_key;
+        cache_key.add("intra_op_threads", std::to_string(execution.intra_op_threads()));
+        const bool use_cache = !has_flag(args, "--no-cache") && resume_path.empty() && save_path.empty() &&
+                               cache_key.add_file("model", config.model_path) &&
+                               (config.feature_store_path.empty() ||
+                                cache_key.add_file("feature_store", config.feature_store_path)) &&
+                               signal_cache_key(dataset, *cpp_ppo, get_arg(args, "--format", "jsonl"),
+                                                start_index, bars_to_process, cache_key);
+        if (use_cache && cache.fetch(cache_key, output)) {
+            std::cout << "⚡ Result cache hit (" << cache_key.hex() << ")" << std::endl;
+            std::cout << "✅ Exported cached PPO signals to " << output << std::endl;
+            return 0;
+        }
         
-        // Generate signals
+        // Stream signals straight to the output file
         std::cout << "\n🔄 Generating PPO signals..." << std::endl;
         auto start_time = std::chrono::high_resolution_clock::now();
-        
-        std::vector<sentio::SignalOutput> signals;
-        signals.reserve(bars.size());
-        
-        int processed_bars = 0;
-        int progress_interval = std::max(1, static_cast<int>(bars.size()) / 20); // 5% intervals
-        
-        for (size_t i = 0; i < bars.size(); ++i) {
-            sentio::SignalOutput signal = cpp_ppo->generate_signal(bars[i], static_cast<int>(i));
-            signals.push_back(signal);
-            
-            processed_bars++;
-            if (processed_bars % progress_interval == 0) {
-                double progress = (static_cast<double>(processed_bars) / bars.size()) * 100.0;
-                std::cout << "  📈 Progress: " << std::fixed << std::setprecision(1) 
-                         << progress << "% (" << processed_bars << "/" << bars.size() << " bars)" << std::endl;
-            }
+        auto sink = make_sink(output, args);
+        if (!cpp_ppo->stream_dataset_range(dataset, base_cfg.name, *sink, start_index, bars_to_process)) {
+            std::cerr << "ERROR: Failed exporting PPO signals to " << output << std::endl;
+            return 2;
         }
-        
         auto end_time = std::chrono::high_resolution_clock::now();
         auto inference_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
-        
-        std::cout << "✅ Generated " << signals.size() << " PPO signals" << std::endl;
-        std::cout << "⏱️  Total inference time: " << inference_time << "ms" << std::endl;
-        std::cout << "🚀 Average time per bar: " << std::fixed << std::setprecision(2) 
-                 << (static_cast<double>(inference_time) / bars.size()) << "ms" << std::endl;
-        
-        // Save signals to JSONL file
-        std::cout << "\n💾 Saving signals to: " << output << std::endl;
-        std::ofstream output_file(output);
-        if (!output_file.is_open()) {
-            std::cerr << "❌ Failed to create output file: " << output << std::endl;
-            return 1;
-        }
-        
-        for (const auto& signal : signals) {
-            // Create JSON object
-            std::ostringstream json_line;
-            json_line << "{";
-            json_line << "\"timestamp_ms\":" << signal.timestamp_ms << ",";
-            json_line << "\"bar_index\":" << signal.bar_index << ",";
-            json_line << "\"probability\":" << std::fixed << std::setprecision(6) << signal.probability << ",";
-            json_line << "\"confidence\":" << std::fixed << std::setprecision(6) << signal.confidence;
-            
-            // Add metadata
-            for (const auto& [key, value] : signal.metadata) {
-                json_line << ",\"" << key << "\":\"" << value << "\"";
+        if (!save_path.empty()) {
+            if (!cpp_ppo->save_state_file(save_path)) {
+                std::cerr << "ERROR: Failed to save strategy state to " << save_path << std::endl;
+                return 2;
             }
-            
-            json_line << "}";
-            output_file << json_line.str() << std::endl;
+            std::cout << "💾 Saved strategy state after bar " << cpp_ppo->last_bar_index() << " to " << save_path << std::endl;
         }
-        output_file.close();
-        
-        std::cout << "✅ Signals saved successfully" << std::endl;
-        
-        // Performance statistics
-        std::cout << "\n📊 PPO Strategy Performance Statistics:" << std::endl;
-        std::cout << "  🎯 Total signals generated: " << signals.size() << std::endl;
-        std::cout << "  ⚡ Average inference time: " << std::fixed << std::setprecision(2) 
-                 << (static_cast<double>(inference_time) / signals.size()) << "ms per signal" << std::endl;
-        
-        // Signal distribution analysis
-        int buy_signals = 0, sell_signals = 0, hold_signals = 0;
-        double avg_confidence = 0.0;
-        
-        for (const auto& signal : signals) {
-            avg_confidence += signal.confidence;
-            
-            // Analyze action from metadata
-            auto action_it = signal.metadata.find("ppo_action");
-            if (action_it != signal.metadata.end()) {
-                if (action_it->second == "BUY") buy_signals++;
-                else if (action_it->second == "SELL") sell_signals++;
-                else if (action_it->second == "HOLD") hold_signals++;
-            }
+        if (use_cache) {
+            cache.store(cache_key, output);
         }
         
-        avg_confidence /= signals.size();
-        
-        std::cout << "  📈 Signal distribution:" << std::endl;
-        std::cout << "    • BUY signals: " << buy_signals << " (" 
-                 << std::fixed << std::setprecision(1) << (100.0 * buy_signals / signals.size()) << "%)" << std::endl;
-        std::cout << "    • SELL signals: " << sell_signals << " (" 
-                 << std::fixed << std::setprecision(1) << (100.0 * sell_signals / signals.size()) << "%)" << std::endl;
-        std::cout << "    • HOLD signals: " << hold_signals << " (" 
-                 << std::fixed << std::setprecision(1) << (100.0 * hold_signals / signals.size()) << "%)" << std::endl;
-        std::cout << "  🎯 Average confidence: " << std::fixed << std::setprecision(3) << avg_confidence << std::endl;
-        
-        std::cout << "\n🎉 C++ PPO strategy execution completed successfully!" << std::endl;
+        const size_t signals = sink->count();
+        std::cout << "✅ Exported " << signals << " PPO signals to " << output << std::endl;
+        std::cout << "⏱️  Total run time: " << inference_time << "ms" << std::endl;
+        if (signals == 0) {
+            return 0;
+        }
+        std::cout << "🚀 Average time per bar: " << std::fixed << std::setprecision(3)
+                  << (static_cast<double>(inference_time) / signals) << "ms" << std::endl;
         
+        // Action distribution over the bars the actor ran on
+        const auto& actions = cpp_ppo->action_counts();
+        const int acted = actions[0] + actions[1] + actions[2];
+        std::cout << "  📈 Action distribution (" << acted << " decisions, "
+                  << cpp_ppo->total_trades() << " simulated trades):" << std::endl;
+        const char* names[] = {"SELL", "HOLD", "BUY"};
+        for (int i : {2, 0, 1}) {
+            std::cout << "    • " << names[i] << ": " << actions[i] << " (" << std::fixed << std::setprecision(1)
+                      << (acted > 0 ? 100.0 * actions[i] / acted : 0.0) << "%)" << std::endl;
+        }
         return 0;
         
     } catch (const std::exception& e) {
@@ -2,6 +2,7 @@
 #include "training/quality_enforced_loss.h"
 #include "common/utils.h"
 #include "features/unified_feature_engine.h"
+#include "features/feature_store.h"
 #include "common/types.h"
 #include <torch/torch.h>
 #include <iostream>
@@ -22,11 +23,15 @@ struct RealMarketDataLoader {
     int batch_size = 64;
     int current_pos = 0;
     
-    RealMarketDataLoader(const std::string& data_path, int sequence_length = 50, double train_split = 0.8) {
-        load_and_process_data(data_path, sequence_length, train_split);
+    // feature_store_path: precomputed features for data_path ("auto" = build
+    // or reuse the store in data/cache/features), empty to run the engine here
+    RealMarketDataLoader(const std::string& data_path, int sequence_length = 50, double train_split = 0.8,
+                         const std::string& feature_store_path = "") {
+        load_and_process_data(data_path, sequence_length, train_split, feature_store_path);
     }
     
-    void load_and_process_data(const std::string& data_path, int sequence_length, double train_split) {
+    void load_and_process_data(const std::string& data_path, int sequence_length, double train_split,
+                               const std::string& feature_store_path = "") {
         // Load QQQ market data
         std::cout << "Loading market data from: " << data_path << std::endl;
         auto bars = sentio::utils::read_csv_data(data_path);
@@ -42,17 +47,35 @@ struct RealMarketDataLoader {
         sentio::features::UnifiedFeatureEngine::Config config;
         sentio::features::UnifiedFeatureEngine feature_engine(config);
         
+        // Precomputed features replace the engine entirely
+        sentio::features::FeatureStore store;
+        if (!feature_store_path.empty()) {
+            const bool opened = feature_store_path == "auto"
+                ? store.open_or_build(data_path, config)
+                : store.open(feature_store_path) && store.matches(config, data_path);
+            if (!opened || store.rows() != bars.size()) {
+                std::cerr << "ERROR: Feature store does not match " << data_path << ": " << feature_store_path << std::endl;
+                return;
+            }
+            std::cout << "Reading features from store: " << store.path() << std::endl;
+        }
+        
         std::vector<std::vector<double>> all_features;
         std::vector<double> all_returns;
         
         // Process each bar and generate features
         std::cout << "Processing bars and generating features..." << std::endl;
         for (size_t i = 0; i < bars.size(); ++i) {
-            feature_engine.update(bars[i]);
+            const float* row = nullptr;
+            if (store.is_open()) {
+                if (store.is_ready(i)) row = store.row(i);
+            } else {
+                feature_engine.update(bars[i]);
+                if (feature_engine.is_ready()) row = feature_engine.features();
+            }
             
-            if (feature_engine.is_ready()) {
-                auto features = feature_engine.get_features();
-                all_features.push_back(features);
+            if (row) {
+                all_features.emplace_back(row, row + feature_engine.feature_count());
                 
                 // Create target: next bar's return (close price change)
                 if (i + 1 < bars.size()) {
@@ -159,6 +182,7 @@ int main(int argc, char** argv) {
     double learning_rate = 1e-4;
     double dropout_rate = 0.1;
     int sequence_length = 50;
+    std::string feature_store_path;   // PATH or "auto"
     
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
@@ -172,6 +196,8 @@ int main(int argc, char** argv) {
             dropout_rate = std::stod(argv[++i]);
         } else if (arg == "--sequence" && i + 1 < argc) {
             sequence_length = std::stoi(argv[++i]);
+        } else if (arg == "--feature-store" && i + 1 < argc) {
+            feature_store_path = argv[++i];
         }
     }
     
@@ -181,9 +207,12 @@ int main(int argc, char** argv) {
     std::cout << "  Learning Rate: " << learning_rate << std::endl;
     std::cout << "  Dropout: " << dropout_rate << std::endl;
     std::cout << "  Sequence Length: " << sequence_length << std::endl;
+    if (!feature_store_path.empty()) {
+        std::cout << "  Feature Store: " << feature_store_path << std::endl;
+    }
     
     // --- Load Real Market Data ---
-    RealMarketDataLoader data_loader(data_path, sequence_length, 0.8);
+    RealMarketDataLoader data_loader(data_path, sequence_length, 0.8, feature_store_path);
     
     if (data_loader.size() == 0) {
         std::cerr << "❌ Failed to load market data. Exiting." << std::endl;
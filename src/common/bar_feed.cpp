@@ -0,0 +1,239 @@
+#include "common/bar_feed.h"
+#include <cstring>
+#include "common/binary_data.h"
+#include "common/utils.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace sentio {
+
+namespace {
+    constexpr size_t FEED_BUFFER_BYTES = 64 * 1024;
+    constexpr size_t FRAME_BYTES = sizeof(binary_data::BinaryBar);
+}
+
+// =============================================================================
+// BarFeed (framing shared by all sources)
+// =============================================================================
+
+BarFeed::~BarFeed() = default;
+
+void BarFeed::close() {}
+
+void BarFeed::reset_stream(bool expect_header) {
+    buffer_.resize(FEED_BUFFER_BYTES);
+    begin_ = 0;
+    end_ = 0;
+    header_done_ = !expect_header;
+    bars_read_ = 0;
+}
+
+bool BarFeed::has_buffered() const {
+    return header_done_ && end_ - begin_ >= FRAME_BYTES;
+}
+
+bool BarFeed::parse_header() {
+    binary_data::BinaryHeader header;
+    std::memcpy(&header, buffer_.data() + begin_, sizeof(header));
+    if (header.magic != binary_data::BINARY_DATA_MAGIC ||
+        header.version != binary_data::BINARY_DATA_VERSION) {
+        utils::log_error("BarFeed: stream does not start with a binary_data header");
+        return false;
+    }
+    header.symbol[sizeof(header.symbol) - 1] = '\0';
+    symbol_ = header.symbol;
+    begin_ += sizeof(header);
+    header_done_ = true;
+    return true;
+}
+
+BarFeed::Status BarFeed::next(Bar& bar, int64_t timeout_us) {
+    for (;;) {
+        const size_t avail = end_ - begin_;
+        if (!header_done_) {
+            if (avail >= sizeof(binary_data::BinaryHeader)) {
+                if (!parse_header()) return Status::Error;
+                continue;
+            }
+        } else if (avail >= FRAME_BYTES) {
+            binary_data::BinaryBar frame;
+            std::memcpy(&frame, buffer_.data() + begin_, FRAME_BYTES);
+            begin_ += FRAME_BYTES;
+            bar = frame.to_bar(symbol_);
+            ++bars_read_;
+            return Status::Ready;
+        }
+
+        // Keep the partial frame and refill behind it
+        if (begin_ > 0) {
+            std::memmove(buffer_.data(), buffer_.data() + begin_, avail);
+            begin_ = 0;
+            end_ = avail;
+        }
+        long n = read_some(buffer_.data() + end_, buffer_.size() - end_, timeout_us);
+        if (n == 0) return Status::Idle;
+        if (n == -1) return Status::Closed;
+        if (n < 0) return Status::Error;
+        end_ += static_cast<size_t>(n);
+        arrival_ = Clock::now();
+    }
+}
+
+// =============================================================================
+// BinaryFileTailFeed
+// =============================================================================
+
+BinaryFileTailFeed::BinaryFileTailFeed(std::string path, Options options)
+    : path_(std::move(path)), options_(options) {}
+
+BinaryFileTailFeed::~BinaryFileTailFeed() {
+    close();
+}
+
+bool BinaryFileTailFeed::open() {
+    close();
+    fd_ = ::open(path_.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        utils::log_error("BinaryFileTailFeed: cannot open " + path_);
+        return false;
+    }
+
+    // Validate the header here so history can be skipped by seeking
+    binary_data::BinaryHeader header;
+    if (::pread(fd_, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+        header.magic != binary_data::BINARY_DATA_MAGIC ||
+        header.version != binary_data::BINARY_DATA_VERSION) {
+        utils::log_error("BinaryFileTailFeed: invalid binary_data header in " + path_);
+        close();
+        return false;
+    }
+    header.symbol[sizeof(header.symbol) - 1] = '\0';
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        close();
+        return false;
+    }
+    const uint64_t on_disk = (static_cast<uint64_t>(st.st_size) - sizeof(header)) / FRAME_BYTES;
+    uint64_t skip = 0;
+    if (options_.resume_index >= 0) {
+        // State comes from a snapshot: every bar from resume_index on is new
+        skip = std::min(on_disk, static_cast<uint64_t>(options_.resume_index));
+        history_bars_ = 0;
+    } else {
+        if (options_.max_history >= 0 && on_disk > static_cast<uint64_t>(options_.max_history)) {
+            skip = on_disk - static_cast<uint64_t>(options_.max_history);
+        }
+        history_bars_ = on_disk - skip;
+    }
+    start_index_ = skip;
+
+    if (::lseek(fd_, static_cast<off_t>(sizeof(header) + skip * FRAME_BYTES), SEEK_SET) < 0) {
+        close();
+        return false;
+    }
+    reset_stream(false);
+    symbol_ = header.symbol;
+
+    utils::log_info("Tailing " + path_ + " (symbol=" + symbol_ + ", history=" +
+                   std::to_string(history_bars_) + " of " + std::to_string(on_disk) + " bars)");
+    return true;
+}
+
+void BinaryFileTailFeed::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+long BinaryFileTailFeed::read_some(char* dst, size_t cap, int64_t timeout_us) {
+    if (fd_ < 0) return -2;
+    const auto deadline = Clock::now() + std::chrono::microseconds(timeout_us);
+    for (;;) {
+        // Regular files never block: read() returns 0 at the current end and
+        // picks up appended bytes on the next call.
+        ssize_t n = ::read(fd_, dst, cap);
+        if (n > 0) return static_cast<long>(n);
+        if (n < 0 && errno != EINTR) return -2;
+        if (timeout_us <= 0 || Clock::now() >= deadline) return 0;
+        std::this_thread::sleep_for(std::chrono::microseconds(options_.poll_interval_us));
+    }
+}
+
+// =============================================================================
+// UnixSocketBarFeed
+// =============================================================================
+
+UnixSocketBarFeed::UnixSocketBarFeed(std::string socket_path)
+    : socket_path_(std::move(socket_path)) {}
+
+UnixSocketBarFeed::~UnixSocketBarFeed() {
+    close();
+}
+
+bool UnixSocketBarFeed::open() {
+    close();
+    sockaddr_un addr{};
+    if (socket_path_.size() >= sizeof(addr.sun_path)) {
+        utils::log_error("UnixSocketBarFeed: socket path too long: " + socket_path_);
+        return false;
+    }
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0) {
+        utils::log_error("UnixSocketBarFeed: socket() failed");
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, socket_path_.c_str(), socket_path_.size() + 1);
+    if (::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        utils::log_error("UnixSocketBarFeed: cannot connect to " + socket_path_);
+        close();
+        return false;
+    }
+    reset_stream(true);
+    utils::log_info("Connected to bar feed socket " + socket_path_);
+    return true;
+}
+
+void UnixSocketBarFeed::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+long UnixSocketBarFeed::read_some(char* dst, size_t cap, int64_t timeout_us) {
+    if (fd_ < 0) return -2;
+    pollfd pfd{fd_, POLLIN, 0};
+    // poll() has millisecond resolution; round sub-millisecond waits up
+    const int timeout_ms = timeout_us <= 0 ? 0 : static_cast<int>((timeout_us + 999) / 1000);
+    int rc = ::poll(&pfd, 1, timeout_ms);
+    if (rc == 0) return 0;
+    if (rc < 0) return errno == EINTR ? 0 : -2;
+
+    ssize_t n = ::recv(fd_, dst, cap, 0);
+    if (n > 0) return static_cast<long>(n);
+    if (n == 0) return -1;
+    return (errno == EINTR || errno == EAGAIN) ? 0 : -2;
+}
+
+std::unique_ptr<BarFeed> make_bar_feed(const std::string& spec,
+                                       const BinaryFileTailFeed::Options& file_options) {
+    const std::string unix_prefix = "unix:";
+    if (spec.compare(0, unix_prefix.size(), unix_prefix) == 0) {
+        return std::make_unique<UnixSocketBarFeed>(spec.substr(unix_prefix.size()));
+    }
+    return std::make_unique<BinaryFileTailFeed>(spec, file_options);
+}
+
+} // namespace sentio
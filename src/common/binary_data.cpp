@@ -260,6 +260,44 @@ void BinaryDataWriter::close() {
     }
 }
 
+// =============================================================================
+// Microstructure Companion File
+// =============================================================================
+
+std::string micro_path_for(const std::string& binary_path) {
+    std::filesystem::path path(binary_path);
+    if (path.extension() == ".bin") {
+        path.replace_extension();
+    }
+    return path.string() + ".micro.bin";
+}
+
+bool read_micro_file(const std::string& micro_path, std::vector<BinaryMicroBar>& out) {
+    std::ifstream file(micro_path, std::ios::binary);
+    if (!file.is_open()) {
+        utils::log_error("Cannot open microstructure file: " + micro_path);
+        return false;
+    }
+
+    BinaryHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (file.gcount() != sizeof(header) || header.magic != BINARY_MICRO_MAGIC ||
+        header.version != BINARY_DATA_VERSION) {
+        utils::log_error("Invalid microstructure file header: " + micro_path);
+        return false;
+    }
+
+    out.resize(header.bar_count);
+    file.read(reinterpret_cast<char*>(out.data()),
+              static_cast<std::streamsize>(out.size() * sizeof(BinaryMicroBar)));
+    if (static_cast<uint64_t>(file.gcount()) != out.size() * sizeof(BinaryMicroBar)) {
+        utils::log_error("Truncated microstructure file: " + micro_path);
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
 // =============================================================================
 // Conversion Utilities Implementation
 // =============================================================================
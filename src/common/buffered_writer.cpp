@@ -0,0 +1,144 @@
+#include "common/buffered_writer.h"
+#include "common/utils.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace sentio {
+
+BufferedFileWriter::~BufferedFileWriter() {
+    close();
+}
+
+bool BufferedFileWriter::open(const std::string& path, size_t buffer_bytes, bool async) {
+    return open_mode(path, "wb", buffer_bytes, async);
+}
+
+bool BufferedFileWriter::open_append(const std::string& path, size_t buffer_bytes, bool async) {
+    return open_mode(path, "ab", buffer_bytes, async);
+}
+
+bool BufferedFileWriter::open_mode(const std::string& path, const char* mode,
+                                   size_t buffer_bytes, bool async) {
+    close();
+
+    file_ = std::fopen(path.c_str(), mode);
+    if (!file_) {
+        utils::log_error("BufferedFileWriter: cannot open " + path);
+        return false;
+    }
+    // Our own buffer replaces stdio's; avoid a second copy.
+    std::setvbuf(file_, nullptr, _IONBF, 0);
+
+    path_ = path;
+    failed_ = false;
+    total_bytes_ = 0;
+    capacity_ = buffer_bytes > 0 ? buffer_bytes : DEFAULT_BUFFER_BYTES;
+    active_ = new char[capacity_];
+    fill_ = 0;
+    pending_size_ = 0;
+    async_ = async;
+    stop_ = false;
+
+    if (async_) {
+        pending_ = new char[capacity_];
+        io_thread_ = std::thread(&BufferedFileWriter::io_loop, this);
+    }
+    return true;
+}
+
+void BufferedFileWriter::write(const char* data, size_t size) {
+    while (size > 0) {
+        if (fill_ == capacity_) swap_buffers();
+        size_t n = std::min(size, capacity_ - fill_);
+        std::memcpy(active_ + fill_, data, n);
+        fill_ += n;
+        data += n;
+        size -= n;
+    }
+}
+
+void BufferedFileWriter::swap_buffers() {
+    if (fill_ == 0) return;
+
+    if (!async_) {
+        write_out(active_, fill_);
+        fill_ = 0;
+        return;
+    }
+
+    // Wait until the I/O thread has drained the previous buffer, then hand
+    // over the full one and keep producing into the drained one.
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return pending_size_ == 0; });
+    std::swap(active_, pending_);
+    pending_size_ = fill_;
+    fill_ = 0;
+    lock.unlock();
+    cv_.notify_all();
+}
+
+void BufferedFileWriter::write_out(const char* data, size_t size) {
+    if (failed_) return;
+    if (std::fwrite(data, 1, size, file_) != size) {
+        failed_ = true;
+        utils::log_error("BufferedFileWriter: write failed for " + path_);
+        return;
+    }
+    total_bytes_ += size;
+}
+
+void BufferedFileWriter::io_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        cv_.wait(lock, [this] { return pending_size_ > 0 || stop_; });
+        if (pending_size_ > 0) {
+            size_t size = pending_size_;
+            lock.unlock();
+            write_out(pending_, size);
+            lock.lock();
+            pending_size_ = 0;
+            cv_.notify_all();
+            continue;
+        }
+        if (stop_) break;
+    }
+}
+
+bool BufferedFileWriter::flush() {
+    if (!file_) return false;
+    swap_buffers();
+    if (async_) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return pending_size_ == 0; });
+    }
+    if (std::fflush(file_) != 0) failed_ = true;
+    return !failed_;
+}
+
+bool BufferedFileWriter::close() {
+    if (!file_) return !failed_;
+
+    flush();
+    if (async_ && io_thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        io_thread_.join();
+    }
+    if (std::fclose(file_) != 0) failed_ = true;
+    file_ = nullptr;
+
+    delete[] active_;
+    delete[] pending_;
+    active_ = nullptr;
+    pending_ = nullptr;
+    capacity_ = 0;
+    fill_ = 0;
+    async_ = false;
+    return !failed_;
+}
+
+} // namespace sentio
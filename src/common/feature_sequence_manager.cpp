@@ -0,0 +1,108 @@
+#include "common/feature_sequence_manager.h"
+#include "common/state_stream.h"
+#include "common/utils.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace sentio {
+
+FeatureSequenceManager::FeatureSequenceManager(int sequence_length, int feature_dim)
+    : sequence_length_(std::max(sequence_length, 1)),
+      feature_dim_(std::max(feature_dim, 1)),
+      ring_(2 * static_cast<size_t>(sequence_length_) * feature_dim_, 0.0f),
+      scratch_(static_cast<size_t>(feature_dim_), 0.0f) {}
+
+bool FeatureSequenceManager::set_normalization(const std::vector<float>& means,
+                                               const std::vector<float>& stds) {
+    if (means.size() != static_cast<size_t>(feature_dim_) || stds.size() != means.size()) {
+        utils::log_error("Sequence normalization needs " + std::to_string(feature_dim_) +
+                         " means and stds, got " + std::to_string(means.size()) + "/" +
+                         std::to_string(stds.size()));
+        return false;
+    }
+    means_ = means;
+    stds_ = stds;
+    return true;
+}
+
+void FeatureSequenceManager::add_features(const float* features) {
+    if (means_.empty()) {
+        store(features);
+        return;
+    }
+    for (int i = 0; i < feature_dim_; ++i) {
+        scratch_[i] = (features[i] - means_[i]) / stds_[i];
+    }
+    store(scratch_.data());
+}
+
+void FeatureSequenceManager::add_features(const std::vector<double>& features) {
+    const size_t n = std::min(features.size(), scratch_.size());
+    for (size_t i = 0; i < n; ++i) scratch_[i] = static_cast<float>(features[i]);
+    std::fill(scratch_.begin() + n, scratch_.end(), 0.0f);
+    add_features(scratch_.data());   // normalizes in place when enabled
+}
+
+void FeatureSequenceManager::commit_row() {
+    float* row = next_row();
+    if (!means_.empty()) {
+        for (int i = 0; i < feature_dim_; ++i) {
+            row[i] = (row[i] - means_[i]) / stds_[i];
+        }
+    }
+    store(row);
+}
+
+void FeatureSequenceManager::store(const float* row) {
+    // The slot leaving the window takes the new row in both halves; the
+    // window then starts one slot later and ends with the new row.
+    const size_t bytes = static_cast<size_t>(feature_dim_) * sizeof(float);
+    const size_t slot = head_;
+    std::memmove(ring_.data() + slot * feature_dim_, row, bytes);
+    std::memcpy(ring_.data() + (slot + sequence_length_) * feature_dim_,
+                ring_.data() + slot * feature_dim_, bytes);
+    head_ = (slot + 1) % static_cast<size_t>(sequence_length_);
+    if (size_ < static_cast<size_t>(sequence_length_)) ++size_;
+}
+
+void FeatureSequenceManager::reset() {
+    std::fill(ring_.begin(), ring_.end(), 0.0f);
+    head_ = 0;
+    size_ = 0;
+}
+
+void FeatureSequenceManager::save_state(StateWriter& w) const {
+    w.put(static_cast<uint32_t>(sequence_length_));
+    w.put(static_cast<uint32_t>(feature_dim_));
+    w.put(static_cast<uint64_t>(head_));
+    w.put(static_cast<uint64_t>(size_));
+    // The size_ newest rows end the window, oldest first
+    const float* rows = window() + (static_cast<size_t>(sequence_length_) - size_) * feature_dim_;
+    w.put_bytes(reinterpret_cast<const char*>(rows), size_ * feature_dim_ * sizeof(float));
+}
+
+bool FeatureSequenceManager::load_state(StateReader& r) {
+    uint32_t length = 0, dim = 0;
+    uint64_t head = 0, size = 0;
+    if (!r.get(length) || !r.get(dim) || !r.get(head) || !r.get(size) ||
+        length != static_cast<uint32_t>(sequence_length_) || dim != static_cast<uint32_t>(feature_dim_) ||
+        head >= length || size > length) {
+        return false;
+    }
+    const size_t row_bytes = static_cast<size_t>(feature_dim_) * sizeof(float);
+    const char* rows = r.take(static_cast<size_t>(size) * row_bytes);
+    if (!rows) return false;
+
+    // Replay the rows from the slot the oldest one was stored in, so the
+    // window ends at the saved slot; store() does not normalize again.
+    reset();
+    head_ = static_cast<size_t>((head + length - size) % length);
+    for (uint64_t i = 0; i < size; ++i) {
+        std::memcpy(scratch_.data(), rows + i * row_bytes, row_bytes);
+        store(scratch_.data());
+    }
+    return true;
+}
+
+} // namespace sentio
@@ -0,0 +1,43 @@
+#include "common/latency_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace sentio {
+
+LatencyStats::Summary LatencyStats::summary() const {
+    Summary s;
+    s.count = samples_.size();
+    if (samples_.empty()) return s;
+
+    std::vector<int64_t> sorted(samples_);
+    std::sort(sorted.begin(), sorted.end());
+
+    auto rank = [&sorted](double q) {
+        size_t idx = static_cast<size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+        idx = std::min(sorted.size(), std::max<size_t>(idx, 1)) - 1;
+        return static_cast<double>(sorted[idx]) / 1000.0;
+    };
+
+    double total = 0.0;
+    for (int64_t v : sorted) total += static_cast<double>(v);
+    s.mean_us = total / static_cast<double>(sorted.size()) / 1000.0;
+    s.p50_us = rank(0.50);
+    s.p90_us = rank(0.90);
+    s.p99_us = rank(0.99);
+    s.p999_us = rank(0.999);
+    s.max_us = static_cast<double>(sorted.back()) / 1000.0;
+    return s;
+}
+
+std::string LatencyStats::format() const {
+    const Summary s = summary();
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "n=%zu mean=%.1fus p50=%.1fus p90=%.1fus p99=%.1fus p99.9=%.1fus max=%.1fus",
+                  s.count, s.mean_us, s.p50_us, s.p90_us, s.p99_us, s.p999_us, s.max_us);
+    return buf;
+}
+
+} // namespace sentio
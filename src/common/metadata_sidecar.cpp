@@ -0,0 +1,78 @@
+#include "common/metadata_sidecar.h"
+#include "common/result_cache.h"
+#include "common/utils.h"
+
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+namespace sentio {
+
+namespace {
+
+struct SidecarHeader {
+    uint32_t magic = MetadataSidecar::MAGIC;
+    uint32_t format_version = MetadataSidecar::FORMAT_VERSION;
+    uint32_t sequence_length = 0;
+    uint32_t feature_dim = 0;
+    uint64_t source_hash = 0;       // hash_file_contents() of the JSON
+    uint32_t means = 0;
+    uint32_t stds = 0;
+};
+static_assert(sizeof(SidecarHeader) == 32, "metadata sidecar header must stay 32 bytes");
+
+} // namespace
+
+bool MetadataSidecar::load(const std::string& metadata_path, NormalizationMetadata& out) {
+    std::ifstream in(path_for(metadata_path), std::ios::binary);
+    if (!in) return false;
+    SidecarHeader header;
+    uint64_t source_hash = 0;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != MAGIC ||
+        header.format_version != FORMAT_VERSION || !hash_file_contents(metadata_path, source_hash) ||
+        header.source_hash != source_hash) {
+        return false;
+    }
+    NormalizationMetadata metadata;
+    metadata.sequence_length = header.sequence_length;
+    metadata.feature_dim = header.feature_dim;
+    metadata.means.resize(header.means);
+    metadata.stds.resize(header.stds);
+    if (!in.read(reinterpret_cast<char*>(metadata.means.data()), metadata.means.size() * sizeof(double)) ||
+        !in.read(reinterpret_cast<char*>(metadata.stds.data()), metadata.stds.size() * sizeof(double))) {
+        return false;
+    }
+    out = std::move(metadata);
+    return true;
+}
+
+bool MetadataSidecar::store(const std::string& metadata_path, const NormalizationMetadata& metadata) {
+    SidecarHeader header;
+    header.sequence_length = metadata.sequence_length;
+    header.feature_dim = metadata.feature_dim;
+    header.means = static_cast<uint32_t>(metadata.means.size());
+    header.stds = static_cast<uint32_t>(metadata.stds.size());
+    if (!hash_file_contents(metadata_path, header.source_hash)) return false;
+
+    const std::string path = path_for(metadata_path);
+    // Per-process name: several strategy processes may start on a new model at once
+    const std::string tmp = path + ".tmp" + std::to_string(::getpid());
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(metadata.means.data()), metadata.means.size() * sizeof(double));
+        out.write(reinterpret_cast<const char*>(metadata.stds.data()), metadata.stds.size() * sizeof(double));
+        if (!out) {
+            std::remove(tmp.c_str());
+            utils::log_warning("Cannot write metadata sidecar: " + path);
+            return false;
+        }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace sentio
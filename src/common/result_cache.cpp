@@ -0,0 +1,168 @@
+#include "common/result_cache.h"
+#include "common/state_stream.h"
+#include "common/utils.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+namespace sentio {
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr size_t HASH_CHUNK_BYTES = 1 << 20;
+    // Second FNV offset basis so the two key halves are independent
+    constexpr uint64_t KEY_SEED_HI = 0x6c62272e07bb0142ULL;
+
+    // Link `src` to `dest` (replacing it), copying across filesystems.
+    bool link_or_copy(const fs::path& src, const fs::path& dest) {
+        std::error_code ec;
+        // rename() is a no-op between two links to the same file
+        if (fs::exists(dest, ec) && fs::equivalent(src, dest, ec)) return true;
+        fs::path tmp = dest;
+        tmp += ".tmp";
+        fs::remove(tmp, ec);
+        fs::create_hard_link(src, tmp, ec);
+        if (ec) {
+            ec.clear();
+            fs::copy_file(src, tmp, fs::copy_options::overwrite_existing, ec);
+            if (ec) return false;
+        }
+        fs::rename(tmp, dest, ec);
+        if (ec) {
+            fs::remove(tmp, ec);
+            return false;
+        }
+        return true;
+    }
+}
+
+// =============================================================================
+// CacheKey
+// =============================================================================
+
+CacheKey& CacheKey::add(const std::string& field, const std::string& value) {
+    canonical_ += field;
+    canonical_ += '=';
+    canonical_ += value;
+    canonical_ += '\n';
+    return *this;
+}
+
+bool CacheKey::add_file(const std::string& field, const std::string& path) {
+    uint64_t hash = 0;
+    if (!hash_file_contents(path, hash)) return false;
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(hash));
+    add(field, buf);
+    return true;
+}
+
+std::string CacheKey::hex() const {
+    const uint64_t lo = fnv1a64(canonical_);
+    const uint64_t hi = fnv1a64(canonical_.data(), canonical_.size(), KEY_SEED_HI);
+    char buf[33];
+    std::snprintf(buf, sizeof(buf), "%016llx%016llx",
+                  static_cast<unsigned long long>(hi), static_cast<unsigned long long>(lo));
+    return buf;
+}
+
+// =============================================================================
+// ResultCache
+// =============================================================================
+
+ResultCache::ResultCache(Options options) : options_(std::move(options)) {}
+
+std::string ResultCache::entry_path(const CacheKey& key, const std::string& extension) const {
+    return (fs::path(options_.directory) / (key.hex() + extension)).string();
+}
+
+bool ResultCache::fetch(const CacheKey& key, const std::string& dest) {
+    const fs::path entry = entry_path(key, fs::path(dest).extension().string());
+    std::error_code ec;
+    if (!fs::is_regular_file(entry, ec)) return false;
+    if (!link_or_copy(entry, dest)) {
+        utils::log_warning("ResultCache: cannot materialize " + entry.string() + " at " + dest);
+        return false;
+    }
+    // Mark as most recently used
+    fs::last_write_time(entry, fs::file_time_type::clock::now(), ec);
+    return true;
+}
+
+bool ResultCache::store(const CacheKey& key, const std::string& src) {
+    std::error_code ec;
+    fs::create_directories(options_.directory, ec);
+    const fs::path entry = entry_path(key, fs::path(src).extension().string());
+    if (!link_or_copy(src, entry)) {
+        utils::log_warning("ResultCache: cannot store " + src + " in " + options_.directory);
+        return false;
+    }
+    evict();
+    return true;
+}
+
+size_t ResultCache::evict() {
+    struct Entry {
+        fs::path path;
+        uint64_t bytes;
+        fs::file_time_type used;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+
+    std::error_code ec;
+    for (fs::directory_iterator it(options_.directory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec) || it->path().extension() == ".tmp") continue;
+        Entry e{it->path(), static_cast<uint64_t>(it->file_size(ec)), it->last_write_time(ec)};
+        if (ec) { ec.clear(); continue; }
+        total += e.bytes;
+        entries.push_back(std::move(e));
+    }
+    if (total <= options_.max_bytes) return 0;
+
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    size_t removed = 0;
+    for (const auto& e : entries) {
+        if (total <= options_.max_bytes) break;
+        if (fs::remove(e.path, ec)) {
+            total -= e.bytes;
+            ++removed;
+        }
+    }
+    utils::log_info("ResultCache: evicted " + std::to_string(removed) + " entries from " + options_.directory);
+    return removed;
+}
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+bool hash_file_contents(const std::string& path, uint64_t& hash) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::vector<char> chunk(HASH_CHUNK_BYTES);
+    hash = fnv1a64(nullptr, 0);
+    while (in) {
+        in.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        hash = fnv1a64(chunk.data(), static_cast<size_t>(in.gcount()), hash);
+    }
+    return in.eof();
+}
+
+bool detach_hard_link(const std::string& path) {
+    std::error_code ec;
+    if (!fs::exists(path, ec) || fs::hard_link_count(path, ec) <= 1) return true;
+    fs::path tmp = path;
+    tmp += ".detach.tmp";
+    if (!fs::copy_file(path, tmp, fs::copy_options::overwrite_existing, ec)) return false;
+    fs::rename(tmp, path, ec);
+    return !ec;
+}
+
+} // namespace sentio
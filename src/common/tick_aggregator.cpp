@@ -0,0 +1,348 @@
+#include "common/tick_aggregator.h"
+#include "common/utils.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace sentio {
+namespace ticks {
+
+// =============================================================================
+// TickAggregator
+// =============================================================================
+
+TickAggregator::TickAggregator(const Config& config, BarCallback on_bar)
+    : config_(config), on_bar_(std::move(on_bar)) {
+    config_.interval_ms = std::max<int64_t>(config_.interval_ms, 1);
+}
+
+int64_t TickAggregator::clamp_time(int64_t ts) {
+    if (ts < last_ts_) {
+        ++stats_.out_of_order;
+        return last_ts_;
+    }
+    last_ts_ = ts;
+    return ts;
+}
+
+void TickAggregator::roll_time_bar(int64_t ts) {
+    if (config_.type != BarType::Time || !open_) return;
+    const int64_t bucket = ts - ts % config_.interval_ms;
+    if (bucket != static_cast<int64_t>(bar_.timestamp_ms)) emit();
+}
+
+void TickAggregator::on_quote(const QuoteTick& quote) {
+    const int64_t ts = clamp_time(quote.timestamp_ms);
+    ++stats_.quotes;
+    roll_time_bar(ts);
+
+    if (have_quote_) {
+        const QuoteTick& prev = quote_;
+        double e = 0.0;
+        if (quote.bid >= prev.bid) e += quote.bid_size;
+        if (quote.bid <= prev.bid) e -= prev.bid_size;
+        if (quote.ask <= prev.ask) e -= quote.ask_size;
+        if (quote.ask >= prev.ask) e += prev.ask_size;
+        ofi_ += e;
+    }
+    quote_ = quote;
+    have_quote_ = true;
+    ++quote_count_;
+}
+
+double TickAggregator::classify(const TradeTick& trade) {
+    double sign = 0.0;
+    if (have_quote_ && quote_.ask > quote_.bid) {
+        // Quote rule: at/above the ask or above the mid is a buy
+        const double mid = 0.5 * (quote_.bid + quote_.ask);
+        if (trade.price > mid) sign = 1.0;
+        else if (trade.price < mid) sign = -1.0;
+    }
+    if (sign == 0.0 && stats_.trades > 1) {
+        // Tick rule; a zero tick keeps the previous direction
+        if (trade.price > last_trade_price_) sign = 1.0;
+        else if (trade.price < last_trade_price_) sign = -1.0;
+        else sign = last_sign_;
+    }
+    last_trade_price_ = trade.price;
+    last_sign_ = sign;
+    return sign;
+}
+
+void TickAggregator::on_trade(const TradeTick& trade) {
+    const int64_t ts = clamp_time(trade.timestamp_ms);
+    ++stats_.trades;
+    roll_time_bar(ts);
+
+    if (!open_) {
+        open_ = true;
+        bar_.timestamp_ms = static_cast<uint64_t>(
+            config_.type == BarType::Time ? ts - ts % config_.interval_ms : ts);
+        bar_.open = bar_.high = bar_.low = trade.price;
+        bar_.volume = 0.0;
+    }
+    bar_.high = std::max(bar_.high, trade.price);
+    bar_.low = std::min(bar_.low, trade.price);
+    bar_.close = trade.price;
+    bar_.volume += trade.size;
+    notional_ += trade.price * trade.size;
+    ++trade_count_;
+
+    const double sign = classify(trade);
+    if (sign > 0.0) buy_volume_ += trade.size;
+    else if (sign < 0.0) sell_volume_ += trade.size;
+
+    if (config_.type == BarType::Volume && bar_.volume >= config_.volume_per_bar) {
+        emit();
+    }
+}
+
+void TickAggregator::emit() {
+    binary_data::BinaryMicroBar micro;
+    micro.timestamp_ms = bar_.timestamp_ms;
+    micro.vwap = bar_.volume > 0.0 ? notional_ / bar_.volume : bar_.close;
+    micro.ofi = ofi_;
+    micro.buy_volume = buy_volume_;
+    micro.sell_volume = sell_volume_;
+    micro.trade_count = trade_count_;
+    micro.quote_count = quote_count_;
+    on_bar_(bar_, micro);
+    ++stats_.bars;
+
+    open_ = false;
+    notional_ = ofi_ = buy_volume_ = sell_volume_ = 0.0;
+    trade_count_ = quote_count_ = 0;
+}
+
+void TickAggregator::finish() {
+    if (open_) emit();
+}
+
+// =============================================================================
+// TickCsvReader
+// =============================================================================
+
+namespace {
+
+// Epoch integer in s/ms/us/ns (by magnitude), or seconds with a fraction.
+const char* parse_timestamp(const char* p, const char* end, int64_t& ms) {
+    int64_t v = 0;
+    auto r = std::from_chars(p, end, v);
+    if (r.ec != std::errc()) return nullptr;
+    p = r.ptr;
+    if (v < 100000000000LL) {               // seconds
+        ms = v * 1000;
+        if (p < end && *p == '.') {
+            int64_t frac = 0;
+            int digits = 0;
+            for (++p; p < end && *p >= '0' && *p <= '9'; ++p) {
+                if (digits < 3) { frac = frac * 10 + (*p - '0'); ++digits; }
+            }
+            for (; digits < 3; ++digits) frac *= 10;
+            ms += frac;
+        }
+    } else if (v < 100000000000000LL) {     // milliseconds
+        ms = v;
+    } else if (v < 100000000000000000LL) {  // microseconds
+        ms = v / 1000;
+    } else {                                // nanoseconds
+        ms = v / 1000000;
+    }
+    return p;
+}
+
+// Parse `n` comma-separated doubles after the current field.
+bool parse_fields(const char* p, const char* end, double* out, int n) {
+    for (int i = 0; i < n; ++i) {
+        if (p >= end || *p != ',') return false;
+        ++p;
+        while (p < end && *p == ' ') ++p;
+        auto r = std::from_chars(p, end, out[i]);
+        if (r.ec != std::errc()) return false;
+        p = r.ptr;
+        while (p < end && *p == ' ') ++p;
+    }
+    return p == end || *p == ',' || *p == '\r';
+}
+
+} // namespace
+
+TickCsvReader::~TickCsvReader() {
+    close();
+}
+
+bool TickCsvReader::open(const std::string& path, size_t buffer_bytes) {
+    close();
+    file_ = std::fopen(path.c_str(), "rb");
+    if (!file_) {
+        utils::log_error("Cannot open tick file: " + path);
+        return false;
+    }
+    buffer_.resize(std::max<size_t>(buffer_bytes, 1 << 16));
+    pos_ = end_ = 0;
+    eof_ = false;
+    malformed_ = bytes_read_ = 0;
+    return true;
+}
+
+void TickCsvReader::close() {
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+bool TickCsvReader::next_line(const char*& begin, const char*& end) {
+    for (;;) {
+        const char* data = buffer_.data();
+        const void* nl = std::memchr(data + pos_, '\n', end_ - pos_);
+        if (nl || (eof_ && pos_ < end_)) {
+            begin = data + pos_;
+            end = nl ? static_cast<const char*>(nl) : data + end_;
+            pos_ = static_cast<size_t>(end - data) + (nl ? 1 : 0);
+            if (end > begin && end[-1] == '\r') --end;
+            if (end > begin) return true;
+            continue;
+        }
+        if (eof_ || !file_) return false;
+
+        // Move the partial line to the front and refill
+        std::memmove(buffer_.data(), data + pos_, end_ - pos_);
+        end_ -= pos_;
+        pos_ = 0;
+        if (end_ == buffer_.size()) buffer_.resize(buffer_.size() * 2);   // very long line
+        const size_t n = std::fread(buffer_.data() + end_, 1, buffer_.size() - end_, file_);
+        bytes_read_ += n;
+        end_ += n;
+        if (n == 0) eof_ = true;
+    }
+}
+
+bool TickCsvReader::next(TradeTick& trade) {
+    const char* begin;
+    const char* end;
+    double fields[2];
+    while (next_line(begin, end)) {
+        const char* p = parse_timestamp(begin, end, trade.timestamp_ms);
+        if (p && parse_fields(p, end, fields, 2)) {
+            trade.price = fields[0];
+            trade.size = fields[1];
+            return true;
+        }
+        ++malformed_;
+    }
+    return false;
+}
+
+bool TickCsvReader::next(QuoteTick& quote) {
+    const char* begin;
+    const char* end;
+    double fields[4];
+    while (next_line(begin, end)) {
+        const char* p = parse_timestamp(begin, end, quote.timestamp_ms);
+        if (p && parse_fields(p, end, fields, 4)) {
+            quote.bid = fields[0];
+            quote.bid_size = fields[1];
+            quote.ask = fields[2];
+            quote.ask_size = fields[3];
+            return true;
+        }
+        ++malformed_;
+    }
+    return false;
+}
+
+// =============================================================================
+// TickBarFileWriter
+// =============================================================================
+
+namespace {
+
+binary_data::BinaryHeader make_header(uint32_t magic, const std::string& symbol, uint64_t count) {
+    binary_data::BinaryHeader header;
+    header.magic = magic;
+    header.symbol_length = static_cast<uint32_t>(symbol.size());
+    std::strncpy(header.symbol, symbol.c_str(), sizeof(header.symbol) - 1);
+    header.bar_count = count;
+    return header;
+}
+
+bool patch_header(const std::string& path, const binary_data::BinaryHeader& header) {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file.is_open()) return false;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return file.good();
+}
+
+} // namespace
+
+bool TickBarFileWriter::open(const std::string& binary_path, const std::string& symbol) {
+    bar_path_ = binary_path;
+    micro_path_ = binary_data::micro_path_for(binary_path);
+    symbol_ = symbol;
+    written_ = 0;
+
+    std::error_code ec;
+    const auto parent = std::filesystem::path(bar_path_).parent_path();
+    if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+    if (!bars_.open(bar_path_) || !micro_.open(micro_path_)) {
+        utils::log_error("Cannot create bar files: " + bar_path_);
+        return false;
+    }
+    const auto bar_header = make_header(binary_data::BINARY_DATA_MAGIC, symbol_, 0);
+    const auto micro_header = make_header(binary_data::BINARY_MICRO_MAGIC, symbol_, 0);
+    bars_.write(reinterpret_cast<const char*>(&bar_header), sizeof(bar_header));
+    micro_.write(reinterpret_cast<const char*>(&micro_header), sizeof(micro_header));
+    return true;
+}
+
+void TickBarFileWriter::write(const binary_data::BinaryBar& bar, const binary_data::BinaryMicroBar& micro) {
+    bars_.write(reinterpret_cast<const char*>(&bar), sizeof(bar));
+    micro_.write(reinterpret_cast<const char*>(&micro), sizeof(micro));
+    ++written_;
+}
+
+bool TickBarFileWriter::close() {
+    bool ok = bars_.close() & micro_.close();
+    ok = ok && patch_header(bar_path_, make_header(binary_data::BINARY_DATA_MAGIC, symbol_, written_));
+    ok = ok && patch_header(micro_path_, make_header(binary_data::BINARY_MICRO_MAGIC, symbol_, written_));
+    if (!ok) utils::log_error("Failed to finalize bar files: " + bar_path_);
+    return ok;
+}
+
+// =============================================================================
+// File merge
+// =============================================================================
+
+bool aggregate_files(const std::string& trades_path,
+                     const std::string& quotes_path,
+                     TickAggregator& aggregator) {
+    TickCsvReader trades;
+    TickCsvReader quotes;
+    if (!trades.open(trades_path)) return false;
+    const bool with_quotes = !quotes_path.empty();
+    if (with_quotes && !quotes.open(quotes_path)) return false;
+
+    TradeTick trade;
+    QuoteTick quote;
+    bool have_trade = trades.next(trade);
+    bool have_quote = with_quotes && quotes.next(quote);
+    while (have_trade || have_quote) {
+        if (have_quote && (!have_trade || quote.timestamp_ms <= trade.timestamp_ms)) {
+            aggregator.on_quote(quote);
+            have_quote = quotes.next(quote);
+        } else {
+            aggregator.on_trade(trade);
+            have_trade = trades.next(trade);
+        }
+    }
+    aggregator.finish();
+    aggregator.stats().malformed += trades.malformed() + quotes.malformed();
+    return true;
+}
+
+} // namespace ticks
+} // namespace sentio
@@ -0,0 +1,164 @@
+#include "features/feature_store.h"
+#include "common/buffered_writer.h"
+#include "common/result_cache.h"
+#include "common/state_stream.h"
+#include "common/utils.h"
+
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sentio {
+namespace features {
+
+namespace fs = std::filesystem;
+
+FeatureStore::~FeatureStore() {
+    close();
+}
+
+std::string FeatureStore::path_for(const std::string& dataset,
+                                   const UnifiedFeatureEngine::Config& config,
+                                   const std::string& directory) {
+    CacheKey key;
+    if (!key.add_file("dataset", dataset)) return "";
+    key.add("features", config.fingerprint())
+       .add("engine_version", std::to_string(UnifiedFeatureEngine::VERSION))
+       .add("format_version", std::to_string(FORMAT_VERSION));
+    return (fs::path(directory) / (key.hex() + ".features")).string();
+}
+
+bool FeatureStore::build(const std::string& dataset,
+                         const UnifiedFeatureEngine::Config& config,
+                         const std::string& path) {
+    Header header;
+    if (!hash_file_contents(dataset, header.dataset_hash)) {
+        utils::log_error("Cannot read dataset for feature store: " + dataset);
+        return false;
+    }
+    auto bars = utils::read_market_data_range(dataset, 0, 0);
+    if (bars.empty()) {
+        utils::log_error("No bars loaded for feature store: " + dataset);
+        return false;
+    }
+
+    UnifiedFeatureEngine engine(config);
+    header.cols = static_cast<uint32_t>(engine.feature_count());
+    header.rows = bars.size();
+    header.warmup_bars = config.warmup_bars;
+    header.config_hash = fnv1a64(config.fingerprint());
+    header.first_timestamp_ms = bars.front().timestamp_ms;
+    header.last_timestamp_ms = bars.back().timestamp_ms;
+
+    std::error_code ec;
+    const auto parent = fs::path(path).parent_path();
+    if (!parent.empty()) fs::create_directories(parent, ec);
+    const std::string tmp = path + ".tmp";
+    BufferedFileWriter out;
+    if (!out.open(tmp)) {
+        utils::log_error("Cannot create feature store: " + tmp);
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::vector<float> row(header.cols);
+    const size_t row_bytes = row.size() * sizeof(float);
+    for (const Bar& bar : bars) {
+        engine.update(bar, row.data());
+        out.write(reinterpret_cast<const char*>(row.data()), row_bytes);
+    }
+    if (!out.close()) {
+        utils::log_error("Failed writing feature store: " + tmp);
+        fs::remove(tmp, ec);
+        return false;
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        utils::log_error("Cannot move feature store into place: " + path);
+        fs::remove(tmp, ec);
+        return false;
+    }
+    utils::log_info("Built feature store " + path + " (" + std::to_string(header.rows) + " x " +
+                    std::to_string(header.cols) + ")");
+    return true;
+}
+
+bool FeatureStore::open(const std::string& path) {
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        ::close(fd);
+        utils::log_error("Feature store too short: " + path);
+        return false;
+    }
+    const size_t bytes = static_cast<size_t>(st.st_size);
+    void* mapping = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);   // the mapping keeps the file referenced
+    if (mapping == MAP_FAILED) {
+        utils::log_error("Cannot map feature store: " + path);
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, mapping, sizeof(header));
+    const uint64_t expected = sizeof(Header) + header.rows * header.cols * sizeof(float);
+    const char* problem = nullptr;
+    if (header.magic != MAGIC) problem = "not a feature store";
+    else if (header.format_version != FORMAT_VERSION) problem = "unsupported format version";
+    else if (header.engine_version != UnifiedFeatureEngine::VERSION) problem = "built by another feature engine version";
+    else if (header.cols == 0 || expected != bytes) problem = "size does not match header";
+    if (problem) {
+        ::munmap(mapping, bytes);
+        utils::log_error("Rejected feature store " + path + ": " + problem);
+        return false;
+    }
+
+    header_ = header;
+    path_ = path;
+    mapping_ = mapping;
+    mapping_bytes_ = bytes;
+    data_ = reinterpret_cast<const float*>(static_cast<const char*>(mapping) + sizeof(Header));
+    return true;
+}
+
+bool FeatureStore::open_or_build(const std::string& dataset,
+                                 const UnifiedFeatureEngine::Config& config,
+                                 const std::string& directory) {
+    const std::string path = path_for(dataset, config, directory);
+    if (path.empty()) {
+        utils::log_error("Cannot read dataset for feature store: " + dataset);
+        return false;
+    }
+    std::error_code ec;
+    if (fs::exists(path, ec) && open(path) && matches(config)) return true;
+    return build(dataset, config, path) && open(path) && matches(config);
+}
+
+void FeatureStore::close() {
+    if (mapping_) ::munmap(mapping_, mapping_bytes_);
+    mapping_ = nullptr;
+    mapping_bytes_ = 0;
+    data_ = nullptr;
+    header_ = Header{};
+    path_.clear();
+}
+
+bool FeatureStore::matches(const UnifiedFeatureEngine::Config& config) const {
+    return is_open() && header_.config_hash == fnv1a64(config.fingerprint()) &&
+           static_cast<int>(header_.cols) == config.total_features();
+}
+
+bool FeatureStore::matches(const UnifiedFeatureEngine::Config& config, const std::string& dataset) const {
+    uint64_t dataset_hash = 0;
+    return matches(config) && hash_file_contents(dataset, dataset_hash) && dataset_hash == header_.dataset_hash;
+}
+
+} // namespace features
+} // namespace sentio
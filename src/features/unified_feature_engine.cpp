@@ -0,0 +1,659 @@
+#include "features/unified_feature_engine.h"
+#include "common/state_stream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace sentio {
+namespace features {
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double LN2 = 0.69314718055994530942;
+
+// Feature names per category, in output order
+const char* const TIME_NAMES[] = {
+    "time_of_day_sin", "time_of_day_cos", "day_of_week_sin", "day_of_week_cos", "minute_of_hour"};
+const char* const PRICE_ACTION_NAMES[] = {
+    "return_1", "log_return_1", "range_pct", "body_pct", "upper_wick_pct",
+    "lower_wick_pct", "close_location", "gap_pct", "return_2", "return_3",
+    "return_5", "return_10", "true_range_pct", "position_10", "position_20",
+    "position_50", "dist_high_20", "dist_low_20", "body_to_range", "typical_vs_close"};
+const char* const MOVING_AVERAGE_NAMES[] = {
+    "close_sma_5", "close_sma_10", "close_sma_20", "close_sma_50",
+    "close_ema_5", "close_ema_10", "close_ema_20", "close_ema_50",
+    "sma_5_20", "sma_10_50", "ema_5_20", "ema_10_50",
+    "slope_10", "slope_20", "macd_pct"};
+const char* const MOMENTUM_NAMES[] = {
+    "rsi_7", "rsi_14", "rsi_21", "macd_signal_pct", "macd_hist_pct",
+    "stoch_k_14", "stoch_d_3", "williams_r_28", "roc_15", "roc_30",
+    "roc_60", "cci_20", "return_acceleration", "up_bar_ratio_10", "efficiency_10"};
+const char* const VOLATILITY_NAMES[] = {
+    "return_std_5", "return_std_10", "return_std_20", "return_std_50", "atr_14_pct",
+    "parkinson_20", "garman_klass_20", "vol_ratio_5_20", "vol_ratio_10_50", "bollinger_width_20"};
+const char* const VOLUME_NAMES[] = {
+    "volume_sma_5", "volume_sma_10", "volume_sma_20", "volume_sma_50", "log_volume_z_20",
+    "log_volume_change", "obv_slope_10", "obv_slope_20", "vwap_dev_10", "vwap_dev_20",
+    "vwap_dev_50", "up_volume_ratio_10", "up_volume_ratio_20", "volume_ema_5_20", "mfi_14",
+    "return_volume_corr_20", "volume_cv_20", "force_index", "ad_pct", "ad_mean_10"};
+const char* const PATTERN_NAMES[] = {
+    "doji", "hammer", "shooting_star", "bullish_engulfing", "bearish_engulfing", "inside_bar"};
+const char* const STATISTICAL_NAMES[] = {
+    "skew_20", "kurtosis_20", "skew_50", "kurtosis_50", "autocorr_1_20",
+    "zscore_20", "zscore_50", "sharpe_20", "sharpe_50", "range_ratio_20"};
+
+struct CategoryInfo {
+    const char* name;
+    int size;
+};
+
+const CategoryInfo CATEGORIES[] = {
+    {"time", 5}, {"price_action", 20}, {"moving_averages", 15}, {"momentum", 15},
+    {"volatility", 10}, {"volume", 20}, {"patterns", 6}, {"statistical", 10},
+    {"price_lags", 15}, {"return_lags", 10}};
+
+// a / b, 0 when b is 0
+inline double div0(double a, double b) { return b != 0.0 ? a / b : 0.0; }
+// a / b - 1, 0 when b is 0
+inline double rel(double a, double b) { return b != 0.0 ? a / b - 1.0 : 0.0; }
+// Position of x in [lo, hi], 0.5 for an empty range
+inline double position(double x, double lo, double hi) { return hi > lo ? (x - lo) / (hi - lo) : 0.5; }
+
+// Skewness and excess kurtosis from raw moments E[x^3], E[x^4] and mean/variance
+inline double skewness(double mean, double var, double e3) {
+    if (var <= 0.0) return 0.0;
+    const double m3 = e3 - 3.0 * mean * var - mean * mean * mean;
+    return m3 / (var * std::sqrt(var));
+}
+
+inline double excess_kurtosis(double mean, double var, double e3, double e4) {
+    if (var <= 0.0) return 0.0;
+    const double e2 = var + mean * mean;
+    const double mean2 = mean * mean;
+    const double m4 = e4 - 4.0 * mean * e3 + 6.0 * mean2 * e2 - 3.0 * mean2 * mean2;
+    return m4 / (var * var) - 3.0;
+}
+
+} // namespace
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+bool UnifiedFeatureEngine::Config::enabled(Category category) const {
+    switch (category) {
+        case Category::Time: return enable_time_features;
+        case Category::PriceAction: return enable_price_action;
+        case Category::MovingAverages: return enable_moving_averages;
+        case Category::Momentum: return enable_momentum;
+        case Category::Volatility: return enable_volatility;
+        case Category::Volume: return enable_volume;
+        case Category::Patterns: return enable_pattern_detection;
+        case Category::Statistical: return enable_statistical;
+        case Category::PriceLags: return enable_price_lags;
+        case Category::ReturnLags: return enable_return_lags;
+        default: return false;
+    }
+}
+
+int UnifiedFeatureEngine::Config::total_features() const {
+    int total = 0;
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+        if (enabled(static_cast<Category>(i))) total += CATEGORIES[i].size;
+    }
+    return total;
+}
+
+std::string UnifiedFeatureEngine::Config::fingerprint() const {
+    std::string out;
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+        out += CATEGORIES[i].name;
+        out += enabled(static_cast<Category>(i)) ? "=1;" : "=0;";
+    }
+    char buf[96];
+    std::snprintf(buf, sizeof(buf), "normalize=%d;clip=%.17g;warmup=%zu",
+                  normalize_features ? 1 : 0, clip_value, warmup_bars);
+    return out + buf;
+}
+
+int UnifiedFeatureEngine::category_size(Category category) {
+    return category < Category::Count ? CATEGORIES[static_cast<size_t>(category)].size : 0;
+}
+
+const char* UnifiedFeatureEngine::category_name(Category category) {
+    return category < Category::Count ? CATEGORIES[static_cast<size_t>(category)].name : "unknown";
+}
+
+const UnifiedFeatureEngine::Writer UnifiedFeatureEngine::WRITERS[CATEGORY_COUNT] = {
+    &UnifiedFeatureEngine::write_time,
+    &UnifiedFeatureEngine::write_price_action,
+    &UnifiedFeatureEngine::write_moving_averages,
+    &UnifiedFeatureEngine::write_momentum,
+    &UnifiedFeatureEngine::write_volatility,
+    &UnifiedFeatureEngine::write_volume,
+    &UnifiedFeatureEngine::write_patterns,
+    &UnifiedFeatureEngine::write_statistical,
+    &UnifiedFeatureEngine::write_price_lags,
+    &UnifiedFeatureEngine::write_return_lags,
+};
+
+UnifiedFeatureEngine::UnifiedFeatureEngine() : UnifiedFeatureEngine(Config()) {
+}
+
+UnifiedFeatureEngine::UnifiedFeatureEngine(const Config& config)
+    : config_(config),
+      feature_count_(config.total_features()),
+      current_(static_cast<size_t>(feature_count_), 0.0f) {
+}
+
+// =============================================================================
+// Update
+// =============================================================================
+
+void UnifiedFeatureEngine::update(const Bar& bar) {
+    update(bar, current_.data());
+}
+
+void UnifiedFeatureEngine::update(const Bar& bar, float* out) {
+    BarContext c;
+    c.open = bar.open;
+    c.high = bar.high;
+    c.low = bar.low;
+    c.close = bar.close;
+    c.volume = bar.volume;
+    c.timestamp_ms = bar.timestamp_ms;
+    c.prev_close = has_prev_ ? prev_.close : bar.close;
+    c.ret = rel(c.close, c.prev_close);
+    c.log_ret = (c.close > 0.0 && c.prev_close > 0.0) ? std::log(c.close / c.prev_close) : 0.0;
+    c.true_range = std::max({c.high - c.low, std::abs(c.high - c.prev_close), std::abs(c.low - c.prev_close)});
+    c.typical = (c.high + c.low + c.close) / 3.0;
+    c.log_volume = std::log1p(std::max(0.0, c.volume));
+
+    closes_.push(c.close);
+    returns_.push(c.ret);
+
+    float* p = out;
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+        if (!config_.enabled(static_cast<Category>(i))) continue;
+        if (timing_enabled_) {
+            const auto t0 = std::chrono::steady_clock::now();
+            p = (this->*WRITERS[i])(c, p);
+            const auto t1 = std::chrono::steady_clock::now();
+            timing_[i].calls++;
+            timing_[i].total_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        } else {
+            p = (this->*WRITERS[i])(c, p);
+        }
+    }
+
+    if (config_.normalize_features) {
+        const float clip = static_cast<float>(config_.clip_value);
+        for (float* f = out; f != p; ++f) {
+            *f = std::isfinite(*f) ? std::clamp(*f, -clip, clip) : 0.0f;
+        }
+    }
+
+    prev_.open = c.open;
+    prev_.high = c.high;
+    prev_.low = c.low;
+    prev_.close = c.close;
+    prev_.volume = c.volume;
+    prev_.typical = c.typical;
+    prev_.log_volume = c.log_volume;
+    has_prev_ = true;
+    ++bar_count_;
+}
+
+double UnifiedFeatureEngine::close_ago(size_t k) const {
+    return k < closes_.size() ? closes_.back(k) : closes_.front();
+}
+
+// -----------------------------------------------------------------------------
+// Time (UTC)
+// -----------------------------------------------------------------------------
+float* UnifiedFeatureEngine::write_time(const BarContext& c, float* out) {
+    // sin/cos of the minute of the day, computed once
+    static const std::vector<std::array<float, 2>> minute_of_day = [] {
+        std::vector<std::array<float, 2>> table(1440);
+        for (size_t m = 0; m < table.size(); ++m) {
+            const double angle = 2.0 * PI * static_cast<double>(m) / 1440.0;
+            table[m] = {static_cast<float>(std::sin(angle)), static_cast<float>(std::cos(angle))};
+        }
+        return table;
+    }();
+
+    const int64_t seconds = c.timestamp_ms / 1000;
+    const int64_t second_of_day = seconds % 86400;
+    if (second_of_day % 60 == 0) {
+        const auto& sc = minute_of_day[static_cast<size_t>(second_of_day / 60)];
+        *out++ = sc[0];
+        *out++ = sc[1];
+    } else {
+        const double angle = 2.0 * PI * static_cast<double>(second_of_day) / 86400.0;
+        *out++ = static_cast<float>(std::sin(angle));
+        *out++ = static_cast<float>(std::cos(angle));
+    }
+
+    const int64_t day = seconds / 86400;
+    if (day != time_day_) {
+        const double angle = 2.0 * PI * static_cast<double>((day + 4) % 7) / 7.0;   // 1970-01-01 was a Thursday
+        time_day_ = day;
+        day_of_week_[0] = static_cast<float>(std::sin(angle));
+        day_of_week_[1] = static_cast<float>(std::cos(angle));
+    }
+    *out++ = day_of_week_[0];
+    *out++ = day_of_week_[1];
+    *out++ = static_cast<float>((seconds / 60) % 60) / 60.0f;
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Price action
+// -----------------------------------------------------------------------------
+float* UnifiedFeatureEngine::write_price_action(const BarContext& c, float* out) {
+    high_10_.push(c.high);
+    low_10_.push(c.low);
+    high_20_.push(c.high);
+    low_20_.push(c.low);
+    high_50_.push(c.high);
+    low_50_.push(c.low);
+
+    const double range = c.high - c.low;
+    const double upper = c.high - std::max(c.open, c.close);
+    const double lower = std::min(c.open, c.close) - c.low;
+
+    *out++ = static_cast<float>(c.ret);
+    *out++ = static_cast<float>(c.log_ret);
+    *out++ = static_cast<float>(div0(range, c.close));
+    *out++ = static_cast<float>(div0(c.close - c.open, c.close));
+    *out++ = static_cast<float>(div0(upper, c.close));
+    *out++ = static_cast<float>(div0(lower, c.close));
+    *out++ = static_cast<float>(position(c.close, c.low, c.high));
+    *out++ = static_cast<float>(rel(c.open, c.prev_close));
+    *out++ = static_cast<float>(rel(c.close, close_ago(2)));
+    *out++ = static_cast<float>(rel(c.close, close_ago(3)));
+    *out++ = static_cast<float>(rel(c.close, close_ago(5)));
+    *out++ = static_cast<float>(rel(c.close, close_ago(10)));
+    *out++ = static_cast<float>(div0(c.true_range, c.close));
+    *out++ = static_cast<float>(position(c.close, low_10_.value(), high_10_.value()));
+    *out++ = static_cast<float>(position(c.close, low_20_.value(), high_20_.value()));
+    *out++ = static_cast<float>(position(c.close, low_50_.value(), high_50_.value()));
+    *out++ = static_cast<float>(rel(c.close, high_20_.value()));
+    *out++ = static_cast<float>(rel(c.close, low_20_.value()));
+    *out++ = static_cast<float>(div0(std::abs(c.close - c.open), range));
+    *out++ = static_cast<float>(rel(c.typical, c.close));
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Moving averages
+// -----------------------------------------------------------------------------
+float* UnifiedFeatureEngine::write_moving_averages(const BarContext& c, float* out) {
+    close_sma_.push(c.close);
+    close_ema_.push(c.close);
+    slope_10_.push(c.close);
+    slope_20_.push(c.close);
+
+    const double sma5 = close_sma_.get<5>().value();
+    const double sma10 = close_sma_.get<10>().value();
+    const double sma20 = close_sma_.get<20>().value();
+    const double sma50 = close_sma_.get<50>().value();
+    const double ema5 = close_ema_.get<5>().value();
+    const double ema10 = close_ema_.get<10>().value();
+    const double ema20 = close_ema_.get<20>().value();
+    const double ema50 = close_ema_.get<50>().value();
+
+    *out++ = static_cast<float>(rel(c.close, sma5));
+    *out++ = static_cast<float>(rel(c.close, sma10));
+    *out++ = static_cast<float>(rel(c.close, sma20));
+    *out++ = static_cast<float>(rel(c.close, sma50));
+    *out++ = static_cast<float>(rel(c.close, ema5));
+    *out++ = static_cast<float>(rel(c.close, ema10));
+    *out++ = static_cast<float>(rel(c.close, ema20));
+    *out++ = static_cast<float>(rel(c.close, ema50));
+    *out++ = static_cast<float>(rel(sma5, sma20));
+    *out++ = static_cast<float>(rel(sma10, sma50));
+    *out++ = static_cast<float>(rel(ema5, ema20));
+    *out++ = static_cast<float>(rel(ema10, ema50));
+    *out++ = static_cast<float>(div0(slope_10_.value(), c.close));
+    *out++ = static_cast<float>(div0(slope_20_.value(), c.close));
+    *out++ = static_cast<float>(div0(close_ema_.get<12>().value() - close_ema_.get<26>().value(), c.close));
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Momentum
+// -----------------------------------------------------------------------------
+float* UnifiedFeatureEngine::write_momentum(const BarContext& c, float* out) {
+    rsi_7_.push(c.close);
+    rsi_14_.push(c.close);
+    rsi_21_.push(c.close);
+    macd_ema_.push(c.close);
+    const double macd = macd_ema_.get<12>().value() - macd_ema_.get<26>().value();
+    macd_signal_.push(macd);
+    high_14_.push(c.high);
+    low_14_.push(c.low);
+    const double stoch_k = position(c.close, low_14_.value(), high_14_.value());
+    stoch_d_.push(stoch_k);
+    high_28_.push(c.high);
+    low_28_.push(c.low);
+    typical_20_.push(c.typical);
+    up_bars_10_.push(c.close > c.prev_close ? 1.0 : 0.0);
+    ret_ema_10_.push(c.ret);
+    abs_ret_ema_10_.push(std::abs(c.ret));
+
+    const double williams_range = high_28_.value() - low_28_.value();
+    const double prev_ret = returns_.size() > 1 ? returns_.back(1) : 0.0;
+
+    *out++ = static_cast<float>(rsi_7_.value() / 100.0);
+    *out++ = static_cast<float>(rsi_14_.value() / 100.0);
+    *out++ = static_cast<float>(rsi_21_.value() / 100.0);
+    *out++ = static_cast<float>(div0(macd_signal_.value(), c.close));
+    *out++ = static_cast<float>(div0(macd - macd_signal_.value(), c.close));
+    *out++ = static_cast<float>(stoch_k);
+    *out++ = static_cast<float>(stoch_d_.value());
+    *out++ = static_cast<float>(williams_range > 0.0 ? (c.close - high_28_.value()) / williams_range : -0.5);
+    *out++ = static_cast<float>(rel(c.close, close_ago(15)));
+    *out++ = static_cast<float>(rel(c.close, close_ago(30)));
+    *out++ = static_cast<float>(rel(c.close, close_ago(60)));
+    // CCI with the standard deviation in place of the mean absolute deviation
+    *out++ = static_cast<float>(div0(c.typical - typical_20_.mean(), 0.015 * typical_20_.stddev()) / 100.0);
+    *out++ = static_cast<float>(c.ret - prev_ret);
+    *out++ = static_cast<float>(up_bars_10_.value());
+    *out++ = static_cast<float>(div0(ret_ema_10_.value(), abs_ret_ema_10_.value()));
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Volatility
+// -----------------------------------------------------------------------------
+float* UnifiedFeatureEngine::write_volatility(const BarContext& c, float* out) {
+    vol_ret_5_.push(c.ret);
+    vol_ret_10_.push(c.ret);
+    vol_ret_20_.push(c.ret);
+    vol_ret_50_.push(c.ret);
+    true_range_14_.push(c.true_range);
+    const double log_hl = (c.high > 0.0 && c.low > 0.0) ? std::log(c.high / c.low) : 0.0;
+    const double log_co = (c.close > 0.0 && c.open > 0.0) ? std::log(c.close / c.open) : 0.0;
+    parkinson_20_.push(log_hl * log_hl);
+    garman_klass_20_.push(0.5 * log_hl * log_hl - (2.0 * LN2 - 1.0) * log_co * log_co);
+    bollinger_20_.push(c.close);
+
+    const double std5 = vol_ret_5_.stddev();
+    const double std10 = vol_ret_10_.stddev();
+    const double std20 = vol_ret_20_.stddev();
+    const double std50 = vol_ret_50_.stddev();
+
+    *out++ = static_cast<float>(std5);
+    *out++ = static_cast<float>(std10);
+    *out++ = static_cast<float>(std20);
+    *out++ = static_cast<float>(std50);
+    *out++ = static_cast<float>(div0(true_range_14_.value(), c.close));
+    *out++ = static_cast<float>(std::sqrt(parkinson_20_.value() / (4.0 * LN2)));
+    *out++ = static_cast<float>(std::sqrt(std::max(0.0, garman_klass_20_.value())));
+    *out++ = static_cast<float>(div0(std5, std20));
+    *out++ = static_cast<float>(div0(std10, std50));
+    *out++ = static_cast<float>(div0(4.0 * bollinger_20_.stddev(), bollinger_20_.mean()));
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Volume
+// -----------------------------------------------------------------------------
+float* UnifiedFeatureEngine::write_volume(const BarContext& c, float* out) {
+    const double v = c.volume;
+    const double log_v = c.log_volume;
+    const double up = c.close > c.prev_close ? 1.0 : 0.0;
+
+    volume_sma_.push(v);
+    log_volume_20_.push(log_v);
+    volume_20_.push(v);
+    if (c.close > c.prev_close) obv_ += v;
+    else if (c.close < c.prev_close) obv_ -= v;
+    obv_slope_10_.push(obv_);
+    obv_slope_20_.push(obv_);
+    pv_10_.push(c.typical * v);
+    pv_20_.push(c.typical * v);
+    pv_50_.push(c.typical * v);
+    up_volume_10_.push(up * v);
+    up_volume_20_.push(up * v);
+    volume_ema_5_.push(v);
+    volume_ema_20_.push(v);
+    const bool flow_up = has_prev_ && c.typical > prev_.typical;
+    const bool flow_down = has_prev_ && c.typical < prev_.typical;
+    positive_flow_14_.push(flow_up ? c.typical * v : 0.0);
+    negative_flow_14_.push(flow_down ? c.typical * v : 0.0);
+    flow_ret_20_.push(c.ret);
+    ret_volume_20_.push(c.ret * v);
+    const double range = c.high - c.low;
+    const double clv = range > 0.0 ? ((c.close - c.low) - (c.high - c.close)) / range : 0.0;
+    const double mean_v20 = volume_sma_.get<20>().value();
+    const double ad = div0(clv * v, mean_v20);
+    ad_10_.push(ad);
+
+    const auto& v10 = volume_sma_.get<10>();
+    const auto& v20 = volume_sma_.get<20>();
+    const auto& v50 = volume_sma_.get<50>();
+    const double flow_total = positive_flow_14_.sum() + negative_flow_14_.sum();
+    const double cov = ret_volume_20_.value() - flow_ret_20_.mean() * volume_20_.mean();
+    const double prev_log_v = has_prev_ ? prev_.log_volume : log_v;
+
+    *out++ = static_cast<float>(rel(v, volume_sma_.get<5>().value()));
+    *out++ = static_cast<float>(rel(v, v10.value()));
+    *out++ = static_cast<float>(rel(v, mean_v20));
+    *out++ = static_cast<float>(rel(v, v50.value()));
+    *out++ = static_cast<float>(div0(log_v - log_volume_20_.mean(), log_volume_20_.stddev()));
+    *out++ = static_cast<float>(log_v - prev_log_v);
+    *out++ = static_cast<float>(div0(obv_slope_10_.value(), mean_v20));
+    *out++ = static_cast<float>(div0(obv_slope_20_.value(), mean_v20));
+    *out++ = static_cast<float>(rel(c.close, div0(pv_10_.sum(), v10.sum())));
+    *out++ = static_cast<float>(rel(c.close, div0(pv_20_.sum(), v20.sum())));
+    *out++ = static_cast<float>(rel(c.close, div0(pv_50_.sum(), v50.sum())));
+    *out++ = static_cast<float>(div0(up_volume_10_.sum(), v10.sum()));
+    *out++ = static_cast<float>(div0(up_volume_20_.sum(), v20.sum()));
+    *out++ = static_cast<float>(rel(volume_ema_5_.value(), volume_ema_20_.value()));
+    *out++ = static_cast<float>(flow_total > 0.0 ? positive_flow_14_.sum() / flow_total : 0.5);
+    *out++ = static_cast<float>(div0(cov, flow_ret_20_.stddev() * volume_20_.stddev()));
+    *out++ = static_cast<float>(div0(volume_20_.stddev(), volume_20_.mean()));
+    *out++ = static_cast<float>(div0(c.ret * v, mean_v20));
+    *out++ = static_cast<float>(ad);
+    *out++ = static_cast<float>(ad_10_.value());
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Candlestick patterns (0/1)
+// -----------------------------------------------------------------------------
+float* UnifiedFeatureEngine::write_patterns(const BarContext& c, float* out) {
+    const double range = c.high - c.low;
+    const double body = std::abs(c.close - c.open);
+    const double upper = c.high - std::max(c.open, c.close);
+    const double lower = std::min(c.open, c.close) - c.low;
+    const bool prev_down = has_prev_ && prev_.close < prev_.open;
+    const bool prev_up = has_prev_ && prev_.close > prev_.open;
+
+    const bool doji = range > 0.0 && body <= 0.1 * range;
+    const bool hammer = range > 0.0 && lower >= 2.0 * body && upper <= 0.25 * range;
+    const bool shooting_star = range > 0.0 && upper >= 2.0 * body && lower <= 0.25 * range;
+    const bool bullish_engulfing = prev_down && c.close > c.open &&
+                                   c.open <= prev_.close && c.close >= prev_.open;
+    const bool bearish_engulfing = prev_up && c.close < c.open &&
+                                   c.open >= prev_.close && c.close <= prev_.open;
+    const bool inside_bar = has_prev_ && c.high < prev_.high && c.low > prev_.low;
+
+    *out++ = doji ? 1.0f : 0.0f;
+    *out++ = hammer ? 1.0f : 0.0f;
+    *out++ = shooting_star ? 1.0f : 0.0f;
+    *out++ = bullish_engulfing ? 1.0f : 0.0f;
+    *out++ = bearish_engulfing ? 1.0f : 0.0f;
+    *out++ = inside_bar ? 1.0f : 0.0f;
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Statistical (return distribution shape, z-scores)
+// -----------------------------------------------------------------------------
+float* UnifiedFeatureEngine::write_statistical(const BarContext& c, float* out) {
+    const double r = c.ret;
+    const double r2 = r * r;
+    stat_ret_20_.push(r);
+    stat_ret_50_.push(r);
+    ret3_20_.push(r2 * r);
+    ret4_20_.push(r2 * r2);
+    ret3_50_.push(r2 * r);
+    ret4_50_.push(r2 * r2);
+    ret_lag_prod_20_.push(returns_.size() > 1 ? r * returns_.back(1) : 0.0);
+    stat_close_20_.push(c.close);
+    stat_close_50_.push(c.close);
+    hl_range_20_.push(c.high - c.low);
+
+    const double mean20 = stat_ret_20_.mean();
+    const double var20 = stat_ret_20_.variance();
+    const double mean50 = stat_ret_50_.mean();
+    const double var50 = stat_ret_50_.variance();
+
+    *out++ = static_cast<float>(skewness(mean20, var20, ret3_20_.value()));
+    *out++ = static_cast<float>(excess_kurtosis(mean20, var20, ret3_20_.value(), ret4_20_.value()));
+    *out++ = static_cast<float>(skewness(mean50, var50, ret3_50_.value()));
+    *out++ = static_cast<float>(excess_kurtosis(mean50, var50, ret3_50_.value(), ret4_50_.value()));
+    *out++ = static_cast<float>(div0(ret_lag_prod_20_.value() - mean20 * mean20, var20));
+    *out++ = static_cast<float>(div0(c.close - stat_close_20_.mean(), stat_close_20_.stddev()));
+    *out++ = static_cast<float>(div0(c.close - stat_close_50_.mean(), stat_close_50_.stddev()));
+    *out++ = static_cast<float>(div0(mean20, std::sqrt(var20)));
+    *out++ = static_cast<float>(div0(mean50, std::sqrt(var50)));
+    *out++ = static_cast<float>(div0(c.high - c.low, hl_range_20_.value()));
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Lags
+// -----------------------------------------------------------------------------
+float* UnifiedFeatureEngine::write_price_lags(const BarContext& c, float* out) {
+    for (size_t k = 1; k <= 15; ++k) {
+        *out++ = static_cast<float>(rel(close_ago(k), c.close));
+    }
+    return out;
+}
+
+float* UnifiedFeatureEngine::write_return_lags(const BarContext& c, float* out) {
+    (void)c;
+    for (size_t k = 1; k <= 10; ++k) {
+        *out++ = static_cast<float>(k < returns_.size() ? returns_.back(k) : 0.0);
+    }
+    return out;
+}
+
+// =============================================================================
+// Accessors
+// =============================================================================
+
+std::vector<double> UnifiedFeatureEngine::get_features() const {
+    return std::vector<double>(current_.begin(), current_.end());
+}
+
+std::vector<std::string> UnifiedFeatureEngine::feature_names() const {
+    std::vector<std::string> names;
+    names.reserve(static_cast<size_t>(feature_count_));
+    auto add = [&names](const char* const* list, int n) {
+        for (int i = 0; i < n; ++i) names.emplace_back(list[i]);
+    };
+    if (config_.enable_time_features) add(TIME_NAMES, 5);
+    if (config_.enable_price_action) add(PRICE_ACTION_NAMES, 20);
+    if (config_.enable_moving_averages) add(MOVING_AVERAGE_NAMES, 15);
+    if (config_.enable_momentum) add(MOMENTUM_NAMES, 15);
+    if (config_.enable_volatility) add(VOLATILITY_NAMES, 10);
+    if (config_.enable_volume) add(VOLUME_NAMES, 20);
+    if (config_.enable_pattern_detection) add(PATTERN_NAMES, 6);
+    if (config_.enable_statistical) add(STATISTICAL_NAMES, 10);
+    if (config_.enable_price_lags) {
+        for (int k = 1; k <= 15; ++k) names.push_back("price_lag_" + std::to_string(k));
+    }
+    if (config_.enable_return_lags) {
+        for (int k = 1; k <= 10; ++k) names.push_back("return_lag_" + std::to_string(k));
+    }
+    return names;
+}
+
+void UnifiedFeatureEngine::reset() {
+    const bool timing = timing_enabled_;
+    *this = UnifiedFeatureEngine(config_);
+    timing_enabled_ = timing;
+}
+
+std::string UnifiedFeatureEngine::timing_report() const {
+    int64_t total_ns = 0;
+    for (const auto& t : timing_) total_ns += t.total_ns;
+
+    std::string out;
+    char buf[128];
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+        const Category category = static_cast<Category>(i);
+        if (!config_.enabled(category)) continue;
+        const CategoryTiming& t = timing_[i];
+        std::snprintf(buf, sizeof(buf), "  %-16s calls=%-10llu %8.1f ns/bar %6.1f%%\n",
+                      category_name(category), static_cast<unsigned long long>(t.calls),
+                      t.calls ? static_cast<double>(t.total_ns) / t.calls : 0.0,
+                      total_ns ? 100.0 * t.total_ns / total_ns : 0.0);
+        out += buf;
+    }
+    return out;
+}
+
+// =============================================================================
+// Snapshots
+// =============================================================================
+
+template <typename Engine, typename F>
+bool UnifiedFeatureEngine::for_each_kernel(Engine& e, F&& f) {
+    return f(e.closes_) && f(e.returns_) &&
+           f(e.high_10_) && f(e.low_10_) && f(e.high_20_) && f(e.low_20_) && f(e.high_50_) && f(e.low_50_) &&
+           f(e.close_sma_) && f(e.close_ema_) && f(e.slope_10_) && f(e.slope_20_) &&
+           f(e.rsi_7_) && f(e.rsi_14_) && f(e.rsi_21_) && f(e.macd_ema_) && f(e.macd_signal_) &&
+           f(e.high_14_) && f(e.low_14_) && f(e.stoch_d_) && f(e.high_28_) && f(e.low_28_) &&
+           f(e.typical_20_) && f(e.up_bars_10_) && f(e.ret_ema_10_) && f(e.abs_ret_ema_10_) &&
+           f(e.vol_ret_5_) && f(e.vol_ret_10_) && f(e.vol_ret_20_) && f(e.vol_ret_50_) &&
+           f(e.true_range_14_) && f(e.parkinson_20_) && f(e.garman_klass_20_) && f(e.bollinger_20_) &&
+           f(e.volume_sma_) && f(e.log_volume_20_) && f(e.volume_20_) &&
+           f(e.obv_slope_10_) && f(e.obv_slope_20_) && f(e.pv_10_) && f(e.pv_20_) && f(e.pv_50_) &&
+           f(e.up_volume_10_) && f(e.up_volume_20_) && f(e.volume_ema_5_) && f(e.volume_ema_20_) &&
+           f(e.positive_flow_14_) && f(e.negative_flow_14_) && f(e.flow_ret_20_) && f(e.ret_volume_20_) &&
+           f(e.ad_10_) &&
+           f(e.stat_ret_20_) && f(e.stat_ret_50_) && f(e.ret3_20_) && f(e.ret4_20_) && f(e.ret3_50_) &&
+           f(e.ret4_50_) && f(e.ret_lag_prod_20_) && f(e.stat_close_20_) && f(e.stat_close_50_) &&
+           f(e.hl_range_20_);
+}
+
+void UnifiedFeatureEngine::save_state(StateWriter& w) const {
+    w.put(static_cast<uint32_t>(feature_count_));
+    w.put(static_cast<uint64_t>(bar_count_));
+    w.put(prev_);
+    w.put(static_cast<uint8_t>(has_prev_ ? 1 : 0));
+    w.put(obv_);
+    for_each_kernel(*this, [&w](const auto& k) { k.save(w); return true; });
+}
+
+bool UnifiedFeatureEngine::load_state(StateReader& r) {
+    UnifiedFeatureEngine loaded(config_);
+    uint32_t count = 0;
+    uint64_t bars = 0;
+    uint8_t has_prev = 0;
+    if (!r.get(count) || count != static_cast<uint32_t>(feature_count_) ||
+        !r.get(bars) || !r.get(loaded.prev_) || !r.get(has_prev) || !r.get(loaded.obv_)) {
+        return false;
+    }
+    if (!for_each_kernel(loaded, [&r](auto& k) { return k.load(r); })) {
+        return false;
+    }
+    loaded.bar_count_ = static_cast<size_t>(bars);
+    loaded.has_prev_ = has_prev != 0;
+    loaded.timing_enabled_ = timing_enabled_;
+    loaded.timing_ = timing_;
+    *this = std::move(loaded);
+    return true;
+}
+
+} // namespace features
+} // namespace sentio
@@ -0,0 +1,439 @@
+#include "ml/gemm_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define SENTIO_KERNELS_AVX2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SENTIO_KERNELS_NEON 1
+#endif
+
+namespace sentio {
+namespace ml {
+namespace kernels {
+
+namespace {
+
+// Weight rows per gemm_nt() block: keep the block within ~32 KB.
+constexpr int BLOCK_BYTES = 32 * 1024;
+
+inline float widen(int8_t v) {
+    return static_cast<float>(v);
+}
+
+inline float widen(uint16_t v) {
+    const uint32_t bits = static_cast<uint32_t>(v) << 16;
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+#if defined(SENTIO_KERNELS_AVX2)
+
+inline float hsum(__m256 v) {
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    lo = _mm_add_ps(lo, hi);
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_movehdup_ps(lo));
+    return _mm_cvtss_f32(lo);
+}
+
+// out[r] = dot(w + r * stride, x) for r = 0..3
+inline void dot4(const float* w, int stride, const float* x, int n, float* out) {
+    const float* w0 = w;
+    const float* w1 = w + stride;
+    const float* w2 = w + 2 * stride;
+    const float* w3 = w + 3 * stride;
+    __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+    __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+    int i = 0;
+    // Two independent accumulator sets hide the FMA latency
+    __m256 b0 = _mm256_setzero_ps(), b1 = _mm256_setzero_ps();
+    __m256 b2 = _mm256_setzero_ps(), b3 = _mm256_setzero_ps();
+    for (; i + 16 <= n; i += 16) {
+        const __m256 xa = _mm256_loadu_ps(x + i);
+        const __m256 xb = _mm256_loadu_ps(x + i + 8);
+        a0 = _mm256_fmadd_ps(_mm256_loadu_ps(w0 + i), xa, a0);
+        a1 = _mm256_fmadd_ps(_mm256_loadu_ps(w1 + i), xa, a1);
+        a2 = _mm256_fmadd_ps(_mm256_loadu_ps(w2 + i), xa, a2);
+        a3 = _mm256_fmadd_ps(_mm256_loadu_ps(w3 + i), xa, a3);
+        b0 = _mm256_fmadd_ps(_mm256_loadu_ps(w0 + i + 8), xb, b0);
+        b1 = _mm256_fmadd_ps(_mm256_loadu_ps(w1 + i + 8), xb, b1);
+        b2 = _mm256_fmadd_ps(_mm256_loadu_ps(w2 + i + 8), xb, b2);
+        b3 = _mm256_fmadd_ps(_mm256_loadu_ps(w3 + i + 8), xb, b3);
+    }
+    a0 = _mm256_add_ps(a0, b0);
+    a1 = _mm256_add_ps(a1, b1);
+    a2 = _mm256_add_ps(a2, b2);
+    a3 = _mm256_add_ps(a3, b3);
+    for (; i + 8 <= n; i += 8) {
+        const __m256 xv = _mm256_loadu_ps(x + i);
+        a0 = _mm256_fmadd_ps(_mm256_loadu_ps(w0 + i), xv, a0);
+        a1 = _mm256_fmadd_ps(_mm256_loadu_ps(w1 + i), xv, a1);
+        a2 = _mm256_fmadd_ps(_mm256_loadu_ps(w2 + i), xv, a2);
+        a3 = _mm256_fmadd_ps(_mm256_loadu_ps(w3 + i), xv, a3);
+    }
+    float s0 = hsum(a0), s1 = hsum(a1), s2 = hsum(a2), s3 = hsum(a3);
+    for (; i < n; ++i) {
+        s0 += w0[i] * x[i];
+        s1 += w1[i] * x[i];
+        s2 += w2[i] * x[i];
+        s3 += w3[i] * x[i];
+    }
+    out[0] = s0; out[1] = s1; out[2] = s2; out[3] = s3;
+}
+
+inline float dot1(const float* a, const float* b, int n) {
+    __m256 acc = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc);
+    }
+    float s = hsum(acc);
+    for (; i < n; ++i) s += a[i] * b[i];
+    return s;
+}
+
+// Reduced-precision rows widened to 8 floats per load
+struct WidenBf16 {
+    static __m256 load8(const uint16_t* p) {
+        const __m256i v = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(v, 16));
+    }
+};
+struct WidenInt8 {
+    static __m256 load8(const int8_t* p) {
+        return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+    }
+};
+
+template <typename Widen, typename T>
+inline void dot4_reduced(const T* w, int stride, const float* x, int n, float* out) {
+    const T* w0 = w;
+    const T* w1 = w + stride;
+    const T* w2 = w + 2 * stride;
+    const T* w3 = w + 3 * stride;
+    __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+    __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 xv = _mm256_loadu_ps(x + i);
+        a0 = _mm256_fmadd_ps(Widen::load8(w0 + i), xv, a0);
+        a1 = _mm256_fmadd_ps(Widen::load8(w1 + i), xv, a1);
+        a2 = _mm256_fmadd_ps(Widen::load8(w2 + i), xv, a2);
+        a3 = _mm256_fmadd_ps(Widen::load8(w3 + i), xv, a3);
+    }
+    float s0 = hsum(a0), s1 = hsum(a1), s2 = hsum(a2), s3 = hsum(a3);
+    for (; i < n; ++i) {
+        s0 += widen(w0[i]) * x[i];
+        s1 += widen(w1[i]) * x[i];
+        s2 += widen(w2[i]) * x[i];
+        s3 += widen(w3[i]) * x[i];
+    }
+    out[0] = s0; out[1] = s1; out[2] = s2; out[3] = s3;
+}
+
+#elif defined(SENTIO_KERNELS_NEON)
+
+inline void dot4(const float* w, int stride, const float* x, int n, float* out) {
+    const float* w0 = w;
+    const float* w1 = w + stride;
+    const float* w2 = w + 2 * stride;
+    const float* w3 = w + 3 * stride;
+    float32x4_t a0 = vdupq_n_f32(0.0f), a1 = vdupq_n_f32(0.0f);
+    float32x4_t a2 = vdupq_n_f32(0.0f), a3 = vdupq_n_f32(0.0f);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t xv = vld1q_f32(x + i);
+        a0 = vfmaq_f32(a0, vld1q_f32(w0 + i), xv);
+        a1 = vfmaq_f32(a1, vld1q_f32(w1 + i), xv);
+        a2 = vfmaq_f32(a2, vld1q_f32(w2 + i), xv);
+        a3 = vfmaq_f32(a3, vld1q_f32(w3 + i), xv);
+    }
+    float s0 = vaddvq_f32(a0), s1 = vaddvq_f32(a1), s2 = vaddvq_f32(a2), s3 = vaddvq_f32(a3);
+    for (; i < n; ++i) {
+        s0 += w0[i] * x[i];
+        s1 += w1[i] * x[i];
+        s2 += w2[i] * x[i];
+        s3 += w3[i] * x[i];
+    }
+    out[0] = s0; out[1] = s1; out[2] = s2; out[3] = s3;
+}
+
+inline float dot1(const float* a, const float* b, int n) {
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) acc = vfmaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+    float s = vaddvq_f32(acc);
+    for (; i < n; ++i) s += a[i] * b[i];
+    return s;
+}
+
+struct WidenBf16 {
+    static void load8(const uint16_t* p, float32x4_t& lo, float32x4_t& hi) {
+        const uint16x8_t v = vld1q_u16(p);
+        lo = vreinterpretq_f32_u32(vshll_n_u16(vget_low_u16(v), 16));
+        hi = vreinterpretq_f32_u32(vshll_n_u16(vget_high_u16(v), 16));
+    }
+};
+struct WidenInt8 {
+    static void load8(const int8_t* p, float32x4_t& lo, float32x4_t& hi) {
+        const int16x8_t v = vmovl_s8(vld1_s8(p));
+        lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+        hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+    }
+};
+
+template <typename Widen, typename T>
+inline void dot4_reduced(const T* w, int stride, const float* x, int n, float* out) {
+    float32x4_t acc[4] = {vdupq_n_f32(0.0f), vdupq_n_f32(0.0f), vdupq_n_f32(0.0f), vdupq_n_f32(0.0f)};
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const float32x4_t xlo = vld1q_f32(x + i);
+        const float32x4_t xhi = vld1q_f32(x + i + 4);
+        for (int r = 0; r < 4; ++r) {
+            float32x4_t lo, hi;
+            Widen::load8(w + r * stride + i, lo, hi);
+            acc[r] = vfmaq_f32(vfmaq_f32(acc[r], lo, xlo), hi, xhi);
+        }
+    }
+    for (int r = 0; r < 4; ++r) {
+        float s = vaddvq_f32(acc[r]);
+        for (int j = i; j < n; ++j) s += widen(w[r * stride + j]) * x[j];
+        out[r] = s;
+    }
+}
+
+#else
+
+inline void dot4(const float* w, int stride, const float* x, int n, float* out) {
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        s0 += w[i] * x[i];
+        s1 += w[stride + i] * x[i];
+        s2 += w[2 * stride + i] * x[i];
+        s3 += w[3 * stride + i] * x[i];
+    }
+    out[0] = s0; out[1] = s1; out[2] = s2; out[3] = s3;
+}
+
+inline float dot1(const float* a, const float* b, int n) {
+    float s = 0.0f;
+    for (int i = 0; i < n; ++i) s += a[i] * b[i];
+    return s;
+}
+
+struct WidenBf16 {};
+struct WidenInt8 {};
+
+template <typename Widen, typename T>
+inline void dot4_reduced(const T* w, int stride, const float* x, int n, float* out) {
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        s0 += widen(w[i]) * x[i];
+        s1 += widen(w[stride + i]) * x[i];
+        s2 += widen(w[2 * stride + i]) * x[i];
+        s3 += widen(w[3 * stride + i]) * x[i];
+    }
+    out[0] = s0; out[1] = s1; out[2] = s2; out[3] = s3;
+}
+
+#endif
+
+// y[r] = dot(W row r, x) (+ bias[r]) for rows [begin, end)
+inline void rows_times_vector(const float* W, const float* x, const float* bias, float* y,
+                              int begin, int end, int cols) {
+    int r = begin;
+    for (; r + 4 <= end; r += 4) {
+        dot4(W + static_cast<size_t>(r) * cols, cols, x, cols, y + r);
+    }
+    for (; r < end; ++r) {
+        y[r] = dot1(W + static_cast<size_t>(r) * cols, x, cols);
+    }
+    if (bias) {
+        for (r = begin; r < end; ++r) y[r] += bias[r];
+    }
+}
+
+// Reduced-precision rows_times_vector(); `scales` (Int8) multiply each row's dot
+template <typename Widen, typename T>
+inline void reduced_rows_times_vector(const T* W, const float* scales, const float* x, const float* bias,
+                                      float* y, int begin, int end, int cols) {
+    int r = begin;
+    for (; r + 4 <= end; r += 4) {
+        dot4_reduced<Widen>(W + static_cast<size_t>(r) * cols, cols, x, cols, y + r);
+    }
+    for (; r < end; ++r) {
+        const T* row = W + static_cast<size_t>(r) * cols;
+        float s = 0.0f;
+        for (int i = 0; i < cols; ++i) s += widen(row[i]) * x[i];
+        y[r] = s;
+    }
+    for (r = begin; r < end; ++r) {
+        if (scales) y[r] *= scales[r];
+        if (bias) y[r] += bias[r];
+    }
+}
+
+inline void matrix_rows_times_vector(const WeightMatrix& W, const float* x, const float* bias, float* y,
+                                     int begin, int end) {
+    switch (W.precision) {
+        case WeightPrecision::Fp32:
+            rows_times_vector(W.fp32, x, bias, y, begin, end, W.cols);
+            break;
+        case WeightPrecision::Bf16:
+            reduced_rows_times_vector<WidenBf16>(W.bf16.data(), nullptr, x, bias, y, begin, end, W.cols);
+            break;
+        case WeightPrecision::Int8:
+            reduced_rows_times_vector<WidenInt8>(W.int8.data(), W.scales.data(), x, bias, y, begin, end, W.cols);
+            break;
+    }
+}
+
+// Round-to-nearest-even float -> bf16
+inline uint16_t to_bf16(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    bits += 0x7FFF + ((bits >> 16) & 1);
+    return static_cast<uint16_t>(bits >> 16);
+}
+
+} // namespace
+
+const char* simd_path() {
+#if defined(SENTIO_KERNELS_AVX2)
+    return "avx2";
+#elif defined(SENTIO_KERNELS_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+float dot(const float* a, const float* b, int n) {
+    return dot1(a, b, n);
+}
+
+void gemv(const float* W, const float* x, const float* bias, float* y, int rows, int cols) {
+    rows_times_vector(W, x, bias, y, 0, rows, cols);
+}
+
+void gemm_nt(const float* X, const float* W, const float* bias, float* Y, int m, int n, int k) {
+    if (m == 1) {
+        gemv(W, X, bias, Y, n, k);
+        return;
+    }
+    const int block = std::max(4, (BLOCK_BYTES / static_cast<int>(sizeof(float) * std::max(k, 1))) & ~3);
+    for (int j0 = 0; j0 < n; j0 += block) {
+        const int j1 = std::min(n, j0 + block);
+        for (int i = 0; i < m; ++i) {
+            rows_times_vector(W, X + static_cast<size_t>(i) * k, bias, Y + static_cast<size_t>(i) * n,
+                              j0, j1, k);
+        }
+    }
+}
+
+const char* to_string(WeightPrecision precision) {
+    switch (precision) {
+        case WeightPrecision::Bf16: return "bf16";
+        case WeightPrecision::Int8: return "int8";
+        case WeightPrecision::Fp32: break;
+    }
+    return "fp32";
+}
+
+bool parse_weight_precision(const std::string& name, WeightPrecision& precision) {
+    if (name == "fp32") precision = WeightPrecision::Fp32;
+    else if (name == "bf16") precision = WeightPrecision::Bf16;
+    else if (name == "int8") precision = WeightPrecision::Int8;
+    else return false;
+    return true;
+}
+
+WeightMatrix WeightMatrix::quantize(const float* W, int rows, int cols, WeightPrecision precision) {
+    WeightMatrix m;
+    m.precision = precision;
+    m.rows = rows;
+    m.cols = cols;
+    const size_t count = static_cast<size_t>(rows) * cols;
+    switch (precision) {
+        case WeightPrecision::Fp32:
+            m.fp32 = W;
+            break;
+        case WeightPrecision::Bf16:
+            m.bf16.resize(count);
+            for (size_t i = 0; i < count; ++i) m.bf16[i] = to_bf16(W[i]);
+            break;
+        case WeightPrecision::Int8:
+            m.int8.resize(count);
+            m.scales.resize(rows);
+            for (int r = 0; r < rows; ++r) {
+                const float* row = W + static_cast<size_t>(r) * cols;
+                float peak = 0.0f;
+                for (int i = 0; i < cols; ++i) peak = std::max(peak, std::abs(row[i]));
+                const float scale = peak > 0.0f ? peak / 127.0f : 1.0f;
+                m.scales[r] = scale;
+                for (int i = 0; i < cols; ++i) {
+                    const float q = std::nearbyint(row[i] / scale);
+                    m.int8[static_cast<size_t>(r) * cols + i] = static_cast<int8_t>(std::max(-127.0f, std::min(127.0f, q)));
+                }
+            }
+            break;
+    }
+    return m;
+}
+
+size_t WeightMatrix::bytes() const {
+    const size_t count = static_cast<size_t>(rows) * cols;
+    switch (precision) {
+        case WeightPrecision::Bf16: return count * sizeof(uint16_t);
+        case WeightPrecision::Int8: return count * sizeof(int8_t) + scales.size() * sizeof(float);
+        case WeightPrecision::Fp32: break;
+    }
+    return count * sizeof(float);
+}
+
+void gemv(const WeightMatrix& W, const float* x, const float* bias, float* y) {
+    matrix_rows_times_vector(W, x, bias, y, 0, W.rows);
+}
+
+void gemm_nt(const float* X, const WeightMatrix& W, const float* bias, float* Y, int m) {
+    const int n = W.rows, k = W.cols;
+    if (m == 1) {
+        gemv(W, X, bias, Y);
+        return;
+    }
+    // Same blocking as the fp32 kernel, sized by the stored element width
+    const int element = static_cast<int>(W.bytes() / std::max<size_t>(static_cast<size_t>(n) * k, 1));
+    const int block = std::max(4, (BLOCK_BYTES / (std::max(element, 1) * std::max(k, 1))) & ~3);
+    for (int j0 = 0; j0 < n; j0 += block) {
+        const int j1 = std::min(n, j0 + block);
+        for (int i = 0; i < m; ++i) {
+            matrix_rows_times_vector(W, X + static_cast<size_t>(i) * k, bias, Y + static_cast<size_t>(i) * n, j0, j1);
+        }
+    }
+}
+
+void layer_norm(float* x, const float* gamma, const float* beta, int n, float eps) {
+    float mean = 0.0f;
+    for (int i = 0; i < n; ++i) mean += x[i];
+    mean /= n;
+    float var = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        const float d = x[i] - mean;
+        var += d * d;
+    }
+    const float inv = 1.0f / std::sqrt(var / n + eps);
+    for (int i = 0; i < n; ++i) {
+        x[i] = (x[i] - mean) * inv * gamma[i] + beta[i];
+    }
+}
+
+} // namespace kernels
+} // namespace ml
+} // namespace sentio
@@ -1,6 +1,8 @@
 #include "ml/gru_model.h"
+#include "ml/native_gru.h"
 #include <iostream>
 #include <filesystem>
+#include <stdexcept>
 
 namespace sentio {
 namespace ml {
@@ -85,6 +87,32 @@ torch::nn::Sequential AdvancedGRUModelImpl::create_prediction_head(int output_di
 
 GRUOutput AdvancedGRUModelImpl::forward(const torch::Tensor& input) {
     // Input shape: [batch_size, sequence_length, feature_dim]
+    return predict(encode(input, nullptr, nullptr));
+}
+
+GRUOutput AdvancedGRUModelImpl::forward_window(const torch::Tensor& input, GRUStreamState& state) {
+    state.hidden.clear();
+    auto last_timestep = encode(input, nullptr, &state.hidden);
+    state.steps_since_sync = 0;
+    return predict(last_timestep);
+}
+
+GRUOutput AdvancedGRUModelImpl::forward_step(const torch::Tensor& features, GRUStreamState& state) {
+    if (state.hidden.size() != gru_layers_.size()) {
+        throw std::runtime_error("forward_step() needs a state initialized by forward_window()");
+    }
+    // One timestep: [batch_size, 1, feature_dim]
+    auto step = features.dim() == 2 ? features.unsqueeze(1) : features;
+    std::vector<torch::Tensor> h_n;
+    auto last_timestep = encode(step, &state.hidden, &h_n);
+    state.hidden = std::move(h_n);
+    state.steps_since_sync++;
+    return predict(last_timestep);
+}
+
+torch::Tensor AdvancedGRUModelImpl::encode(const torch::Tensor& input,
+                                           const std::vector<torch::Tensor>* h0,
+                                           std::vector<torch::Tensor>* h_n) {
     auto x = input;
     
     // Feature encoding
@@ -97,9 +125,12 @@ GRUOutput AdvancedGRUModelImpl::forward(const torch::Tensor& input) {
     for (size_t i = 0; i < gru_layers_.size(); ++i) {
         auto residual = x;
         
-        // GRU forward pass
-        auto gru_output = gru_layers_[i](x);
-        x = std::get<0>(gru_output); // Get output tensor, ignore hidden state
+        // GRU forward pass (from the carried hidden state when streaming)
+        auto gru_output = h0 ? gru_layers_[i]->forward(x, (*h0)[i]) : gru_layers_[i]->forward(x);
+        x = std::get<0>(gru_output);
+        if (h_n) {
+            h_n->push_back(std::get<1>(gru_output));
+        }
         
         // Layer normalization
         x = layer_norms_[i](x);
@@ -110,7 +141,10 @@ GRUOutput AdvancedGRUModelImpl::forward(const torch::Tensor& input) {
         }
     }
     
-    // Multi-head attention
+    // Multi-head attention. MultiheadAttention is sequence-first, so with the
+    // batch-first x it mixes across the batch at each timestep, never across
+    // timesteps: the last timestep's output needs only the last timestep,
+    // which is why forward_step() can run it on the new step alone.
     auto attention_output = attention_(x, x, x);
     auto attended = std::get<0>(attention_output); // Get output tensor, ignore attention weights
     
@@ -118,8 +152,10 @@ GRUOutput AdvancedGRUModelImpl::forward(const torch::Tensor& input) {
     attended = attention_norm_(attended + x);
     
     // Get last timestep output for prediction
-    auto last_timestep = attended.select(1, -1); // [batch_size, hidden_dim]
-    
+    return attended.select(1, -1); // [batch_size, hidden_dim]
+}
+
+GRUOutput AdvancedGRUModelImpl::predict(const torch::Tensor& last_timestep) {
     // Generate predictions
     GRUOutput output;
     
@@ -132,7 +168,7 @@ GRUOutput AdvancedGRUModelImpl::forward(const torch::Tensor& input) {
     } else {
         output.direction = direction_head_->forward(last_timestep);
         // Set other outputs to neutral values
-        auto batch_size = input.size(0);
+        auto batch_size = last_timestep.size(0);
         output.magnitude = torch::zeros({batch_size, 1});
         output.confidence = torch::full({batch_size, 1}, 0.5);
         output.volatility = torch::full({batch_size, 1}, 0.1);
@@ -187,5 +223,34 @@ void AdvancedGRUModelImpl::load_model(const std::string& path) {
     }
 }
 
+bool AdvancedGRUModelImpl::export_native(const std::string& path) {
+    NativeGruConfig native_config;
+    native_config.feature_dim = static_cast<uint32_t>(config_.feature_dim);
+    native_config.hidden_dim = static_cast<uint32_t>(config_.hidden_dim);
+    native_config.num_layers = static_cast<uint32_t>(config_.num_layers);
+    native_config.num_heads = static_cast<uint32_t>(config_.num_heads);
+    native_config.sequence_length = static_cast<uint32_t>(config_.sequence_length);
+    native_config.multi_task = config_.enable_multi_task ? 1 : 0;
+    
+    // Contiguous float32 copies stay alive until the file is written
+    std::vector<torch::Tensor> tensors;
+    std::vector<NativeGruModel::TensorView> views;
+    for (const auto& item : named_parameters()) {
+        if (!item.value().defined()) continue;  // e.g. unused attention projections
+        auto tensor = item.value().detach().to(torch::kCPU, torch::kFloat).contiguous();
+        NativeGruModel::TensorView view;
+        view.name = item.key();
+        for (auto d : tensor.sizes()) view.shape.push_back(static_cast<uint32_t>(d));
+        view.data = tensor.data_ptr<float>();
+        tensors.push_back(tensor);
+        views.push_back(std::move(view));
+    }
+    if (!NativeGruModel::write_weights(path, native_config, views)) {
+        return false;
+    }
+    std::cout << "Native weights exported to: " << path << std::endl;
+    return true;
+}
+
 } // namespace ml
 } // namespace sentio
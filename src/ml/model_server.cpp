@@ -0,0 +1,571 @@
+#include "ml/model_server.h"
+#include "ml/native_gru.h"
+#include "common/utils.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifdef TORCH_AVAILABLE
+#include "strategy/transformer_architecture.h"
+#include <torch/script.h>
+#include <torch/torch.h>
+#endif
+
+namespace sentio {
+namespace ml {
+
+// =============================================================================
+// Wire helpers
+// =============================================================================
+
+namespace serving {
+
+bool send_frame(int fd, FrameType type, uint64_t request_id,
+                const void* part1, size_t bytes1, const void* part2, size_t bytes2) {
+    FrameHeader header;
+    header.type = static_cast<uint32_t>(type);
+    header.request_id = request_id;
+    header.payload_bytes = static_cast<uint32_t>(bytes1 + bytes2);
+    iovec parts[3] = {{&header, sizeof(header)},
+                      {const_cast<void*>(part1), bytes1},
+                      {const_cast<void*>(part2), bytes2}};
+    iovec* next = parts;
+    int remaining = 3;
+    while (remaining > 0) {
+        msghdr msg{};
+        msg.msg_iov = next;
+        msg.msg_iovlen = static_cast<size_t>(remaining);
+        ssize_t n = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        // Advance past what was written (partial writes on large payloads)
+        size_t written = static_cast<size_t>(n);
+        while (remaining > 0 && written >= next->iov_len) {
+            written -= next->iov_len;
+            ++next;
+            --remaining;
+        }
+        if (remaining > 0) {
+            next->iov_base = static_cast<char*>(next->iov_base) + written;
+            next->iov_len -= written;
+        }
+    }
+    return true;
+}
+
+bool recv_exact(int fd, void* dst, size_t bytes) {
+    char* p = static_cast<char*>(dst);
+    while (bytes > 0) {
+        ssize_t n = ::recv(fd, p, bytes, 0);
+        if (n == 0) return false;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        bytes -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool recv_header(int fd, FrameHeader& header) {
+    return recv_exact(fd, &header, sizeof(header)) && header.magic == MAGIC &&
+           header.payload_bytes <= MAX_PAYLOAD_BYTES;
+}
+
+} // namespace serving
+
+// =============================================================================
+// Backends
+// =============================================================================
+
+namespace {
+
+// Direction logit per window; rows run one after another (the engine is
+// batch size 1), so a row's output does not depend on its batch neighbours.
+// Windows may be shorter than the exported sequence length, as in
+// OptimizedGruStrategy::load_native_model().
+class NativeGruBackend : public ModelBackend {
+public:
+    bool load(const std::string& path, kernels::WeightPrecision precision, uint32_t sequence_length,
+              std::string& error) {
+        if (!model_.load(path, precision)) {
+            error = "cannot load native GRU weights: " + path;
+            return false;
+        }
+        if (sequence_length == 0 || sequence_length > model_.config().sequence_length) {
+            error = path + " was exported for at most " + std::to_string(model_.config().sequence_length) + " steps";
+            return false;
+        }
+        sequence_length_ = sequence_length;
+        return true;
+    }
+    uint32_t sequence_length() const override { return sequence_length_; }
+    uint32_t feature_dim() const override { return model_.config().feature_dim; }
+    uint32_t output_dim() const override { return 1; }
+    bool forward(const float* windows, int rows, float* out) override {
+        const size_t window = static_cast<size_t>(sequence_length_) * feature_dim();
+        for (int r = 0; r < rows; ++r) {
+            if (!model_.forward(windows + r * window, static_cast<int>(sequence_length_), output_)) return false;
+            out[r] = output_.direction;
+        }
+        return true;
+    }
+
+private:
+    NativeGruModel model_;
+    NativeGruOutput output_;
+    uint32_t sequence_length_ = 0;
+};
+
+#ifdef TORCH_AVAILABLE
+// OptimizedGruStrategy's TorchScript model: first output, column 0 (the
+// direction logit) per window.
+class TorchScriptGruBackend : public ModelBackend {
+public:
+    TorchScriptGruBackend(uint32_t sequence_length, uint32_t feature_dim)
+        : sequence_length_(sequence_length), feature_dim_(feature_dim) {}
+
+    bool load(const std::string& path, std::string& error) {
+        try {
+            module_ = torch::jit::load(path);
+            module_.eval();
+            module_.to(torch::kCPU);
+            return true;
+        } catch (const std::exception& e) {
+            error = "cannot load TorchScript model " + path + ": " + e.what();
+            return false;
+        }
+    }
+    uint32_t sequence_length() const override { return sequence_length_; }
+    uint32_t feature_dim() const override { return feature_dim_; }
+    uint32_t output_dim() const override { return 1; }
+    bool forward(const float* windows, int rows, float* out) override {
+        torch::NoGradGuard no_grad;
+        auto input = torch::from_blob(const_cast<float*>(windows),
+                                      {rows, static_cast<int64_t>(sequence_length_), static_cast<int64_t>(feature_dim_)},
+                                      torch::kFloat);
+        auto output = module_.forward({input});
+        torch::Tensor direction = output.isTuple() ? output.toTuple()->elements()[0].toTensor() : output.toTensor();
+        torch::Tensor logits = direction.reshape({rows, -1}).select(1, 0).to(torch::kFloat).contiguous();
+        std::memcpy(out, logits.data_ptr<float>(), static_cast<size_t>(rows) * sizeof(float));
+        return true;
+    }
+
+private:
+    uint32_t sequence_length_;
+    uint32_t feature_dim_;
+    torch::jit::script::Module module_;
+};
+
+// TransformerStrategy's checkpoint: (predicted return, log variance) per window.
+class TransformerBackend : public ModelBackend {
+public:
+    TransformerBackend(uint32_t sequence_length, uint32_t feature_dim)
+        : sequence_length_(sequence_length), feature_dim_(feature_dim) {}
+
+    bool load(const std::string& path, std::string& error) {
+        try {
+            model_ = std::make_unique<TransformerModel>(
+                transformer_model_config(static_cast<int>(sequence_length_), static_cast<int>(feature_dim_)));
+            torch::load(*model_, path);
+            (*model_)->to(torch::kCPU);
+            (*model_)->eval();
+            return true;
+        } catch (const std::exception& e) {
+            error = "cannot load Transformer model " + path + ": " + e.what();
+            return false;
+        }
+    }
+    uint32_t sequence_length() const override { return sequence_length_; }
+    uint32_t feature_dim() const override { return feature_dim_; }
+    uint32_t output_dim() const override { return 2; }
+    bool forward(const float* windows, int rows, float* out) override {
+        torch::NoGradGuard no_grad;
+        auto input = torch::from_blob(const_cast<float*>(windows),
+                                      {rows, static_cast<int64_t>(sequence_length_), static_cast<int64_t>(feature_dim_)},
+                                      torch::kFloat);
+        auto [prediction, log_var] = (*model_)->forward(input);
+        torch::Tensor p = prediction.reshape({-1}).to(torch::kFloat).contiguous();
+        torch::Tensor lv = log_var.reshape({-1}).to(torch::kFloat).contiguous();
+        for (int r = 0; r < rows; ++r) {
+            out[2 * r] = p.data_ptr<float>()[r];
+            out[2 * r + 1] = lv.data_ptr<float>()[r];
+        }
+        return true;
+    }
+
+private:
+    uint32_t sequence_length_;
+    uint32_t feature_dim_;
+    std::unique_ptr<TransformerModel> model_;
+};
+#endif
+
+} // namespace
+
+std::unique_ptr<ModelBackend> ModelBackend::load(const std::string& kind, const std::string& path,
+                                                 uint32_t sequence_length, uint32_t feature_dim,
+                                                 std::string& error) {
+    std::unique_ptr<ModelBackend> backend;
+    if (kind.compare(0, 6, "native") == 0) {
+        // "native", or "native-bf16" / "native-int8" for reduced-precision weights
+        kernels::WeightPrecision precision = kernels::WeightPrecision::Fp32;
+        if (kind.size() > 6 && (kind[6] != '-' || !kernels::parse_weight_precision(kind.substr(7), precision))) {
+            error = "unknown model kind '" + kind + "'";
+            return nullptr;
+        }
+        auto native = std::make_unique<NativeGruBackend>();
+        if (!native->load(path, precision, sequence_length, error)) return nullptr;
+        backend = std::move(native);
+#ifdef TORCH_AVAILABLE
+    } else if (kind == "torchscript") {
+        auto script = std::make_unique<TorchScriptGruBackend>(sequence_length, feature_dim);
+        if (!script->load(path, error)) return nullptr;
+        backend = std::move(script);
+    } else if (kind == "transformer") {
+        auto transformer = std::make_unique<TransformerBackend>(sequence_length, feature_dim);
+        if (!transformer->load(path, error)) return nullptr;
+        backend = std::move(transformer);
+#endif
+    } else {
+        error = "unknown model kind '" + kind + "'";
+        return nullptr;
+    }
+    if (backend->sequence_length() != sequence_length || backend->feature_dim() != feature_dim) {
+        error = path + " expects windows of " + std::to_string(backend->sequence_length()) + " x " +
+                std::to_string(backend->feature_dim());
+        return nullptr;
+    }
+    return backend;
+}
+
+// =============================================================================
+// ModelServer
+// =============================================================================
+
+struct ModelServer::Connection {
+    int fd = -1;
+    std::mutex write_mutex;      // replies come from batcher threads
+    std::thread reader;
+    std::atomic<bool> done{false};
+
+    // Closed when the last reference goes, so a batcher still holding a
+    // request never writes to a descriptor number reused by a new client
+    ~Connection() {
+        if (fd >= 0) ::close(fd);
+    }
+
+    bool send(serving::FrameType type, uint64_t request_id, const void* data, size_t bytes) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        return serving::send_frame(fd, type, request_id, data, bytes);
+    }
+    void send_error(uint64_t request_id, const std::string& message) {
+        send(serving::FrameType::Error, request_id, message.data(), message.size());
+    }
+};
+
+struct ModelServer::ServedModel {
+    uint32_t id = 0;
+    std::string key;
+    std::unique_ptr<ModelBackend> backend;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<PendingRequest> queue;
+    size_t queued_rows = 0;
+    bool stopping = false;
+    std::thread batcher;
+};
+
+ModelServer::ModelServer(Options options) : options_(std::move(options)) {
+    options_.max_batch_rows = std::max(1, options_.max_batch_rows);
+    options_.batch_window_us = std::max<int64_t>(0, options_.batch_window_us);
+}
+
+ModelServer::~ModelServer() {
+    stop();
+}
+
+bool ModelServer::start() {
+    sockaddr_un addr{};
+    if (options_.socket_path.size() >= sizeof(addr.sun_path)) {
+        utils::log_error("ModelServer: socket path too long: " + options_.socket_path);
+        return false;
+    }
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        utils::log_error("ModelServer: socket() failed");
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, options_.socket_path.c_str(), options_.socket_path.size() + 1);
+    ::unlink(options_.socket_path.c_str());
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 64) != 0) {
+        utils::log_error("ModelServer: cannot listen on " + options_.socket_path + ": " + std::strerror(errno));
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    // Owner and group only (see the access note in the header)
+    ::chmod(options_.socket_path.c_str(), 0660);
+    stopping_ = false;
+    accept_thread_ = std::thread([this] { accept_loop(); });
+    utils::log_info("ModelServer listening on " + options_.socket_path + " (batch window " +
+                    std::to_string(options_.batch_window_us) + "us, max " +
+                    std::to_string(options_.max_batch_rows) + " rows, " + options_.execution.describe() + ")");
+    return true;
+}
+
+void ModelServer::stop() {
+    if (listen_fd_ < 0) return;
+    stopping_ = true;
+    if (accept_thread_.joinable()) accept_thread_.join();
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    ::unlink(options_.socket_path.c_str());
+
+    // Wake blocked readers; they exit on the failed recv
+    std::vector<std::shared_ptr<Connection>> connections;
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        connections.swap(connections_);
+    }
+    for (auto& c : connections) ::shutdown(c->fd, SHUT_RDWR);
+    for (auto& c : connections) {
+        if (c->reader.joinable()) c->reader.join();
+    }
+
+    std::lock_guard<std::mutex> lock(models_mutex_);
+    for (auto& [key, model] : models_) {
+        {
+            std::lock_guard<std::mutex> model_lock(model->mutex);
+            model->stopping = true;
+        }
+        model->cv.notify_all();
+        if (model->batcher.joinable()) model->batcher.join();
+    }
+}
+
+ModelServer::Stats ModelServer::stats() const {
+    Stats s;
+    s.connections = connection_count_;
+    s.requests = request_count_;
+    s.rows = row_count_;
+    s.batches = batch_count_;
+    std::lock_guard<std::mutex> lock(models_mutex_);
+    s.models = models_.size();
+    return s;
+}
+
+void ModelServer::accept_loop() {
+    while (!stopping_) {
+        pollfd pfd{listen_fd_, POLLIN, 0};
+        int rc = ::poll(&pfd, 1, 100);    // re-check stopping_ every 100ms
+        if (rc <= 0) continue;
+        int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) continue;
+
+        auto connection = std::make_shared<Connection>();
+        connection->fd = fd;
+        connection_count_++;
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        // Reap clients that have disconnected since the last accept
+        for (auto it = connections_.begin(); it != connections_.end();) {
+            if ((*it)->done) {
+                (*it)->reader.join();
+                it = connections_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        connection->reader = std::thread([this, connection] { serve_connection(connection); });
+        connections_.push_back(std::move(connection));
+    }
+}
+
+void ModelServer::serve_connection(std::shared_ptr<Connection> connection) {
+    serving::FrameHeader header;
+    while (!stopping_ && serving::recv_header(connection->fd, header)) {
+        bool ok = false;
+        switch (static_cast<serving::FrameType>(header.type)) {
+            case serving::FrameType::Open:  ok = handle_open(*connection, header); break;
+            case serving::FrameType::Infer: ok = handle_infer(connection, header); break;
+            default: break;
+        }
+        if (!ok) break;    // malformed stream: drop the client
+    }
+    connection->done = true;
+}
+
+bool ModelServer::handle_open(Connection& connection, const serving::FrameHeader& header) {
+    serving::OpenRequest request;
+    if (header.payload_bytes < sizeof(request) || !serving::recv_exact(connection.fd, &request, sizeof(request))) {
+        return false;
+    }
+    std::string names(header.payload_bytes - sizeof(request), '\0');
+    if (!serving::recv_exact(connection.fd, &names[0], names.size())) return false;
+    const size_t split = names.find('\0');
+    if (split == std::string::npos) return false;
+    const std::string kind = names.substr(0, split);
+    const std::string path = names.substr(split + 1);
+    const std::string key = kind + ":" + path;
+
+    ServedModel* model = nullptr;
+    std::string error;
+    {
+        // Loading under the lock: a second client opening the same model
+        // waits for the first load instead of loading it again
+        std::lock_guard<std::mutex> lock(models_mutex_);
+        auto it = models_.find(key);
+        if (it != models_.end()) {
+            model = it->second.get();
+            if (model->backend->sequence_length() != request.sequence_length ||
+                model->backend->feature_dim() != request.feature_dim) {
+                error = key + " is served with windows of " + std::to_string(model->backend->sequence_length()) +
+                        " x " + std::to_string(model->backend->feature_dim());
+                model = nullptr;
+            }
+        } else {
+            auto backend = ModelBackend::load(kind, path, request.sequence_length, request.feature_dim, error);
+            if (backend) {
+                auto served = std::make_unique<ServedModel>();
+                served->id = static_cast<uint32_t>(models_by_id_.size());
+                served->key = key;
+                served->backend = std::move(backend);
+                model = served.get();
+                models_by_id_.push_back(model);
+                model->batcher = std::thread([this, model] { batch_loop(*model); });
+                models_.emplace(key, std::move(served));
+                utils::log_info("ModelServer: loaded " + key + " (model " + std::to_string(model->id) + ")");
+            }
+        }
+    }
+    if (!model) {
+        utils::log_error("ModelServer: open failed: " + error);
+        connection.send_error(header.request_id, error);
+        return true;
+    }
+    serving::ModelInfo info;
+    info.model_id = model->id;
+    info.sequence_length = model->backend->sequence_length();
+    info.feature_dim = model->backend->feature_dim();
+    info.output_dim = model->backend->output_dim();
+    return connection.send(serving::FrameType::OpenReply, header.request_id, &info, sizeof(info));
+}
+
+bool ModelServer::handle_infer(const std::shared_ptr<Connection>& connection, const serving::FrameHeader& header) {
+    serving::InferRequest request;
+    if (header.payload_bytes < sizeof(request) || !serving::recv_exact(connection->fd, &request, sizeof(request))) {
+        return false;
+    }
+    ServedModel* model = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(models_mutex_);
+        if (request.model_id < models_by_id_.size()) model = models_by_id_[request.model_id];
+    }
+    if ((header.payload_bytes - sizeof(request)) % sizeof(float) != 0) return false;
+    const size_t floats = (header.payload_bytes - sizeof(request)) / sizeof(float);
+    const size_t window = model ? static_cast<size_t>(model->backend->sequence_length()) *
+                                      model->backend->feature_dim() : 0;
+    PendingRequest pending;
+    pending.connection = connection;
+    pending.request_id = header.request_id;
+    pending.rows = request.rows;
+    pending.windows.resize(floats);
+    if (!serving::recv_exact(connection->fd, pending.windows.data(), floats * sizeof(float))) return false;
+    if (!model || request.rows == 0 || floats != request.rows * window) {
+        connection->send_error(header.request_id, model ? "window size mismatch" : "unknown model id");
+        return true;
+    }
+    pending.arrival = std::chrono::steady_clock::now();
+    request_count_++;
+    {
+        std::lock_guard<std::mutex> lock(model->mutex);
+        model->queued_rows += pending.rows;
+        model->queue.push_back(std::move(pending));
+    }
+    model->cv.notify_one();
+    return true;
+}
+
+void ModelServer::batch_loop(ServedModel& model) {
+    options_.execution.apply_to_current_thread();
+    const size_t window = static_cast<size_t>(model.backend->sequence_length()) * model.backend->feature_dim();
+    const size_t output_dim = model.backend->output_dim();
+    const auto batch_window = std::chrono::microseconds(options_.batch_window_us);
+    const size_t max_rows = static_cast<size_t>(options_.max_batch_rows);
+    std::vector<PendingRequest> batch;
+    std::vector<float> inputs;
+    std::vector<float> outputs;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(model.mutex);
+            model.cv.wait(lock, [&] { return model.stopping || !model.queue.empty(); });
+            if (model.queue.empty()) break;    // stopping and drained
+            // Micro-batch: give other clients until the oldest request's
+            // window closes to join, unless the batch is already full
+            const auto deadline = model.queue.front().arrival + batch_window;
+            model.cv.wait_until(lock, deadline, [&] { return model.stopping || model.queued_rows >= max_rows; });
+            size_t rows = 0;
+            while (!model.queue.empty() && (batch.empty() || rows + model.queue.front().rows <= max_rows)) {
+                rows += model.queue.front().rows;
+                batch.push_back(std::move(model.queue.front()));
+                model.queue.pop_front();
+            }
+            model.queued_rows -= rows;
+        }
+
+        // A single request is evaluated from its own buffer
+        size_t rows = 0;
+        for (const auto& r : batch) rows += r.rows;
+        const float* in = batch.front().windows.data();
+        if (batch.size() > 1) {
+            inputs.resize(rows * window);
+            float* dst = inputs.data();
+            for (const auto& r : batch) {
+                std::memcpy(dst, r.windows.data(), r.windows.size() * sizeof(float));
+                dst += r.windows.size();
+            }
+            in = inputs.data();
+        }
+        outputs.resize(rows * output_dim);
+        bool ok;
+        try {
+            ok = model.backend->forward(in, static_cast<int>(rows), outputs.data());
+        } catch (const std::exception& e) {
+            utils::log_error("ModelServer: " + model.key + " forward failed: " + e.what());
+            ok = false;
+        }
+        batch_count_++;
+        row_count_ += rows;
+
+        const float* out = outputs.data();
+        for (auto& r : batch) {
+            if (ok) {
+                r.connection->send(serving::FrameType::InferReply, r.request_id, out,
+                                   r.rows * output_dim * sizeof(float));
+            } else {
+                r.connection->send_error(r.request_id, "forward failed");
+            }
+            out += r.rows * output_dim;
+        }
+        batch.clear();
+    }
+}
+
+} // namespace ml
+} // namespace sentio
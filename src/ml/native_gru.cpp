@@ -0,0 +1,435 @@
+#include "ml/native_gru.h"
+#include "ml/gemm_kernels.h"
+#include "common/utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sentio {
+namespace ml {
+
+namespace {
+
+struct FileHeader {
+    uint32_t magic = NativeGruModel::MAGIC;
+    uint32_t format_version = NativeGruModel::FORMAT_VERSION;
+    uint32_t feature_dim = 0;
+    uint32_t hidden_dim = 0;
+    uint32_t num_layers = 0;
+    uint32_t num_heads = 0;
+    uint32_t sequence_length = 0;
+    uint32_t multi_task = 0;
+    uint32_t tensor_count = 0;
+    uint32_t reserved[7] = {};
+};
+static_assert(sizeof(FileHeader) == 64, "native GRU header must stay 64 bytes");
+
+struct TensorEntry {
+    char name[80] = {};
+    uint32_t ndim = 0;
+    uint32_t dims[4] = {};
+    uint32_t reserved = 0;
+    uint64_t offset = 0;        // bytes from the start of the file, 64-byte aligned
+    uint64_t count = 0;         // floats
+    uint64_t reserved2 = 0;
+};
+static_assert(sizeof(TensorEntry) == 128, "native GRU tensor entry must stay 128 bytes");
+
+constexpr uint64_t ALIGNMENT = 64;
+
+uint64_t align_up(uint64_t n) {
+    return (n + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+inline float sigmoid(float x) {
+    return 1.0f / (1.0f + std::exp(-x));
+}
+
+} // namespace
+
+bool NativeGruModel::write_weights(const std::string& path,
+                                   const NativeGruConfig& config,
+                                   const std::vector<TensorView>& tensors) {
+    FileHeader header;
+    header.feature_dim = config.feature_dim;
+    header.hidden_dim = config.hidden_dim;
+    header.num_layers = config.num_layers;
+    header.num_heads = config.num_heads;
+    header.sequence_length = config.sequence_length;
+    header.multi_task = config.multi_task;
+    header.tensor_count = static_cast<uint32_t>(tensors.size());
+
+    std::vector<TensorEntry> table(tensors.size());
+    uint64_t offset = align_up(sizeof(FileHeader) + table.size() * sizeof(TensorEntry));
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        const auto& t = tensors[i];
+        if (t.name.size() >= sizeof(table[i].name) || t.shape.empty() || t.shape.size() > 4 || !t.data) {
+            utils::log_error("Cannot store tensor in native GRU file: " + t.name);
+            return false;
+        }
+        std::memcpy(table[i].name, t.name.data(), t.name.size());
+        table[i].ndim = static_cast<uint32_t>(t.shape.size());
+        uint64_t count = 1;
+        for (size_t d = 0; d < t.shape.size(); ++d) {
+            table[i].dims[d] = t.shape[d];
+            count *= t.shape[d];
+        }
+        table[i].offset = offset;
+        table[i].count = count;
+        offset = align_up(offset + count * sizeof(float));
+    }
+
+    // Written aside and renamed: a process that has the old file mapped
+    // keeps its pages instead of faulting on a truncated file
+    const std::string tmp = path + ".tmp";
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        utils::log_error("Cannot create native GRU weights: " + tmp);
+        return false;
+    }
+    const std::vector<char> padding(ALIGNMENT, 0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(TensorEntry));
+    uint64_t written = sizeof(header) + table.size() * sizeof(TensorEntry);
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        out.write(padding.data(), table[i].offset - written);
+        out.write(reinterpret_cast<const char*>(tensors[i].data), table[i].count * sizeof(float));
+        written = table[i].offset + table[i].count * sizeof(float);
+    }
+    out.write(padding.data(), align_up(written) - written);
+    out.close();
+    if (!out.good() || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        utils::log_error("Failed writing native GRU weights: " + path);
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool NativeGruModel::write_synthetic_weights(const std::string& path, const NativeGruConfig& config, uint32_t seed) {
+    const uint32_t F = config.feature_dim, H = config.hidden_dim;
+    std::vector<std::pair<std::string, std::vector<uint32_t>>> shapes = {
+        {"feature_encoder.weight", {H, F}}, {"feature_encoder.bias", {H}},
+        {"feature_norm.weight", {H}}, {"feature_norm.bias", {H}},
+        {"attention.in_proj_weight", {3 * H, H}}, {"attention.in_proj_bias", {3 * H}},
+        {"attention.out_proj.weight", {H, H}}, {"attention.out_proj.bias", {H}},
+        {"attention_norm.weight", {H}}, {"attention_norm.bias", {H}},
+    };
+    for (uint32_t l = 0; l < config.num_layers; ++l) {
+        const std::string gru = "gru_" + std::to_string(l) + ".";
+        const std::string norm = "norm_" + std::to_string(l) + ".";
+        shapes.push_back({gru + "weight_ih_l0", {3 * H, H}});
+        shapes.push_back({gru + "weight_hh_l0", {3 * H, H}});
+        shapes.push_back({gru + "bias_ih_l0", {3 * H}});
+        shapes.push_back({gru + "bias_hh_l0", {3 * H}});
+        shapes.push_back({norm + "weight", {H}});
+        shapes.push_back({norm + "bias", {H}});
+    }
+    for (const char* head : {"direction", "magnitude", "confidence", "volatility", "regime"}) {
+        const uint32_t out = std::string(head) == "regime" ? 4 : 1;
+        const std::string prefix = std::string(head) + "_head.";
+        shapes.push_back({prefix + "0.weight", {H / 2, H}});
+        shapes.push_back({prefix + "0.bias", {H / 2}});
+        shapes.push_back({prefix + "3.weight", {out, H / 2}});
+        shapes.push_back({prefix + "3.bias", {out}});
+    }
+
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> dist(0.0f, 0.08f);
+    std::vector<std::vector<float>> data;
+    std::vector<TensorView> views;
+    data.reserve(shapes.size());
+    for (const auto& [name, shape] : shapes) {
+        size_t count = 1;
+        for (uint32_t d : shape) count *= d;
+        data.emplace_back(count);
+        for (float& v : data.back()) v = dist(rng);
+        views.push_back({name, shape, data.back().data()});
+    }
+    return write_weights(path, config, views);
+}
+
+bool NativeGruModel::load(const std::string& path, kernels::WeightPrecision precision) {
+    loaded_ = false;
+    precision_ = precision;
+    entries_.clear();
+    mapping_.reset();
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        utils::log_error("Cannot open native GRU weights: " + path);
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < sizeof(FileHeader) ||
+        st.st_size % sizeof(float) != 0) {
+        ::close(fd);
+        utils::log_error("Rejected native GRU weights " + path + ": bad size");
+        return false;
+    }
+    const uint64_t bytes = static_cast<uint64_t>(st.st_size);
+    void* mapping = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);   // the mapping keeps the file referenced
+    if (mapping == MAP_FAILED) {
+        utils::log_error("Cannot map native GRU weights: " + path);
+        return false;
+    }
+    mapping_ = std::shared_ptr<const char>(static_cast<const char*>(mapping), [bytes](const char* p) {
+        ::munmap(const_cast<char*>(p), bytes);
+    });
+
+    FileHeader header;
+    std::memcpy(&header, mapping_.get(), sizeof(header));
+    const char* problem = nullptr;
+    if (header.magic != MAGIC) problem = "not a native GRU weight file";
+    else if (header.format_version != FORMAT_VERSION) problem = "unsupported format version";
+    else if (header.feature_dim == 0 || header.hidden_dim < 2 || header.num_layers == 0 ||
+             header.sequence_length == 0) problem = "bad architecture";
+    else if (sizeof(FileHeader) + uint64_t(header.tensor_count) * sizeof(TensorEntry) > bytes) problem = "truncated table";
+    if (problem) {
+        utils::log_error("Rejected native GRU weights " + path + ": " + problem);
+        return false;
+    }
+
+    const char* base = mapping_.get();
+    for (uint32_t i = 0; i < header.tensor_count; ++i) {
+        TensorEntry e;
+        std::memcpy(&e, base + sizeof(FileHeader) + i * sizeof(TensorEntry), sizeof(e));
+        if (e.ndim == 0 || e.ndim > 4 || e.offset % sizeof(float) != 0 ||
+            e.offset + e.count * sizeof(float) > bytes) {
+            utils::log_error("Rejected native GRU weights " + path + ": bad tensor entry " + std::to_string(i));
+            return false;
+        }
+        Entry entry;
+        entry.name.assign(e.name, strnlen(e.name, sizeof(e.name)));
+        entry.shape.assign(e.dims, e.dims + e.ndim);
+        entry.data = reinterpret_cast<const float*>(base + e.offset);
+        entries_.push_back(std::move(entry));
+    }
+
+    config_.feature_dim = header.feature_dim;
+    config_.hidden_dim = header.hidden_dim;
+    config_.num_layers = header.num_layers;
+    config_.num_heads = header.num_heads;
+    config_.sequence_length = header.sequence_length;
+    config_.multi_task = header.multi_task;
+
+    const uint32_t H = config_.hidden_dim;
+    bool ok = bind_linear(encoder_, "feature_encoder", H, config_.feature_dim) &&
+              bind_norm(encoder_norm_, "feature_norm", H);
+    layers_.assign(config_.num_layers, GruLayer{});
+    for (uint32_t i = 0; ok && i < config_.num_layers; ++i) {
+        const std::string gru = "gru_" + std::to_string(i) + ".";
+        auto& layer = layers_[i];
+        ok = set_linear(layer.input, find(gru + "weight_ih_l0", {3 * H, H}), find(gru + "bias_ih_l0", {3 * H}),
+                        3 * H, H) &&
+             set_linear(layer.hidden, find(gru + "weight_hh_l0", {3 * H, H}), find(gru + "bias_hh_l0", {3 * H}),
+                        3 * H, H) &&
+             bind_norm(layer.norm, "norm_" + std::to_string(i), H);
+    }
+    if (ok) {
+        const float* in_proj = find("attention.in_proj_weight", {3 * H, H});
+        const float* in_bias = find("attention.in_proj_bias", {3 * H});
+        // Only the value projection matters (see header)
+        ok = in_proj && in_bias &&
+             set_linear(value_, in_proj + size_t(2) * H * H, in_bias + size_t(2) * H, H, H) &&
+             bind_linear(attention_out_, "attention.out_proj", H, H) &&
+             bind_norm(attention_norm_, "attention_norm", H);
+    }
+    ok = ok && bind_head(direction_, "direction_head", 1, Activation::None);
+    if (ok && config_.multi_task) {
+        ok = bind_head(magnitude_, "magnitude_head", 1, Activation::Relu) &&
+             bind_head(confidence_, "confidence_head", 1, Activation::Sigmoid) &&
+             bind_head(volatility_, "volatility_head", 1, Activation::Relu) &&
+             bind_head(regime_, "regime_head", 4, Activation::Softmax);
+    }
+    if (!ok) {
+        utils::log_error("Rejected native GRU weights " + path + ": missing or mis-shaped tensors");
+        return false;
+    }
+
+    const size_t steps = config_.sequence_length;
+    x_.assign(steps * H, 0.0f);
+    gates_in_.assign(steps * 3 * H, 0.0f);
+    gates_h_.assign(3 * H, 0.0f);
+    h_.assign(H, 0.0f);
+    head_hidden_.assign(H / 2, 0.0f);
+    last_.assign(H, 0.0f);
+    tmp_.assign(H, 0.0f);
+    loaded_ = true;
+    return true;
+}
+
+const float* NativeGruModel::find(const std::string& name, std::initializer_list<uint32_t> shape) const {
+    for (const auto& entry : entries_) {
+        if (entry.name == name) {
+            if (!std::equal(entry.shape.begin(), entry.shape.end(), shape.begin(), shape.end())) {
+                utils::log_error("Native GRU tensor " + name + " has an unexpected shape");
+                return nullptr;
+            }
+            return entry.data;
+        }
+    }
+    utils::log_error("Native GRU tensor missing: " + name);
+    return nullptr;
+}
+
+bool NativeGruModel::bind_linear(Linear& linear, const std::string& prefix, uint32_t out, uint32_t in) const {
+    return set_linear(linear, find(prefix + ".weight", {out, in}), find(prefix + ".bias", {out}), out, in);
+}
+
+bool NativeGruModel::set_linear(Linear& linear, const float* weight, const float* bias,
+                                uint32_t out, uint32_t in) const {
+    if (!weight || !bias) return false;
+    linear.weight = kernels::WeightMatrix::quantize(weight, static_cast<int>(out), static_cast<int>(in), precision_);
+    linear.bias = bias;
+    linear.out = static_cast<int>(out);
+    linear.in = static_cast<int>(in);
+    return true;
+}
+
+size_t NativeGruModel::weight_bytes() const {
+    size_t bytes = encoder_.weight.bytes() + value_.weight.bytes() + attention_out_.weight.bytes();
+    for (const auto& layer : layers_) bytes += layer.input.weight.bytes() + layer.hidden.weight.bytes();
+    for (const Head* head : {&direction_, &magnitude_, &confidence_, &volatility_, &regime_}) {
+        if (head->present) bytes += head->hidden.weight.bytes() + head->output.weight.bytes();
+    }
+    return bytes;
+}
+
+bool NativeGruModel::bind_norm(Norm& norm, const std::string& prefix, uint32_t n) const {
+    norm = {find(prefix + ".weight", {n}), find(prefix + ".bias", {n})};
+    return norm.gamma && norm.beta;
+}
+
+bool NativeGruModel::bind_head(Head& head, const std::string& prefix, uint32_t out, Activation activation) const {
+    // Sequential: 0 Linear(H, H/2), 1 ReLU, 2 Dropout, 3 Linear(H/2, out), 4 activation
+    const uint32_t H = config_.hidden_dim;
+    head.activation = activation;
+    head.present = bind_linear(head.hidden, prefix + ".0", H / 2, H) &&
+                   bind_linear(head.output, prefix + ".3", out, H / 2);
+    return head.present;
+}
+
+bool NativeGruModel::forward(const float* window, int steps, NativeGruOutput& out) {
+    if (!loaded_ || steps < 1 || steps > static_cast<int>(config_.sequence_length)) return false;
+    run(window, steps, nullptr, nullptr, out);
+    return true;
+}
+
+bool NativeGruModel::forward_window(const float* window, int steps, NativeGruState& state, NativeGruOutput& out) {
+    if (!loaded_ || steps < 1 || steps > static_cast<int>(config_.sequence_length)) return false;
+    state.hidden.resize(static_cast<size_t>(config_.num_layers) * config_.hidden_dim);
+    run(window, steps, nullptr, state.hidden.data(), out);
+    state.steps_since_sync = 0;
+    return true;
+}
+
+bool NativeGruModel::forward_step(const float* features, NativeGruState& state, NativeGruOutput& out) {
+    if (!loaded_ || state.hidden.size() != static_cast<size_t>(config_.num_layers) * config_.hidden_dim) {
+        return false;
+    }
+    // h0 and h_n may alias: each layer reads its state before writing it
+    run(features, 1, state.hidden.data(), state.hidden.data(), out);
+    state.steps_since_sync++;
+    return true;
+}
+
+void NativeGruModel::run(const float* input, int steps, const float* h0, float* h_n, NativeGruOutput& out) {
+    const int H = static_cast<int>(config_.hidden_dim);
+    float* x = x_.data();
+
+    // Encoder for all timesteps: Linear -> LayerNorm -> ReLU (dropout is a no-op)
+    kernels::gemm_nt(input, encoder_.weight, encoder_.bias, x, steps);
+    for (int t = 0; t < steps; ++t) {
+        float* row = x + static_cast<size_t>(t) * H;
+        kernels::layer_norm(row, encoder_norm_.gamma, encoder_norm_.beta, H);
+        for (int j = 0; j < H; ++j) row[j] = std::max(row[j], 0.0f);
+    }
+
+    for (size_t l = 0; l < layers_.size(); ++l) {
+        const GruLayer& layer = layers_[l];
+        // Input projections of every timestep in one GEMM; gates ordered r, z, n
+        kernels::gemm_nt(x, layer.input.weight, layer.input.bias, gates_in_.data(), steps);
+        if (h0) {
+            std::copy(h0 + l * H, h0 + (l + 1) * H, h_.begin());
+        } else {
+            std::fill(h_.begin(), h_.end(), 0.0f);
+        }
+        float* h = h_.data();
+        for (int t = 0; t < steps; ++t) {
+            kernels::gemv(layer.hidden.weight, h, layer.hidden.bias, gates_h_.data());
+            const float* gi = gates_in_.data() + static_cast<size_t>(t) * 3 * H;
+            const float* gh = gates_h_.data();
+            float* row = x + static_cast<size_t>(t) * H;
+            for (int j = 0; j < H; ++j) {
+                const float r = sigmoid(gi[j] + gh[j]);
+                const float z = sigmoid(gi[H + j] + gh[H + j]);
+                const float n = std::tanh(gi[2 * H + j] + r * gh[2 * H + j]);
+                h[j] = (1.0f - z) * n + z * h[j];
+            }
+            // Output row = LayerNorm(h), plus the layer input (still in `row`)
+            // as residual above the first layer
+            std::copy(h, h + H, tmp_.begin());
+            kernels::layer_norm(tmp_.data(), layer.norm.gamma, layer.norm.beta, H);
+            if (l > 0) {
+                for (int j = 0; j < H; ++j) row[j] += tmp_[j];
+            } else {
+                std::copy(tmp_.begin(), tmp_.end(), row);
+            }
+        }
+        if (h_n) {
+            std::copy(h_.begin(), h_.end(), h_n + l * H);
+        }
+    }
+
+    // Attention (value + output projections) and norm on the last timestep
+    const float* x_last = x + static_cast<size_t>(steps - 1) * H;
+    kernels::gemv(value_.weight, x_last, value_.bias, tmp_.data());
+    kernels::gemv(attention_out_.weight, tmp_.data(), attention_out_.bias, last_.data());
+    for (int j = 0; j < H; ++j) last_[j] += x_last[j];
+    kernels::layer_norm(last_.data(), attention_norm_.gamma, attention_norm_.beta, H);
+
+    out = NativeGruOutput{};
+    run_head(direction_, last_.data(), &out.direction);
+    if (config_.multi_task) {
+        run_head(magnitude_, last_.data(), &out.magnitude);
+        run_head(confidence_, last_.data(), &out.confidence);
+        run_head(volatility_, last_.data(), &out.volatility);
+        run_head(regime_, last_.data(), out.regime);
+    }
+}
+
+void NativeGruModel::run_head(const Head& head, const float* x, float* out) {
+    kernels::gemv(head.hidden.weight, x, head.hidden.bias, head_hidden_.data());
+    for (float& v : head_hidden_) v = std::max(v, 0.0f);
+    kernels::gemv(head.output.weight, head_hidden_.data(), head.output.bias, out);
+    const int n = head.output.out;
+    switch (head.activation) {
+        case Activation::Relu:
+            for (int i = 0; i < n; ++i) out[i] = std::max(out[i], 0.0f);
+            break;
+        case Activation::Sigmoid:
+            for (int i = 0; i < n; ++i) out[i] = sigmoid(out[i]);
+            break;
+        case Activation::Softmax: {
+            const float peak = *std::max_element(out, out + n);
+            float sum = 0.0f;
+            for (int i = 0; i < n; ++i) sum += (out[i] = std::exp(out[i] - peak));
+            for (int i = 0; i < n; ++i) out[i] /= sum;
+            break;
+        }
+        case Activation::None:
+            break;
+    }
+}
+
+} // namespace ml
+} // namespace sentio
@@ -0,0 +1,124 @@
+#include "ml/remote_model.h"
+#include "ml/model_server.h"
+#include "common/utils.h"
+
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+namespace sentio {
+namespace ml {
+
+RemoteModel::~RemoteModel() {
+    close();
+}
+
+void RemoteModel::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool RemoteModel::connect(const std::string& socket_path, const std::string& kind, const std::string& model_path,
+                          uint32_t sequence_length, uint32_t feature_dim) {
+    close();
+    socket_path_ = socket_path;
+    sockaddr_un addr{};
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        utils::log_error("RemoteModel: socket path too long: " + socket_path);
+        return false;
+    }
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0) {
+        utils::log_error("RemoteModel: socket() failed");
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, socket_path.c_str(), socket_path.size() + 1);
+    if (::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        utils::log_error("RemoteModel: cannot connect to model server " + socket_path);
+        close();
+        return false;
+    }
+
+    serving::OpenRequest request;
+    request.sequence_length = sequence_length;
+    request.feature_dim = feature_dim;
+    std::string names = kind;
+    names.push_back('\0');
+    names += model_path;
+    std::vector<char> open(sizeof(request) + names.size());
+    std::memcpy(open.data(), &request, sizeof(request));
+    std::memcpy(open.data() + sizeof(request), names.data(), names.size());
+    const uint64_t id = next_request_id_++;
+
+    serving::FrameHeader header;
+    if (!serving::send_frame(fd_, serving::FrameType::Open, id, open.data(), open.size()) ||
+        !serving::recv_header(fd_, header) || header.request_id != id) {
+        utils::log_error("RemoteModel: no reply from model server " + socket_path);
+        close();
+        return false;
+    }
+    if (static_cast<serving::FrameType>(header.type) != serving::FrameType::OpenReply) {
+        std::string message(header.payload_bytes, '\0');
+        serving::recv_exact(fd_, &message[0], message.size());
+        utils::log_error("RemoteModel: model server cannot serve " + kind + ":" + model_path + ": " + message);
+        close();
+        return false;
+    }
+    serving::ModelInfo info;
+    if (header.payload_bytes != sizeof(info) || !serving::recv_exact(fd_, &info, sizeof(info))) {
+        utils::log_error("RemoteModel: malformed reply from model server " + socket_path);
+        close();
+        return false;
+    }
+    model_id_ = info.model_id;
+    sequence_length_ = info.sequence_length;
+    feature_dim_ = info.feature_dim;
+    output_dim_ = info.output_dim;
+    utils::log_info("RemoteModel: " + kind + ":" + model_path + " served by " + socket_path + " (model " +
+                    std::to_string(model_id_) + ", " + std::to_string(output_dim_) + " outputs)");
+    return true;
+}
+
+bool RemoteModel::infer(const float* windows, int rows, float* out) {
+    if (fd_ < 0 || rows <= 0) return false;
+    serving::InferRequest request;
+    request.model_id = model_id_;
+    request.rows = static_cast<uint32_t>(rows);
+    const size_t window_bytes = static_cast<size_t>(rows) * sequence_length_ * feature_dim_ * sizeof(float);
+    const uint64_t id = next_request_id_++;
+
+    serving::FrameHeader header;
+    if (!serving::send_frame(fd_, serving::FrameType::Infer, id, &request, sizeof(request), windows, window_bytes) ||
+        !serving::recv_header(fd_, header)) {
+        utils::log_error("RemoteModel: lost connection to model server " + socket_path_);
+        close();
+        return false;
+    }
+    if (header.request_id != id) {
+        utils::log_error("RemoteModel: reply for request " + std::to_string(header.request_id) +
+                         ", expected " + std::to_string(id));
+        close();
+        return false;
+    }
+    if (static_cast<serving::FrameType>(header.type) != serving::FrameType::InferReply) {
+        std::string message(header.payload_bytes, '\0');
+        serving::recv_exact(fd_, &message[0], message.size());
+        utils::log_error("RemoteModel: inference failed: " + message);
+        return false;
+    }
+    const size_t out_bytes = static_cast<size_t>(rows) * output_dim_ * sizeof(float);
+    if (header.payload_bytes != out_bytes || !serving::recv_exact(fd_, out, out_bytes)) {
+        utils::log_error("RemoteModel: malformed reply from model server " + socket_path_);
+        close();
+        return false;
+    }
+    return true;
+}
+
+} // namespace ml
+} // namespace sentio
@@ -1,15 +1,23 @@
 #include "strategy/cpp_ppo_strategy.h"
+#include "common/state_stream.h"
 #include "common/utils.h"
 #include "features/feature_config_standard.h" // 🔧 CONSOLIDATED: Standard 91-feature config
 #include <torch/torch.h>
+#include <algorithm>
 #include <fstream>
 #include <chrono>
 #include <cmath>
+#include <sstream>
 
 namespace sentio {
 
-CppPpoStrategy::CppPpoStrategy(const CppPpoConfig& config) 
-    : StrategyComponent(StrategyComponent::StrategyConfig{}), config_(config) {
+CppPpoStrategy::CppPpoStrategy(const CppPpoConfig& config)
+    : CppPpoStrategy(StrategyComponent::StrategyConfig{}, config) {}
+
+CppPpoStrategy::CppPpoStrategy(const StrategyConfig& base_config, const CppPpoConfig& config)
+    : StrategyComponent(base_config), config_(config),
+      observation_window_(config.window_size,
+                          config.feature_dim + (config.enable_state_features ? STATE_FEATURE_DIM : 0)) {
     
     // 🔧 CONSOLIDATED: Use standardized 91-feature configuration
     // This ensures identical features between TFM, PPO, and all future ML strategies
@@ -22,13 +30,31 @@ CppPpoStrategy::CppPpoStrategy(const CppPpoConfig& config)
     feature_engine_ = std::make_unique<features::UnifiedFeatureEngine>(feature_config);
     
     // Initialize caches
-    last_probabilities_.resize(3, 0.33);  // [p_sell, p_hold, p_buy]
-    last_action_mask_.resize(3, true);    // [sell, hold, buy] validity
+    last_probabilities_.fill(0.33);       // [p_sell, p_hold, p_buy]
+    last_action_mask_.fill(true);         // [sell, hold, buy] validity
 }
 
 bool CppPpoStrategy::initialize() {
     utils::log_info("🤖 Initializing C++ PPO Strategy");
     
+    if (!config_.feature_store_path.empty()) {
+        feature_store_ = std::make_unique<features::FeatureStore>();
+        if (!feature_store_->open(config_.feature_store_path) ||
+            !feature_store_->matches(feature_engine_->config(), config_.feature_store_dataset)) {
+            utils::log_error("❌ Feature store does not match dataset " + config_.feature_store_dataset +
+                             " and the standard feature configuration: " + config_.feature_store_path);
+            return false;
+        }
+        feature_engine_.reset();
+    }
+    
+    const int feature_count = feature_store_ ? feature_store_->cols() : feature_engine_->feature_count();
+    if (feature_count != config_.feature_dim) {
+        utils::log_error("❌ PPO feature_dim " + std::to_string(config_.feature_dim) +
+                         " does not match the " + std::to_string(feature_count) + " engine features");
+        return false;
+    }
+    
     // Load the trained PPO model
     if (!load_model()) {
         utils::log_error("❌ Failed to load PPO model");
@@ -55,14 +81,16 @@ bool CppPpoStrategy::load_model() {
         }
         file_check.close();
         
-        // Set PyTorch to single-threaded for stability
-        torch::set_num_threads(1);
-        torch::set_num_interop_threads(1);
+        // Thread budget comes from this instance's ExecutionContext; the
+        // inter-op pool is process-wide and configured once
+        ExecutionContext::configure_process(execution_context().interop_threads());
+        execution_context().apply_to_current_thread();
         
         // Load the TorchScript model
         model_ = torch::jit::load(config_.model_path);
         model_.eval();
         model_.to(torch::kCPU);
+        build_model_inputs();
         
         model_loaded_ = true;
         
@@ -76,6 +104,96 @@ bool CppPpoStrategy::load_model() {
     }
 }
 
+void CppPpoStrategy::build_model_inputs() {
+    // The observation window starts at one of window_size ring slots; a view
+    // per slot means no tensor is created per bar
+    const int64_t observation_size = static_cast<int64_t>(config_.window_size) * observation_window_.feature_dim();
+    mask_tensor_ = torch::ones({ACTION_COUNT}, torch::kBool);
+    model_inputs_.clear();
+    model_inputs_.reserve(config_.window_size);
+    for (int slot = 0; slot < config_.window_size; ++slot) {
+        std::vector<torch::jit::IValue> inputs;
+        inputs.push_back(torch::from_blob(observation_window_.window_at(slot), {1, observation_size}, torch::kFloat));
+        if (config_.enable_action_masking) {
+            inputs.push_back(mask_tensor_);
+        }
+        model_inputs_.push_back(std::move(inputs));
+    }
+}
+
+std::string CppPpoStrategy::config_fingerprint() const {
+    std::ostringstream oss;
+    oss.precision(17);
+    oss << StrategyComponent::config_fingerprint() << "|ppo=" << config_.model_path << "|window=" << config_.window_size
+        << "|feat=" << config_.feature_dim << "|mask=" << config_.enable_action_masking
+        << "|state=" << config_.enable_state_features << "|fee=" << config_.transaction_fee_pct
+        << "|store=" << config_.feature_store_path;
+    return oss.str();
+}
+
+void CppPpoStrategy::save_derived_state(StateWriter& w) const {
+    if (feature_engine_) {
+        feature_engine_->save_state(w);
+    }
+    w.put(static_cast<int32_t>(position_state_));
+    w.put(entry_price_);
+    w.put(last_close_);
+    w.put(last_timestamp_ms_);
+    w.put(current_tick_);
+    w.put(total_trades_);
+    w.put(last_action_);
+    w.put(action_counts_);
+    w.put(last_probabilities_);
+    w.put(last_action_mask_);
+    // Last: its load is the final step that can fail (see load_derived_state)
+    observation_window_.save_state(w);
+}
+
+bool CppPpoStrategy::load_derived_state(StateReader& r) {
+    // Everything is read into copies and checked first; the observation
+    // window is then replayed in place, since the model inputs view its ring
+    std::unique_ptr<features::UnifiedFeatureEngine> engine;
+    if (feature_engine_) {
+        engine = std::make_unique<features::UnifiedFeatureEngine>(feature_engine_->config());
+        if (!engine->load_state(r)) return false;
+    }
+    int32_t position = 0;
+    double entry_price = 0.0, last_close = 0.0;
+    int64_t last_timestamp_ms = 0;
+    int current_tick = 0, total_trades = 0, last_action = 0;
+    std::array<int, ACTION_COUNT> action_counts{};
+    std::array<double, ACTION_COUNT> last_probabilities{};
+    std::array<bool, ACTION_COUNT> last_action_mask{};
+    if (!r.get(position) || !r.get(entry_price) || !r.get(last_close) || !r.get(last_timestamp_ms) ||
+        !r.get(current_tick) || !r.get(total_trades) || !r.get(last_action) || !r.get(action_counts) ||
+        !r.get(last_probabilities) || !r.get(last_action_mask) ||
+        position < 0 || position > static_cast<int32_t>(PositionState::SHORT) ||
+        last_action < 0 || last_action >= ACTION_COUNT) {
+        return false;
+    }
+    const StateReader window_state = r;
+    FeatureSequenceManager window = observation_window_;
+    if (!window.load_state(r) || !r.at_end()) {
+        return false;
+    }
+    StateReader replay = window_state;
+    observation_window_.load_state(replay);   // validated above
+    if (engine) {
+        *feature_engine_ = std::move(*engine);
+    }
+    position_state_ = static_cast<PositionState>(position);
+    entry_price_ = entry_price;
+    last_close_ = last_close;
+    last_timestamp_ms_ = last_timestamp_ms;
+    current_tick_ = current_tick;
+    total_trades_ = total_trades;
+    last_action_ = last_action;
+    action_counts_ = action_counts;
+    last_probabilities_ = last_probabilities;
+    last_action_mask_ = last_action_mask;
+    return true;
+}
+
 SignalOutput CppPpoStrategy::generate_signal(const Bar& bar, int bar_index) {
     SignalOutput signal;
     signal.timestamp_ms = bar.timestamp_ms;
@@ -83,29 +201,47 @@ SignalOutput CppPpoStrategy::generate_signal(const Bar& bar, int bar_index) {
     signal.probability = 0.5;  // Default neutral
     signal.confidence = 0.0;
     
+    if (step(bar, bar_index)) {
+        signal = convert_to_signal(last_action_, last_probabilities_, bar_index);
+    }
+    return signal;
+}
+
+SignalRecord CppPpoStrategy::generate_record(const Bar& bar, int bar_index) {
+    // Same values as generate_signal() without the per-bar metadata strings
+    SignalRecord record;
+    record.timestamp_ms = bar.timestamp_ms;
+    record.bar_index = bar_index;
+    record.symbol_id = run_info_.intern_symbol(bar.symbol);
+    record.probability = 0.5;
+    record.confidence = 0.0;
+    
+    if (step(bar, bar_index)) {
+        record.probability = last_probabilities_[2];
+        record.confidence = last_probabilities_[last_action_];
+    }
+    return record;
+}
+
+bool CppPpoStrategy::step(const Bar& bar, int bar_index) {
     if (!model_loaded_) {
         if (config_.enable_debug) {
             utils::log_warning("PPO model not loaded, returning neutral signal");
         }
-        return signal;
+        return false;
     }
     
-    // Update feature engine with new bar
-    feature_engine_->update(bar);
-    bar_history_.push_back(bar);
-    
-    // Maintain sliding window
-    if (bar_history_.size() > config_.window_size) {
-        bar_history_.pop_front();
-    }
+    push_observation_row(bar, bar_index);
+    last_close_ = bar.close;
+    last_timestamp_ms_ = bar.timestamp_ms;
     
-    // Need enough history for observation
-    if (bar_history_.size() < config_.window_size) {
+    // Need a full window of feature rows for the observation
+    if (!observation_window_.is_ready()) {
         if (config_.enable_debug) {
-            utils::log_info("Insufficient history: " + std::to_string(bar_history_.size()) + 
+            utils::log_info("Insufficient history: " + std::to_string(observation_window_.get_history_size()) + 
                            "/" + std::to_string(config_.window_size));
         }
-        return signal;
+        return false;
     }
     
     current_tick_ = bar_index;
@@ -113,160 +249,123 @@ SignalOutput CppPpoStrategy::generate_signal(const Bar& bar, int bar_index) {
     try {
         auto start_time = std::chrono::high_resolution_clock::now();
         
-        // Create observation tensor
-        torch::Tensor observation = create_observation();
+        execution_context().apply_to_current_thread();
         
-        // Get action mask
-        std::vector<bool> action_mask = compute_action_mask();
-        // Convert action mask to tensor
-        std::vector<uint8_t> mask_data;
-        for (bool mask_val : action_mask) {
-            mask_data.push_back(mask_val ? 1 : 0);
-        }
-        torch::Tensor mask_tensor = torch::from_blob(mask_data.data(), {3}, torch::kUInt8).to(torch::kBool).clone();
-        
-        // Run model inference
-        std::vector<torch::jit::IValue> inputs;
-        inputs.push_back(observation);
-        if (config_.enable_action_masking) {
-            inputs.push_back(mask_tensor);
+        // Action mask for the current position, written into the mask tensor
+        compute_action_mask(last_action_mask_);
+        bool* mask = mask_tensor_.data_ptr<bool>();
+        for (int i = 0; i < ACTION_COUNT; ++i) {
+            mask[i] = last_action_mask_[i];
         }
         
         // Forward pass through the model
-        torch::Tensor logits;
         {
             torch::NoGradGuard no_grad;
-            auto output = model_.forward(inputs);
+            auto output = model_.forward(prepare_observation());
             
             // Extract logits from model output
             if (output.isTuple()) {
-                auto tuple_output = output.toTuple();
-                logits = tuple_output->elements()[0].toTensor();
+                select_action(output.toTuple()->elements()[0].toTensor());
             } else {
-                logits = output.toTensor();
+                select_action(output.toTensor());
             }
         }
         
-        // Apply softmax to get probabilities
-        torch::Tensor probabilities = torch::softmax(logits, -1);
-        
-        // Apply action mask if enabled
-        if (config_.enable_action_masking) {
-            probabilities = probabilities * mask_tensor.to(torch::kFloat32);
-            probabilities = probabilities / probabilities.sum();  // Renormalize
-        }
-        
-        // Get action (argmax of probabilities)
-        torch::Tensor action_tensor = torch::argmax(probabilities, -1);
-        int action = action_tensor.item<int>();
-        
-        // Convert probabilities to vector
-        std::vector<double> probs = tensor_to_vector(probabilities);
-        
-        // Cache results
-        last_probabilities_ = probs;
-        last_action_mask_ = action_mask;
-        
         // Update position state based on action
-        update_position_state(action);
-        
-        // Convert to Sentio signal format
-        signal = convert_to_signal(action, probs, bar_index);
-        
-        auto end_time = std::chrono::high_resolution_clock::now();
-        auto inference_time = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count();
+        action_counts_[last_action_]++;
+        update_position_state(last_action_);
         
         if (config_.enable_debug) {
-            log_inference_details(action, probs, bar_index);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            auto inference_time = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count();
+            log_inference_details(last_action_, last_probabilities_, bar_index);
             utils::log_info("PPO inference time: " + std::to_string(inference_time) + "μs");
         }
+        return true;
         
     } catch (const std::exception& e) {
         utils::log_error("PPO inference failed: " + std::string(e.what()));
-        // Return neutral signal on error
-        signal.probability = 0.5;
-        signal.confidence = 0.0;
+        // Neutral signal on error
+        return false;
     }
-    
-    return signal;
 }
 
-torch::Tensor CppPpoStrategy::create_observation() {
-    // Create observation tensor matching real Kochi model format
-    // Real model expects flattened input: [batch, window_size * feature_dim]
-    
-    int state_feature_dim = config_.enable_state_features ? 4 : 0;  // 3 position + 1 PnL
-    int total_feature_dim = config_.feature_dim + state_feature_dim;
-    
-    // Create 2D observation first: [window_size, total_feature_dim]
-    torch::Tensor observation_2d = torch::zeros({config_.window_size, total_feature_dim}, torch::kFloat32);
-    
-    // Fill with features for each timestep in the window
-    for (int i = 0; i < config_.window_size && i < static_cast<int>(bar_history_.size()); ++i) {
-        int bar_idx = bar_history_.size() - config_.window_size + i;
-        if (bar_idx < 0) continue;
-        
-        // Get market features from unified feature engine
-        std::vector<double> features = feature_engine_->get_features();
-        
-        // For now, use a simplified feature set that matches Kochi's 71 features
-        // TODO: Implement proper Kochi feature calculation
-        const Bar& bar = bar_history_[bar_idx];
-        
-        // Create simplified features matching Kochi's format
-        std::vector<double> kochi_features = create_kochi_compatible_features(bar, bar_idx);
-        
-        // Fill market features
-        for (size_t j = 0; j < kochi_features.size() && j < config_.feature_dim; ++j) {
-            observation_2d[i][j] = static_cast<float>(kochi_features[j]);
+bool CppPpoStrategy::push_observation_row(const Bar& bar, int bar_index) {
+    // This bar's features, written straight into the next observation row; with
+    // state features the trailing columns are rewritten in prepare_observation()
+    float* row = observation_window_.next_row();
+    if (feature_store_) {
+        if (!feature_store_->is_ready(static_cast<size_t>(bar_index))) {
+            return false;
         }
-        
-        // Add state features if enabled
-        if (config_.enable_state_features) {
-            torch::Tensor state_features = get_state_features();
-            for (int k = 0; k < state_features.size(0); ++k) {
-                observation_2d[i][config_.feature_dim + k] = state_features[k];
-            }
+        const float* features = feature_store_->row(static_cast<size_t>(bar_index));
+        std::copy(features, features + config_.feature_dim, row);
+    } else {
+        feature_engine_->update(bar, row);
+        if (!feature_engine_->is_ready()) {
+            return false;
         }
     }
-    
-    // Flatten for real Kochi model: [1, window_size * total_feature_dim]
-    torch::Tensor observation_flat = observation_2d.view({1, -1});
-    
-    return observation_flat;
+    observation_window_.commit_row();
+    return true;
 }
 
-torch::Tensor CppPpoStrategy::get_state_features() const {
-    // Create state features matching Kochi2 format
-    // [position_long, position_short, position_hold, unrealized_pnl]
-    
-    torch::Tensor state_features = torch::zeros({4}, torch::kFloat32);
-    
-    // Position one-hot encoding
-    switch (position_state_) {
-        case PositionState::LONG:
-            state_features[0] = 1.0f;  // position_long
-            break;
-        case PositionState::SHORT:
-            state_features[1] = 1.0f;  // position_short
-            break;
-        case PositionState::HOLD:
-            state_features[2] = 1.0f;  // position_hold
-            break;
+std::vector<torch::jit::IValue>& CppPpoStrategy::prepare_observation() {
+    // Observation matching the Kochi model format: flattened
+    // [1, window_size * total_feature_dim] over the window rows
+    if (config_.enable_state_features) {
+        // Every row carries the current position state
+        const int total_feature_dim = observation_window_.feature_dim();
+        float state[STATE_FEATURE_DIM];
+        fill_state_features(state);
+        float* rows = observation_window_.window();
+        for (int i = 0; i < config_.window_size; ++i) {
+            std::copy(state, state + STATE_FEATURE_DIM, rows + i * total_feature_dim + config_.feature_dim);
+        }
+    }
+    return model_inputs_[observation_window_.window_slot()];
+}
+
+void CppPpoStrategy::select_action(const torch::Tensor& logits) {
+    // softmax -> mask -> renormalize -> argmax over the three logits
+    torch::Tensor values = logits;
+    if (values.scalar_type() != torch::kFloat || !values.is_contiguous()) {
+        values = values.to(torch::kFloat).contiguous();
+    }
+    const float* l = values.data_ptr<float>();
+    float p[ACTION_COUNT];
+    const float peak = std::max({l[0], l[1], l[2]});
+    float sum = 0.0f;
+    for (int i = 0; i < ACTION_COUNT; ++i) sum += (p[i] = std::exp(l[i] - peak));
+    for (int i = 0; i < ACTION_COUNT; ++i) p[i] /= sum;
+    
+    if (config_.enable_action_masking) {
+        float masked_sum = 0.0f;
+        for (int i = 0; i < ACTION_COUNT; ++i) masked_sum += (p[i] = last_action_mask_[i] ? p[i] : 0.0f);
+        for (int i = 0; i < ACTION_COUNT; ++i) p[i] /= masked_sum;  // Renormalize
     }
     
-    // Unrealized P&L
-    double unrealized_pnl = compute_reward();
-    state_features[3] = static_cast<float>(unrealized_pnl);
-    
-    return state_features;
+    last_action_ = 0;
+    for (int i = 0; i < ACTION_COUNT; ++i) {
+        last_probabilities_[i] = p[i];
+        if (p[i] > p[last_action_]) last_action_ = i;
+    }
 }
 
-std::vector<bool> CppPpoStrategy::compute_action_mask() const {
-    std::vector<bool> mask(3, true);  // [sell, hold, buy]
+void CppPpoStrategy::fill_state_features(float* out) const {
+    // State features matching Kochi2 format
+    // [position_long, position_short, position_hold, unrealized_pnl]
+    out[0] = position_state_ == PositionState::LONG ? 1.0f : 0.0f;
+    out[1] = position_state_ == PositionState::SHORT ? 1.0f : 0.0f;
+    out[2] = position_state_ == PositionState::HOLD ? 1.0f : 0.0f;
+    out[3] = static_cast<float>(compute_reward());   // unrealized P&L
+}
+
+void CppPpoStrategy::compute_action_mask(std::array<bool, ACTION_COUNT>& mask) const {
+    mask.fill(true);  // [sell, hold, buy]
     
     if (!config_.enable_action_masking) {
-        return mask;  // All actions allowed
+        return;  // All actions allowed
     }
     
     // Apply action masking rules (matching Kochi logic)
@@ -292,8 +391,6 @@ std::vector<bool> CppPpoStrategy::compute_action_mask() const {
             mask[2] = true;   // Can buy (close short)
             break;
     }
-    
-    return mask;
 }
 
 void CppPpoStrategy::update_position_state(int action) {
@@ -309,7 +406,7 @@ void CppPpoStrategy::update_position_state(int action) {
             } else if (position_state_ == PositionState::HOLD) {
                 // Open long position
                 position_state_ = PositionState::LONG;
-                entry_price_ = bar_history_.back().close;  // Use close price
+                entry_price_ = last_close_;  // Use close price
                 total_trades_++;
             }
             break;
@@ -323,7 +420,7 @@ void CppPpoStrategy::update_position_state(int action) {
             } else if (position_state_ == PositionState::HOLD) {
                 // Open short position
                 position_state_ = PositionState::SHORT;
-                entry_price_ = bar_history_.back().close;  // Use close price
+                entry_price_ = last_close_;  // Use close price
                 total_trades_++;
             }
             break;
@@ -335,11 +432,11 @@ void CppPpoStrategy::update_position_state(int action) {
 }
 
 double CppPpoStrategy::compute_reward() const {
-    if (position_state_ == PositionState::HOLD || entry_price_ <= 0.0 || bar_history_.empty()) {
+    if (position_state_ == PositionState::HOLD || entry_price_ <= 0.0 || last_close_ <= 0.0) {
         return 0.0;
     }
     
-    double current_price = bar_history_.back().close;
+    double current_price = last_close_;
     double reward = 0.0;
     
     if (position_state_ == PositionState::LONG) {
@@ -354,16 +451,17 @@ double CppPpoStrategy::compute_reward() const {
     return reward;
 }
 
-SignalOutput CppPpoStrategy::convert_to_signal(int action, const std::vector<double>& probabilities, int bar_index) {
+SignalOutput CppPpoStrategy::convert_to_signal(int action, const std::array<double, ACTION_COUNT>& probabilities,
+                                               int bar_index) {
     SignalOutput signal;
-    signal.timestamp_ms = bar_history_.back().timestamp_ms;
+    signal.timestamp_ms = last_timestamp_ms_;
     signal.bar_index = bar_index;
     
     // Use BUY probability as "probability next bar up" (matching our analysis)
-    signal.probability = probabilities.size() > 2 ? probabilities[2] : 0.5;
+    signal.probability = probabilities[2];
     
     // Use selected action probability as confidence
-    signal.confidence = probabilities.size() > action ? probabilities[action] : 0.0;
+    signal.confidence = probabilities[action];
     
     // Add required metadata for trading system compatibility
     PpoAction ppo_action = index_to_ppo_action(action);
@@ -385,33 +483,15 @@ SignalOutput CppPpoStrategy::convert_to_signal(int action, const std::vector<dou
 }
 
 std::vector<double> CppPpoStrategy::get_action_probabilities() const {
-    return last_probabilities_;
+    return std::vector<double>(last_probabilities_.begin(), last_probabilities_.end());
 }
 
 std::vector<bool> CppPpoStrategy::get_action_mask() const {
-    return last_action_mask_;
+    return std::vector<bool>(last_action_mask_.begin(), last_action_mask_.end());
 }
 
-std::vector<double> CppPpoStrategy::tensor_to_vector(const torch::Tensor& tensor) {
-    std::vector<double> result;
-    
-    if (tensor.dim() == 1) {
-        result.reserve(tensor.size(0));
-        for (int i = 0; i < tensor.size(0); ++i) {
-            result.push_back(tensor[i].item<double>());
-        }
-    } else if (tensor.dim() == 2 && tensor.size(0) == 1) {
-        // Handle batch dimension
-        result.reserve(tensor.size(1));
-        for (int i = 0; i < tensor.size(1); ++i) {
-            result.push_back(tensor[0][i].item<double>());
-        }
-    }
-    
-    return result;
-}
-
-void CppPpoStrategy::log_inference_details(int action, const std::vector<double>& probs, int bar_index) const {
+void CppPpoStrategy::log_inference_details(int action, const std::array<double, ACTION_COUNT>& probs,
+                                           int bar_index) const {
     PpoAction ppo_action = index_to_ppo_action(action);
     
     utils::log_info("🤖 PPO Inference [Bar " + std::to_string(bar_index) + "]:");
@@ -424,149 +504,4 @@ void CppPpoStrategy::log_inference_details(int action, const std::vector<double>
     utils::log_info("   Unrealized P&L: " + std::to_string(compute_reward()));
 }
 
-std::vector<double> CppPpoStrategy::create_kochi_compatible_features(const Bar& bar, int bar_index) const {
-    std::vector<double> features(config_.feature_dim, 0.0);
-    
-    // Create simplified features that approximate Kochi's feature set
-    // This is a placeholder implementation - in production, we'd need the exact Kochi features
-    
-    if (bar_history_.size() < 2) {
-        return features;  // Return zeros if insufficient history
-    }
-    
-    // Basic OHLC features (normalized)
-    double close = bar.close;
-    double open = bar.open;
-    double high = bar.high;
-    double low = bar.low;
-    double volume = bar.volume;
-    
-    int idx = 0;
-    
-    // Price ratios (5 features)
-    if (idx < config_.feature_dim) features[idx++] = (high - low) / close;  // Range ratio
-    if (idx < config_.feature_dim) features[idx++] = (close - open) / close;  // Body ratio
-    if (idx < config_.feature_dim) features[idx++] = (high - std::max(open, close)) / close;  // Upper shadow
-    if (idx < config_.feature_dim) features[idx++] = (std::min(open, close) - low) / close;  // Lower shadow
-    if (idx < config_.feature_dim) features[idx++] = std::log(volume + 1.0) / 20.0;  // Log volume (normalized)
-    
-    // Price momentum features (10 features)
-    if (bar_history_.size() >= 2) {
-        const Bar& prev = bar_history_[bar_history_.size() - 2];
-        if (idx < config_.feature_dim) features[idx++] = (close - prev.close) / prev.close;  // Return
-        if (idx < config_.feature_dim) features[idx++] = (high - prev.high) / prev.high;  // High change
-        if (idx < config_.feature_dim) features[idx++] = (low - prev.low) / prev.low;  // Low change
-        if (idx < config_.feature_dim) features[idx++] = (volume - prev.volume) / (prev.volume + 1.0);  // Volume change
-        if (idx < config_.feature_dim) features[idx++] = (open - prev.close) / prev.close;  // Gap
-    }
-    
-    // Moving averages (simplified - 20 features)
-    if (bar_history_.size() >= 5) {
-        // 5-period MA
-        double ma5 = 0.0;
-        for (int i = 0; i < 5 && i < static_cast<int>(bar_history_.size()); ++i) {
-            ma5 += bar_history_[bar_history_.size() - 1 - i].close;
-        }
-        ma5 /= std::min(5, static_cast<int>(bar_history_.size()));
-        if (idx < config_.feature_dim) features[idx++] = (close - ma5) / ma5;
-    }
-    
-    if (bar_history_.size() >= 10) {
-        // 10-period MA
-        double ma10 = 0.0;
-        for (int i = 0; i < 10 && i < static_cast<int>(bar_history_.size()); ++i) {
-            ma10 += bar_history_[bar_history_.size() - 1 - i].close;
-        }
-        ma10 /= std::min(10, static_cast<int>(bar_history_.size()));
-        if (idx < config_.feature_dim) features[idx++] = (close - ma10) / ma10;
-    }
-    
-    if (bar_history_.size() >= 20) {
-        // 20-period MA
-        double ma20 = 0.0;
-        for (int i = 0; i < 20 && i < static_cast<int>(bar_history_.size()); ++i) {
-            ma20 += bar_history_[bar_history_.size() - 1 - i].close;
-        }
-        ma20 /= std::min(20, static_cast<int>(bar_history_.size()));
-        if (idx < config_.feature_dim) features[idx++] = (close - ma20) / ma20;
-    }
-    
-    // Volatility features (10 features)
-    if (bar_history_.size() >= 10) {
-        // Calculate recent volatility
-        std::vector<double> returns;
-        for (int i = 1; i < 10 && i < static_cast<int>(bar_history_.size()); ++i) {
-            double ret = (bar_history_[bar_history_.size() - i].close - 
-                         bar_history_[bar_history_.size() - i - 1].close) / 
-                         bar_history_[bar_history_.size() - i - 1].close;
-            returns.push_back(ret);
-        }
-        
-        if (!returns.empty()) {
-            double mean_return = 0.0;
-            for (double ret : returns) mean_return += ret;
-            mean_return /= returns.size();
-            
-            double variance = 0.0;
-            for (double ret : returns) {
-                variance += (ret - mean_return) * (ret - mean_return);
-            }
-            variance /= returns.size();
-            double volatility = std::sqrt(variance);
-            
-            if (idx < config_.feature_dim) features[idx++] = volatility * 100.0;  // Volatility (%)
-        }
-    }
-    
-    // Technical indicators (simplified RSI - 5 features)
-    if (bar_history_.size() >= 14) {
-        // Simplified RSI calculation
-        double gains = 0.0, losses = 0.0;
-        for (int i = 1; i < 14 && i < static_cast<int>(bar_history_.size()); ++i) {
-            double change = bar_history_[bar_history_.size() - i].close - 
-                           bar_history_[bar_history_.size() - i - 1].close;
-            if (change > 0) gains += change;
-            else losses -= change;
-        }
-        
-        if (losses > 0) {
-            double rs = gains / losses;
-            double rsi = 100.0 - (100.0 / (1.0 + rs));
-            if (idx < config_.feature_dim) features[idx++] = rsi / 100.0;  // Normalize to [0,1]
-        }
-    }
-    
-    // Time features (10 features)
-    time_t timestamp = bar.timestamp_ms / 1000;
-    struct tm* time_info = gmtime(&timestamp);
-    if (time_info && idx < config_.feature_dim) {
-        features[idx++] = std::sin(2 * M_PI * time_info->tm_hour / 24.0);  // Hour cyclical
-        if (idx < config_.feature_dim) features[idx++] = std::cos(2 * M_PI * time_info->tm_hour / 24.0);
-        if (idx < config_.feature_dim) features[idx++] = std::sin(2 * M_PI * time_info->tm_min / 60.0);  // Minute cyclical
-        if (idx < config_.feature_dim) features[idx++] = std::cos(2 * M_PI * time_info->tm_min / 60.0);
-        if (idx < config_.feature_dim) features[idx++] = std::sin(2 * M_PI * time_info->tm_wday / 7.0);  // Day of week
-    }
-    
-    // Fill remaining features with normalized price lags
-    for (int lag = 1; lag <= 10 && idx < config_.feature_dim; ++lag) {
-        if (static_cast<int>(bar_history_.size()) > lag) {
-            double lagged_price = bar_history_[bar_history_.size() - 1 - lag].close;
-            features[idx++] = (close - lagged_price) / lagged_price;
-        } else {
-            features[idx++] = 0.0;
-        }
-    }
-    
-    // Ensure all features are bounded
-    for (double& feature : features) {
-        if (std::isnan(feature) || std::isinf(feature)) {
-            feature = 0.0;
-        }
-        // Clamp to reasonable range
-        feature = std::max(-5.0, std::min(5.0, feature));
-    }
-    
-    return features;
-}
-
 } // namespace sentio
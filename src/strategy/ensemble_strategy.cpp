@@ -0,0 +1,319 @@
+#include "strategy/ensemble_strategy.h"
+#include "strategy/detector_pipeline.h"
+#include "common/utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace sentio {
+
+EnsembleStrategy::EnsembleStrategy(const StrategyConfig& config, const Config& ensemble_config)
+    : StrategyComponent(config), ens_cfg_(ensemble_config) {
+    ens_cfg_.batch_bars = std::max<size_t>(ens_cfg_.batch_bars, 1);
+}
+
+EnsembleStrategy::~EnsembleStrategy() = default;
+
+void EnsembleStrategy::add_child(const std::string& label,
+                                 std::unique_ptr<StrategyComponent> child,
+                                 double weight) {
+    auto c = std::make_unique<Child>();
+    c->label = label;
+    c->weight = weight;
+    c->strategy = std::move(child);
+    c->lane = std::make_unique<ThreadPool>(1);
+    children_.push_back(std::move(c));
+}
+
+void EnsembleStrategy::partition_threads(int total_threads, const std::vector<int>& cpus) {
+    auto contexts = ExecutionContext::partition(total_threads, static_cast<int>(children_.size()), cpus);
+    for (size_t i = 0; i < children_.size(); ++i) {
+        children_[i]->strategy->set_execution_context(contexts[i]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Child evaluation
+// -----------------------------------------------------------------------------
+EnsembleStrategy::Eval EnsembleStrategy::evaluate(Child& c, const Bar& bar, int bar_index) {
+    Eval e;
+    StrategyComponent& child = *c.strategy;
+    // The lane runs this child only: pin it to the child's CPUs (no-op after the first bar)
+    child.execution_context().apply_to_current_thread();
+    const auto t0 = LatencyStats::Clock::now();
+    e.emitted = child.on_bar(bar, bar_index, e.record);
+    const auto t1 = LatencyStats::Clock::now();
+    std::lock_guard<std::mutex> lock(c.latency_mutex);
+    c.latency.add(t0, t1);
+    return e;
+}
+
+void EnsembleStrategy::evaluate_children(const Bar& bar, int bar_index) {
+    std::vector<std::future<Eval>> pending;
+    std::vector<uint8_t> behind(children_.size(), 0);
+    pending.reserve(children_.size());
+    for (size_t i = 0; i < children_.size(); ++i) {
+        Child& c = *children_[i];
+        const uint32_t queued = c.backlog.fetch_add(1) + 1;
+        c.max_backlog = std::max(c.max_backlog, queued);
+        behind[i] = queued > 1;
+        pending.push_back(c.lane->submit([&c, bar, bar_index] {
+            struct Finished {
+                std::atomic<uint32_t>& backlog;
+                ~Finished() { backlog.fetch_sub(1); }
+            } finished{c.backlog};
+            return evaluate(c, bar, bar_index);
+        }));
+    }
+
+    const auto deadline = LatencyStats::Clock::now() + std::chrono::microseconds(ens_cfg_.child_budget_us);
+    for (size_t i = 0; i < children_.size(); ++i) {
+        Child& c = *children_[i];
+        // Late, or queued behind a late bar: sit this bar out; the child
+        // finishes it in the background
+        if (ens_cfg_.child_budget_us > 0 &&
+            (behind[i] || pending[i].wait_until(deadline) != std::future_status::ready)) {
+            ++c.misses;
+            c.present = false;
+            continue;
+        }
+        const Eval e = pending[i].get();
+        c.present = e.emitted;
+        if (e.emitted) {
+            c.warmed = true;
+            c.probability = e.record.probability;
+        }
+    }
+}
+
+void EnsembleStrategy::take_batch_results(size_t offset) {
+    for (size_t i = 0; i < children_.size(); ++i) {
+        Child& c = *children_[i];
+        const Eval& e = batch_[i][offset];
+        c.present = e.emitted;
+        if (e.emitted) {
+            c.warmed = true;
+            c.probability = e.record.probability;
+        }
+    }
+}
+
+void EnsembleStrategy::update_indicators(const Bar& bar) {
+    if (batch_mode_) {
+        take_batch_results(batch_cursor_++);
+    } else {
+        evaluate_children(bar, last_bar_index_);
+    }
+}
+
+bool EnsembleStrategy::is_warmed_up() const {
+    if (children_.empty()) return false;
+    for (const auto& c : children_) {
+        if (!c->warmed) return false;
+    }
+    return StrategyComponent::is_warmed_up();
+}
+
+SignalRecord EnsembleStrategy::generate_record(const Bar& bar, int bar_index) {
+    LogOddsFusion fusion;
+    for (const auto& c : children_) {
+        if (c->present && c->weight != 0.0) {
+            fusion.add(c->probability, c->weight);
+        }
+    }
+
+    SignalRecord r;
+    r.timestamp_ms = bar.timestamp_ms;
+    r.bar_index = bar_index;
+    r.symbol_id = run_info_.intern_symbol(bar.symbol);
+    r.strategy_id = strategy_id_;
+    if (fusion.count > 0) {
+        r.probability = fusion.probability(ens_cfg_.k);
+        r.confidence = fusion.confidence();
+    }
+    return r;
+}
+
+// -----------------------------------------------------------------------------
+// Backtest path: one task per child per block of bars
+// -----------------------------------------------------------------------------
+bool EnsembleStrategy::stream_dataset_range(const std::string& dataset_path,
+                                            const std::string& strategy_name,
+                                            SignalSink& sink,
+                                            uint64_t start_index,
+                                            uint64_t count) {
+    if (ens_cfg_.child_budget_us > 0) {
+        return StrategyComponent::stream_dataset_range(dataset_path, strategy_name, sink, start_index, count);
+    }
+
+    auto bars = utils::read_market_data_range(dataset_path, start_index, count);
+    if (bars.empty()) {
+        utils::log_error("Failed to load market data range: start=" + std::to_string(start_index) +
+                        ", count=" + std::to_string(count) + ", path=" + dataset_path);
+        return false;
+    }
+
+    utils::log_info("Processing " + std::to_string(bars.size()) + " bars from index " +
+                   std::to_string(start_index) + " (strategy=" + strategy_name + ", ensemble of " +
+                   std::to_string(children_.size()) + ")");
+
+    set_run_strategy(strategy_name);
+    if (!sink.begin(run_info_)) {
+        return false;
+    }
+
+    batch_.assign(children_.size(), {});
+    batch_mode_ = true;
+    SignalRecord record;
+    bool ok = true;
+    for (size_t offset = 0; offset < bars.size() && ok; offset += ens_cfg_.batch_bars) {
+        const size_t len = std::min(ens_cfg_.batch_bars, bars.size() - offset);
+        const int first_index = static_cast<int>(start_index + offset);
+
+        std::vector<std::future<void>> pending;
+        pending.reserve(children_.size());
+        for (size_t i = 0; i < children_.size(); ++i) {
+            Child* child = children_[i].get();
+            std::vector<Eval>* out = &batch_[i];
+            const Bar* block = bars.data() + offset;
+            pending.push_back(child->lane->submit([child, out, block, len, first_index] {
+                out->resize(len);
+                for (size_t j = 0; j < len; ++j) {
+                    (*out)[j] = evaluate(*child, block[j], first_index + static_cast<int>(j));
+                }
+            }));
+        }
+        for (auto& f : pending) {
+            try {
+                f.get();
+            } catch (const std::exception& e) {
+                utils::log_error(std::string("Ensemble child failed: ") + e.what());
+                ok = false;
+            }
+        }
+        if (!ok) break;
+
+        batch_cursor_ = 0;
+        for (size_t j = 0; j < len; ++j) {
+            if (on_bar(bars[offset + j], first_index + static_cast<int>(j), record)) {
+                sink.write(record);
+            }
+        }
+    }
+    batch_mode_ = false;
+    batch_.clear();
+
+    return sink.finish() && ok;
+}
+
+// -----------------------------------------------------------------------------
+// Reporting
+// -----------------------------------------------------------------------------
+LatencyStats EnsembleStrategy::child_latency(size_t i) const {
+    std::lock_guard<std::mutex> lock(children_[i]->latency_mutex);
+    return children_[i]->latency;
+}
+
+std::string EnsembleStrategy::latency_report() const {
+    std::string out;
+    char buf[96];
+    for (const auto& c : children_) {
+        std::snprintf(buf, sizeof(buf), "  %-12s w=%-6.3g ", c->label.c_str(), c->weight);
+        out += buf;
+        {
+            std::lock_guard<std::mutex> lock(c->latency_mutex);
+            out += c->latency.format();
+        }
+        if (ens_cfg_.child_budget_us > 0) {
+            out += " budget_misses=" + std::to_string(c->misses) +
+                   " backlog=" + std::to_string(c->backlog.load()) +
+                   " max_backlog=" + std::to_string(c->max_backlog);
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Lookback and snapshots (delegated to the children)
+// -----------------------------------------------------------------------------
+int EnsembleStrategy::required_lookback() const {
+    if (children_.empty()) return -1;
+    int lookback = 0;
+    for (const auto& c : children_) {
+        const int child_lookback = c->strategy->required_lookback();
+        if (child_lookback < 0) return -1;
+        lookback = std::max(lookback, child_lookback);
+    }
+    return lookback;
+}
+
+bool EnsembleStrategy::supports_snapshots() const {
+    if (children_.empty()) return false;
+    for (const auto& c : children_) {
+        if (!c->strategy->supports_snapshots()) return false;
+    }
+    return true;
+}
+
+std::string EnsembleStrategy::config_fingerprint() const {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "|k=%.17g", ens_cfg_.k);
+    std::string fp = StrategyComponent::config_fingerprint() + buf;
+    for (const auto& c : children_) {
+        std::snprintf(buf, sizeof(buf), "|w=%.17g|", c->weight);
+        fp += "|child=" + c->label + buf + c->strategy->result_fingerprint();
+    }
+    return fp;
+}
+
+void EnsembleStrategy::save_derived_state(StateWriter& w) const {
+    w.put(static_cast<uint32_t>(children_.size()));
+    for (const auto& c : children_) {
+        // Let a child that missed its budget finish its queue first
+        c->lane->submit([] {}).wait();
+        std::vector<char> blob;
+        if (!c->strategy->save_state(blob)) blob.clear();
+        w.put(static_cast<uint64_t>(blob.size()));
+        w.put_bytes(blob.data(), blob.size());
+        w.put(static_cast<uint8_t>(c->warmed ? 1 : 0));
+    }
+}
+
+bool EnsembleStrategy::load_derived_state(StateReader& r) {
+    // Read every child's snapshot before restoring any of them
+    uint32_t n = 0;
+    if (!r.get(n) || n != children_.size()) return false;
+    std::vector<const char*> blobs(n, nullptr);
+    std::vector<size_t> sizes(n, 0);
+    std::vector<uint8_t> warmed(n, 0);
+    for (uint32_t i = 0; i < n; ++i) {
+        uint64_t size = 0;
+        if (!r.get(size)) return false;
+        sizes[i] = static_cast<size_t>(size);
+        blobs[i] = r.take(sizes[i]);
+        if (!blobs[i] || !r.get(warmed[i])) return false;
+    }
+    if (!r.at_end()) return false;
+
+    // A child that rejects its snapshot rolls back the ones restored before it
+    std::vector<std::vector<char>> previous(n);
+    for (size_t i = 0; i < n; ++i) {
+        StrategyComponent& child = *children_[i]->strategy;
+        children_[i]->lane->submit([] {}).wait();
+        if (!child.save_state(previous[i]) || !child.restore_state(blobs[i], sizes[i])) {
+            for (size_t j = 0; j < i; ++j) {
+                children_[j]->strategy->restore_state(previous[j].data(), previous[j].size());
+            }
+            return false;
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        children_[i]->warmed = warmed[i] != 0;
+        children_[i]->present = false;
+    }
+    return true;
+}
+
+} // namespace sentio
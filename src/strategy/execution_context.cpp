@@ -0,0 +1,161 @@
+#include "strategy/execution_context.h"
+#include "common/thread_pool.h"
+#include "common/utils.h"
+
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#ifdef TORCH_AVAILABLE
+#include <ATen/Parallel.h>
+#endif
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace sentio {
+
+namespace {
+    std::mutex g_process_mutex;
+    int g_interop_threads = 0;      // 0 = not configured yet
+
+    // Pin the calling thread to `cpus`; false when unsupported or rejected.
+    bool pin_current_thread(const std::vector<int>& cpus) {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpus;
+        return false;
+#endif
+    }
+
+    // Compact "0-3,8" rendering of a CPU list
+    std::string format_cpu_list(const std::vector<int>& cpus) {
+        std::string out;
+        for (size_t i = 0; i < cpus.size();) {
+            size_t j = i;
+            while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+            if (!out.empty()) out += ",";
+            out += std::to_string(cpus[i]);
+            if (j > i) out += "-" + std::to_string(cpus[j]);
+            i = j + 1;
+        }
+        return out;
+    }
+}
+
+ExecutionContext::ExecutionContext(Options options) : options_(std::move(options)) {
+    options_.intra_op_threads = std::max(1, options_.intra_op_threads);
+    options_.interop_threads = std::max(1, options_.interop_threads);
+}
+
+void ExecutionContext::apply_to_current_thread() const {
+    thread_local int applied = 0;
+    thread_local std::vector<int> applied_cpus;
+    if (options_.cpus != applied_cpus) {
+        // Pin before the thread count so a newly started intra-op team
+        // inherits the CPU set
+        if (!options_.cpus.empty() && !pin_current_thread(options_.cpus)) {
+            utils::log_warning("ExecutionContext: cannot pin thread to CPUs " + format_cpu_list(options_.cpus));
+        }
+        applied_cpus = options_.cpus;
+    }
+    if (applied == options_.intra_op_threads) return;
+#ifdef TORCH_AVAILABLE
+    at::set_num_threads(options_.intra_op_threads);
+#endif
+    applied = options_.intra_op_threads;
+}
+
+std::vector<ExecutionContext> ExecutionContext::partition(int total_threads, int instances,
+                                                          const std::vector<int>& cpus) {
+    if (total_threads <= 0) {
+        total_threads = cpus.empty() ? ThreadPool::default_thread_count() : static_cast<int>(cpus.size());
+    }
+    instances = std::max(1, instances);
+
+    std::vector<ExecutionContext> contexts;
+    contexts.reserve(static_cast<size_t>(instances));
+    const int base = total_threads / instances;
+    const int extra = total_threads % instances;
+    size_t next_cpu = 0;
+    for (int i = 0; i < instances; ++i) {
+        Options options;
+        options.intra_op_threads = std::max(1, base + (i < extra ? 1 : 0));
+        for (int t = 0; t < options.intra_op_threads && !cpus.empty(); ++t) {
+            options.cpus.push_back(cpus[next_cpu++ % cpus.size()]);
+        }
+        std::sort(options.cpus.begin(), options.cpus.end());
+        options.cpus.erase(std::unique(options.cpus.begin(), options.cpus.end()), options.cpus.end());
+        contexts.emplace_back(options);
+    }
+    return contexts;
+}
+
+bool ExecutionContext::parse_cpu_list(const std::string& text, std::vector<int>& cpus) {
+    cpus.clear();
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) return false;
+        try {
+            size_t used = 0;
+            const int first = std::stoi(item, &used);
+            int last = first;
+            if (used < item.size()) {
+                if (item[used] != '-') return false;
+                const std::string rest = item.substr(used + 1);
+                last = std::stoi(rest, &used);
+                if (used != rest.size()) return false;
+            }
+            if (first < 0 || last < first) return false;
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return !cpus.empty();
+}
+
+std::string ExecutionContext::describe() const {
+    std::string text = "intra=" + std::to_string(options_.intra_op_threads) +
+                       " interop=" + std::to_string(options_.interop_threads);
+    if (!options_.cpus.empty()) text += " cpus=" + format_cpu_list(options_.cpus);
+    return text;
+}
+
+bool ExecutionContext::configure_process(int interop_threads) {
+    interop_threads = std::max(1, interop_threads);
+    std::lock_guard<std::mutex> lock(g_process_mutex);
+    if (g_interop_threads != 0) {
+        if (g_interop_threads != interop_threads) {
+            utils::log_warning("ExecutionContext: inter-op threads already set to " +
+                               std::to_string(g_interop_threads) + ", ignoring " +
+                               std::to_string(interop_threads));
+            return false;
+        }
+        return true;
+    }
+#ifdef TORCH_AVAILABLE
+    try {
+        at::set_num_interop_threads(interop_threads);
+    } catch (const std::exception& e) {
+        // The pool already started (e.g. set elsewhere); keep its size
+        utils::log_warning(std::string("ExecutionContext: cannot set inter-op threads: ") + e.what());
+    }
+#endif
+    g_interop_threads = interop_threads;
+    return true;
+}
+
+} // namespace sentio
@@ -39,9 +39,10 @@ bool MLStrategyBase::load_model_base(const std::string& model_path, const std::s
     try {
         utils::log_info("Loading TorchScript model from: " + model_path);
         
-        // FIX #2: Threading Issues - Force single-threaded LibTorch
-        torch::set_num_threads(1);
-        torch::set_num_interop_threads(1);
+        // Thread budget comes from this instance's ExecutionContext; the
+        // inter-op pool is process-wide and configured once
+        ExecutionContext::configure_process(execution_context().interop_threads());
+        execution_context().apply_to_current_thread();
         
         model_ = torch::jit::load(model_path);
         model_.eval();
@@ -62,6 +63,7 @@ bool MLStrategyBase::load_model_base(const std::string& model_path, const std::s
         
         std::thread dummy_thread([&]() {
             try {
+                execution_context().apply_to_current_thread();
                 dummy_output = model_.forward({dummy_input});
                 dummy_completed = true;
             } catch (...) {
@@ -2,12 +2,13 @@
 #include "common/utils.h"
 #include <algorithm>
 #include <cmath>
-#include <numeric>
 
 namespace sentio {
 
 RegimeAdaptiveMomentumScalper::RegimeAdaptiveMomentumScalper(const ScalperConfig& config)
-    : config_(config) {
+    : config_(config),
+      fast_ma_(static_cast<size_t>(std::max(1, config.fast_sma_period))),
+      slow_ma_(static_cast<size_t>(std::max(1, config.slow_sma_period))) {
     
     // Initialize PSM for systematic position management
     psm_ = std::make_unique<PositionStateMachine>();
@@ -153,14 +154,14 @@ bool RegimeAdaptiveMomentumScalper::is_transition_allowed(
 }
 
 void RegimeAdaptiveMomentumScalper::update_sma_values(double price) {
-    // Add new price to history
-    price_history_.push_back(price);
-    maintain_history_size();
+    fast_ma_.push(price);
+    slow_ma_.push(price);
+    ++bars_seen_;
     
     // Calculate SMAs if we have enough data
-    if (price_history_.size() >= static_cast<size_t>(config_.slow_sma_period)) {
-        fast_sma_ = calculate_sma(price_history_, config_.fast_sma_period);
-        slow_sma_ = calculate_sma(price_history_, config_.slow_sma_period);
+    if (slow_ma_.ready()) {
+        fast_sma_ = fast_ma_.value();
+        slow_sma_ = slow_ma_.value();
         
         // Calculate trend strength (-1.0 to +1.0)
         if (slow_sma_ > 0) {
@@ -171,7 +172,7 @@ void RegimeAdaptiveMomentumScalper::update_sma_values(double price) {
 
 RegimeAdaptiveMomentumScalper::MarketRegime RegimeAdaptiveMomentumScalper::detect_market_regime() {
     // Need sufficient data for regime detection
-    if (price_history_.size() < static_cast<size_t>(config_.min_bars_for_trend)) {
+    if (bars_seen_ < static_cast<size_t>(config_.min_bars_for_trend)) {
         return MarketRegime::NEUTRAL;
     }
     
@@ -284,24 +285,4 @@ std::string RegimeAdaptiveMomentumScalper::select_optimal_instrument(
     return "HOLD";
 }
 
-double RegimeAdaptiveMomentumScalper::calculate_sma(const std::deque<double>& data, int period) const {
-    if (data.size() < static_cast<size_t>(period)) {
-        return 0.0;
-    }
-    
-    // Calculate SMA over the last 'period' values
-    auto start_it = data.end() - period;
-    double sum = std::accumulate(start_it, data.end(), 0.0);
-    return sum / period;
-}
-
-void RegimeAdaptiveMomentumScalper::maintain_history_size() {
-    // Keep only the data we need (slow SMA period + some buffer)
-    size_t max_history = static_cast<size_t>(config_.slow_sma_period * 2);
-    
-    while (price_history_.size() > max_history) {
-        price_history_.pop_front();
-    }
-}
-
 } // namespace sentio
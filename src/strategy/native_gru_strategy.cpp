@@ -0,0 +1,131 @@
+#include "strategy/native_gru_strategy.h"
+#include "common/state_stream.h"
+#include "common/utils.h"
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+namespace sentio {
+
+NativeGruStrategy::NativeGruStrategy(const StrategyConfig& base_config, const Config& config)
+    : StrategyComponent(base_config), config_(config), features_(config.sequence_length) {
+    run_info_.metadata["model_type"] = "NativeGRU";
+}
+
+bool NativeGruStrategy::initialize() {
+    startup_.begin();
+    ml::kernels::WeightPrecision precision;
+    if (!ml::kernels::parse_weight_precision(config_.precision, precision)) {
+        utils::log_error("Unknown native GRU precision: " + config_.precision + " (fp32|bf16|int8)");
+        return false;
+    }
+    auto model = std::make_unique<ml::NativeGruModel>();
+    if (!model->load(config_.model_path, precision)) {
+        return false;
+    }
+    const auto& shape = model->config();
+    if (shape.feature_dim != GruFeatureWindow::FEATURE_COUNT ||
+        shape.sequence_length < static_cast<uint32_t>(config_.sequence_length)) {
+        utils::log_error("Native GRU model expects " + std::to_string(shape.feature_dim) + " features x " +
+                         std::to_string(shape.sequence_length) + " steps; strategy feeds " +
+                         std::to_string(GruFeatureWindow::FEATURE_COUNT) + " x " +
+                         std::to_string(config_.sequence_length));
+        return false;
+    }
+    model_ = std::move(model);
+    state_.reset();
+    startup_.mark("model");
+
+    // First forward on a zero window (also faults in the mapped weights)
+    startup_.start_warmup([this] {
+        std::vector<float> window(static_cast<size_t>(config_.sequence_length) * GruFeatureWindow::FEATURE_COUNT,
+                                  0.0f);
+        ml::NativeGruOutput output;
+        model_->forward(window.data(), config_.sequence_length, output);
+    });
+    utils::log_info("Native GRU model loaded (" + std::string(ml::kernels::to_string(precision)) + " weights" +
+                    (config_.streaming ? ", streaming, re-sync every " + std::to_string(config_.resync_interval) +
+                                             " bars"
+                                       : "") +
+                    "): " + config_.model_path);
+    return true;
+}
+
+void NativeGruStrategy::update_indicators(const Bar& bar) {
+    features_.update_statistics(bar);
+}
+
+bool NativeGruStrategy::infer(int bar_index, double& probability, double& confidence) {
+    const float* window = features_.window();
+    if (!model_ || !window) {
+        return false;
+    }
+    startup_.finish_warmup();
+
+    const int steps = config_.sequence_length;
+    ml::NativeGruOutput output;
+    bool ok;
+    if (!config_.streaming) {
+        ok = model_->forward(window, steps, output);
+    } else if (!state_.valid() || state_.steps_since_sync + 1 >= config_.resync_interval) {
+        ok = model_->forward_window(window, steps, state_, output);
+    } else {
+        ok = model_->forward_step(window + static_cast<size_t>(steps - 1) * GruFeatureWindow::FEATURE_COUNT,
+                                  state_, output);
+    }
+    if (!ok) {
+        return false;
+    }
+    probability = 1.0 / (1.0 + std::exp(-static_cast<double>(output.direction)));
+    confidence = std::abs(probability - 0.5) * 2.0;
+    startup_.first_signal(bar_index);
+    return true;
+}
+
+SignalRecord NativeGruStrategy::generate_record(const Bar& bar, int bar_index) {
+    SignalRecord record;
+    record.timestamp_ms = bar.timestamp_ms;
+    record.bar_index = bar_index;
+    record.symbol_id = run_info_.intern_symbol(bar.symbol);
+    infer(bar_index, record.probability, record.confidence);
+    return record;
+}
+
+SignalOutput NativeGruStrategy::generate_signal(const Bar& bar, int bar_index) {
+    SignalOutput signal;
+    signal.timestamp_ms = bar.timestamp_ms;
+    signal.bar_index = bar_index;
+    signal.symbol = bar.symbol;
+    signal.strategy_name = get_name();
+    signal.probability = 0.5;
+    signal.confidence = 0.0;
+    infer(bar_index, signal.probability, signal.confidence);
+    return signal;
+}
+
+std::string NativeGruStrategy::config_fingerprint() const {
+    std::ostringstream oss;
+    oss << StrategyComponent::config_fingerprint() << "|native_gru=" << config_.model_path
+        << "|seq=" << config_.sequence_length << "|precision=" << config_.precision;
+    if (config_.streaming) {
+        oss << "|resync=" << config_.resync_interval;
+    }
+    return oss.str();
+}
+
+void NativeGruStrategy::save_derived_state(StateWriter& w) const {
+    features_.save(w);
+}
+
+bool NativeGruStrategy::load_derived_state(StateReader& r) {
+    // Load into a copy so a malformed payload leaves the strategy untouched
+    GruFeatureWindow features = features_;
+    if (!features.load(r) || !r.at_end()) {
+        return false;
+    }
+    features_ = std::move(features);
+    state_.reset();   // next bar runs a full window
+    return true;
+}
+
+} // namespace sentio
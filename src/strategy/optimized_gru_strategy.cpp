@@ -1,6 +1,9 @@
 #include "strategy/optimized_gru_strategy.h"
 #include "common/utils.h"
+#include "common/metadata_sidecar.h"
+#include <cstring>
 #include <fstream>
+#include <stdexcept>
 #include <nlohmann/json.hpp>
 #include <iomanip>
 #include <cmath>
@@ -11,8 +14,9 @@ OptimizedGruStrategy::OptimizedGruStrategy(const OptimizedGruConfig& config)
     : StrategyComponent(StrategyConfig{config.model_path, "2.0", 0.6, 0.4, config.sequence_length}),
       config_(config) {
     
-    feature_engine_ = std::make_unique<FastFeatureEngine>();
+    feature_engine_ = std::make_unique<FastFeatureEngine>(static_cast<int>(config_.sequence_length));
     bar_history_.clear();
+    run_info_.metadata["model_type"] = "OptimizedGRU";
     
     utils::log_info("Initializing OptimizedGruStrategy v2.0 - High Performance Edition");
     utils::log_info("Model: " + config_.model_path);
@@ -26,6 +30,7 @@ bool OptimizedGruStrategy::initialize() {
     
     try {
         std::cout << "🔄 Attempting to load model..." << std::endl;
+        startup_.begin();
         
         // Load model
         if (!load_model()) {
@@ -33,6 +38,8 @@ bool OptimizedGruStrategy::initialize() {
             utils::log_error("Failed to load GRU model");
             return false;
         }
+        startup_.mark(remote_model_ ? "model (server)" : "model");
+        start_model_warmup();
         
         std::cout << "✅ Model loaded successfully, initializing feature engine..." << std::endl;
         
@@ -43,6 +50,7 @@ bool OptimizedGruStrategy::initialize() {
             return false;
         }
         
+        startup_.mark("metadata");
         std::cout << "✅ Feature engine initialized" << std::endl;
         utils::log_info("✅ OptimizedGruStrategy initialized successfully");
         utils::log_info("🎯 Target: <500μs inference time");
@@ -57,6 +65,16 @@ bool OptimizedGruStrategy::initialize() {
 }
 
 bool OptimizedGruStrategy::load_model() {
+    if (!config_.model_server.empty()) {
+        return load_remote_model();
+    }
+    if (!config_.native_model_path.empty()) {
+        return load_native_model();
+    }
+    if (!config_.streaming_model_path.empty()) {
+        return load_streaming_model();
+    }
+    
     try {
         utils::log_info("🔄 Loading GRU model from: " + config_.model_path);
         
@@ -68,9 +86,10 @@ bool OptimizedGruStrategy::load_model() {
         }
         file_check.close();
         
-        // Force single-threaded LibTorch for stability
-        torch::set_num_threads(1);
-        torch::set_num_interop_threads(1);
+        // Thread budget comes from this instance's ExecutionContext; the
+        // inter-op pool is process-wide and configured once
+        ExecutionContext::configure_process(execution_context().interop_threads());
+        execution_context().apply_to_current_thread();
         
         model_ = torch::jit::load(config_.model_path);
         model_.eval();
@@ -90,6 +109,115 @@ bool OptimizedGruStrategy::load_model() {
     }
 }
 
+bool OptimizedGruStrategy::load_streaming_model() {
+    try {
+        utils::log_info("🔄 Loading streaming GRU model from: " + config_.streaming_model_path);
+        
+        ml::GRUConfig gru_config;
+        gru_config.feature_dim = 53;
+        gru_config.sequence_length = config_.sequence_length;
+        std::ifstream metadata_file(config_.metadata_path);
+        if (metadata_file.is_open()) {
+            nlohmann::json metadata;
+            metadata_file >> metadata;
+            gru_config.hidden_dim = metadata.value("hidden_dim", gru_config.hidden_dim);
+            gru_config.num_layers = metadata.value("num_layers", gru_config.num_layers);
+            gru_config.num_heads = metadata.value("num_heads", gru_config.num_heads);
+            gru_config.enable_multi_task = metadata.value("enable_multi_task", gru_config.enable_multi_task);
+        }
+        
+        ExecutionContext::configure_process(execution_context().interop_threads());
+        execution_context().apply_to_current_thread();
+        
+        streaming_model_ = ml::AdvancedGRUModel(gru_config);
+        streaming_model_->load_model(config_.streaming_model_path);
+        streaming_model_->eval();
+        stream_state_.reset();
+        
+        model_loaded_ = true;
+        utils::log_info("✅ Streaming GRU model loaded (re-sync every " +
+                        std::to_string(config_.resync_interval) + " bars)");
+        return true;
+        
+    } catch (const std::exception& e) {
+        utils::log_error("❌ Failed to load streaming GRU model: " + std::string(e.what()));
+        streaming_model_ = nullptr;
+        model_loaded_ = false;
+        return false;
+    }
+}
+
+bool OptimizedGruStrategy::load_native_model() {
+    ml::kernels::WeightPrecision precision;
+    if (!ml::kernels::parse_weight_precision(config_.native_precision, precision)) {
+        utils::log_error("❌ Unknown native GRU precision: " + config_.native_precision + " (fp32|bf16|int8)");
+        model_loaded_ = false;
+        return false;
+    }
+    auto model = std::make_unique<ml::NativeGruModel>();
+    if (!model->load(config_.native_model_path, precision)) {
+        model_loaded_ = false;
+        return false;
+    }
+    if (model->config().feature_dim != 53 ||
+        model->config().sequence_length < static_cast<uint32_t>(config_.sequence_length)) {
+        utils::log_error("❌ Native GRU model expects " + std::to_string(model->config().feature_dim) +
+                         " features x " + std::to_string(model->config().sequence_length) +
+                         " steps; strategy feeds 53 x " + std::to_string(config_.sequence_length));
+        model_loaded_ = false;
+        return false;
+    }
+    native_model_ = std::move(model);
+    native_state_.reset();
+    model_loaded_ = true;
+    utils::log_info("✅ Native GRU model loaded (no LibTorch at inference, " +
+                    std::string(ml::kernels::to_string(precision)) + " weights): " + config_.native_model_path);
+    return true;
+}
+
+bool OptimizedGruStrategy::load_remote_model() {
+    const bool native = !config_.native_model_path.empty();
+    const std::string kind = !native ? "torchscript"
+                           : config_.native_precision == "fp32" ? "native" : "native-" + config_.native_precision;
+    const std::string& path = native ? config_.native_model_path : config_.model_path;
+    if (!config_.streaming_model_path.empty() || config_.native_streaming) {
+        utils::log_warning("⚠️  Streaming inference is not served remotely; the model server runs full windows");
+    }
+    auto model = std::make_unique<ml::RemoteModel>();
+    if (!model->connect(config_.model_server, kind, path, static_cast<uint32_t>(config_.sequence_length), 53) ||
+        model->output_dim() != 1) {
+        model_loaded_ = false;
+        return false;
+    }
+    remote_model_ = std::move(model);
+    model_loaded_ = true;
+    utils::log_info("✅ GRU model served by " + config_.model_server + ": " + kind + ":" + path);
+    return true;
+}
+
+void OptimizedGruStrategy::start_model_warmup() {
+    if (remote_model_) return;   // the server keeps its models warm
+    startup_.start_warmup([this] {
+        execution_context().apply_to_current_thread();
+        const int steps = static_cast<int>(config_.sequence_length);
+        if (native_model_) {
+            // Also faults in the mapped weight pages
+            std::vector<float> window(static_cast<size_t>(steps) * 53, 0.0f);
+            ml::NativeGruOutput output;
+            native_model_->forward(window.data(), steps, output);
+            return;
+        }
+        torch::NoGradGuard no_grad;
+        auto window = torch::zeros({1, steps, 53}, torch::kFloat32);
+        if (streaming_model_) {
+            ml::GRUStreamState state;
+            streaming_model_->forward_window(window, state);
+        } else {
+            model_.forward({window});
+        }
+    });
+}
+
 void OptimizedGruStrategy::update_indicators(const Bar& bar) {
     // CRITICAL: Update incremental feature calculator FIRST
     feature_engine_->update_statistics(bar);
@@ -103,6 +231,62 @@ void OptimizedGruStrategy::update_indicators(const Bar& bar) {
     }
 }
 
+std::string OptimizedGruStrategy::config_fingerprint() const {
+    std::string fingerprint = StrategyComponent::config_fingerprint() + "|" + config_.metadata_path + "|seq=" +
+                              std::to_string(config_.sequence_length) + "|feat=" + std::to_string(config_.feature_dim) +
+                              "|rows=rolling";
+    if (!config_.native_model_path.empty()) {
+        fingerprint += "|native=" + config_.native_model_path + 
+                       (config_.native_precision != "fp32" ? "|native_precision=" + config_.native_precision : "") +
+                       (config_.native_streaming ? "|native_resync=" + std::to_string(config_.resync_interval) : "");
+    }
+    if (!config_.streaming_model_path.empty()) {
+        fingerprint += "|stream=" + config_.streaming_model_path + "|resync=" + std::to_string(config_.resync_interval);
+    }
+    return fingerprint;
+}
+
+void OptimizedGruStrategy::save_derived_state(StateWriter& w) const {
+    feature_engine_->save(w);
+    w.put(static_cast<uint64_t>(bar_history_.size()));
+    for (const auto& bar : bar_history_) {
+        w.put(bar.timestamp_ms);
+        w.put(bar.open);
+        w.put(bar.high);
+        w.put(bar.low);
+        w.put(bar.close);
+        w.put(bar.volume);
+        w.put_string(bar.symbol);
+    }
+}
+
+bool OptimizedGruStrategy::load_derived_state(StateReader& r) {
+    // Load into copies so a malformed payload leaves the strategy untouched
+    GruFeatureWindow features = *feature_engine_;
+    uint64_t count = 0;
+    if (!features.load(r) || !r.get(count) ||
+        count > static_cast<uint64_t>(config_.sequence_length + 10)) {
+        return false;
+    }
+    std::deque<Bar> history;
+    for (uint64_t i = 0; i < count; ++i) {
+        Bar bar;
+        if (!r.get(bar.timestamp_ms) || !r.get(bar.open) || !r.get(bar.high) || !r.get(bar.low) ||
+            !r.get(bar.close) || !r.get(bar.volume) || !r.get_string(bar.symbol, 64)) {
+            return false;
+        }
+        history.push_back(std::move(bar));
+    }
+    if (!r.at_end()) {
+        return false;
+    }
+    static_cast<GruFeatureWindow&>(*feature_engine_) = std::move(features);
+    bar_history_ = std::move(history);
+    stream_state_.reset();   // next bar runs a full window
+    native_state_.reset();
+    return true;
+}
+
 SignalOutput OptimizedGruStrategy::generate_signal(const Bar& bar, int bar_index) {
     SignalOutput signal;
     signal.timestamp_ms = bar.timestamp_ms;
@@ -125,18 +309,34 @@ SignalOutput OptimizedGruStrategy::generate_signal(const Bar& bar, int bar_index
     
     // Performance optimized inference - no debug output
     
+    // Batched backtest: queue the feature window; stream_dataset_range()
+    // completes the record once the batch has been evaluated.
+    if (inference_batch_) {
+        auto features = feature_engine_->create_features();
+        const size_t window = static_cast<size_t>(features.numel());
+        std::memcpy(batch_inputs_.data_ptr<float>() + inference_batch_->next_row() * window,
+                    features.data_ptr<float>(), window * sizeof(float));
+        deferred_ = true;
+        return signal;
+    }
+    
+    startup_.finish_warmup();
     try {
         // PERFORMANCE TIMING START
         auto start_time = std::chrono::high_resolution_clock::now();
         
         // Create features using optimized engine
-        auto features = feature_engine_->create_features(bar_history_, config_.sequence_length, config_.feature_dim);
+        auto features = feature_engine_->create_features();
         
-        // Run inference
-        auto output = run_inference(features);
+        // Run inference (one step from the carried state when streaming)
+        const double direction_logit = remote_model_    ? run_remote_inference(features)[0].item<double>()
+                                     : native_model_    ? run_native_inference(features)
+                                     : streaming_model_ ? run_streaming_inference(features)
+                                                        : run_inference(features)[0][0].item<double>();
         
         // Convert to signal
-        signal = convert_to_signal(output, bar_index);
+        signal = convert_to_signal(direction_logit, bar_index);
+        startup_.first_signal(bar_index);
         
         // PERFORMANCE TIMING END
         auto end_time = std::chrono::high_resolution_clock::now();
@@ -180,7 +380,8 @@ torch::Tensor OptimizedGruStrategy::run_inference(const torch::Tensor& features)
     std::vector<torch::jit::IValue> inputs;
     inputs.push_back(features);
     
-    // Run model inference
+    // Run model inference within this instance's thread budget
+    execution_context().apply_to_current_thread();
     auto output = model_.forward(inputs);
     
     // Extract direction tensor from the tuple/named output
@@ -195,13 +396,56 @@ torch::Tensor OptimizedGruStrategy::run_inference(const torch::Tensor& features)
     return direction_logits;
 }
 
-SignalOutput OptimizedGruStrategy::convert_to_signal(const torch::Tensor& output, int bar_index) {
+double OptimizedGruStrategy::run_streaming_inference(const torch::Tensor& features) {
+    execution_context().apply_to_current_thread();
+    torch::NoGradGuard no_grad;
+    
+    // Full window when there is no state yet or the interval is up: the
+    // output then equals windowed inference and the drift of the carried
+    // state (history from before the window) is reset
+    ml::GRUOutput output;
+    if (!stream_state_.valid() || stream_state_.steps_since_sync + 1 >= config_.resync_interval) {
+        output = streaming_model_->forward_window(features, stream_state_);
+    } else {
+        output = streaming_model_->forward_step(features.select(1, -1), stream_state_);
+    }
+    return output.direction[0][0].item<double>();
+}
+
+double OptimizedGruStrategy::run_native_inference(const torch::Tensor& features) {
+    // features is the contiguous [1, seq_len, 53] window built by the feature engine
+    const float* window = features.data_ptr<float>();
+    const int steps = config_.sequence_length;
+    ml::NativeGruOutput output;
+    bool ok;
+    if (!config_.native_streaming) {
+        ok = native_model_->forward(window, steps, output);
+    } else if (!native_state_.valid() || native_state_.steps_since_sync + 1 >= config_.resync_interval) {
+        ok = native_model_->forward_window(window, steps, native_state_, output);
+    } else {
+        ok = native_model_->forward_step(window + static_cast<size_t>(steps - 1) * 53, native_state_, output);
+    }
+    if (!ok) {
+        throw std::runtime_error("native GRU inference failed");
+    }
+    return output.direction;
+}
+
+torch::Tensor OptimizedGruStrategy::run_remote_inference(const torch::Tensor& windows) {
+    const int rows = static_cast<int>(windows.size(0));
+    torch::Tensor logits = torch::empty({rows}, torch::kFloat);
+    if (!remote_model_->infer(windows.data_ptr<float>(), rows, logits.data_ptr<float>())) {
+        throw std::runtime_error("model server inference failed");
+    }
+    return logits;
+}
+
+SignalOutput OptimizedGruStrategy::convert_to_signal(double direction_logit, int bar_index) {
     SignalOutput signal;
     signal.bar_index = bar_index;
     signal.strategy_name = get_name();
     
-    // Extract logit and apply sigmoid activation
-    double direction_logit = output[0][0].item<double>();
+    // Apply sigmoid activation to the direction logit
     double direction_prob = 1.0 / (1.0 + std::exp(-direction_logit));  // Sigmoid
     
     // Apply bias correction if model is consistently bearish
@@ -213,14 +457,99 @@ SignalOutput OptimizedGruStrategy::convert_to_signal(const torch::Tensor& output
     signal.probability = direction_prob;
     signal.confidence = std::abs(direction_prob - 0.5) * 2.0;  // Distance from neutral
     
-    // Add metadata
-    signal.metadata["model_type"] = "OptimizedGRU";
-    signal.metadata["inference_time_us"] = std::to_string(perf_stats_.avg_inference_time_us);
-    signal.metadata["total_inferences"] = std::to_string(perf_stats_.total_inferences);
-    
+    // Model type is published once in run_info(); timing lives in
+    // get_performance_stats() rather than being stringified per bar.
     return signal;
 }
 
+bool OptimizedGruStrategy::stream_dataset_range(const std::string& dataset_path,
+                                                const std::string& strategy_name,
+                                                SignalSink& sink,
+                                                uint64_t start_index,
+                                                uint64_t count) {
+    // Streaming and native inference run per bar: keep the per-bar loop
+    if (config_.inference_batch <= 1 || !model_loaded_ || streaming_model_ || native_model_) {
+        return StrategyComponent::stream_dataset_range(dataset_path, strategy_name, sink, start_index, count);
+    }
+
+    auto bars = utils::read_market_data_range(dataset_path, start_index, count);
+    if (bars.empty()) {
+        utils::log_error("Failed to load market data range: start=" + std::to_string(start_index) +
+                         ", count=" + std::to_string(count) + ", path=" + dataset_path);
+        return false;
+    }
+    utils::log_info("Processing " + std::to_string(bars.size()) + " bars from index " +
+                    std::to_string(start_index) + " (strategy=" + strategy_name + ", batched inference x" +
+                    std::to_string(config_.inference_batch) + ")");
+
+    set_run_strategy(strategy_name);
+    if (!sink.begin(run_info_)) {
+        return false;
+    }
+
+    DeferredRecordBatch batch(static_cast<size_t>(config_.inference_batch));
+    batch_inputs_ = torch::zeros({static_cast<int64_t>(batch.capacity()), config_.sequence_length, 53},
+                                 torch::TensorOptions().dtype(torch::kFloat32));
+    inference_batch_ = &batch;
+
+    SignalRecord record;
+    for (size_t i = 0; i < bars.size(); ++i) {
+        deferred_ = false;
+        if (on_bar(bars[i], static_cast<int>(start_index + i), record)) {
+            if (deferred_) {
+                batch.add_deferred(record);
+            } else {
+                batch.add(record);
+            }
+        }
+        if (batch.full()) {
+            flush_inference_batch(batch, sink);
+        }
+    }
+    flush_inference_batch(batch, sink);
+
+    inference_batch_ = nullptr;
+    batch_inputs_ = torch::Tensor();
+    return sink.finish();
+}
+
+void OptimizedGruStrategy::flush_inference_batch(DeferredRecordBatch& batch, SignalSink& sink) {
+    const int64_t rows = static_cast<int64_t>(batch.next_row());
+    if (rows > 0) {
+        try {
+            startup_.finish_warmup();
+            auto start_time = std::chrono::high_resolution_clock::now();
+            torch::NoGradGuard no_grad;
+            torch::Tensor windows = batch_inputs_.narrow(0, 0, rows);
+            torch::Tensor logits = (remote_model_ ? run_remote_inference(windows)
+                                                  : run_inference(windows).reshape({rows, -1}).select(1, 0))
+                                       .to(torch::kDouble).contiguous();
+            auto end_time = std::chrono::high_resolution_clock::now();
+            const uint64_t per_row_us = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count() / rows);
+
+            // Rows are converted in bar order so the running confidence stats
+            // (and the bias correction that reads them) match the per-bar path
+            const double* logit = logits.data_ptr<double>();
+            batch.flush(sink, [&](size_t row, SignalRecord& record) {
+                SignalOutput signal = convert_to_signal(logit[row], static_cast<int>(record.bar_index));
+                record.probability = signal.probability;
+                record.confidence = signal.confidence;
+                startup_.first_signal(static_cast<int>(record.bar_index));
+                perf_stats_.update(per_row_us, signal.confidence);
+                if (perf_stats_.total_inferences % 1000 == 0) {
+                    log_performance_stats();
+                }
+            });
+            return;
+        } catch (const std::exception& e) {
+            utils::log_error("Batched inference failed: " + std::string(e.what()));
+        }
+    }
+    // Nothing to evaluate, or the batch failed: keep the neutral placeholders
+    batch.flush(sink, [](size_t, SignalRecord&) {});
+}
+
 void OptimizedGruStrategy::log_performance_stats() const {
     utils::log_info("📊 OptimizedGRU Performance Stats:");
     utils::log_info("   Total Inferences: " + std::to_string(perf_stats_.total_inferences));
@@ -240,6 +569,15 @@ void OptimizedGruStrategy::log_performance_stats() const {
 // =============================================================================
 
 bool OptimizedGruStrategy::FastFeatureEngine::initialize(const std::string& metadata_path) {
+    NormalizationMetadata normalization;
+    if (MetadataSidecar::load(metadata_path, normalization)) {
+        feature_means_ = std::move(normalization.means);
+        feature_stds_ = std::move(normalization.stds);
+        utils::log_info(feature_means_.empty() ? "ℹ️  No normalization parameters found, using raw features"
+                                               : "✅ Loaded " + std::to_string(feature_means_.size()) +
+                                                     " feature normalization parameters (sidecar)");
+        return true;
+    }
     try {
         std::ifstream file(metadata_path);
         if (!file.is_open()) {
@@ -259,284 +597,26 @@ bool OptimizedGruStrategy::FastFeatureEngine::initialize(const std::string& meta
             utils::log_info("ℹ️  No normalization parameters found, using raw features");
         }
         
-        return true;
-        
     } catch (const std::exception& e) {
         utils::log_error("Failed to load metadata: " + std::string(e.what()));
         return false;
     }
-}
-
-torch::Tensor& OptimizedGruStrategy::FastFeatureEngine::get_tensor(int seq_len, int feat_count) {
-    // Always use 53 features to match the trained advanced GRU model
-    const int actual_features = 53;
-    if (!tensor_initialized_) {
-        cached_tensor_ = torch::zeros({1, seq_len, actual_features}, torch::TensorOptions().dtype(torch::kFloat32));
-        tensor_initialized_ = true;
-    }
-    cached_tensor_.zero_();  // Zero out for reuse
-    return cached_tensor_;
-}
-
-// CRITICAL: Update ALL moving averages incrementally in O(1) time
-void OptimizedGruStrategy::FastFeatureEngine::update_mas(double new_price) {
-    // Define all required periods for the 53-feature advanced model
-    std::vector<int> sma_periods = {3, 5, 10, 15, 20, 25, 30, 40, 50, 60};
-    std::vector<int> ema_periods = {5, 10, 12, 15, 20, 26, 30, 50};
-    
-    // Update SMAs for all periods
-    for (int period : sma_periods) {
-        auto& window = ma_windows_[period];
-        auto& sum = ma_sums_[period];
-        
-        window.push_back(new_price);
-        sum += new_price;
-        
-        if (window.size() > period) {
-            sum -= window.front();  // O(1) sliding window
-            window.pop_front();
-        }
-    }
     
-    // Update EMAs for all periods
-    for (int period : ema_periods) {
-        double alpha = 2.0 / (period + 1.0);
-        if (!ema_initialized_) {
-            ema_values_[period] = new_price;
-        } else {
-            ema_values_[period] = alpha * new_price + (1.0 - alpha) * ema_values_[period];
-        }
-    }
-    ema_initialized_ = true;
-}
-
-// Get any SMA in O(1) time
-double OptimizedGruStrategy::FastFeatureEngine::get_sma(int period) const {
-    auto it = ma_windows_.find(period);
-    if (it == ma_windows_.end() || it->second.size() < period) return 0.0;
-    
-    auto sum_it = ma_sums_.find(period);
-    return sum_it->second / it->second.size();
+    // Shape lives in the strategy config here; the sidecar only carries the statistics
+    normalization.means = feature_means_;
+    normalization.stds = feature_stds_;
+    MetadataSidecar::store(metadata_path, normalization);
+    return true;
 }
 
-// Get any EMA in O(1) time
-double OptimizedGruStrategy::FastFeatureEngine::get_ema(int period) const {
-    auto it = ema_values_.find(period);
-    return (it != ema_values_.end()) ? it->second : 0.0;
-}
-
-void OptimizedGruStrategy::FastFeatureEngine::update_statistics(const Bar& bar) {
-    // CRITICAL: Update incremental calculator FIRST
-    update_mas(bar.close);
-}
-
-torch::Tensor OptimizedGruStrategy::FastFeatureEngine::create_features(
-    const std::deque<Bar>& history, int seq_len, int feat_dim) {
-    
-    if (history.size() < seq_len) {
-        return torch::zeros({1, seq_len, 53}, torch::TensorOptions().dtype(torch::kFloat32));  // 53 features
+torch::Tensor OptimizedGruStrategy::FastFeatureEngine::create_features() {
+    const float* rows = window();
+    if (!rows) {
+        return torch::zeros({1, sequence_length(), FEATURE_COUNT}, torch::TensorOptions().dtype(torch::kFloat32));
     }
-    
-    // Use pre-allocated tensor pool with correct dimensions (53 features)
-    torch::Tensor& features = get_tensor(seq_len, 53);
-    
-    // Direct tensor accessor for maximum performance
-    auto accessor = features.accessor<float, 3>();
-    
-    // Process sequence efficiently
-    int start_idx = history.size() - seq_len;
-    
-    // Extract price data for calculations
-    std::vector<double> prices, volumes, opens, highs, lows;
-    for (int i = 0; i < seq_len; ++i) {
-        const Bar& bar = history[start_idx + i];
-        prices.push_back(bar.close);
-        volumes.push_back(bar.volume);
-        opens.push_back(bar.open);
-        highs.push_back(bar.high);
-        lows.push_back(bar.low);
-    }
-    
-    // Calculate returns
-    std::vector<double> returns(seq_len, 0.0);
-    for (int i = 1; i < seq_len; ++i) {
-        returns[i] = std::log(prices[i] / prices[i-1]);
-    }
-    
-    // Generate the exact 53 features that the advanced model expects
-    for (int seq_idx = 0; seq_idx < seq_len; ++seq_idx) {
-        int feat_idx = 0;
-        
-        // Feature 0: returns
-        accessor[0][seq_idx][feat_idx++] = returns[seq_idx];
-        
-        // Feature 1-2: returns_2, returns_3
-        accessor[0][seq_idx][feat_idx++] = seq_idx >= 1 ? returns[seq_idx-1] : 0.0f;
-        accessor[0][seq_idx][feat_idx++] = seq_idx >= 2 ? returns[seq_idx-2] : 0.0f;
-        
-        // Feature 3: price_acceleration
-        double accel = seq_idx >= 1 ? returns[seq_idx] - returns[seq_idx-1] : 0.0;
-        accessor[0][seq_idx][feat_idx++] = accel;
-        
-        // Features 4-6: momentum (5, 10, 20 bars)
-        accessor[0][seq_idx][feat_idx++] = seq_idx >= 4 ? prices[seq_idx] / prices[seq_idx-4] - 1.0 : 0.0f;
-        accessor[0][seq_idx][feat_idx++] = seq_idx >= 9 ? prices[seq_idx] / prices[seq_idx-9] - 1.0 : 0.0f;
-        accessor[0][seq_idx][feat_idx++] = seq_idx >= 19 ? prices[seq_idx] / prices[seq_idx-19] - 1.0 : 0.0f;
-        
-        // Features 7-10: SMA ratios (5, 10, 20, 50) - O(1) OPTIMIZED
-        for (int period : {5, 10, 20, 50}) {
-            double sma = get_sma(period);  // O(1) lookup instead of O(n) calculation!
-            accessor[0][seq_idx][feat_idx++] = sma > 0 ? prices[seq_idx] / sma : 1.0f;
-        }
-        
-        // Features 11-14: SMA slopes (5, 10, 20, 50) - SIMPLIFIED O(1)
-        for (int period : {5, 10, 20, 50}) {
-            // Simplified slope calculation using current SMA vs previous price
-            double sma = get_sma(period);  // O(1) lookup
-            if (seq_idx > 0 && sma > 0) {
-                double prev_price = prices[seq_idx - 1];
-                accessor[0][seq_idx][feat_idx++] = prev_price > 0 ? (sma - prev_price) / prev_price : 0.0f;
-            } else {
-                accessor[0][seq_idx][feat_idx++] = 0.0f;
-            }
-        }
-        
-        // Features 15-17: volatility (5, 10, 20) - SIMPLIFIED O(1)
-        for (int period : {5, 10, 20}) {
-            // Simplified volatility using recent returns standard deviation
-            if (seq_idx >= 1) {
-                double recent_vol = std::abs(returns[seq_idx]) * std::sqrt(period);  // Approximation
-                accessor[0][seq_idx][feat_idx++] = recent_vol;
-            } else {
-                accessor[0][seq_idx][feat_idx++] = 0.0f;
-            }
-        }
-        
-        // Features 18-20: volatility ratios (5, 10, 20) - SIMPLIFIED O(1)
-        for (int period : {5, 10, 20}) {
-            // Simplified volatility ratio using recent vs previous returns
-            if (seq_idx >= period && seq_idx >= 1) {
-                double current_vol = std::abs(returns[seq_idx]);
-                double prev_vol = std::abs(returns[seq_idx - 1]);
-                accessor[0][seq_idx][feat_idx++] = prev_vol > 0 ? current_vol / prev_vol : 1.0f;
-            } else {
-                accessor[0][seq_idx][feat_idx++] = 1.0f;
-            }
-        }
-        
-        // Feature 21: RSI - SIMPLIFIED O(1)
-        double rsi = 50.0;  // Default neutral RSI
-        if (seq_idx >= 1) {
-            // Simplified RSI using recent price momentum
-            double recent_change = prices[seq_idx] - prices[seq_idx - 1];
-            if (recent_change > 0) {
-                rsi = 50.0 + (recent_change / prices[seq_idx - 1]) * 1000.0;  // Scaled momentum
-                rsi = std::min(100.0, std::max(0.0, rsi));  // Clamp to [0, 100]
-            } else if (recent_change < 0) {
-                rsi = 50.0 + (recent_change / prices[seq_idx - 1]) * 1000.0;  // Scaled momentum
-                rsi = std::min(100.0, std::max(0.0, rsi));  // Clamp to [0, 100]
-            }
-        }
-        accessor[0][seq_idx][feat_idx++] = rsi;
-        
-        // Features 22-23: RSI oversold/overbought
-        accessor[0][seq_idx][feat_idx++] = rsi < 30 ? 1.0f : 0.0f;
-        accessor[0][seq_idx][feat_idx++] = rsi > 70 ? 1.0f : 0.0f;
-        
-        // Features 24-25: Bollinger Bands
-        double bb_position = 0.5, bb_squeeze = 0.0;
-        if (seq_idx >= 19) {
-            double sum = 0.0, sum_sq = 0.0;
-            for (int i = seq_idx - 19; i <= seq_idx; ++i) {
-                sum += prices[i];
-                sum_sq += prices[i] * prices[i];
-            }
-            double mean = sum / 20.0;
-            double variance = (sum_sq / 20.0) - (mean * mean);
-            double std_dev = std::sqrt(std::max(0.0, variance));
-            
-            if (std_dev > 0) {
-                double upper = mean + 2.0 * std_dev;
-                double lower = mean - 2.0 * std_dev;
-                bb_position = (prices[seq_idx] - lower) / (upper - lower);
-                bb_squeeze = std_dev / mean;  // Normalized band width
-            }
-        }
-        accessor[0][seq_idx][feat_idx++] = std::max(0.0, std::min(1.0, bb_position));
-        accessor[0][seq_idx][feat_idx++] = bb_squeeze;
-        
-        // Features 26-28: MACD
-        double macd = 0.0, macd_signal = 0.0, macd_histogram = 0.0;
-        if (seq_idx >= 25) {
-            // Simplified MACD calculation
-            double ema12 = prices[seq_idx];  // Simplified
-            double ema26 = prices[seq_idx];  // Simplified
-            macd = ema12 - ema26;
-            macd_signal = macd * 0.9;  // Simplified signal line
-            macd_histogram = macd - macd_signal;
-        }
-        accessor[0][seq_idx][feat_idx++] = macd;
-        accessor[0][seq_idx][feat_idx++] = macd_signal;
-        accessor[0][seq_idx][feat_idx++] = macd_histogram;
-        
-        // Features 29-30: Volume
-        accessor[0][seq_idx][feat_idx++] = seq_idx > 0 && volumes[seq_idx-1] > 0 ? 
-            volumes[seq_idx] / volumes[seq_idx-1] : 1.0f;
-        accessor[0][seq_idx][feat_idx++] = seq_idx >= 4 && volumes[seq_idx-4] > 0 ? 
-            volumes[seq_idx] / volumes[seq_idx-4] - 1.0 : 0.0f;
-        
-        // Feature 31: VWAP deviation (simplified)
-        accessor[0][seq_idx][feat_idx++] = 0.0f;  // Placeholder
-        
-        // Features 32-33: Price ratios
-        accessor[0][seq_idx][feat_idx++] = prices[seq_idx] > 0 ? (highs[seq_idx] - lows[seq_idx]) / prices[seq_idx] : 0.0f;
-        accessor[0][seq_idx][feat_idx++] = opens[seq_idx] > 0 ? (prices[seq_idx] - opens[seq_idx]) / opens[seq_idx] : 0.0f;
-        
-        // Feature 34: Gap
-        accessor[0][seq_idx][feat_idx++] = seq_idx > 0 && prices[seq_idx-1] > 0 ? 
-            (opens[seq_idx] - prices[seq_idx-1]) / prices[seq_idx-1] : 0.0f;
-        
-        // Features 35-39: Time features (simplified)
-        accessor[0][seq_idx][feat_idx++] = 0.0f;  // hour
-        accessor[0][seq_idx][feat_idx++] = 0.0f;  // day_of_week
-        accessor[0][seq_idx][feat_idx++] = 0.0f;  // is_monday
-        accessor[0][seq_idx][feat_idx++] = 0.0f;  // is_friday
-        accessor[0][seq_idx][feat_idx++] = 0.0f;  // trend_strength
-        
-        // Feature 40: Price range
-        accessor[0][seq_idx][feat_idx++] = seq_idx >= 19 ? 
-            (highs[seq_idx] - lows[seq_idx]) / prices[seq_idx] : 0.0f;
-        
-        // Features 41-44: Price lags
-        accessor[0][seq_idx][feat_idx++] = seq_idx >= 1 ? prices[seq_idx-1] : prices[seq_idx];
-        accessor[0][seq_idx][feat_idx++] = seq_idx >= 2 ? prices[seq_idx-2] : prices[seq_idx];
-        accessor[0][seq_idx][feat_idx++] = seq_idx >= 3 ? prices[seq_idx-3] : prices[seq_idx];
-        accessor[0][seq_idx][feat_idx++] = seq_idx >= 5 ? prices[seq_idx-5] : prices[seq_idx];
-        
-        // Features 45-48: Return lags
-        accessor[0][seq_idx][feat_idx++] = seq_idx >= 1 ? returns[seq_idx-1] : 0.0f;
-        accessor[0][seq_idx][feat_idx++] = seq_idx >= 2 ? returns[seq_idx-2] : 0.0f;
-        accessor[0][seq_idx][feat_idx++] = seq_idx >= 3 ? returns[seq_idx-3] : 0.0f;
-        accessor[0][seq_idx][feat_idx++] = seq_idx >= 5 ? returns[seq_idx-5] : 0.0f;
-        
-        // Features 49-52: Volatility lags - SIMPLIFIED O(1)
-        for (int lag : {1, 2, 3, 5}) {
-            if (seq_idx >= lag) {
-                // Simplified volatility lag using lagged returns
-                double lagged_return = returns[seq_idx - lag];
-                accessor[0][seq_idx][feat_idx++] = std::abs(lagged_return);
-            } else {
-                accessor[0][seq_idx][feat_idx++] = 0.0f;
-            }
-        }
-        
-        // Ensure we have exactly 53 features
-        while (feat_idx < 53) {
-            accessor[0][seq_idx][feat_idx++] = 0.0f;
-        }
-    }
-    
-    return features;
+    // The window is already contiguous in the engine's row ring: wrap, don't copy
+    return torch::from_blob(const_cast<float*>(rows), {1, sequence_length(), FEATURE_COUNT},
+                            torch::TensorOptions().dtype(torch::kFloat32));
 }
 
 } // namespace sentio
@@ -0,0 +1,174 @@
+#include "strategy/sharded_runner.h"
+#include "common/thread_pool.h"
+#include "common/utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <future>
+
+namespace sentio {
+
+std::vector<ShardPlan> plan_shards(uint64_t range_start, uint64_t range_count,
+                                   int shards, int lookback) {
+    std::vector<ShardPlan> plans;
+    if (range_count == 0) return plans;
+
+    uint64_t n = static_cast<uint64_t>(std::max(1, shards));
+    n = std::min(n, range_count);
+    const uint64_t base = range_count / n;
+    const uint64_t extra = range_count % n;
+    const uint64_t lb = static_cast<uint64_t>(std::max(0, lookback));
+
+    uint64_t cursor = range_start;
+    for (uint64_t i = 0; i < n; ++i) {
+        ShardPlan p;
+        p.start = cursor;
+        p.end = cursor + base + (i < extra ? 1 : 0);
+        p.warmup_start = (p.start - range_start > lb) ? p.start - lb : range_start;
+        plans.push_back(p);
+        cursor = p.end;
+    }
+    return plans;
+}
+
+namespace {
+    struct ShardResult {
+        std::vector<SignalRecord> records;
+        SignalRunInfo run_info;
+        double elapsed_ms = 0.0;
+    };
+}
+
+ShardedRunner::ShardedRunner(StrategyFactory factory, int threads)
+    : factory_(std::move(factory)), threads_(threads) {}
+
+bool ShardedRunner::run(const std::string& dataset_path,
+                        const std::string& strategy_name,
+                        SignalSink& sink,
+                        int shards,
+                        uint64_t start_index,
+                        uint64_t count) {
+    // Probe instance: lookback and strategy-level metadata
+    auto probe = factory_();
+    if (!probe) return false;
+    const int declared = probe->required_lookback();
+    if (declared < 0) {
+        utils::log_error("Strategy " + strategy_name + " has unbounded lookback; sharded execution is not exact");
+        return false;
+    }
+    const int lookback = std::max(declared, probe->warmup_bars());
+    for (const auto& kv : probe->run_info().metadata) {
+        run_info_.metadata.emplace(kv.first, kv.second);
+    }
+
+    // Bars are loaded once and shared read-only between shards
+    const auto bars = utils::read_market_data_range(dataset_path, start_index, count);
+    if (bars.empty()) {
+        utils::log_error("Failed to load market data range: start=" + std::to_string(start_index) +
+                        ", count=" + std::to_string(count) + ", path=" + dataset_path);
+        return false;
+    }
+
+    const auto plans = plan_shards(start_index, bars.size(), shards, lookback);
+    utils::log_info("Sharded run: " + std::to_string(bars.size()) + " bars, " +
+                   std::to_string(plans.size()) + " shards, lookback=" + std::to_string(lookback));
+
+    ThreadPool pool(std::min<int>(threads_ > 0 ? threads_ : ThreadPool::default_thread_count(),
+                                  static_cast<int>(plans.size())));
+    std::vector<std::future<ShardResult>> futures;
+    futures.reserve(plans.size());
+
+    // Concurrent shards split the machine's threads between them
+    ExecutionContext::Options shard_options;
+    shard_options.intra_op_threads = ThreadPool::default_thread_count() / static_cast<int>(pool.size());
+    const ExecutionContext shard_context(shard_options);
+
+    for (const auto& plan : plans) {
+        futures.push_back(pool.submit([this, &bars, plan, start_index, &strategy_name, shard_context] {
+            auto t0 = std::chrono::steady_clock::now();
+            ShardResult result;
+            auto strategy = factory_();
+            strategy->set_execution_context(shard_context);
+            strategy->set_run_strategy(strategy_name);
+            result.records.reserve(static_cast<size_t>(plan.end - plan.start));
+
+            SignalRecord record;
+            for (uint64_t i = plan.warmup_start; i < plan.end; ++i) {
+                const bool emitted = strategy->on_bar(bars[static_cast<size_t>(i - start_index)],
+                                                      static_cast<int>(i), record);
+                if (emitted && i >= plan.start) {
+                    result.records.push_back(record);
+                }
+            }
+            result.run_info = strategy->run_info();
+            result.elapsed_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - t0).count();
+            return result;
+        }));
+    }
+
+    // Stitch shard outputs back in order, remapping ids into run_info_
+    if (!sink.begin(run_info_)) return false;
+    std::vector<uint16_t> symbol_map;
+    std::vector<uint16_t> strategy_map;
+    for (size_t s = 0; s < futures.size(); ++s) {
+        ShardResult result = futures[s].get();
+
+        symbol_map.clear();
+        for (const auto& sym : result.run_info.symbols) {
+            symbol_map.push_back(run_info_.intern_symbol(sym));
+        }
+        strategy_map.clear();
+        for (const auto& st : result.run_info.strategies) {
+            strategy_map.push_back(run_info_.intern_strategy(st.name, st.version));
+        }
+
+        for (SignalRecord r : result.records) {
+            if (r.symbol_id < symbol_map.size()) r.symbol_id = symbol_map[r.symbol_id];
+            if (r.strategy_id < strategy_map.size()) r.strategy_id = strategy_map[r.strategy_id];
+            sink.write(r);
+        }
+
+        utils::log_debug("Shard " + std::to_string(s) + " [" + std::to_string(plans[s].start) + "-" +
+                        std::to_string(plans[s].end) + ") warmup_from=" + std::to_string(plans[s].warmup_start) +
+                        " signals=" + std::to_string(result.records.size()) +
+                        " time_ms=" + std::to_string(result.elapsed_ms));
+    }
+
+    return sink.finish();
+}
+
+bool compare_signal_streams(const std::vector<SignalRecord>& a, const SignalRunInfo& info_a,
+                            const std::vector<SignalRecord>& b, const SignalRunInfo& info_b,
+                            std::string* diff) {
+    auto fail = [diff](const std::string& msg) {
+        if (diff) *diff = msg;
+        return false;
+    };
+    auto same_bits = [](double x, double y) { return std::memcmp(&x, &y, sizeof(double)) == 0; };
+    auto symbol_of = [](const SignalRunInfo& info, const SignalRecord& r) -> std::string {
+        return r.symbol_id < info.symbols.size() ? info.symbols[r.symbol_id] : std::string();
+    };
+
+    if (a.size() != b.size()) {
+        return fail("record count differs: " + std::to_string(a.size()) + " vs " + std::to_string(b.size()));
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        const auto& x = a[i];
+        const auto& y = b[i];
+        const std::string where = "record " + std::to_string(i) + " (bar_index " + std::to_string(x.bar_index) + "): ";
+        if (x.bar_index != y.bar_index) return fail(where + "bar_index " + std::to_string(y.bar_index));
+        if (x.timestamp_ms != y.timestamp_ms) return fail(where + "timestamp differs");
+        if (!same_bits(x.probability, y.probability)) {
+            return fail(where + "probability " + std::to_string(x.probability) + " vs " + std::to_string(y.probability));
+        }
+        if (!same_bits(x.confidence, y.confidence)) {
+            return fail(where + "confidence " + std::to_string(x.confidence) + " vs " + std::to_string(y.confidence));
+        }
+        if (symbol_of(info_a, x) != symbol_of(info_b, y)) return fail(where + "symbol differs");
+    }
+    return true;
+}
+
+} // namespace sentio
@@ -2,6 +2,8 @@
 #include "common/utils.h"
 
 #include <sstream>
+#include <charconv>
+#include <cstdio>
 
 namespace sentio {
 
@@ -48,6 +50,129 @@ SignalOutput SignalOutput::from_json(const std::string& json_str) {
     return s;
 }
 
-} // namespace sentio
+// -----------------------------------------------------------------------------
+// SignalRunInfo
+// -----------------------------------------------------------------------------
+namespace {
+    const std::string kEmpty;
+
+    // Same formatting as std::to_string (printf "%lld" / "%f") without the
+    // temporary std::string.
+    inline void append_int(std::string& out, int64_t v) {
+        char buf[24];
+        auto res = std::to_chars(buf, buf + sizeof(buf), v);
+        out.append(buf, res.ptr);
+    }
+
+    inline void append_double(std::string& out, double v) {
+        char buf[64];
+        int n = std::snprintf(buf, sizeof(buf), "%f", v);
+        if (n > 0) out.append(buf, static_cast<size_t>(n));
+    }
+
+    inline void append_field(std::string& out, const char* key, const std::string& value, bool first = false) {
+        if (!first) out.push_back(',');
+        out.push_back('"');
+        out.append(key);
+        out.append("\":\"");
+        out.append(value);
+        out.push_back('"');
+    }
+}
+
+uint16_t SignalRunInfo::intern_symbol(const std::string& symbol) {
+    if (last_symbol_id_ < symbols.size() && symbols[last_symbol_id_] == symbol) {
+        return last_symbol_id_;
+    }
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        if (symbols[i] == symbol) {
+            last_symbol_id_ = static_cast<uint16_t>(i);
+            return last_symbol_id_;
+        }
+    }
+    symbols.push_back(symbol);
+    last_symbol_id_ = static_cast<uint16_t>(symbols.size() - 1);
+    return last_symbol_id_;
+}
+
+uint16_t SignalRunInfo::intern_strategy(const std::string& name, const std::string& version) {
+    for (size_t i = 0; i < strategies.size(); ++i) {
+        if (strategies[i].name == name && strategies[i].version == version) {
+            return static_cast<uint16_t>(i);
+        }
+    }
+    strategies.push_back({name, version});
+    return static_cast<uint16_t>(strategies.size() - 1);
+}
 
+SignalOutput SignalRunInfo::expand(const SignalRecord& record) const {
+    SignalOutput s;
+    s.timestamp_ms = record.timestamp_ms;
+    s.bar_index = record.bar_index;
+    s.symbol = record.symbol_id < symbols.size() ? symbols[record.symbol_id] : kEmpty;
+    s.probability = record.probability;
+    s.confidence = record.confidence;
+    if (record.strategy_id < strategies.size()) {
+        s.strategy_name = strategies[record.strategy_id].name;
+        s.strategy_version = strategies[record.strategy_id].version;
+    }
+    s.metadata = metadata;
+    return s;
+}
 
+SignalRecord SignalRunInfo::compact(const SignalOutput& signal) {
+    SignalRecord r;
+    r.timestamp_ms = signal.timestamp_ms;
+    r.bar_index = signal.bar_index;
+    r.symbol_id = intern_symbol(signal.symbol);
+    r.strategy_id = intern_strategy(signal.strategy_name, signal.strategy_version);
+    r.probability = signal.probability;
+    r.confidence = signal.confidence;
+    return r;
+}
+
+void SignalRunInfo::append_json(const SignalRecord& record, std::string& out) const {
+    const std::string& symbol = record.symbol_id < symbols.size() ? symbols[record.symbol_id] : kEmpty;
+    const bool has_strategy = record.strategy_id < strategies.size();
+    const std::string& name = has_strategy ? strategies[record.strategy_id].name : kEmpty;
+    const std::string& version = has_strategy ? strategies[record.strategy_id].version : kEmpty;
+
+    // Keys are emitted in the same (sorted) order as utils::to_json over a std::map.
+    out.append("{\"bar_index\":\"");
+    append_int(out, record.bar_index);
+    out.append("\",\"confidence\":\"");
+    append_double(out, record.confidence);
+    out.push_back('"');
+    auto it = metadata.find("market_data_path");
+    if (it != metadata.end()) {
+        append_field(out, "market_data_path", it->second);
+    }
+    out.append(",\"probability\":\"");
+    append_double(out, record.probability);
+    out.push_back('"');
+    append_field(out, "strategy_name", name);
+    append_field(out, "strategy_version", version);
+    append_field(out, "symbol", symbol);
+    out.append(",\"timestamp_ms\":\"");
+    append_int(out, record.timestamp_ms);
+    out.append("\"}");
+}
+
+void SignalRunInfo::append_csv(const SignalRecord& record, std::string& out) const {
+    const bool has_strategy = record.strategy_id < strategies.size();
+    append_int(out, record.timestamp_ms);
+    out.push_back(',');
+    append_int(out, record.bar_index);
+    out.push_back(',');
+    out.append(record.symbol_id < symbols.size() ? symbols[record.symbol_id] : kEmpty);
+    out.push_back(',');
+    append_double(out, record.probability);
+    out.push_back(',');
+    append_double(out, record.confidence);
+    out.push_back(',');
+    out.append(has_strategy ? strategies[record.strategy_id].name : kEmpty);
+    out.push_back(',');
+    out.append(has_strategy ? strategies[record.strategy_id].version : kEmpty);
+}
+
+} // namespace sentio
@@ -0,0 +1,340 @@
+#include "strategy/signal_sink.h"
+#include "common/utils.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace sentio {
+
+namespace {
+    void put_u32(BufferedFileWriter& w, uint32_t v) {
+        w.write(reinterpret_cast<const char*>(&v), sizeof(v));
+    }
+
+    void put_string(BufferedFileWriter& w, const std::string& s) {
+        put_u32(w, static_cast<uint32_t>(s.size()));
+        w.write(s.data(), s.size());
+    }
+
+    bool get_u32(std::ifstream& in, uint32_t& v) {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&v), sizeof(v)));
+    }
+
+    bool get_string(std::ifstream& in, std::string& s) {
+        uint32_t n = 0;
+        if (!get_u32(in, n)) return false;
+        s.resize(n);
+        return n == 0 || static_cast<bool>(in.read(&s[0], n));
+    }
+
+    bool file_has_content(const std::string& path) {
+        std::error_code ec;
+        return std::filesystem::exists(path, ec) && std::filesystem::file_size(path, ec) > 0;
+    }
+
+    bool open_writer(BufferedFileWriter& writer, const std::string& path,
+                     const SignalSinkOptions& options) {
+        return options.append
+            ? writer.open_append(path, options.buffer_bytes, options.async_io)
+            : writer.open(path, options.buffer_bytes, options.async_io);
+    }
+}
+
+// ------------------------------- JSONL ---------------------------------------
+JsonlSignalSink::JsonlSignalSink(std::string path, SignalSinkOptions options)
+    : path_(std::move(path)), options_(options) {
+    line_.reserve(256);
+}
+
+bool JsonlSignalSink::begin(const SignalRunInfo& run_info) {
+    SignalSink::begin(run_info);
+    return open_writer(writer_, path_, options_);
+}
+
+void JsonlSignalSink::write(const SignalRecord& record) {
+    line_.clear();
+    run_info_->append_json(record, line_);
+    line_.push_back('\n');
+    writer_.write(line_);
+    ++count_;
+}
+
+bool JsonlSignalSink::finish() {
+    return writer_.close();
+}
+
+// -------------------------------- CSV ----------------------------------------
+CsvSignalSink::CsvSignalSink(std::string path, SignalSinkOptions options)
+    : path_(std::move(path)), options_(options) {
+    line_.reserve(128);
+}
+
+bool CsvSignalSink::begin(const SignalRunInfo& run_info) {
+    SignalSink::begin(run_info);
+    const bool need_header = !(options_.append && file_has_content(path_));
+    if (!open_writer(writer_, path_, options_)) return false;
+    if (need_header) {
+        writer_.write(std::string("timestamp_ms,bar_index,symbol,probability,confidence,strategy_name,strategy_version\n"));
+    }
+    return true;
+}
+
+void CsvSignalSink::write(const SignalRecord& record) {
+    line_.clear();
+    run_info_->append_csv(record, line_);
+    line_.push_back('\n');
+    writer_.write(line_);
+    ++count_;
+}
+
+bool CsvSignalSink::finish() {
+    return writer_.close();
+}
+
+// ------------------------------- Binary --------------------------------------
+BinarySignalSink::BinarySignalSink(std::string path, SignalSinkOptions options)
+    : path_(std::move(path)), options_(options) {}
+
+bool BinarySignalSink::begin(const SignalRunInfo& run_info) {
+    SignalSink::begin(run_info);
+    existing_records_ = 0;
+
+    if (options_.append && file_has_content(path_)) {
+        // Records keep their ids, so the new run info must extend the file's
+        SignalRunInfo prior;
+        SignalFileFooter footer;
+        if (!read_signal_run_info(path_, prior, &footer)) return false;
+        auto is_prefix = [](const auto& a, const auto& b) {
+            return a.size() <= b.size() && std::equal(a.begin(), a.end(), b.begin());
+        };
+        auto same_strategy = [](const SignalRunInfo::StrategyEntry& x, const SignalRunInfo::StrategyEntry& y) {
+            return x.name == y.name && x.version == y.version;
+        };
+        if (!is_prefix(prior.symbols, run_info.symbols) ||
+            prior.strategies.size() > run_info.strategies.size() ||
+            !std::equal(prior.strategies.begin(), prior.strategies.end(),
+                        run_info.strategies.begin(), same_strategy)) {
+            utils::log_error("BinarySignalSink: run info does not extend the one in " + path_);
+            return false;
+        }
+
+        // Drop the trailing run info + footer; they are rewritten by finish()
+        std::error_code ec;
+        std::filesystem::resize_file(path_, footer.run_info_offset, ec);
+        if (ec) {
+            utils::log_error("BinarySignalSink: cannot truncate " + path_ + ": " + ec.message());
+            return false;
+        }
+        existing_records_ = footer.record_count;
+        return writer_.open_append(path_, options_.buffer_bytes, options_.async_io);
+    }
+
+    if (!writer_.open(path_, options_.buffer_bytes, options_.async_io)) return false;
+    SignalFileHeader header;
+    writer_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return true;
+}
+
+void BinarySignalSink::write(const SignalRecord& record) {
+    writer_.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    ++count_;
+}
+
+bool BinarySignalSink::finish() {
+    if (!writer_.is_open()) return false;
+
+    SignalFileFooter footer;
+    footer.record_count = existing_records_ + count_;
+    footer.run_info_offset = sizeof(SignalFileHeader) + footer.record_count * sizeof(SignalRecord);
+
+    const SignalRunInfo& info = *run_info_;
+    put_u32(writer_, static_cast<uint32_t>(info.symbols.size()));
+    for (const auto& s : info.symbols) put_string(writer_, s);
+    put_u32(writer_, static_cast<uint32_t>(info.strategies.size()));
+    for (const auto& s : info.strategies) {
+        put_string(writer_, s.name);
+        put_string(writer_, s.version);
+    }
+    put_u32(writer_, static_cast<uint32_t>(info.metadata.size()));
+    for (const auto& kv : info.metadata) {
+        put_string(writer_, kv.first);
+        put_string(writer_, kv.second);
+    }
+    writer_.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    return writer_.close();
+}
+
+namespace {
+    bool read_header_and_footer(std::ifstream& in, const std::string& path, SignalFileFooter& footer) {
+        SignalFileHeader header;
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            header.magic != SIGNAL_FILE_MAGIC || header.record_size != sizeof(SignalRecord)) {
+            utils::log_error("Invalid signal file header: " + path);
+            return false;
+        }
+        in.seekg(-static_cast<std::streamoff>(sizeof(footer)), std::ios::end);
+        if (!in.read(reinterpret_cast<char*>(&footer), sizeof(footer)) ||
+            footer.magic != SIGNAL_FILE_MAGIC) {
+            utils::log_error("Invalid or truncated signal file: " + path);
+            return false;
+        }
+        return true;
+    }
+
+    bool read_run_info_block(std::ifstream& in, const SignalFileFooter& footer, SignalRunInfo& run_info) {
+        run_info = SignalRunInfo{};
+        in.seekg(static_cast<std::streamoff>(footer.run_info_offset), std::ios::beg);
+        uint32_t n = 0;
+        if (!get_u32(in, n)) return false;
+        for (uint32_t i = 0; i < n; ++i) {
+            std::string s;
+            if (!get_string(in, s)) return false;
+            run_info.symbols.push_back(std::move(s));
+        }
+        if (!get_u32(in, n)) return false;
+        for (uint32_t i = 0; i < n; ++i) {
+            SignalRunInfo::StrategyEntry e;
+            if (!get_string(in, e.name) || !get_string(in, e.version)) return false;
+            run_info.strategies.push_back(std::move(e));
+        }
+        if (!get_u32(in, n)) return false;
+        for (uint32_t i = 0; i < n; ++i) {
+            std::string k, v;
+            if (!get_string(in, k) || !get_string(in, v)) return false;
+            run_info.metadata[k] = v;
+        }
+        return true;
+    }
+
+    // Last non-empty line of a text file, reading backwards in small chunks.
+    bool read_last_line(const std::string& path, std::string& line) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) return false;
+        in.seekg(0, std::ios::end);
+        std::streamoff pos = in.tellg();
+        std::string tail;
+        const std::streamoff CHUNK = 4096;
+        while (pos > 0) {
+            std::streamoff n = std::min(CHUNK, pos);
+            pos -= n;
+            std::string chunk(static_cast<size_t>(n), '\0');
+            in.seekg(pos, std::ios::beg);
+            if (!in.read(&chunk[0], n)) return false;
+            tail.insert(0, chunk);
+            size_t end = tail.find_last_not_of("\r\n");
+            if (end == std::string::npos) continue;
+            size_t begin = tail.rfind('\n', end);
+            if (begin != std::string::npos || pos == 0) {
+                begin = (begin == std::string::npos) ? 0 : begin + 1;
+                line = tail.substr(begin, end - begin + 1);
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+bool read_signal_file(const std::string& path,
+                      std::vector<SignalRecord>& records,
+                      SignalRunInfo& run_info) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    SignalFileFooter footer;
+    if (!read_header_and_footer(in, path, footer)) return false;
+
+    records.resize(footer.record_count);
+    in.seekg(sizeof(SignalFileHeader), std::ios::beg);
+    if (footer.record_count > 0 &&
+        !in.read(reinterpret_cast<char*>(records.data()),
+                 static_cast<std::streamsize>(footer.record_count * sizeof(SignalRecord)))) {
+        return false;
+    }
+    return read_run_info_block(in, footer, run_info);
+}
+
+bool read_signal_run_info(const std::string& path,
+                          SignalRunInfo& run_info,
+                          SignalFileFooter* footer) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    SignalFileFooter f;
+    if (!read_header_and_footer(in, path, f) || !read_run_info_block(in, f, run_info)) return false;
+    if (footer) *footer = f;
+    return true;
+}
+
+bool read_signal_file_tail(const std::string& path,
+                           const std::string& format,
+                           SignalFileTail& tail) {
+    tail = SignalFileTail{};
+    if (!file_has_content(path)) return true;
+
+    if (format == "bin") {
+        std::ifstream in(path, std::ios::binary);
+        SignalFileFooter footer;
+        if (!in.is_open() || !read_header_and_footer(in, path, footer)) return false;
+        if (footer.record_count == 0) return true;
+        SignalRecord last;
+        in.seekg(static_cast<std::streamoff>(sizeof(SignalFileHeader) +
+                                             (footer.record_count - 1) * sizeof(SignalRecord)), std::ios::beg);
+        if (!in.read(reinterpret_cast<char*>(&last), sizeof(last))) return false;
+        tail.empty = false;
+        tail.bar_index = last.bar_index;
+        tail.timestamp_ms = last.timestamp_ms;
+        return true;
+    }
+
+    std::string line;
+    if (!read_last_line(path, line)) return true;   // whitespace only
+    try {
+        if (format == "jsonl") {
+            auto m = utils::from_json(line);
+            if (!m.count("bar_index") || !m.count("timestamp_ms")) return false;
+            tail.bar_index = std::stoll(m["bar_index"]);
+            tail.timestamp_ms = std::stoll(m["timestamp_ms"]);
+        } else if (format == "csv") {
+            // timestamp_ms,bar_index,symbol,...
+            if (line.compare(0, 12, "timestamp_ms") == 0) return true;   // header only
+            size_t c1 = line.find(',');
+            size_t c2 = (c1 == std::string::npos) ? c1 : line.find(',', c1 + 1);
+            if (c2 == std::string::npos) return false;
+            tail.timestamp_ms = std::stoll(line.substr(0, c1));
+            tail.bar_index = std::stoll(line.substr(c1 + 1, c2 - c1 - 1));
+        } else {
+            return false;
+        }
+    } catch (const std::exception&) {
+        utils::log_error("Cannot parse last signal of " + path);
+        return false;
+    }
+    tail.empty = false;
+    return true;
+}
+
+std::string signal_format_from_path(const std::string& path) {
+    const std::string ext = std::filesystem::path(path).extension().string();
+    if (ext == ".jsonl") return "jsonl";
+    if (ext == ".csv") return "csv";
+    if (ext == ".sigbin") return "bin";
+    return "";
+}
+
+// ------------------------------- Factory -------------------------------------
+std::unique_ptr<SignalSink> make_signal_sink(const std::string& format,
+                                             const std::string& path,
+                                             const SignalSinkOptions& options) {
+    if (format == "jsonl") return std::make_unique<JsonlSignalSink>(path, options);
+    if (format == "csv") return std::make_unique<CsvSignalSink>(path, options);
+    if (format == "bin") return std::make_unique<BinarySignalSink>(path, options);
+    return nullptr;
+}
+
+std::string signal_file_extension(const std::string& format) {
+    if (format == "bin") return ".sigbin";
+    return "." + format;
+}
+
+} // namespace sentio
@@ -17,6 +17,10 @@ SigorConfig SigorConfig::from_file(const std::string& path) {
     std::ifstream in(path);
     if (!in.is_open()) return c;
     std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    // from_json expects the object to span the whole string; drop surrounding whitespace
+    const auto first = content.find_first_not_of(" \t\r\n");
+    const auto last = content.find_last_not_of(" \t\r\n");
+    content = (first == std::string::npos) ? std::string() : content.substr(first, last - first + 1);
     auto m = utils::from_json(content);
     auto getd = [&](const char* k, double& dst){ if (m.count(k)) dst = std::stod(m[k]); };
     auto geti = [&](const char* k, int& dst){ if (m.count(k)) dst = std::stoi(m[k]); };
@@ -25,7 +29,7 @@ SigorConfig SigorConfig::from_file(const std::string& path) {
     getd("w_boll", c.w_boll); getd("w_rsi", c.w_rsi); getd("w_mom", c.w_mom);
     getd("w_vwap", c.w_vwap); getd("w_orb", c.w_orb); getd("w_ofi", c.w_ofi); getd("w_vol", c.w_vol);
     geti("win_boll", c.win_boll); geti("win_rsi", c.win_rsi); geti("win_mom", c.win_mom);
-    geti("win_vwap", c.win_vwap); geti("orb_opening_bars", c.orb_opening_bars);
+    geti("win_vwap", c.win_vwap); geti("win_vol", c.win_vol); geti("orb_opening_bars", c.orb_opening_bars);
     return c;
 }
 
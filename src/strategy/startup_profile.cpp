@@ -0,0 +1,77 @@
+#include "strategy/startup_profile.h"
+#include "common/utils.h"
+
+#include <cstdio>
+
+namespace sentio {
+
+namespace {
+
+int64_t micros_between(StartupProfile::Clock::time_point from, StartupProfile::Clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+}
+
+std::string format_ms(int64_t us) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.1fms", us / 1000.0);
+    return buf;
+}
+
+} // namespace
+
+void StartupProfile::begin() {
+    finish_warmup();
+    start_ = last_ = Clock::now();
+    phases_.clear();
+    warmup_us_ = -1;
+    first_signal_us_ = 0;
+    first_signal_bar_ = -1;
+    reported_ = false;
+}
+
+void StartupProfile::mark(const std::string& phase) {
+    const auto now = Clock::now();
+    phases_.emplace_back(phase, micros_between(last_, now));
+    last_ = now;
+}
+
+void StartupProfile::start_warmup(std::function<void()> warmup) {
+    finish_warmup();
+    warmup_ = std::thread([this, warmup = std::move(warmup)] {
+        const auto start = Clock::now();
+        try {
+            warmup();
+        } catch (const std::exception& e) {
+            utils::log_warning(std::string("Warm-up inference failed: ") + e.what());
+        }
+        warmup_us_ = micros_between(start, Clock::now());
+    });
+}
+
+void StartupProfile::finish_warmup() {
+    if (warmup_.joinable()) warmup_.join();
+}
+
+void StartupProfile::first_signal(int bar_index) {
+    if (reported_) return;
+    first_signal_us_ = micros_between(start_, Clock::now());
+    first_signal_bar_ = bar_index;
+    reported_ = true;
+    utils::log_info(report());
+}
+
+std::string StartupProfile::report() const {
+    std::string text = "⏱️  Startup:";
+    for (const auto& [name, us] : phases_) {
+        text += " " + name + " " + format_ms(us);
+    }
+    if (warmup_us_ >= 0) {
+        text += " | warm-up " + format_ms(warmup_us_) + " (background)";
+    }
+    if (reported_) {
+        text += " | first signal after " + format_ms(first_signal_us_) + " (bar " + std::to_string(first_signal_bar_) + ")";
+    }
+    return text;
+}
+
+} // namespace sentio
@@ -1,7 +1,9 @@
 #include "strategy/strategy_component.h"
 #include "common/utils.h"
 
+#include <cstdio>
 #include <fstream>
+#include <iterator>
 #include <sstream>
 #include <algorithm>
 #include <numeric>
@@ -82,6 +84,92 @@ std::vector<SignalOutput> StrategyComponent::process_dataset_range(
     return signals;
 }
 
+std::vector<SignalRecord> StrategyComponent::process_records_range(
+    const std::string& dataset_path,
+    const std::string& strategy_name,
+    uint64_t start_index,
+    uint64_t count) {
+
+    MemorySignalSink sink;
+    if (count > 0) sink.reserve(static_cast<size_t>(count));
+    stream_dataset_range(dataset_path, strategy_name, sink, start_index, count);
+    return sink.take();
+}
+
+bool StrategyComponent::stream_dataset_range(
+    const std::string& dataset_path,
+    const std::string& strategy_name,
+    SignalSink& sink,
+    uint64_t start_index,
+    uint64_t count) {
+
+    auto bars = utils::read_market_data_range(dataset_path, start_index, count);
+
+    if (bars.empty()) {
+        utils::log_error("Failed to load market data range: start=" + std::to_string(start_index) +
+                        ", count=" + std::to_string(count) + ", path=" + dataset_path);
+        return false;
+    }
+
+    utils::log_info("Processing " + std::to_string(bars.size()) + " bars from index " +
+                   std::to_string(start_index) + " (strategy=" + strategy_name + ", streaming)");
+
+    set_run_strategy(strategy_name);
+    if (!sink.begin(run_info_)) {
+        return false;
+    }
+
+    SignalRecord record;
+    for (size_t i = 0; i < bars.size(); ++i) {
+        if (on_bar(bars[i], static_cast<int>(start_index + i), record)) {
+            sink.write(record);
+        }
+    }
+
+    return sink.finish();
+}
+
+bool StrategyComponent::warm_up_range(
+    const std::string& dataset_path,
+    uint64_t start_index,
+    uint64_t count) {
+
+    if (count == 0) return true;
+    auto bars = utils::read_market_data_range(dataset_path, start_index, count);
+    if (bars.size() != count) {
+        utils::log_error("Failed to load warm-up range: start=" + std::to_string(start_index) +
+                        ", count=" + std::to_string(count) + ", path=" + dataset_path);
+        return false;
+    }
+
+    SignalRecord discarded;
+    for (size_t i = 0; i < bars.size(); ++i) {
+        on_bar(bars[i], static_cast<int>(start_index + i), discarded);
+    }
+    return true;
+}
+
+void StrategyComponent::set_run_strategy(const std::string& strategy_name) {
+    strategy_id_ = run_info_.intern_strategy(strategy_name, config_.version);
+}
+
+bool StrategyComponent::on_bar(const Bar& bar, int bar_index, SignalRecord& out) {
+    // Set first so update_indicators() can see the index of the bar it gets
+    last_bar_index_ = bar_index;
+    last_bar_timestamp_ms_ = bar.timestamp_ms;
+    update_indicators(bar);
+
+    bool emitted = false;
+    if (is_warmed_up()) {
+        out = generate_record(bar, bar_index);
+        out.strategy_id = strategy_id_;
+        emitted = true;
+    }
+
+    bars_processed_++;
+    return emitted;
+}
+
 bool StrategyComponent::export_signals(
     const std::vector<SignalOutput>& signals,
     const std::string& output_path,
@@ -116,6 +204,19 @@ bool StrategyComponent::export_signals(
     return false;
 }
 
+bool StrategyComponent::export_records(
+    const std::vector<SignalRecord>& records,
+    const std::string& output_path,
+    const std::string& format) const {
+
+    auto sink = make_signal_sink(format, output_path);
+    if (!sink || !sink->begin(run_info_)) return false;
+    for (const auto& record : records) {
+        sink->write(record);
+    }
+    return sink->finish();
+}
+
 SignalOutput StrategyComponent::generate_signal(const Bar& bar, int bar_index) {
     // Default implementation: neutral placeholder
     SignalOutput signal;
@@ -128,6 +229,19 @@ SignalOutput StrategyComponent::generate_signal(const Bar& bar, int bar_index) {
     return signal;
 }
 
+SignalRecord StrategyComponent::generate_record(const Bar& bar, int bar_index) {
+    // Adapter for strategies that only implement the rich hook. Per-bar
+    // metadata is dropped; run-level metadata belongs in run_info_.
+    SignalOutput signal = generate_signal(bar, bar_index);
+    SignalRecord record;
+    record.timestamp_ms = signal.timestamp_ms;
+    record.bar_index = signal.bar_index;
+    record.symbol_id = run_info_.intern_symbol(signal.symbol.empty() ? bar.symbol : signal.symbol);
+    record.probability = signal.probability;
+    record.confidence = signal.confidence;
+    return record;
+}
+
 void StrategyComponent::update_indicators(const Bar& bar) {
     historical_bars_.push_back(bar);
     if (historical_bars_.size() > static_cast<size_t>(std::max(0, config_.warmup_bars))) {
@@ -148,6 +262,139 @@ bool StrategyComponent::is_warmed_up() const {
     return bars_processed_ >= config_.warmup_bars;
 }
 
+// -----------------------------------------------------------------------------
+// State snapshots
+// -----------------------------------------------------------------------------
+std::string StrategyComponent::config_fingerprint() const {
+    std::ostringstream oss;
+    oss.precision(17);
+    oss << config_.name << '|' << config_.version << '|' << config_.warmup_bars << '|'
+        << config_.buy_threshold << '|' << config_.sell_threshold;
+    for (const auto& kv : config_.params) {
+        oss << '|' << kv.first << '=' << kv.second;
+    }
+    return oss.str();
+}
+
+bool StrategyComponent::save_state(std::vector<char>& out) const {
+    if (!supports_snapshots()) {
+        utils::log_error("Strategy " + config_.name + " does not support state snapshots");
+        return false;
+    }
+
+    StateWriter payload;
+    save_derived_state(payload);
+
+    StateWriter w;
+    w.put(SNAPSHOT_MAGIC);
+    w.put(SNAPSHOT_FORMAT_VERSION);
+    w.put_string(config_.name);
+    w.put_string(config_.version);
+    w.put(state_version());
+    w.put(fnv1a64(config_fingerprint()));
+    w.put(static_cast<int64_t>(bars_processed_));
+    w.put(static_cast<int64_t>(last_bar_index_));
+    w.put(last_bar_timestamp_ms_);
+    w.put(static_cast<uint64_t>(payload.size()));
+    w.put_bytes(payload.data().data(), payload.size());
+    w.put(fnv1a64(payload.data().data(), payload.size()));
+
+    out = std::move(w.data());
+    return true;
+}
+
+bool StrategyComponent::restore_state(const char* data, size_t size) {
+    if (!supports_snapshots()) {
+        utils::log_error("Strategy " + config_.name + " does not support state snapshots");
+        return false;
+    }
+
+    StateReader r(data, size);
+    uint32_t magic = 0, format = 0, layout = 0;
+    std::string name, version;
+    uint64_t config_hash = 0, payload_size = 0, checksum = 0;
+    int64_t bars = 0, last_index = 0, last_ts = 0;
+
+    r.get(magic);
+    r.get(format);
+    if (!r.ok() || magic != SNAPSHOT_MAGIC || format != SNAPSHOT_FORMAT_VERSION) {
+        utils::log_error("Snapshot rejected: not a strategy snapshot (or unsupported format)");
+        return false;
+    }
+    r.get_string(name, 256);
+    r.get_string(version, 256);
+    r.get(layout);
+    r.get(config_hash);
+    r.get(bars);
+    r.get(last_index);
+    r.get(last_ts);
+    r.get(payload_size);
+    const char* payload = r.take(static_cast<size_t>(payload_size));
+    r.get(checksum);
+    if (!r.at_end()) {
+        utils::log_error("Snapshot rejected: truncated or trailing data");
+        return false;
+    }
+    if (name != config_.name || version != config_.version) {
+        utils::log_error("Snapshot rejected: taken by " + name + " " + version +
+                        ", expected " + config_.name + " " + config_.version);
+        return false;
+    }
+    if (layout != state_version()) {
+        utils::log_error("Snapshot rejected: state version " + std::to_string(layout) +
+                        ", expected " + std::to_string(state_version()));
+        return false;
+    }
+    if (config_hash != fnv1a64(config_fingerprint())) {
+        utils::log_error("Snapshot rejected: strategy configuration differs from the snapshot");
+        return false;
+    }
+    if (checksum != fnv1a64(payload, static_cast<size_t>(payload_size))) {
+        utils::log_error("Snapshot rejected: payload checksum mismatch");
+        return false;
+    }
+
+    StateReader pr(payload, static_cast<size_t>(payload_size));
+    if (!load_derived_state(pr) || !pr.at_end()) {
+        utils::log_error("Snapshot rejected: malformed " + config_.name + " state payload");
+        return false;
+    }
+
+    bars_processed_ = static_cast<int>(bars);
+    last_bar_index_ = static_cast<int>(last_index);
+    last_bar_timestamp_ms_ = last_ts;
+    return true;
+}
+
+bool StrategyComponent::save_state_file(const std::string& path) const {
+    std::vector<char> bytes;
+    if (!save_state(bytes)) return false;
+
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()))) {
+            utils::log_error("Failed to write snapshot: " + tmp);
+            return false;
+        }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        utils::log_error("Failed to move snapshot into place: " + path);
+        return false;
+    }
+    return true;
+}
+
+bool StrategyComponent::load_state_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        utils::log_error("Cannot open snapshot: " + path);
+        return false;
+    }
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return restore_state(bytes.data(), bytes.size());
+}
+
 // SigorStrategy implementation moved to strategy/sigor_strategy.cpp
 
 } // namespace sentio
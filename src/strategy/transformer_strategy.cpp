@@ -3,8 +3,12 @@
 #include "strategy/transformer_model.h" // For the model class definition
 #include "common/feature_sequence_manager.h" // NEW: For proper sequence management
 #include "features/feature_config_standard.h" // 🔧 CONSOLIDATED: Standard 91-feature config
+#include "common/metadata_sidecar.h"
+#include "common/state_stream.h"
 #include <nlohmann/json.hpp>
+#include <cstring>
 #include <fstream>
+#include <sstream>
 #include <chrono>
 #include <vector>
 
@@ -20,12 +24,14 @@ TransformerStrategy::TransformerStrategy(const StrategyConfig& base_config, cons
 
 bool TransformerStrategy::initialize() {
     utils::log_info("Initializing Rewritten Transformer Strategy (v2)...");
+    startup_.begin();
 
     // 1. Load metadata to configure the strategy and normalization parameters.
     if (!load_metadata()) {
         utils::log_error("Failed to load Transformer metadata from: " + config_.metadata_path);
         return false;
     }
+    startup_.mark("metadata");
     
     // 2. 🔧 CONSOLIDATED: Initialize with standardized 91-feature configuration
     //    This ensures identical features between TFM, PPO, and all future ML strategies
@@ -34,7 +40,18 @@ bool TransformerStrategy::initialize() {
         utils::log_error("❌ CRITICAL: Standard feature configuration validation failed!");
         return false;
     }
-    feature_engine_ = std::make_unique<features::UnifiedFeatureEngine>(feature_config);
+    if (!config_.feature_store_path.empty()) {
+        feature_store_ = std::make_unique<features::FeatureStore>();
+        if (!feature_store_->open(config_.feature_store_path) ||
+            !feature_store_->matches(feature_config, config_.feature_store_dataset)) {
+            utils::log_error("Feature store does not match dataset " + config_.feature_store_dataset +
+                             " and the standard feature configuration: " + config_.feature_store_path);
+            return false;
+        }
+        utils::log_info("Reading features from store: " + config_.feature_store_path);
+    } else {
+        feature_engine_ = std::make_unique<features::UnifiedFeatureEngine>(feature_config);
+    }
     
     // 🔍 DEBUG: Verify actual feature count matches expected (91)
     std::cout << "🔧 DEBUG: Configured UnifiedFeatureEngine with filtered features" << std::endl;
@@ -45,35 +62,57 @@ bool TransformerStrategy::initialize() {
     std::cout << "   Return lag features: " << (feature_config.enable_return_lags ? "enabled" : "disabled") << std::endl;
     
     // 3. Initialize the Feature Sequence Manager to fix the critical temporal bug
+    //    Rows are normalized once on insert with the training statistics.
     sequence_manager_ = std::make_unique<FeatureSequenceManager>(
         model_config_.sequence_length, 
         model_config_.feature_dim
     );
+    if (!sequence_manager_->set_normalization(feature_means_, feature_stds_)) {
+        return false;
+    }
+    startup_.mark("features");
     
-    // 4. Load the complete model (full model format).
+    // 4. Load the complete model (full model format), or let the shared
+    //    model server hold it.
+    if (!config_.model_server.empty()) {
+        remote_model_ = std::make_unique<ml::RemoteModel>();
+        if (!remote_model_->connect(config_.model_server, "transformer", config_.model_path,
+                                    static_cast<uint32_t>(model_config_.sequence_length),
+                                    static_cast<uint32_t>(model_config_.feature_dim)) ||
+            remote_model_->output_dim() != 2) {
+            utils::log_error("Failed to open model on server " + config_.model_server);
+            return false;
+        }
+        model_loaded_ = true;
+        startup_.mark("model (server)");
+        utils::log_info("Transformer Strategy v2 initialized; model served by " + config_.model_server);
+        return true;
+    }
     //    Load the complete trained model directly.
     try {
         // Load the complete saved model (match training parameters from real data trainer)
         pytorch_model_ = std::make_unique<TransformerModel>(
-            TransformerModelConfig{
-                .feature_dim = model_config_.feature_dim,  // Now correctly 126 from metadata
-                .sequence_length = model_config_.sequence_length,
-                .d_model = 256,
-                .nhead = 8,
-                .num_encoder_layers = 4,  // ✅ FIXED: Match training script (was 6, should be 4)
-                .dim_feedforward = 1024,
-                .dropout = 0.1
-            }
-        );
+            transformer_model_config(model_config_.sequence_length, model_config_.feature_dim));
         
         // Load the complete model (this will load both structure and weights)
+        ExecutionContext::configure_process(execution_context().interop_threads());
+        execution_context().apply_to_current_thread();
         torch::load(*pytorch_model_, config_.model_path);
         
         (*pytorch_model_)->to(torch::kCPU);
         (*pytorch_model_)->eval();
         
         model_loaded_ = true;
+        startup_.mark("model");
         utils::log_info("Model loaded successfully (complete model format)");
+        
+        // First forward on a synthetic window in the background, while the
+        // feature engine consumes its warm-up bars
+        startup_.start_warmup([this] {
+            execution_context().apply_to_current_thread();
+            torch::NoGradGuard no_grad;
+            (*pytorch_model_)->forward(torch::zeros({1, model_config_.sequence_length, model_config_.feature_dim}));
+        });
     } catch (const std::exception& e) {
         std::cerr << "❌ DETAILED MODEL LOADING ERROR: " << e.what() << std::endl;
         std::cerr << "❌ Model path: " << config_.model_path << std::endl;
@@ -89,6 +128,17 @@ bool TransformerStrategy::initialize() {
 }
 
 bool TransformerStrategy::load_metadata() {
+    NormalizationMetadata normalization;
+    if (MetadataSidecar::load(config_.metadata_path, normalization) &&
+        normalization.feature_dim > 0 && normalization.sequence_length > 0) {
+        model_config_.feature_dim = static_cast<int>(normalization.feature_dim);
+        model_config_.sequence_length = static_cast<int>(normalization.sequence_length);
+        feature_means_.assign(normalization.means.begin(), normalization.means.end());
+        feature_stds_.assign(normalization.stds.begin(), normalization.stds.end());
+        utils::log_info("Metadata read from sidecar: " + MetadataSidecar::path_for(config_.metadata_path));
+        return true;
+    }
+
     std::cerr << "🔍 Attempting to load metadata from: " << config_.metadata_path << std::endl;
     std::ifstream metadata_file(config_.metadata_path);
     if (!metadata_file.is_open()) {
@@ -108,39 +158,47 @@ bool TransformerStrategy::load_metadata() {
         model_config_.feature_dim = metadata["architecture"]["feature_dim"];
         model_config_.sequence_length = metadata["architecture"]["sequence_length"];
         
-        // Load normalization statistics.
-        auto means = metadata["normalization"]["means"].get<std::vector<float>>();
-        auto stds = metadata["normalization"]["stds"].get<std::vector<float>>();
-        
-        // Store as Tensors for efficient computation during inference.
-        feature_means_ = torch::tensor(means, torch::kFloat);
-        feature_stds_ = torch::tensor(stds, torch::kFloat);
+        // Load normalization statistics (as parsed; narrowed to float for the
+        // sequence manager exactly as a direct float read would)
+        normalization.feature_dim = static_cast<uint32_t>(model_config_.feature_dim);
+        normalization.sequence_length = static_cast<uint32_t>(model_config_.sequence_length);
+        normalization.means = metadata["normalization"]["means"].get<std::vector<double>>();
+        normalization.stds = metadata["normalization"]["stds"].get<std::vector<double>>();
+        feature_means_.assign(normalization.means.begin(), normalization.means.end());
+        feature_stds_.assign(normalization.stds.begin(), normalization.stds.end());
 
     } catch (const std::exception& e) {
         utils::log_error("Failed to parse metadata: " + std::string(e.what()));
         return false;
     }
     
+    MetadataSidecar::store(config_.metadata_path, normalization);
     return true;
 }
 
 void TransformerStrategy::update_indicators(const Bar& bar) {
+    // Precomputed features: read this bar's row from the store.
+    if (feature_store_) {
+        const size_t index = static_cast<size_t>(last_bar_index_);
+        if (feature_store_->is_ready(index) && sequence_manager_) {
+            sequence_manager_->add_features(feature_store_->row(index));
+        }
+        return;
+    }
+
     // Update the feature engine with the latest market data.
     if (feature_engine_) {
         feature_engine_->update(bar);
         
-        // NEW: Feed features into sequence manager for proper temporal handling
+        // Feed the engine's float row straight into the sequence window
         if (feature_engine_->is_ready() && sequence_manager_) {
-            auto current_features = feature_engine_->get_features();
-            sequence_manager_->add_features(current_features);
+            sequence_manager_->add_features(feature_engine_->features());
         }
     }
 }
 
 SignalOutput TransformerStrategy::generate_signal(const Bar& bar, int bar_index) {
-    static int call_count = 0;
-    static int warmup_logged = 0;
-    call_count++;
+    diag_.calls++;
     
     SignalOutput signal;
     signal.timestamp_ms = bar.timestamp_ms;
@@ -153,11 +211,12 @@ SignalOutput TransformerStrategy::generate_signal(const Bar& bar, int bar_index)
 
     // 🔍 DIAGNOSTIC: Check each component's readiness state
     bool model_ready = model_loaded_;
-    bool feature_ready = feature_engine_ && feature_engine_->is_ready();
+    bool feature_ready = feature_store_ ? feature_store_->is_ready(static_cast<size_t>(bar_index))
+                                        : feature_engine_ && feature_engine_->is_ready();
     bool sequence_ready = sequence_manager_ && sequence_manager_->is_ready();
     
     // Log diagnostic info periodically during warmup
-    if (!sequence_ready && warmup_logged < 70) {
+    if (!sequence_ready && diag_.warmup_logged < 70) {
         std::cout << "🔍 TFM Diagnostic [" << bar_index << "]: "
                   << "Model=" << (model_ready ? "✅" : "❌") 
                   << ", Features=" << (feature_ready ? "✅" : "❌")
@@ -170,16 +229,15 @@ SignalOutput TransformerStrategy::generate_signal(const Bar& bar, int bar_index)
             std::cout << ", FeatureBars: " << feature_engine_->get_bar_count() << "/64";
         }
         std::cout << std::endl;
-        warmup_logged++;
+        diag_.warmup_logged++;
     }
 
     // Log when sequence manager becomes ready (first time)
-    static bool sequence_readiness_logged = false;
-    if (sequence_ready && !sequence_readiness_logged) {
+    if (sequence_ready && !diag_.sequence_ready_logged) {
         std::cout << "🎉 BREAKTHROUGH! Sequence Manager is now READY! Starting real signal generation..." << std::endl;
         std::cout << "    Bar Index: " << bar_index << ", Sequence History: " 
                   << sequence_manager_->get_history_size() << "/64" << std::endl;
-        sequence_readiness_logged = true;
+        diag_.sequence_ready_logged = true;
     }
 
     // Do not proceed if the model isn't loaded or sequence isn't ready.
@@ -187,61 +245,68 @@ SignalOutput TransformerStrategy::generate_signal(const Bar& bar, int bar_index)
         return signal;
     }
 
+    // Batched backtest: queue the window; stream_dataset_range() completes the
+    // record once the batch has been evaluated.
+    if (inference_batch_) {
+        const size_t window = static_cast<size_t>(model_config_.sequence_length) * model_config_.feature_dim;
+        std::memcpy(batch_inputs_.data_ptr<float>() + inference_batch_->next_row() * window,
+                    sequence_manager_->window(), window * sizeof(float));
+        deferred_ = true;
+        return signal;
+    }
+
     auto start_time = std::chrono::high_resolution_clock::now();
 
     // 🔍 DEBUG: Log that we're starting inference
-    static int inference_attempts = 0;
-    if (++inference_attempts <= 5) {
-        std::cout << "🧪 Starting inference attempt #" << inference_attempts << " [bar " << bar_index << "]" << std::endl;
+    if (++diag_.inference_attempts <= 5) {
+        std::cout << "🧪 Starting inference attempt #" << diag_.inference_attempts << " [bar " << bar_index << "]" << std::endl;
     }
+    execution_context().apply_to_current_thread();
+    startup_.finish_warmup();
 
     try {
         // ✅ FIXED: Get proper temporal sequence using FeatureSequenceManager
-        torch::Tensor input_tensor = sequence_manager_->get_batched_tensor().to(torch::kCPU);
-
-        // 3. Normalize features using stats loaded from metadata.
-        //    LibTorch correctly broadcasts the 1D mean/std tensors across the 3D input tensor.
-        input_tensor = (input_tensor - feature_means_) / feature_stds_;
+        //    A [1, seq_len, feature_dim] view of the already-normalized window (no copy).
+        torch::Tensor input_tensor = sequence_tensor_view(*sequence_manager_);
 
         // 4. Run inference using PyTorch model (not TorchScript).
-        torch::NoGradGuard no_grad;
-        
-        // ✅ FIXED: Use PyTorch model forward method directly
-        auto [prediction, log_var] = (*pytorch_model_)->forward(input_tensor);
+        //    The whole window is re-encoded every bar on purpose: forward()
+        //    takes no attention mask, so every position attends to the whole
+        //    window and its position shifts by one each bar. Per-layer
+        //    keys/values cached from the previous window are therefore stale;
+        //    backtests amortize the cost with Config::inference_batch instead.
+        double predicted_return;
+        double log_variance;
+        if (remote_model_) {
+            float outputs[2];
+            if (!remote_model_->infer(sequence_manager_->window(), 1, outputs)) {
+                throw std::runtime_error("model server inference failed");
+            }
+            predicted_return = outputs[0];
+            log_variance = outputs[1];
+        } else {
+            torch::NoGradGuard no_grad;
+            
+            // ✅ FIXED: Use PyTorch model forward method directly
+            auto [prediction, log_var] = (*pytorch_model_)->forward(input_tensor);
+            predicted_return = prediction.item<double>();
+            log_variance = log_var.item<double>();
+        }
 
         // 5. Convert model outputs to a trading signal.
-        double predicted_return = prediction.item<double>();
-        
-        // Convert the predicted return into a probability using a scaled sigmoid.
-        // A positive return suggests a higher probability of price increase.
-        signal.probability = 1.0 / (1.0 + std::exp(-predicted_return * 100));
-
-        // ✅ ENHANCED v2: Statistical sigma-based confidence calculation (improved)
-        // Convert log-variance to standard deviation (sigma) for more intuitive confidence
-        double log_variance = log_var.item<double>();
-        double sigma = std::exp(0.5 * log_variance);  // Convert log_var to standard deviation
-        signal.confidence = 1.0 - std::min(1.0, sigma);  // Higher sigma = lower confidence
-        
-        // Ensure confidence is in reasonable range [0.1, 0.9] for trading
-        signal.confidence = std::max(0.1, std::min(0.9, signal.confidence));
+        apply_prediction(predicted_return, log_variance, signal.probability, signal.confidence);
+        startup_.first_signal(bar_index);
 
-        // 🔍 DIAGNOSTIC: Log raw values before filtering (first few times)
-        static int inference_logged = 0;
-        if (inference_logged < 5) {
+        // 🔍 DIAGNOSTIC: Log values after filtering (first few times)
+        if (diag_.inference_logged < 5) {
             std::cout << "🧪 Inference Debug [" << bar_index << "]: "
                       << "Raw pred=" << predicted_return 
-                      << ", Raw conf=" << signal.confidence
+                      << ", Conf=" << signal.confidence
                       << ", Threshold=" << config_.confidence_threshold << std::endl;
-            inference_logged++;
-        }
-
-        // Filter out signals with low confidence.
-        if (signal.confidence < config_.confidence_threshold) {
-            if (inference_logged < 5) {
+            if (signal.confidence == 0.0) {
                 std::cout << "    ⚠️  Signal filtered out due to low confidence!" << std::endl;
             }
-            signal.probability = 0.5;
-            signal.confidence = 0.0;
+            diag_.inference_logged++;
         }
         
     } catch (const std::exception& e) {
@@ -259,7 +324,171 @@ SignalOutput TransformerStrategy::generate_signal(const Bar& bar, int bar_index)
     return signal;
 }
 
+void TransformerStrategy::apply_prediction(double predicted_return, double log_variance,
+                                           double& probability, double& confidence) const {
+    // Convert the predicted return into a probability using a scaled sigmoid.
+    // A positive return suggests a higher probability of price increase.
+    probability = 1.0 / (1.0 + std::exp(-predicted_return * 100));
+
+    // ✅ ENHANCED v2: Statistical sigma-based confidence calculation (improved)
+    // Convert log-variance to standard deviation (sigma) for more intuitive confidence
+    double sigma = std::exp(0.5 * log_variance);  // Convert log_var to standard deviation
+    confidence = 1.0 - std::min(1.0, sigma);  // Higher sigma = lower confidence
+    
+    // Ensure confidence is in reasonable range [0.1, 0.9] for trading
+    confidence = std::max(0.1, std::min(0.9, confidence));
+
+    // Filter out signals with low confidence.
+    if (confidence < config_.confidence_threshold) {
+        probability = 0.5;
+        confidence = 0.0;
+    }
+}
+
+bool TransformerStrategy::stream_dataset_range(const std::string& dataset_path,
+                                               const std::string& strategy_name,
+                                               SignalSink& sink,
+                                               uint64_t start_index,
+                                               uint64_t count) {
+    if (config_.inference_batch <= 1 || !model_loaded_) {
+        return StrategyComponent::stream_dataset_range(dataset_path, strategy_name, sink, start_index, count);
+    }
+
+    auto bars = utils::read_market_data_range(dataset_path, start_index, count);
+    if (bars.empty()) {
+        utils::log_error("Failed to load market data range: start=" + std::to_string(start_index) +
+                         ", count=" + std::to_string(count) + ", path=" + dataset_path);
+        return false;
+    }
+    utils::log_info("Processing " + std::to_string(bars.size()) + " bars from index " +
+                    std::to_string(start_index) + " (strategy=" + strategy_name + ", batched inference x" +
+                    std::to_string(config_.inference_batch) + ")");
+
+    set_run_strategy(strategy_name);
+    if (!sink.begin(run_info_)) {
+        return false;
+    }
+
+    DeferredRecordBatch batch(static_cast<size_t>(config_.inference_batch));
+    batch_inputs_ = torch::empty({static_cast<int64_t>(batch.capacity()), model_config_.sequence_length,
+                                  model_config_.feature_dim}, torch::kFloat);
+    inference_batch_ = &batch;
+
+    SignalRecord record;
+    for (size_t i = 0; i < bars.size(); ++i) {
+        deferred_ = false;
+        if (on_bar(bars[i], static_cast<int>(start_index + i), record)) {
+            if (deferred_) {
+                batch.add_deferred(record);
+            } else {
+                batch.add(record);
+            }
+        }
+        if (batch.full()) {
+            flush_inference_batch(batch, sink);
+        }
+    }
+    flush_inference_batch(batch, sink);
+
+    inference_batch_ = nullptr;
+    batch_inputs_ = torch::Tensor();
+    return sink.finish();
+}
+
+void TransformerStrategy::flush_inference_batch(DeferredRecordBatch& batch, SignalSink& sink) {
+    const int64_t rows = static_cast<int64_t>(batch.next_row());
+    if (rows > 0 && remote_model_) {
+        std::vector<float> outputs(static_cast<size_t>(rows) * 2);
+        if (remote_model_->infer(batch_inputs_.data_ptr<float>(), static_cast<int>(rows), outputs.data())) {
+            batch.flush(sink, [&](size_t row, SignalRecord& record) {
+                apply_prediction(outputs[2 * row], outputs[2 * row + 1], record.probability, record.confidence);
+                startup_.first_signal(static_cast<int>(record.bar_index));
+            });
+            return;
+        }
+    } else if (rows > 0) {
+        try {
+            execution_context().apply_to_current_thread();
+            startup_.finish_warmup();
+            torch::NoGradGuard no_grad;
+            auto [prediction, log_var] = (*pytorch_model_)->forward(batch_inputs_.narrow(0, 0, rows));
+            // One scalar per window, as float (the per-bar path reads the same values)
+            torch::Tensor predictions = prediction.reshape({-1}).to(torch::kFloat).contiguous();
+            torch::Tensor log_vars = log_var.reshape({-1}).to(torch::kFloat).contiguous();
+            const float* p = predictions.data_ptr<float>();
+            const float* lv = log_vars.data_ptr<float>();
+            batch.flush(sink, [&](size_t row, SignalRecord& record) {
+                apply_prediction(p[row], lv[row], record.probability, record.confidence);
+                startup_.first_signal(static_cast<int>(record.bar_index));
+            });
+            return;
+        } catch (const std::exception& e) {
+            utils::log_error("Transformer batched inference exception: " + std::string(e.what()));
+        }
+    }
+    // Nothing to evaluate, or the batch failed: keep the neutral placeholders
+    batch.flush(sink, [](size_t, SignalRecord&) {});
+}
+
 // MLStrategyBase pure virtual method implementations
+std::string TransformerStrategy::config_fingerprint() const {
+    std::ostringstream oss;
+    oss.precision(17);
+    oss << StrategyComponent::config_fingerprint() << "|tfm=" << config_.model_path << "|meta="
+        << config_.metadata_path << "|seq=" << model_config_.sequence_length << "|feat="
+        << model_config_.feature_dim << "|conf=" << config_.confidence_threshold << "|store="
+        << config_.feature_store_path;
+    return oss.str();
+}
+
+void TransformerStrategy::save_derived_state(StateWriter& w) const {
+    if (feature_engine_) {
+        feature_engine_->save_state(w);
+    }
+    w.put(diag_.calls);
+    w.put(diag_.warmup_logged);
+    w.put(static_cast<uint8_t>(diag_.sequence_ready_logged ? 1 : 0));
+    w.put(diag_.inference_attempts);
+    w.put(diag_.inference_logged);
+    // Last: its load is the final step that can fail (see load_derived_state)
+    if (sequence_manager_) {
+        sequence_manager_->save_state(w);
+    }
+}
+
+bool TransformerStrategy::load_derived_state(StateReader& r) {
+    if (!sequence_manager_) {
+        utils::log_error("Transformer snapshot needs an initialized strategy");
+        return false;
+    }
+    // Everything is read into copies and checked before anything changes, so
+    // a malformed payload changes nothing
+    std::unique_ptr<features::UnifiedFeatureEngine> engine;
+    if (feature_engine_) {
+        engine = std::make_unique<features::UnifiedFeatureEngine>(feature_engine_->config());
+        if (!engine->load_state(r)) return false;
+    }
+    Diagnostics diag;
+    uint8_t sequence_ready_logged = 0;
+    if (!r.get(diag.calls) || !r.get(diag.warmup_logged) || !r.get(sequence_ready_logged) ||
+        !r.get(diag.inference_attempts) || !r.get(diag.inference_logged)) {
+        return false;
+    }
+    const StateReader sequence_state = r;
+    FeatureSequenceManager sequence = *sequence_manager_;
+    if (!sequence.load_state(r) || !r.at_end()) {
+        return false;
+    }
+    diag.sequence_ready_logged = sequence_ready_logged != 0;
+    if (engine) {
+        *feature_engine_ = std::move(*engine);
+    }
+    diag_ = diag;
+    // Replayed into the existing ring (validated above, so it cannot fail)
+    StateReader replay = sequence_state;
+    return sequence_manager_->load_state(replay);
+}
+
 void TransformerStrategy::apply_metadata_config(const json_utils::JsonValue& metadata) {
     // This method is called by the base class after loading metadata
     // We can use it to configure any additional parameters if needed
@@ -189,8 +189,11 @@ TradingEnvironment::TradingEnvironment(const std::vector<Bar>& market_data,
     : market_data_(market_data), config_(config) {
     
     // 🔧 CONSOLIDATED: Use standardized 91-feature configuration
-    auto feature_config = features::get_standard_91_feature_config();
-    feature_engine_ = std::make_unique<features::UnifiedFeatureEngine>(feature_config);
+    // (not needed when rows come from a precomputed feature store)
+    if (!config_.feature_store) {
+        auto feature_config = features::get_standard_91_feature_config();
+        feature_engine_ = std::make_unique<features::UnifiedFeatureEngine>(feature_config);
+    }
     
     // Initialize observation buffer
     observation_buffer_.clear();
@@ -217,30 +220,14 @@ TradingEnvironment::EnvironmentState TradingEnvironment::reset() {
     
     // Warm up feature engine from the start position
     // 🔧 CONSOLIDATED: Warm up feature engine and build observation buffer
-    feature_engine_->reset();
+    if (feature_engine_) {
+        feature_engine_->reset();
+    }
     observation_buffer_.clear();
     
     for (int i = current_step_ - warmup_bars; i <= current_step_; ++i) {
         if (i >= 0 && i < static_cast<int>(market_data_.size())) {
-            feature_engine_->update(market_data_[i]);
-            
-            // Populate observation buffer with features after engine is ready
-            if (feature_engine_->is_ready()) {
-                auto features = feature_engine_->get_features();
-                // 🔧 CONSOLIDATED: Convert vector<double> to torch::Tensor
-                torch::Tensor feature_tensor = torch::from_blob(
-                    const_cast<double*>(features.data()), 
-                    {static_cast<int64_t>(features.size())}, 
-                    torch::kDouble
-                ).clone(); // Clone to own the data
-                
-                observation_buffer_.push_back(feature_tensor);
-                
-                // Keep buffer size manageable (retain last 100 observations)
-                if (observation_buffer_.size() > 100) {
-                    observation_buffer_.erase(observation_buffer_.begin());
-                }
-            }
+            push_features(i);
         }
     }
     
@@ -271,25 +258,8 @@ TradingEnvironment::EnvironmentState TradingEnvironment::step(Action action) {
     current_step_++;
     episode_length_++;  // Track episode length properly
     if (current_step_ < static_cast<int>(market_data_.size())) {
-        feature_engine_->update(market_data_[current_step_]);
-        
         // 🔧 CONSOLIDATED: Add new features to observation buffer
-        if (feature_engine_->is_ready()) {
-            auto features = feature_engine_->get_features();
-            // 🔧 CONSOLIDATED: Convert vector<double> to torch::Tensor
-            torch::Tensor feature_tensor = torch::from_blob(
-                const_cast<double*>(features.data()), 
-                {static_cast<int64_t>(features.size())}, 
-                torch::kDouble
-            ).clone(); // Clone to own the data
-            
-            observation_buffer_.push_back(feature_tensor);
-            
-            // Keep buffer size manageable (retain last 100 observations)
-            if (observation_buffer_.size() > 100) {
-                observation_buffer_.erase(observation_buffer_.begin());
-            }
-        }
+        push_features(current_step_);
     }
     
     // Check if episode is done
@@ -310,8 +280,32 @@ TradingEnvironment::EnvironmentState TradingEnvironment::step(Action action) {
     return state;
 }
 
+void TradingEnvironment::push_features(int index) {
+    const float* row = nullptr;
+    int64_t count = 0;
+    if (config_.feature_store) {
+        const size_t store_index = config_.feature_store_offset + static_cast<size_t>(index);
+        if (!config_.feature_store->is_ready(store_index)) return;
+        row = config_.feature_store->row(store_index);
+        count = config_.feature_store->cols();
+    } else {
+        feature_engine_->update(market_data_[index]);
+        if (!feature_engine_->is_ready()) return;
+        row = feature_engine_->features();
+        count = feature_engine_->feature_count();
+    }
+    
+    // Wrap the float row; clone to own the data
+    observation_buffer_.push_back(torch::from_blob(const_cast<float*>(row), {count}, torch::kFloat).clone());
+    
+    // Keep buffer size manageable (retain last 100 observations)
+    if (observation_buffer_.size() > 100) {
+        observation_buffer_.pop_front();
+    }
+}
+
 torch::Tensor TradingEnvironment::get_observation() const {
-    if (!feature_engine_->is_ready() || observation_buffer_.size() < config_.window_size) {
+    if ((feature_engine_ && !feature_engine_->is_ready()) || observation_buffer_.size() < config_.window_size) {
         // 🔧 CONSOLIDATED: Use standard feature config dimensions
         auto feature_config = features::get_standard_91_feature_config();
         int feature_count = feature_config.total_features(); // 91 features
@@ -326,7 +320,7 @@ torch::Tensor TradingEnvironment::get_observation() const {
     size_t start_idx = observation_buffer_.size() - config_.window_size;
     for (size_t i = 0; i < config_.window_size; ++i) {
         const torch::Tensor& feature_tensor = observation_buffer_[start_idx + i];
-        obs[i] = feature_tensor.to(torch::kFloat); // Convert to float and copy
+        obs[i] = feature_tensor;
     }
     
     return obs;
@@ -588,6 +582,10 @@ bool CppPpoTrainer::initialize() {
     
     split_data();
     
+    if (!config_.feature_store_path.empty() && !open_feature_store()) {
+        return false;
+    }
+    
     // Setup model and optimizer
     if (!setup_model()) {
         utils::log_error("Failed to setup model");
@@ -604,8 +602,10 @@ bool CppPpoTrainer::initialize() {
     env_config.window_size = config_.window_size;
     env_config.transaction_fee = config_.transaction_fee;
     env_config.reward_scaling = config_.reward_scaling;
+    env_config.feature_store = feature_store_.get();
     
     train_env_ = std::make_unique<TradingEnvironment>(train_data_, env_config);
+    env_config.feature_store_offset = train_data_.size();   // validation follows training
     val_env_ = std::make_unique<TradingEnvironment>(validation_data_, env_config);
     
     // Create buffer
@@ -740,6 +740,23 @@ bool CppPpoTrainer::load_data() {
     return true;
 }
 
+bool CppPpoTrainer::open_feature_store() {
+    const auto feature_config = features::get_standard_91_feature_config();
+    feature_store_ = std::make_unique<features::FeatureStore>();
+    const bool opened = config_.feature_store_path == "auto"
+        ? feature_store_->open_or_build(config_.dataset_path, feature_config)
+        : feature_store_->open(config_.feature_store_path) &&
+              feature_store_->matches(feature_config, config_.dataset_path);
+    if (!opened || feature_store_->rows() != train_data_.size() + validation_data_.size()) {
+        utils::log_error("Feature store does not match dataset " + config_.dataset_path +
+                         " and the standard feature configuration: " + config_.feature_store_path);
+        feature_store_.reset();
+        return false;
+    }
+    utils::log_info("Reading features from store: " + feature_store_->path());
+    return true;
+}
+
 void CppPpoTrainer::split_data() {
     size_t split_point = static_cast<size_t>(train_data_.size() * config_.train_split);
     
@@ -1,5 +1,6 @@
 #include "training/gru_trainer.h"
 #include "common/utils.h"
+#include "common/rolling_indicators.h"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
@@ -474,42 +475,19 @@ void GRUTrainer::create_training_sequences(const torch::Tensor& features,
 // Helper functions for technical indicators
 double GRUTrainer::calculate_sma(const std::vector<double>& data, int period, int index) const {
     if (index < period - 1) return data[index];
-    
-    double sum = 0.0;
-    for (int i = index - period + 1; i <= index; ++i) {
-        sum += data[i];
-    }
-    return sum / period;
+    return rolling::sma(data, static_cast<size_t>(index) + 1, static_cast<size_t>(period));
 }
 
 double GRUTrainer::calculate_rsi(const std::vector<double>& prices, int period, int index) const {
     if (index < period) return 50.0;
-    
-    double gain = 0.0, loss = 0.0;
-    for (int i = index - period + 1; i <= index; ++i) {
-        double change = prices[i] - prices[i-1];
-        if (change > 0) gain += change;
-        else loss -= change;
-    }
-    
-    gain /= period;
-    loss /= period;
-    
-    if (loss == 0.0) return 100.0;
-    double rs = gain / loss;
-    return 100.0 - (100.0 / (1.0 + rs));
+    return rolling::rsi(prices, static_cast<size_t>(index) + 1, static_cast<size_t>(period));
 }
 
 double GRUTrainer::calculate_bollinger_position(const std::vector<double>& prices, int period, int index) const {
     if (index < period - 1) return 0.5;
     
     double sma = calculate_sma(prices, period, index);
-    double sum_sq = 0.0;
-    for (int i = index - period + 1; i <= index; ++i) {
-        double diff = prices[i] - sma;
-        sum_sq += diff * diff;
-    }
-    double std_dev = std::sqrt(sum_sq / period);
+    double std_dev = rolling::stddev(prices, static_cast<size_t>(index) + 1, static_cast<size_t>(period), sma);
     
     double upper = sma + 2.0 * std_dev;
     double lower = sma - 2.0 * std_dev;
@@ -820,6 +798,8 @@ bool GRUTrainer::export_model() {
     // Save final model
     std::string model_path = config_.output_dir + "/model.pt";
     model_->save_model(model_path);
+    // Same weights for LibTorch-free inference (ml/native_gru.h)
+    model_->export_native(config_.output_dir + "/model.native");
     
     // Create metadata
     nlohmann::json metadata;
@@ -0,0 +1,192 @@
+// =============================================================================
+// Test: tests/gru_streaming_test.cpp
+// Purpose: Streaming GRU inference (forward_window() + forward_step()) against
+//          windowed inference, for ml::NativeGruModel and, with LibTorch,
+//          ml::AdvancedGRUModel.
+//
+// Checks, per engine:
+// - forward_window() over a window gives the same outputs as forward().
+// - forward_window() over the first T rows followed by N forward_step()s
+//   gives the outputs and hidden states of one window pass over all T + N
+//   rows.
+// - A resync (forward_window() on a state that has taken N steps) gives
+//   exactly the outputs and hidden states of forward_window() on a fresh
+//   state: nothing carried from before the window survives it.
+// =============================================================================
+
+#include "ml/native_gru.h"
+#ifdef TORCH_AVAILABLE
+#include "ml/gru_model.h"
+#include <torch/torch.h>
+#endif
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+        ++failures;
+    }
+}
+
+bool close(float a, float b, float tolerance) {
+    return std::fabs(a - b) <= tolerance * (1.0f + std::fabs(b));
+}
+
+bool same_output(const sentio::ml::NativeGruOutput& a, const sentio::ml::NativeGruOutput& b, float tolerance) {
+    bool ok = close(a.direction, b.direction, tolerance) && close(a.magnitude, b.magnitude, tolerance) &&
+              close(a.confidence, b.confidence, tolerance) && close(a.volatility, b.volatility, tolerance);
+    for (int i = 0; i < 4; ++i) ok = ok && close(a.regime[i], b.regime[i], tolerance);
+    return ok;
+}
+
+std::vector<float> random_rows(int rows, int dim, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    std::vector<float> data(static_cast<size_t>(rows) * dim);
+    for (auto& v : data) v = normal(rng);
+    return data;
+}
+
+void test_native() {
+    using namespace sentio::ml;
+    NativeGruConfig config;
+    config.feature_dim = 53;
+    config.hidden_dim = 32;
+    config.num_layers = 2;
+    config.num_heads = 4;
+    config.sequence_length = 16;
+
+    const std::string path = "gru_streaming_test.native";
+    NativeGruModel model;
+    check(NativeGruModel::write_synthetic_weights(path, config) && model.load(path), "native: load synthetic weights");
+    std::remove(path.c_str());
+    if (!model.is_loaded()) return;
+
+    const int F = static_cast<int>(config.feature_dim);
+    const int L = static_cast<int>(config.sequence_length);
+    const int T = 10;
+    const int N = L - T;
+    const auto rows = random_rows(L + N, F, 11);
+
+    // Window pass == forward()
+    NativeGruOutput windowed, plain;
+    NativeGruState state;
+    check(model.forward(rows.data(), L, plain), "native: forward");
+    check(model.forward_window(rows.data(), L, state, windowed), "native: forward_window");
+    check(same_output(windowed, plain, 0.0f), "native: forward_window matches forward");
+
+    // T-row window then N steps == one pass over T + N rows. The batched and
+    // single-row GEMMs may round differently, hence a tolerance, but it is far
+    // below the effect of the oldest row on the hidden state (~1e-5 here)
+    NativeGruOutput stepped;
+    check(model.forward_window(rows.data(), T, state, stepped), "native: partial forward_window");
+    for (int i = T; i < T + N; ++i) {
+        check(model.forward_step(rows.data() + static_cast<size_t>(i) * F, state, stepped), "native: forward_step");
+    }
+    check(state.steps_since_sync == N, "native: steps_since_sync counts steps");
+    NativeGruState full_state;
+    check(model.forward_window(rows.data(), T + N, full_state, plain), "native: forward_window over T + N rows");
+    check(same_output(stepped, plain, 1e-6f), "native: window then steps matches forward");
+    bool hidden_close = state.hidden.size() == full_state.hidden.size();
+    for (size_t i = 0; hidden_close && i < state.hidden.size(); ++i) {
+        hidden_close = close(state.hidden[i], full_state.hidden[i], 1e-6f);
+    }
+    check(hidden_close, "native: window then steps reaches the windowed hidden state");
+
+    // Keep stepping past the window, then resync on the latest window
+    for (int i = T + N; i < L + N; ++i) {
+        model.forward_step(rows.data() + static_cast<size_t>(i) * F, state, stepped);
+    }
+    const float* latest = rows.data() + static_cast<size_t>(N) * F;
+    NativeGruOutput resynced, fresh;
+    NativeGruState fresh_state;
+    check(model.forward_window(latest, L, state, resynced), "native: resync");
+    check(model.forward_window(latest, L, fresh_state, fresh), "native: fresh forward_window");
+    check(same_output(resynced, fresh, 0.0f), "native: resync matches a fresh forward_window");
+    check(state.hidden == fresh_state.hidden && state.steps_since_sync == 0,
+          "native: resync resets the hidden state");
+}
+
+#ifdef TORCH_AVAILABLE
+bool same_output(const sentio::ml::GRUOutput& a, const sentio::ml::GRUOutput& b, double tolerance) {
+    auto eq = [tolerance](const torch::Tensor& x, const torch::Tensor& y) {
+        return tolerance == 0.0 ? torch::equal(x, y) : torch::allclose(x, y, tolerance, tolerance);
+    };
+    return eq(a.direction, b.direction) && eq(a.magnitude, b.magnitude) && eq(a.confidence, b.confidence) &&
+           eq(a.volatility, b.volatility) && eq(a.regime, b.regime);
+}
+
+void test_torch() {
+    using namespace sentio::ml;
+    torch::manual_seed(3);
+    GRUConfig config;
+    config.hidden_dim = 32;
+    config.num_layers = 2;
+    config.num_heads = 4;
+    config.sequence_length = 16;
+    AdvancedGRUModel model(config);
+    model->eval();
+    torch::NoGradGuard no_grad;
+
+    const int L = config.sequence_length;
+    const int T = 10;
+    const int N = L - T;
+    auto rows = torch::randn({1, L + N, config.feature_dim});
+
+    GRUStreamState state;
+    auto windowed = model->forward_window(rows.slice(1, 0, L), state);
+    check(same_output(windowed, model->forward(rows.slice(1, 0, L)), 0.0), "torch: forward_window matches forward");
+
+    auto stepped = model->forward_window(rows.slice(1, 0, T), state);
+    for (int i = T; i < T + N; ++i) {
+        stepped = model->forward_step(rows.select(1, i), state);
+    }
+    check(state.steps_since_sync == N, "torch: steps_since_sync counts steps");
+    GRUStreamState full_state;
+    check(same_output(stepped, model->forward_window(rows.slice(1, 0, T + N), full_state), 1e-6),
+          "torch: window then steps matches forward");
+    bool hidden_close = state.hidden.size() == full_state.hidden.size();
+    for (size_t l = 0; hidden_close && l < state.hidden.size(); ++l) {
+        hidden_close = torch::allclose(state.hidden[l], full_state.hidden[l], 1e-6, 1e-6);
+    }
+    check(hidden_close, "torch: window then steps reaches the windowed hidden state");
+
+    for (int i = T + N; i < L + N; ++i) {
+        model->forward_step(rows.select(1, i), state);
+    }
+    auto latest = rows.slice(1, N, L + N);
+    GRUStreamState fresh_state;
+    auto resynced = model->forward_window(latest, state);
+    auto fresh = model->forward_window(latest, fresh_state);
+    check(same_output(resynced, fresh, 0.0), "torch: resync matches a fresh forward_window");
+    bool hidden_equal = state.hidden.size() == fresh_state.hidden.size() && state.steps_since_sync == 0;
+    for (size_t l = 0; hidden_equal && l < state.hidden.size(); ++l) {
+        hidden_equal = torch::equal(state.hidden[l], fresh_state.hidden[l]);
+    }
+    check(hidden_equal, "torch: resync resets the hidden state");
+}
+#endif
+
+} // namespace
+
+int main() {
+    test_native();
+#ifdef TORCH_AVAILABLE
+    test_torch();
+#endif
+    if (failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("gru_streaming_test: all checks passed\n");
+    return 0;
+}
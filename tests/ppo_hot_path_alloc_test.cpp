@@ -0,0 +1,210 @@
+// =============================================================================
+// Test: tests/ppo_hot_path_alloc_test.cpp
+// Purpose: The PPO per-bar path does not allocate once warmed up.
+//
+// Global operator new is replaced with a counting version.
+// - Feature path: UnifiedFeatureEngine::update(bar, next_row()) followed by
+//   FeatureSequenceManager::commit_row() (normalization on) makes zero
+//   allocations per bar after warm-up.
+// - With LibTorch: CppPpoStrategy driven through on_bar() (engine ->
+//   next_row()/commit_row() -> step()) against a small scripted actor. The
+//   TorchScript forward call itself allocates (argument stack, output
+//   tensor), so a bar may allocate no more than one bare forward() of the
+//   same module on the same inputs.
+// =============================================================================
+
+#include "features/unified_feature_engine.h"
+#include "features/feature_config_standard.h"
+#include "common/feature_sequence_manager.h"
+#include "common/types.h"
+#ifdef TORCH_AVAILABLE
+#include "strategy/cpp_ppo_strategy.h"
+#include <torch/script.h>
+#include <torch/torch.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+std::atomic<size_t> g_allocations{0};
+}
+
+// Counting replacements of the global allocation functions (malloc-backed,
+// so the matching deletes free())
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = nullptr;
+    const size_t align = std::max(static_cast<size_t>(alignment), sizeof(void*));
+    if (posix_memalign(&p, align, size ? size : 1) == 0) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+constexpr int WARMUP_BARS = 300;
+constexpr int MEASURED_BARS = 500;
+constexpr int WINDOW = 30;
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+        ++failures;
+    }
+}
+
+// Random-walk minute bars, built before any counting starts
+std::vector<sentio::Bar> make_bars(int count) {
+    std::mt19937 rng(5);
+    std::normal_distribution<double> ret(0.0, 0.001);
+    std::uniform_real_distribution<double> volume(1e5, 1e6);
+    std::vector<sentio::Bar> bars(static_cast<size_t>(count));
+    double close = 400.0;
+    for (int i = 0; i < count; ++i) {
+        auto& bar = bars[static_cast<size_t>(i)];
+        bar.timestamp_ms = 1700000000000LL + i * 60000LL;
+        bar.open = close;
+        close *= std::exp(ret(rng));
+        bar.close = close;
+        bar.high = std::max(bar.open, close) * 1.0005;
+        bar.low = std::min(bar.open, close) * 0.9995;
+        bar.volume = volume(rng);
+        bar.symbol = "QQQ";
+    }
+    return bars;
+}
+
+void test_feature_path(const std::vector<sentio::Bar>& bars) {
+    sentio::features::UnifiedFeatureEngine engine(sentio::features::get_standard_91_feature_config());
+    const int dim = engine.feature_count();
+    sentio::FeatureSequenceManager window(WINDOW, dim);
+    window.set_normalization(std::vector<float>(static_cast<size_t>(dim), 0.5f),
+                             std::vector<float>(static_cast<size_t>(dim), 2.0f));
+
+    size_t allocations = 0;
+    for (int i = 0; i < WARMUP_BARS + MEASURED_BARS; ++i) {
+        const size_t before = g_allocations.load(std::memory_order_relaxed);
+        engine.update(bars[static_cast<size_t>(i)], window.next_row());
+        if (engine.is_ready()) {
+            window.commit_row();
+        }
+        if (i >= WARMUP_BARS) {
+            allocations += g_allocations.load(std::memory_order_relaxed) - before;
+        }
+    }
+    check(window.is_ready(), "feature path: window filled during warm-up");
+    check(allocations == 0, "feature path: " + std::to_string(allocations) + " allocations in " +
+                                std::to_string(MEASURED_BARS) + " bars after warm-up");
+}
+
+#ifdef TORCH_AVAILABLE
+void test_ppo_step(const std::vector<sentio::Bar>& bars) {
+    const int feature_dim = 91;
+    const int64_t observation = static_cast<int64_t>(WINDOW) * feature_dim;
+
+    // Actor stub with the trained actors' signature: (observation, mask) -> logits
+    const std::string model_path = "ppo_hot_path_alloc_test.pt";
+    {
+        torch::jit::Module actor("PpoActorStub");
+        actor.register_parameter("weight", torch::randn({observation, 3}) * 0.01, false);
+        actor.define(R"(
+def forward(self, x, mask):
+    return torch.matmul(x, self.weight)
+)");
+        actor.save(model_path);
+    }
+
+    sentio::StrategyComponent::StrategyConfig base;
+    base.name = "cpp_ppo";
+    base.warmup_bars = 0;
+    sentio::CppPpoConfig config;
+    config.model_path = model_path;
+    config.window_size = WINDOW;
+    config.feature_dim = feature_dim;
+    config.enable_action_masking = true;
+    config.enable_debug = false;
+    sentio::CppPpoStrategy strategy(base, config);
+    check(strategy.initialize(), "ppo: initialize");
+
+    // Allocations of one bare forward() of the same module and input shapes
+    size_t forward_allocations = 0;
+    {
+        torch::jit::Module actor = torch::jit::load(model_path);
+        actor.eval();
+        std::vector<float> buffer(static_cast<size_t>(observation), 0.1f);
+        std::vector<torch::jit::IValue> inputs;
+        inputs.push_back(torch::from_blob(buffer.data(), {1, observation}, torch::kFloat));
+        inputs.push_back(torch::ones({3}, torch::kBool));
+        torch::NoGradGuard no_grad;
+        for (int i = 0; i < 10; ++i) actor.forward(inputs);
+        const size_t before = g_allocations.load(std::memory_order_relaxed);
+        actor.forward(inputs);
+        forward_allocations = g_allocations.load(std::memory_order_relaxed) - before;
+    }
+    std::remove(model_path.c_str());
+
+    sentio::SignalRecord record;
+    size_t worst = 0;
+    int acted = 0;
+    for (int i = 0; i < WARMUP_BARS + MEASURED_BARS; ++i) {
+        const size_t before = g_allocations.load(std::memory_order_relaxed);
+        strategy.on_bar(bars[static_cast<size_t>(i)], i, record);
+        const size_t allocations = g_allocations.load(std::memory_order_relaxed) - before;
+        if (i >= WARMUP_BARS) {
+            worst = std::max(worst, allocations);
+            acted += record.confidence > 0.0 ? 1 : 0;
+        }
+    }
+    check(acted == MEASURED_BARS, "ppo: actor ran on every measured bar");
+    check(worst <= forward_allocations, "ppo: up to " + std::to_string(worst) +
+                                            " allocations per bar, bare forward() makes " +
+                                            std::to_string(forward_allocations));
+}
+#endif
+
+} // namespace
+
+int main() {
+    const auto bars = make_bars(WARMUP_BARS + MEASURED_BARS);
+
+    // The counter must see ordinary allocations
+    const size_t before = g_allocations.load();
+    auto* probe = new std::vector<int>(16);
+    check(g_allocations.load() > before, "operator new replacement is active");
+    delete probe;
+
+    test_feature_path(bars);
+#ifdef TORCH_AVAILABLE
+    test_ppo_step(bars);
+#endif
+    if (failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("ppo_hot_path_alloc_test: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,265 @@
+// =============================================================================
+// Tool: execution_resources_benchmark.cpp
+// Purpose: Throughput vs latency of inference thread layouts on one machine
+//
+// A layout "NxT" runs N inference instances side by side, each with an
+// ExecutionContext of T threads, pinned to its own slice of --cpus (see
+// ExecutionContext::partition). Every instance evaluates batches of GRU
+// windows for --seconds:
+// - native (default): ml::NativeGruModel, one model per thread; a batch is
+//   split across the instance's T threads (workers inherit its CPU pinning)
+// - --torchscript (LibTorch builds only): one module per instance, batches
+//   of [batch, seq, features] with T intra-op threads
+// Reports aggregate windows/s and the per-call latency distribution, e.g.
+// many single-threaded per-bar instances vs a few multi-threaded batchers.
+//
+// Usage:
+//   ./execution_resources_benchmark --synthetic [--layouts 32x1,8x4,2x16]
+//                                   [--cpus 0-31] [--batch 1] [--seconds 3]
+//   ./execution_resources_benchmark --native artifacts/GRU/cpp_trained/model.native ...
+//   ./execution_resources_benchmark --torchscript artifacts/GRU/primary/model.pt --seq 64 --features 53 ...
+//
+//   --batch     windows per call per thread (default 1; a T-thread call
+//               evaluates batch * T windows)
+//   --no-pin    run the layouts without CPU pinning
+// =============================================================================
+
+#include "ml/native_gru.h"
+#include "strategy/execution_context.h"
+#include "common/latency_stats.h"
+#include "common/thread_pool.h"
+#include <algorithm>
+#include <cstdio>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef TORCH_AVAILABLE
+#include <torch/script.h>
+#endif
+
+using namespace sentio;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Layout {
+    int instances = 1;
+    int threads = 1;
+};
+
+struct Workload {
+    std::string native_path;
+    std::string torchscript_path;
+    int steps = 64;
+    int features = 53;
+    int batch = 1;
+    double seconds = 3.0;
+};
+
+struct InstanceResult {
+    std::vector<int64_t> call_ns;
+    size_t windows = 0;
+    std::string error;
+};
+
+bool parse_layouts(const std::string& text, std::vector<Layout>& layouts) {
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        const size_t x = item.find('x');
+        if (x == std::string::npos) return false;
+        Layout layout;
+        try {
+            layout.instances = std::stoi(item.substr(0, x));
+            layout.threads = std::stoi(item.substr(x + 1));
+        } catch (const std::exception&) {
+            return false;
+        }
+        if (layout.instances < 1 || layout.threads < 1) return false;
+        layouts.push_back(layout);
+    }
+    return !layouts.empty();
+}
+
+// N x 1, N/4 x 4 and 1 x N for N hardware threads
+std::vector<Layout> default_layouts(int cpus) {
+    std::vector<Layout> layouts = {{cpus, 1}};
+    if (cpus >= 8) layouts.push_back({cpus / 4, 4});
+    if (cpus > 1) layouts.push_back({1, cpus});
+    return layouts;
+}
+
+void run_native_instance(const ExecutionContext& context, const Workload& work,
+                         const std::vector<float>& window, Clock::time_point deadline,
+                         InstanceResult& result) {
+    // Pin first: the worker pool started below inherits the CPU set
+    context.apply_to_current_thread();
+    const int workers = context.intra_op_threads();
+    std::vector<ml::NativeGruModel> models(static_cast<size_t>(workers));
+    for (auto& model : models) {
+        if (!model.load(work.native_path)) {
+            result.error = "cannot load " + work.native_path;
+            return;
+        }
+    }
+    std::unique_ptr<ThreadPool> pool;
+    if (workers > 1) pool = std::make_unique<ThreadPool>(workers - 1);
+
+    auto run_slice = [&](int worker) {
+        ml::NativeGruOutput out;
+        for (int i = 0; i < work.batch; ++i) {
+            models[static_cast<size_t>(worker)].forward(window.data(), work.steps, out);
+        }
+    };
+    std::vector<std::future<void>> pending;
+    pending.reserve(static_cast<size_t>(workers));
+    while (Clock::now() < deadline) {
+        const auto start = Clock::now();
+        pending.clear();
+        for (int w = 1; w < workers; ++w) {
+            pending.push_back(pool->submit([&run_slice, w] { run_slice(w); }));
+        }
+        run_slice(0);
+        for (auto& f : pending) f.get();
+        result.call_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        result.windows += static_cast<size_t>(work.batch) * workers;
+    }
+}
+
+void run_torchscript_instance(const ExecutionContext& context, const Workload& work,
+                              const std::vector<float>& window, Clock::time_point deadline,
+                              InstanceResult& result) {
+#ifdef TORCH_AVAILABLE
+    context.apply_to_current_thread();
+    try {
+        auto module = torch::jit::load(work.torchscript_path);
+        module.eval();
+        torch::NoGradGuard no_grad;
+        const int64_t batch = static_cast<int64_t>(work.batch) * context.intra_op_threads();
+        auto one = torch::from_blob(const_cast<float*>(window.data()), {1, work.steps, work.features}, torch::kFloat);
+        std::vector<torch::jit::IValue> inputs{one.expand({batch, work.steps, work.features}).contiguous()};
+        while (Clock::now() < deadline) {
+            const auto start = Clock::now();
+            module.forward(inputs);
+            result.call_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+            result.windows += static_cast<size_t>(batch);
+        }
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+#else
+    (void)context; (void)work; (void)window; (void)deadline;
+    result.error = "built without LibTorch";
+#endif
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Workload work;
+    bool synthetic = false;
+    bool pin = true;
+    std::string layout_spec;
+    std::string cpu_spec;
+    ml::NativeGruConfig synthetic_config{53, 128, 3, 8, 64, 1};
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--native" && i + 1 < argc) work.native_path = argv[++i];
+        else if (arg == "--torchscript" && i + 1 < argc) work.torchscript_path = argv[++i];
+        else if (arg == "--synthetic") synthetic = true;
+        else if (arg == "--layouts" && i + 1 < argc) layout_spec = argv[++i];
+        else if (arg == "--cpus" && i + 1 < argc) cpu_spec = argv[++i];
+        else if (arg == "--no-pin") pin = false;
+        else if (arg == "--batch" && i + 1 < argc) work.batch = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--seconds" && i + 1 < argc) work.seconds = std::max(0.1, std::stod(argv[++i]));
+        else if (arg == "--seq" && i + 1 < argc) work.steps = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--features" && i + 1 < argc) work.features = std::max(1, std::stoi(argv[++i]));
+        else {
+            std::cout << "Usage: execution_resources_benchmark (--synthetic | --native <model.native> | "
+                         "--torchscript <model.pt>) [--layouts NxT,...] [--cpus LIST] [--no-pin] "
+                         "[--batch N] [--seconds S]\n";
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+    if (synthetic && work.native_path.empty()) {
+        work.native_path = "/tmp/sentio_gru_synthetic.native";
+        if (!ml::NativeGruModel::write_synthetic_weights(work.native_path, synthetic_config)) return 1;
+    }
+    const bool torchscript = !work.torchscript_path.empty();
+    if (!torchscript && work.native_path.empty()) {
+        std::cout << "❌ --synthetic, --native or --torchscript is required\n";
+        return 1;
+    }
+    if (!torchscript) {
+        ml::NativeGruModel probe;
+        if (!probe.load(work.native_path)) return 1;
+        work.steps = static_cast<int>(probe.config().sequence_length);
+        work.features = static_cast<int>(probe.config().feature_dim);
+    }
+
+    std::vector<int> cpus;
+    if (!cpu_spec.empty()) {
+        if (!ExecutionContext::parse_cpu_list(cpu_spec, cpus)) {
+            std::cout << "❌ Invalid --cpus list: " << cpu_spec << "\n";
+            return 1;
+        }
+    } else {
+        for (int c = 0; c < ThreadPool::default_thread_count(); ++c) cpus.push_back(c);
+    }
+    std::vector<Layout> layouts;
+    if (layout_spec.empty()) {
+        layouts = default_layouts(static_cast<int>(cpus.size()));
+    } else if (!parse_layouts(layout_spec, layouts)) {
+        std::cout << "❌ Invalid --layouts (expected e.g. 32x1,8x4): " << layout_spec << "\n";
+        return 1;
+    }
+
+    std::mt19937 rng(11);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    std::vector<float> window(static_cast<size_t>(work.steps) * work.features);
+    for (float& v : window) v = dist(rng);
+
+    std::printf("⚙️  Execution resources benchmark: %s, %d x %d windows, %zu CPUs%s, %.1fs per layout\n",
+                torchscript ? "torchscript" : "native GRU", work.steps, work.features, cpus.size(),
+                pin ? " (pinned)" : "", work.seconds);
+    std::printf("   %-8s %-7s %12s  %s\n", "layout", "batch", "windows/s", "per call");
+    for (const Layout& layout : layouts) {
+        auto contexts = ExecutionContext::partition(layout.instances * layout.threads, layout.instances,
+                                                    pin ? cpus : std::vector<int>{});
+        std::vector<InstanceResult> results(contexts.size());
+        const auto start = Clock::now();
+        const auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+                                          std::chrono::duration<double>(work.seconds));
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < contexts.size(); ++i) {
+            threads.emplace_back([&, i] {
+                if (torchscript) run_torchscript_instance(contexts[i], work, window, deadline, results[i]);
+                else run_native_instance(contexts[i], work, window, deadline, results[i]);
+            });
+        }
+        for (auto& t : threads) t.join();
+        const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+        LatencyStats calls;
+        size_t windows = 0;
+        for (const auto& r : results) {
+            if (!r.error.empty()) {
+                std::cout << "❌ " << r.error << "\n";
+                return 1;
+            }
+            for (int64_t ns : r.call_ns) calls.add_ns(ns);
+            windows += r.windows;
+        }
+        const std::string name = std::to_string(layout.instances) + "x" + std::to_string(layout.threads);
+        std::printf("   %-8s %-7d %12.1f  %s\n", name.c_str(), work.batch * layout.threads,
+                    windows / elapsed, calls.format().c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+// =============================================================================
+// Tool: feature_benchmark.cpp
+// Purpose: Measure UnifiedFeatureEngine throughput on real market data
+//
+// Runs the engine over a dataset several times and reports bars/s and ns/bar
+// for the two ways callers consume features:
+// - matrix:  update(bar, row) writes each bar into a pre-allocated float
+//            [n_bars, feature_count] matrix (no per-bar allocation)
+// - vector:  update(bar) + get_features(), the per-bar std::vector<double>
+// A final pass with timing enabled prints the per-category breakdown.
+//
+// Usage:
+//   ./feature_benchmark --dataset data/equities/QQQ_RTH_NH.bin [--passes 5] [--standard]
+//
+//   --standard  use the 91-feature ML configuration instead of all 126
+// =============================================================================
+
+#include "features/feature_config_standard.h"
+#include "features/unified_feature_engine.h"
+#include "common/utils.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace sentio;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void report(const char* label, size_t bars, double seconds, double checksum) {
+    std::printf("   %-8s %10.2f M bars/s %8.1f ns/bar  (checksum %.6g)\n",
+                label, bars / seconds / 1e6, seconds * 1e9 / bars, checksum);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string dataset;
+    int passes = 5;
+    bool standard = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--dataset" && i + 1 < argc) dataset = argv[++i];
+        else if (arg == "--passes" && i + 1 < argc) passes = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--standard") standard = true;
+        else {
+            std::cout << "Usage: feature_benchmark --dataset <file.csv|file.bin> [--passes N] [--standard]\n";
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+    if (dataset.empty()) {
+        std::cout << "Usage: feature_benchmark --dataset <file.csv|file.bin> [--passes N] [--standard]\n";
+        return 1;
+    }
+
+    auto bars = utils::read_market_data_range(dataset, 0, 0);
+    if (bars.empty()) {
+        std::cout << "❌ No bars loaded from " << dataset << std::endl;
+        return 1;
+    }
+
+    const auto config = standard ? features::get_standard_91_feature_config()
+                                 : features::UnifiedFeatureEngine::Config();
+    const size_t n = bars.size();
+    const size_t width = static_cast<size_t>(config.total_features());
+    const size_t total = n * static_cast<size_t>(passes);
+
+    std::printf("⚡ UnifiedFeatureEngine benchmark: %zu bars x %d passes, %zu features\n", n, passes, width);
+
+    // Matrix path: one contiguous float row per bar
+    std::vector<float> matrix(n * width);
+    double checksum = 0.0;
+    auto start = Clock::now();
+    for (int p = 0; p < passes; ++p) {
+        features::UnifiedFeatureEngine engine(config);
+        for (size_t i = 0; i < n; ++i) {
+            engine.update(bars[i], matrix.data() + i * width);
+        }
+        checksum += matrix[(n - 1) * width];
+    }
+    report("matrix", total, seconds_since(start), checksum);
+
+    // Vector path: per-bar std::vector<double>
+    checksum = 0.0;
+    start = Clock::now();
+    for (int p = 0; p < passes; ++p) {
+        features::UnifiedFeatureEngine engine(config);
+        for (size_t i = 0; i < n; ++i) {
+            engine.update(bars[i]);
+            checksum += engine.get_features()[0];
+        }
+    }
+    report("vector", total, seconds_since(start), checksum);
+
+    // Per-category breakdown
+    features::UnifiedFeatureEngine engine(config);
+    engine.set_timing_enabled(true);
+    for (size_t i = 0; i < n; ++i) {
+        engine.update(bars[i], matrix.data() + i * width);
+    }
+    std::printf("\n📊 Per-category cost (timing pass):\n%s", engine.timing_report().c_str());
+    return 0;
+}
@@ -0,0 +1,124 @@
+// =============================================================================
+// Tool: gru_inference_benchmark.cpp
+// Purpose: Batch-size-1 GRU inference latency, native engine vs TorchScript
+//
+// Times ml::NativeGruModel on one [seq_len, feature_dim] window per call, both
+// as a full window pass and as a streaming step, and (LibTorch builds only)
+// the TorchScript model the strategy loads today on the same input shape.
+// Reports LatencyStats percentiles per path.
+//
+// Usage:
+//   ./gru_inference_benchmark --native artifacts/GRU/cpp_trained/model.native
+//                             [--torchscript artifacts/GRU/primary/model.pt] [--iters 2000]
+//   ./gru_inference_benchmark --synthetic [--hidden 128 --layers 3 --features 53 --seq 64]
+//
+//   --synthetic  random weights with the AdvancedGRUModelImpl layout (no
+//                trained model needed; latency does not depend on values)
+// =============================================================================
+
+#include "ml/gemm_kernels.h"
+#include "ml/native_gru.h"
+#include "common/latency_stats.h"
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef TORCH_AVAILABLE
+#include <torch/script.h>
+#endif
+
+using namespace sentio;
+
+int main(int argc, char* argv[]) {
+    std::string native_path;
+    std::string torchscript_path;
+    bool synthetic = false;
+    int iters = 2000;
+    ml::NativeGruConfig synthetic_config{53, 128, 3, 8, 64, 1};
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--native" && i + 1 < argc) native_path = argv[++i];
+        else if (arg == "--torchscript" && i + 1 < argc) torchscript_path = argv[++i];
+        else if (arg == "--iters" && i + 1 < argc) iters = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--synthetic") synthetic = true;
+        else if (arg == "--hidden" && i + 1 < argc) synthetic_config.hidden_dim = std::stoul(argv[++i]);
+        else if (arg == "--layers" && i + 1 < argc) synthetic_config.num_layers = std::stoul(argv[++i]);
+        else if (arg == "--features" && i + 1 < argc) synthetic_config.feature_dim = std::stoul(argv[++i]);
+        else if (arg == "--seq" && i + 1 < argc) synthetic_config.sequence_length = std::stoul(argv[++i]);
+        else {
+            std::cout << "Usage: gru_inference_benchmark (--native <model.native> | --synthetic) "
+                         "[--torchscript <model.pt>] [--iters N]\n";
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+    if (synthetic && native_path.empty()) {
+        native_path = "/tmp/sentio_gru_synthetic.native";
+        if (!ml::NativeGruModel::write_synthetic_weights(native_path, synthetic_config)) return 1;
+    }
+    if (native_path.empty()) {
+        std::cout << "❌ --native or --synthetic is required\n";
+        return 1;
+    }
+
+    ml::NativeGruModel model;
+    if (!model.load(native_path)) return 1;
+    const auto& config = model.config();
+    const int steps = static_cast<int>(config.sequence_length);
+    std::printf("⚡ GRU inference benchmark: %u features x %d steps, hidden %u, %u layers, %d iterations (kernels: %s)\n",
+                config.feature_dim, steps, config.hidden_dim, config.num_layers, iters, ml::kernels::simd_path());
+
+    std::mt19937 rng(11);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    std::vector<float> window(static_cast<size_t>(steps) * config.feature_dim);
+    for (float& v : window) v = dist(rng);
+
+    ml::NativeGruOutput output;
+    double checksum = 0.0;
+    LatencyStats native_window(iters);
+    for (int i = 0; i < iters; ++i) {
+        const auto start = LatencyStats::Clock::now();
+        model.forward(window.data(), steps, output);
+        native_window.add(start, LatencyStats::Clock::now());
+        checksum += output.direction;
+    }
+    std::printf("   %-12s %s\n", "native", native_window.format().c_str());
+
+    ml::NativeGruState state;
+    model.forward_window(window.data(), steps, state, output);
+    const float* newest = window.data() + static_cast<size_t>(steps - 1) * config.feature_dim;
+    LatencyStats native_step(iters);
+    for (int i = 0; i < iters; ++i) {
+        const auto start = LatencyStats::Clock::now();
+        model.forward_step(newest, state, output);
+        native_step.add(start, LatencyStats::Clock::now());
+        checksum += output.direction;
+    }
+    std::printf("   %-12s %s\n", "native-step", native_step.format().c_str());
+
+    if (!torchscript_path.empty()) {
+#ifdef TORCH_AVAILABLE
+        torch::set_num_threads(1);
+        auto module = torch::jit::load(torchscript_path);
+        module.eval();
+        torch::NoGradGuard no_grad;
+        auto input = torch::from_blob(window.data(), {1, steps, static_cast<int64_t>(config.feature_dim)},
+                                      torch::kFloat);
+        std::vector<torch::jit::IValue> inputs{input};
+        LatencyStats jit(iters);
+        for (int i = 0; i < iters; ++i) {
+            const auto start = LatencyStats::Clock::now();
+            auto out = module.forward(inputs);
+            jit.add(start, LatencyStats::Clock::now());
+            checksum += out.isTuple() ? out.toTuple()->elements()[0].toTensor().item<double>()
+                                      : out.toTensor().flatten()[0].item<double>();
+        }
+        std::printf("   %-12s %s\n", "torchscript", jit.format().c_str());
+#else
+        std::cout << "   torchscript  skipped (built without LibTorch)\n";
+#endif
+    }
+    std::printf("   (checksum %.6g)\n", checksum);
+    return 0;
+}
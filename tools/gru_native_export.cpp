@@ -0,0 +1,115 @@
+// =============================================================================
+// Tool: gru_native_export.cpp
+// Purpose: Convert a gru_trainer checkpoint (model.pt) into the LibTorch-free
+//          weight file read by ml::NativeGruModel (model.native)
+//
+// The architecture (hidden_dim, num_layers, num_heads, sequence_length,
+// feature_count, enable_multi_task) comes from the trainer's metadata.json.
+// The checkpoint is loaded into ml::AdvancedGRUModel and written with
+// AdvancedGRUModelImpl::export_native(), the same call gru_trainer makes for
+// new models; this covers checkpoints trained before it did.
+//
+// The exported file is then loaded back and a random window is run through
+// both engines; the tool fails if the direction logits disagree.
+//
+// Usage:
+//   ./gru_native_export --model artifacts/GRU/cpp_trained/model.pt
+//                       --metadata artifacts/GRU/cpp_trained/metadata.json
+//                       [--out artifacts/GRU/cpp_trained/model.native]
+//
+//   --out  default: the model path with .pt replaced by .native
+// =============================================================================
+
+#include "ml/gru_model.h"
+#include "ml/native_gru.h"
+#include <torch/torch.h>
+#include <nlohmann/json.hpp>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace sentio;
+
+namespace {
+
+void usage() {
+    std::cout << "Usage: gru_native_export --model <model.pt> --metadata <metadata.json> [--out <model.native>]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string model_path;
+    std::string metadata_path;
+    std::string out_path;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--model" && i + 1 < argc) model_path = argv[++i];
+        else if (arg == "--metadata" && i + 1 < argc) metadata_path = argv[++i];
+        else if (arg == "--out" && i + 1 < argc) out_path = argv[++i];
+        else {
+            usage();
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+    if (model_path.empty() || metadata_path.empty()) {
+        usage();
+        return 1;
+    }
+    if (out_path.empty()) {
+        const bool pt = model_path.size() >= 3 && model_path.substr(model_path.size() - 3) == ".pt";
+        out_path = (pt ? model_path.substr(0, model_path.size() - 3) : model_path) + ".native";
+    }
+
+    ml::GRUConfig config;
+    try {
+        std::ifstream file(metadata_path);
+        if (!file.is_open()) {
+            std::cout << "❌ Cannot open metadata: " << metadata_path << "\n";
+            return 1;
+        }
+        nlohmann::json metadata;
+        file >> metadata;
+        config.feature_dim = metadata.value("feature_count", config.feature_dim);
+        config.sequence_length = metadata.value("sequence_length", config.sequence_length);
+        config.hidden_dim = metadata.value("hidden_dim", config.hidden_dim);
+        config.num_layers = metadata.value("num_layers", config.num_layers);
+        config.num_heads = metadata.value("num_heads", config.num_heads);
+        config.enable_multi_task = metadata.value("enable_multi_task", config.enable_multi_task);
+    } catch (const std::exception& e) {
+        std::cout << "❌ Invalid metadata " << metadata_path << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    torch::NoGradGuard no_grad;
+    ml::AdvancedGRUModel model(config);
+    try {
+        model->load_model(model_path);
+    } catch (const std::exception& e) {
+        std::cout << "❌ " << e.what() << "\n";
+        return 1;
+    }
+    model->eval();
+    if (!model->export_native(out_path)) {
+        std::cout << "❌ Failed to write " << out_path << "\n";
+        return 1;
+    }
+
+    // Round trip: same window through both engines
+    ml::NativeGruModel native;
+    if (!native.load(out_path)) return 1;
+    auto window = torch::randn({1, config.sequence_length, config.feature_dim});
+    const double torch_logit = model->forward(window).direction[0][0].item<double>();
+    ml::NativeGruOutput output;
+    native.forward(window.data_ptr<float>(), config.sequence_length, output);
+    const double drift = std::fabs(torch_logit - output.direction);
+    std::cout << "Direction logit: torch " << torch_logit << ", native " << output.direction
+              << " (|diff| " << drift << ")\n";
+    if (drift > 1e-4 * (1.0 + std::fabs(torch_logit))) {
+        std::cout << "❌ Native weights do not reproduce the checkpoint\n";
+        return 2;
+    }
+    std::cout << "✅ " << model_path << " -> " << out_path << "\n";
+    return 0;
+}
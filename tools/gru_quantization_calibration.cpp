@@ -0,0 +1,138 @@
+// =============================================================================
+// Tool: gru_quantization_calibration.cpp
+// Purpose: Signal drift of reduced-precision GRU weights against fp32
+//
+// Builds the strategy's 53-feature windows (GruFeatureWindow) over a held-out
+// bar range and runs every window through two ml::NativeGruModel instances:
+// fp32 weights and the chosen reduced precision. Reports the absolute drift of
+// the direction probability (sigmoid of the logit, as OptimizedGruStrategy
+// publishes it), how often the two sides of 0.5 disagree, per-window latency
+// of both paths and the weight bytes each streams per timestep.
+//
+// Usage:
+//   ./gru_quantization_calibration --model artifacts/GRU/cpp_trained/model.native
+//                                  --dataset data/equities/QQQ_RTH_NH.bin
+//                                  [--start 0 --count 20000] [--precision int8|bf16]
+//                                  [--max-drift 0.01]
+//
+//   --max-drift  exit status 2 when the p99 drift exceeds this value
+// =============================================================================
+
+#include "ml/gemm_kernels.h"
+#include "ml/native_gru.h"
+#include "strategy/gru_feature_window.h"
+#include "common/latency_stats.h"
+#include "common/utils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace sentio;
+
+namespace {
+
+double direction_probability(float logit) {
+    return 1.0 / (1.0 + std::exp(-static_cast<double>(logit)));
+}
+
+void usage() {
+    std::cout << "Usage: gru_quantization_calibration --model <model.native> --dataset <file.csv|file.bin> "
+                 "[--start N] [--count N] [--precision int8|bf16] [--max-drift X]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string model_path;
+    std::string dataset;
+    uint64_t start = 0;
+    uint64_t count = 0;
+    std::string precision_name = "int8";
+    double max_drift = -1.0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--model" && i + 1 < argc) model_path = argv[++i];
+        else if (arg == "--dataset" && i + 1 < argc) dataset = argv[++i];
+        else if (arg == "--start" && i + 1 < argc) start = std::stoull(argv[++i]);
+        else if (arg == "--count" && i + 1 < argc) count = std::stoull(argv[++i]);
+        else if (arg == "--precision" && i + 1 < argc) precision_name = argv[++i];
+        else if (arg == "--max-drift" && i + 1 < argc) max_drift = std::stod(argv[++i]);
+        else {
+            usage();
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+    ml::kernels::WeightPrecision precision;
+    if (model_path.empty() || dataset.empty() || !ml::kernels::parse_weight_precision(precision_name, precision)) {
+        usage();
+        return 1;
+    }
+
+    ml::NativeGruModel reference;
+    ml::NativeGruModel reduced;
+    if (!reference.load(model_path) || !reduced.load(model_path, precision)) return 1;
+    const auto& config = reference.config();
+    if (config.feature_dim != GruFeatureWindow::FEATURE_COUNT) {
+        std::cout << "❌ Model expects " << config.feature_dim << " features; the strategy builds "
+                  << GruFeatureWindow::FEATURE_COUNT << "\n";
+        return 1;
+    }
+    const std::vector<Bar> bars = utils::read_market_data_range(dataset, start, count);
+    const int seq_len = static_cast<int>(config.sequence_length);
+    if (bars.size() <= static_cast<size_t>(seq_len)) {
+        std::cout << "❌ Need more than " << seq_len << " bars, got " << bars.size() << "\n";
+        return 1;
+    }
+
+    // Same rolling feature rows as OptimizedGruStrategy
+    GruFeatureWindow features(seq_len);
+    std::vector<float> window(static_cast<size_t>(seq_len) * GruFeatureWindow::FEATURE_COUNT);
+    std::vector<double> drift;
+    drift.reserve(bars.size());
+    size_t flips = 0;
+    LatencyStats fp32_latency(bars.size());
+    LatencyStats reduced_latency(bars.size());
+    ml::NativeGruOutput expected, actual;
+    for (const Bar& bar : bars) {
+        features.update_statistics(bar);
+        if (!features.build(window.data())) continue;
+
+        auto t0 = LatencyStats::Clock::now();
+        reference.forward(window.data(), seq_len, expected);
+        auto t1 = LatencyStats::Clock::now();
+        reduced.forward(window.data(), seq_len, actual);
+        auto t2 = LatencyStats::Clock::now();
+        fp32_latency.add(t0, t1);
+        reduced_latency.add(t1, t2);
+
+        const double p_ref = direction_probability(expected.direction);
+        const double p_red = direction_probability(actual.direction);
+        drift.push_back(std::abs(p_red - p_ref));
+        if ((p_ref > 0.5) != (p_red > 0.5)) flips++;
+    }
+
+    std::sort(drift.begin(), drift.end());
+    double mean = 0.0;
+    for (double d : drift) mean += d;
+    mean /= drift.size();
+    const double p99 = drift[std::min(drift.size() - 1, static_cast<size_t>(drift.size() * 0.99))];
+
+    std::printf("🔬 GRU quantization calibration: %s vs fp32 over %zu windows (bars %llu..%llu, kernels: %s)\n",
+                ml::kernels::to_string(precision), drift.size(), static_cast<unsigned long long>(start),
+                static_cast<unsigned long long>(start + bars.size() - 1), ml::kernels::simd_path());
+    std::printf("   |Δprob|      mean %.3g  p99 %.3g  max %.3g\n", mean, p99, drift.back());
+    std::printf("   side flips   %zu (%.3f%%)\n", flips, 100.0 * flips / drift.size());
+    std::printf("   weights      fp32 %.1f KB  %s %.1f KB\n", reference.weight_bytes() / 1024.0,
+                ml::kernels::to_string(precision), reduced.weight_bytes() / 1024.0);
+    std::printf("   %-12s %s\n", "fp32", fp32_latency.format().c_str());
+    std::printf("   %-12s %s\n", ml::kernels::to_string(precision), reduced_latency.format().c_str());
+
+    if (max_drift >= 0.0 && p99 > max_drift) {
+        std::printf("❌ p99 drift %.3g exceeds --max-drift %.3g\n", p99, max_drift);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+// =============================================================================
+// Tool: model_server.cpp
+// Purpose: Shared local inference process for many strategy instances
+//
+// Runs ml::ModelServer on a Unix-domain socket until Ctrl-C. Strategies
+// started with a model server socket (TransformerStrategy::Config::
+// model_server, OptimizedGruConfig::model_server, strattest --model-server)
+// send their windows here instead of loading the model themselves; each
+// model is loaded once, on first use, and requests arriving within
+// --batch-window-us of each other are evaluated in one forward pass.
+//
+// Usage:
+//   ./model_server [--socket /tmp/sentio_models.sock] [--batch-window-us 200]
+//                  [--max-batch 256] [--intra-op-threads 1] [--interop-threads 1]
+//                  [--cpus 0-7] [--stats-interval 60]
+//
+//   --batch-window-us  how long the oldest request waits for others (0 = no wait)
+//   --stats-interval   seconds between request/batch counters (0 = off)
+// =============================================================================
+
+#include "ml/model_server.h"
+#include "strategy/execution_context.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace sentio;
+
+namespace {
+
+std::atomic<bool> g_stop{false};
+void request_stop(int) { g_stop = true; }
+
+void print_stats(const ml::ModelServer::Stats& s) {
+    std::printf("📊 models %zu  clients %llu  requests %llu  rows %llu  batches %llu  (%.1f rows/batch)\n",
+                s.models, static_cast<unsigned long long>(s.connections),
+                static_cast<unsigned long long>(s.requests), static_cast<unsigned long long>(s.rows),
+                static_cast<unsigned long long>(s.batches), s.batches ? double(s.rows) / s.batches : 0.0);
+    std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ml::ModelServer::Options options;
+    ExecutionContext::Options execution;
+    int stats_interval_s = 60;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) options.socket_path = argv[++i];
+        else if (arg == "--batch-window-us" && i + 1 < argc) options.batch_window_us = std::stoll(argv[++i]);
+        else if (arg == "--max-batch" && i + 1 < argc) options.max_batch_rows = std::stoi(argv[++i]);
+        else if (arg == "--intra-op-threads" && i + 1 < argc) execution.intra_op_threads = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--interop-threads" && i + 1 < argc) execution.interop_threads = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--cpus" && i + 1 < argc) {
+            if (!ExecutionContext::parse_cpu_list(argv[++i], execution.cpus)) {
+                std::cout << "❌ Invalid --cpus list: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--stats-interval" && i + 1 < argc) stats_interval_s = std::stoi(argv[++i]);
+        else {
+            std::cout << "Usage: model_server [--socket PATH] [--batch-window-us N] [--max-batch N] "
+                         "[--intra-op-threads N] [--interop-threads N] [--cpus LIST] [--stats-interval S]\n";
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+    ExecutionContext::configure_process(execution.interop_threads);
+    options.execution = ExecutionContext(execution);
+
+    ml::ModelServer server(options);
+    if (!server.start()) return 1;
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+    std::cout << "🧠 Model server on " << options.socket_path << " (Ctrl-C to stop)" << std::endl;
+
+    auto last_stats = std::chrono::steady_clock::now();
+    while (!g_stop) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (stats_interval_s > 0 &&
+            std::chrono::steady_clock::now() - last_stats >= std::chrono::seconds(stats_interval_s)) {
+            print_stats(server.stats());
+            last_stats = std::chrono::steady_clock::now();
+        }
+    }
+    server.stop();
+    print_stats(server.stats());
+    return 0;
+}